@@ -12,9 +12,21 @@ vec3 colors[3] = vec3[](
     vec3(0.0, 0.0, 1.0)
 );
 
+// Per-frame data from the uniform ring, selected by a dynamic offset.
+layout(set = 0, binding = 0) uniform FrameData {
+    mat4 view_proj;
+    vec4 time;
+} frame;
+
+// Per-draw data on the push-constant fast path (128 bytes max).
+layout(push_constant) uniform DrawData {
+    mat4 model;
+    vec4 tint;
+} draw;
+
 layout(location = 0) out vec3 fragColor;
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
-}
\ No newline at end of file
+    gl_Position = frame.view_proj * draw.model * vec4(positions[gl_VertexIndex], 0.0, 1.0);
+    fragColor = colors[gl_VertexIndex] * draw.tint.rgb;
+}
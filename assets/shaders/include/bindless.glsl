@@ -0,0 +1,20 @@
+// Bindless resource table, see PyroBindlessTable. Resources are addressed by the 32-bit slot indices the engine
+// hands out and passes in through push constants or instance data.
+#extension GL_EXT_nonuniform_qualifier : require
+
+#ifndef BINDLESS_SET
+#define BINDLESS_SET 0
+#endif
+
+layout(set = BINDLESS_SET, binding = 0) uniform texture2D bindless_textures[];
+layout(set = BINDLESS_SET, binding = 1) readonly buffer BindlessBuffer { uint words[]; } bindless_buffers[];
+layout(set = BINDLESS_SET, binding = 2) uniform sampler bindless_samplers[];
+
+vec4 bindless_sample(uint texture_index, uint sampler_index, vec2 uv) {
+    return texture(sampler2D(bindless_textures[nonuniformEXT(texture_index)],
+                             bindless_samplers[nonuniformEXT(sampler_index)]), uv);
+}
+
+uint bindless_load_word(uint buffer_index, uint word_offset) {
+    return bindless_buffers[nonuniformEXT(buffer_index)].words[word_offset];
+}
@@ -0,0 +1,47 @@
+// Meshlet and instance data for cluster rendering, see PyroClusterRenderer. Meshlet must match MeshletEntry in
+// src/mesh/PyroMeshFormat.hpp; ClusterInstance and ClusterView match the structs in PyroClusterRenderer.cpp.
+
+struct Meshlet {
+    vec4 sphere; // center, radius
+    vec4 cone;   // axis, cutoff; a cutoff of 1 disables the backface test
+    uint vertex_offset;
+    uint triangle_offset;
+    uint vertex_count;
+    uint triangle_count;
+};
+
+struct ClusterInstance {
+    mat4 model;
+    uint first_meshlet;
+    uint meshlet_count;
+    // Start of this instance's region of the cluster index buffer.
+    uint first_index;
+    uint first_vertex;
+    // Largest axis scale of model, for transforming bounding sphere radii.
+    float scale;
+    // Start of this instance's meshlets in the visibility buffer.
+    uint visibility_offset;
+    uint pad0;
+    uint pad1;
+};
+
+const uint CLUSTER_CULL_FRUSTUM = 1u;
+const uint CLUSTER_CULL_BACKFACE = 2u;
+
+layout(set = 0, binding = 0) readonly buffer Meshlets { Meshlet meshlets[]; };
+layout(set = 0, binding = 1) readonly buffer MeshletVertices { uint meshlet_vertices[]; };
+layout(set = 0, binding = 2) readonly buffer MeshletTriangles { uint meshlet_triangles[]; };
+layout(set = 0, binding = 3) readonly buffer ClusterInstances { ClusterInstance instances[]; };
+layout(set = 0, binding = 4) uniform ClusterView {
+    mat4 view_proj;
+    // World-space frustum planes, inside when dot(plane.xyz, p) + plane.w >= 0.
+    vec4 planes[6];
+    vec4 eye;
+    vec2 pyramid_size;
+    uint pyramid_levels;
+    uint flags;
+} view;
+
+uvec3 unpack_meshlet_triangle(uint packed) {
+    return uvec3(packed & 0xffu, (packed >> 8) & 0xffu, (packed >> 16) & 0xffu);
+}
@@ -0,0 +1,140 @@
+// Per-meshlet visibility tests shared by cluster_cull.comp and cluster.task. Occlusion is tested against a
+// max-depth pyramid (0 near, 1 far); a meshlet is hidden when the nearest point of its bounding box lies behind
+// the farthest depth under its screen footprint.
+//
+// Culling runs in two phases around the pyramid build. The early phase draws the meshlets that were visible last
+// frame, tested against the frustum and normal cone only. Their depth then builds this frame's pyramid, and the
+// late phase tests every meshlet against it, records the result for the next frame and draws the visible ones
+// the early phase skipped. The single phase draws everything that passes the frustum and cone tests at once.
+
+#include "cluster.glsl"
+
+const uint CLUSTER_VISIBLE = 0u;
+const uint CLUSTER_FRUSTUM_CULLED = 1u;
+const uint CLUSTER_BACKFACE_CULLED = 2u;
+const uint CLUSTER_OCCLUSION_CULLED = 3u;
+
+const uint CLUSTER_PHASE_EARLY = 0u;
+const uint CLUSTER_PHASE_LATE = 1u;
+const uint CLUSTER_PHASE_SINGLE = 2u;
+
+layout(push_constant) uniform ClusterPhase {
+    uint phase;
+    // First of this phase's indirect commands; unused by the task shader path.
+    uint draw_offset;
+} cluster_phase;
+
+layout(set = 0, binding = 5) uniform sampler2D depth_pyramid;
+// Must match ClusterCullStats in src/mesh/PyroClusterRenderer.hpp. The single phase counts as early.
+layout(set = 0, binding = 6) buffer ClusterCullStats {
+    uint tested;
+    uint frustum_culled;
+    uint backface_culled;
+    uint occlusion_culled;
+    uint visible;
+    uint early_tested;
+    uint early_drawn;
+    uint late_drawn;
+    uint triangles;
+} cull_stats;
+// One flag per meshlet of every instance: visible at the end of the last frame's late phase.
+layout(set = 0, binding = 10) buffer MeshletVisibility { uint meshlet_visibility[]; };
+
+bool cluster_occluded(vec3 center, float radius) {
+    vec2 lo = vec2(1.0);
+    vec2 hi = vec2(-1.0);
+    float nearest = 1.0;
+    for (int i = 0; i < 8; i++) {
+        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0,
+                                             (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = view.view_proj * vec4(corner, 1.0);
+        // Boxes reaching behind the eye have no usable footprint.
+        if (clip.w <= 0.0) {
+            return false;
+        }
+        vec3 ndc = clip.xyz / clip.w;
+        lo = min(lo, ndc.xy);
+        hi = max(hi, ndc.xy);
+        nearest = min(nearest, ndc.z);
+    }
+    vec2 uv_lo = clamp(lo * 0.5 + 0.5, 0.0, 1.0);
+    vec2 uv_hi = clamp(hi * 0.5 + 0.5, 0.0, 1.0);
+    // At this level the footprint is at most one texel wide, so it touches at most 2x2 texels.
+    vec2 size = (uv_hi - uv_lo) * view.pyramid_size;
+    float level = min(ceil(log2(max(max(size.x, size.y), 1.0))), float(view.pyramid_levels - 1u));
+    float farthest = max(max(textureLod(depth_pyramid, uv_lo, level).r,
+                             textureLod(depth_pyramid, vec2(uv_hi.x, uv_lo.y), level).r),
+                         max(textureLod(depth_pyramid, vec2(uv_lo.x, uv_hi.y), level).r,
+                             textureLod(depth_pyramid, uv_hi, level).r));
+    return nearest > farthest;
+}
+
+uint cull_meshlet(Meshlet meshlet, ClusterInstance instance, bool test_occlusion) {
+    vec3 center = (instance.model * vec4(meshlet.sphere.xyz, 1.0)).xyz;
+    float radius = meshlet.sphere.w * instance.scale;
+    if ((view.flags & CLUSTER_CULL_FRUSTUM) != 0u) {
+        for (int i = 0; i < 6; i++) {
+            if (dot(view.planes[i].xyz, center) + view.planes[i].w < -radius) {
+                return CLUSTER_FRUSTUM_CULLED;
+            }
+        }
+    }
+    if ((view.flags & CLUSTER_CULL_BACKFACE) != 0u && meshlet.cone.w < 1.0) {
+        vec3 axis = normalize(mat3(instance.model) * meshlet.cone.xyz);
+        vec3 offset = center - view.eye.xyz;
+        if (dot(offset, axis) >= meshlet.cone.w * length(offset) + radius) {
+            return CLUSTER_BACKFACE_CULLED;
+        }
+    }
+    if (test_occlusion && cluster_occluded(center, radius)) {
+        return CLUSTER_OCCLUSION_CULLED;
+    }
+    return CLUSTER_VISIBLE;
+}
+
+// Whether the current phase draws the meshlet; the late phase also stores its visibility for the next frame.
+bool cluster_phase_draws(Meshlet meshlet, ClusterInstance instance, uint meshlet_index) {
+    uint slot = instance.visibility_offset + meshlet_index;
+    if (cluster_phase.phase == CLUSTER_PHASE_EARLY) {
+        if (meshlet_visibility[slot] == 0u) {
+            return false;
+        }
+        atomicAdd(cull_stats.early_tested, 1u);
+        if (cull_meshlet(meshlet, instance, false) != CLUSTER_VISIBLE) {
+            return false;
+        }
+        atomicAdd(cull_stats.early_drawn, 1u);
+        atomicAdd(cull_stats.triangles, meshlet.triangle_count);
+        return true;
+    }
+
+    bool late = cluster_phase.phase == CLUSTER_PHASE_LATE;
+    uint result = cull_meshlet(meshlet, instance, late);
+    atomicAdd(cull_stats.tested, 1u);
+    if (result == CLUSTER_FRUSTUM_CULLED) {
+        atomicAdd(cull_stats.frustum_culled, 1u);
+    } else if (result == CLUSTER_BACKFACE_CULLED) {
+        atomicAdd(cull_stats.backface_culled, 1u);
+    } else if (result == CLUSTER_OCCLUSION_CULLED) {
+        atomicAdd(cull_stats.occlusion_culled, 1u);
+    } else {
+        atomicAdd(cull_stats.visible, 1u);
+    }
+    bool visible = result == CLUSTER_VISIBLE;
+    bool draw = visible;
+    if (late) {
+        // The early phase ran the same frustum and cone tests, so it drew exactly the visible meshlets that
+        // were flagged.
+        draw = visible && meshlet_visibility[slot] == 0u;
+        meshlet_visibility[slot] = visible ? 1u : 0u;
+    }
+    if (draw && late) {
+        atomicAdd(cull_stats.late_drawn, 1u);
+    } else if (draw) {
+        atomicAdd(cull_stats.early_drawn, 1u);
+    }
+    if (draw) {
+        atomicAdd(cull_stats.triangles, meshlet.triangle_count);
+    }
+    return draw;
+}
@@ -0,0 +1,16 @@
+// Texture streaming feedback, see PyroTextureStreamer. Each streamed texture handle owns one uint holding the
+// finest mip level any invocation asked for this frame. Fragment-stage use needs fragmentStoresAndAtomics.
+
+#ifndef TEXTURE_FEEDBACK_SET
+#define TEXTURE_FEEDBACK_SET 1
+#endif
+
+layout(set = TEXTURE_FEEDBACK_SET, binding = 0) buffer TextureFeedback { uint requested_mip[]; } texture_feedback;
+
+// `full_size` is the level 0 size of the texture file, not of the (partially resident) image being sampled.
+void texture_feedback_request(uint texture_handle, vec2 uv, vec2 full_size) {
+    vec2 texel = uv * full_size;
+    float rho = max(dot(dFdx(texel), dFdx(texel)), dot(dFdy(texel), dFdy(texel)));
+    uint level = uint(max(0.5 * log2(max(rho, 1.0)), 0.0));
+    atomicMin(texture_feedback.requested_mip[texture_handle], level);
+}
@@ -0,0 +1,13 @@
+#version 450
+
+layout(location = 0) in vec3 fragNormal;
+layout(location = 1) in vec2 fragUv;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // Fixed directional light until materials exist.
+    vec3 light = normalize(vec3(0.4, 0.8, 0.3));
+    float diffuse = max(dot(normalize(fragNormal), light), 0.0);
+    vec3 albedo = vec3(0.6 + 0.4 * fragUv, 0.7);
+    outColor = vec4(albedo * (0.15 + 0.85 * diffuse), 1.0);
+}
@@ -0,0 +1,20 @@
+#version 450
+
+// Must match MeshVertex in src/mesh/PyroMeshFormat.hpp.
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUv;
+
+layout(push_constant) uniform MeshDraw {
+    mat4 model_view_proj;
+    mat4 model;
+} draw;
+
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) out vec2 fragUv;
+
+void main() {
+    gl_Position = draw.model_view_proj * vec4(inPosition, 1.0);
+    fragNormal = mat3(draw.model) * inNormal;
+    fragUv = inUv;
+}
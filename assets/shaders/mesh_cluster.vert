@@ -0,0 +1,27 @@
+#version 450
+
+// Vertex stage for the compute cluster path: mesh.vert with the transform fetched per instance, since one
+// indirect command draws every surviving meshlet of an instance.
+
+#include "include/cluster.glsl"
+
+// Must match MeshVertex in src/mesh/PyroMeshFormat.hpp.
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inUv;
+
+// Must match DrawConstants in src/mesh/PyroClusterRenderer.cpp. Zero when one multi-draw carries every instance
+// in firstInstance; otherwise each instance is drawn on its own with firstInstance 0 and passed here.
+layout(push_constant) uniform DrawInstance {
+    uint instance_base;
+} draw;
+
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) out vec2 fragUv;
+
+void main() {
+    mat4 model = instances[draw.instance_base + gl_InstanceIndex].model;
+    gl_Position = view.view_proj * (model * vec4(inPosition, 1.0));
+    fragNormal = mat3(model) * inNormal;
+    fragUv = inUv;
+}
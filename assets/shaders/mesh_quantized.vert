@@ -0,0 +1,29 @@
+#version 450
+
+// Must match QuantizedMeshVertex in src/mesh/PyroMeshFormat.hpp: half-float position and uv are widened by the
+// vertex fetch, the normal arrives as a snorm octahedral encoding.
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inUv;
+
+layout(push_constant) uniform MeshDraw {
+    mat4 model_view_proj;
+    mat4 model;
+} draw;
+
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) out vec2 fragUv;
+
+vec3 decode_octahedral(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    // Unfold the lower hemisphere.
+    float fold = max(-normal.z, 0.0);
+    normal.xy += vec2(normal.x >= 0.0 ? -fold : fold, normal.y >= 0.0 ? -fold : fold);
+    return normalize(normal);
+}
+
+void main() {
+    gl_Position = draw.model_view_proj * vec4(inPosition, 1.0);
+    fragNormal = mat3(draw.model) * decode_octahedral(inNormal);
+    fragUv = inUv;
+}
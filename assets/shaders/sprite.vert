@@ -0,0 +1,20 @@
+#version 450
+
+// Must match SpriteVertex in src/renderer/PyroSpriteBatch.hpp.
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inUv;
+layout(location = 2) in vec4 inColor;
+
+// Pixel coordinates, origin top-left, mapped to clip space.
+layout(push_constant) uniform SpriteData {
+    vec2 inverse_half_extent;
+} sprite;
+
+layout(location = 0) out vec2 fragUv;
+layout(location = 1) out vec4 fragColor;
+
+void main() {
+    gl_Position = vec4(inPosition * sprite.inverse_half_extent - 1.0, 0.0, 1.0);
+    fragUv = inUv;
+    fragColor = inColor;
+}
@@ -0,0 +1,16 @@
+#version 450
+
+// Signed distance field: 0.5 on the outline, rising inside.
+layout(set = 0, binding = 0) uniform sampler2D glyphAtlas;
+
+layout(location = 0) in vec2 fragUv;
+layout(location = 1) in vec4 fragColor;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    float distance = texture(glyphAtlas, fragUv).r;
+    // Antialias over one screen pixel whatever the glyph scale.
+    float width = max(fwidth(distance) * 0.5, 1e-4);
+    float coverage = smoothstep(0.5 - width, 0.5 + width, distance);
+    outColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
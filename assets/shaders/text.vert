@@ -0,0 +1,27 @@
+#version 450
+
+// Per-glyph instance data; must match TextInstance in src/text/PyroTextRenderer.hpp.
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inSize;
+layout(location = 2) in vec4 inUvRect;
+layout(location = 3) in vec4 inColor;
+
+layout(push_constant) uniform TextData {
+    vec2 inverse_half_extent;
+} text;
+
+layout(location = 0) out vec2 fragUv;
+layout(location = 1) out vec4 fragColor;
+
+// Two triangles per glyph, corners generated from the vertex index.
+const vec2 corners[6] = vec2[](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+    vec2(1.0, 1.0), vec2(0.0, 1.0), vec2(0.0, 0.0)
+);
+
+void main() {
+    vec2 corner = corners[gl_VertexIndex];
+    gl_Position = vec4((inPosition + corner * inSize) * text.inverse_half_extent - 1.0, 0.0, 1.0);
+    fragUv = mix(inUvRect.xy, inUvRect.zw, corner);
+    fragColor = inColor;
+}
@@ -0,0 +1,244 @@
+//
+// Created by srijan on 2/21/25.
+//
+
+// Frame time of an ALU-bound compute workload plus a fill-bound raster workload, with both recorded into one
+// graphics submission (separated by a barrier, as passes are in a frame) and with the compute half submitted to
+// the async compute queue so the two overlap. Run from the build directory so assets/shaders/*.spv resolve.
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <functional>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "../src/compute/PyroAsyncCompute.hpp"
+#include "../src/compute/PyroComputePipeline.hpp"
+#include "../src/core/VulkanBuffer.hpp"
+#include "../src/core/VulkanDevice.hpp"
+#include "../src/core/VulkanImage.hpp"
+#include "../src/core/VulkanInstance.hpp"
+#include "../src/core/VulkanTimelineSemaphore.hpp"
+#include "../src/descriptor/PyroDescriptors.hpp"
+#include "../src/renderer/PyroRender.hpp"
+#include "../src/renderer/PyroUniformRing.hpp"
+#include "../src/renderer/Pyropipeline.hpp"
+#include "../src/utils/Logger.hpp"
+#include "../src/window/PyroWindow.hpp"
+
+namespace {
+    constexpr uint32_t WARMUP_ITERATIONS = 10;
+    constexpr uint32_t ITERATIONS = 100;
+    constexpr VkExtent2D TARGET_EXTENT = {1920, 1080};
+    constexpr uint32_t RASTER_LAYERS = 64;
+    constexpr uint32_t COMPUTE_ELEMENTS = 1 << 20;
+    constexpr uint32_t COMPUTE_ITERATIONS = 256;
+
+    struct ComputeParams {
+        uint32_t count;
+        uint32_t iterations;
+    };
+
+    double median(std::vector<double> samples) {
+        std::ranges::sort(samples);
+        return samples[samples.size() / 2];
+    }
+
+    class Workloads {
+    public:
+        Workloads(pyro::VulkanDevice *device, pyro::PyroDescriptors *descriptors) :
+            descriptors(descriptors), uniforms(device, descriptors),
+            raster_pipeline(device, {uniforms.get_layout()},
+                            {pyro::PyroUniformRing::push_constant_range(VK_SHADER_STAGE_VERTEX_BIT,
+                                                                        sizeof(pyro::DrawPushConstants))}) {
+            pyro::ImageDesc desc{};
+            desc.extent = TARGET_EXTENT;
+            desc.format = device->get_swap_chain_image_format();
+            desc.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            target = std::make_unique<pyro::VulkanImage>(device, desc);
+            // Every frame renders in COLOR_ATTACHMENT_OPTIMAL; transition once up front.
+            const VkCommandBuffer setup = device->begin_single_time_commands();
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = target->get_image();
+            barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            vkCmdPipelineBarrier(setup, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+            device->end_single_time_commands(setup);
+
+            values = std::make_unique<pyro::VulkanBuffer>(device, COMPUTE_ELEMENTS * sizeof(float) * 4,
+                                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            compute_bindings.bind_buffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT,
+                                         values->get_buffer(), 0, VK_WHOLE_SIZE);
+            compute_pipeline = std::make_unique<pyro::PyroComputePipeline>(
+                    device, "assets/shaders/bench_alu.comp.spv",
+                    std::vector{descriptors->get_layout(compute_bindings)},
+                    std::vector{VkPushConstantRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ComputeParams)}});
+        }
+        void begin_frame() {
+            descriptors->begin_frame(0);
+            uniforms.begin_frame(0);
+        }
+
+        void record_compute(const VkCommandBuffer command_buffer) const {
+            compute_pipeline->bind(command_buffer);
+            compute_pipeline->bind_set(command_buffer, 0, descriptors->get_cached_set(compute_bindings));
+            const ComputeParams params{COMPUTE_ELEMENTS, COMPUTE_ITERATIONS};
+            compute_pipeline->push_constants(command_buffer, &params, sizeof(params));
+            pyro::PyroComputePipeline::dispatch(command_buffer,
+                                                pyro::PyroComputePipeline::group_count(COMPUTE_ELEMENTS, 64));
+        }
+
+        // Full-screen overdraw: RASTER_LAYERS instances of the basic triangle scaled past the viewport.
+        void record_raster(const VkCommandBuffer command_buffer) {
+            VkRenderingAttachmentInfo color{};
+            color.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            color.imageView = target->get_view();
+            color.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            color.clearValue.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+            VkRenderingInfo rendering_info{};
+            rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+            rendering_info.renderArea = {{0, 0}, TARGET_EXTENT};
+            rendering_info.layerCount = 1;
+            rendering_info.colorAttachmentCount = 1;
+            rendering_info.pColorAttachments = &color;
+            vkCmdBeginRendering(command_buffer, &rendering_info);
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, raster_pipeline.get_pipeline());
+            const VkViewport viewport{0.0f, 0.0f, static_cast<float>(TARGET_EXTENT.width),
+                                      static_cast<float>(TARGET_EXTENT.height), 0.0f, 1.0f};
+            vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+            const VkRect2D scissor{{0, 0}, TARGET_EXTENT};
+            vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+            pyro::FrameUniforms frame{};
+            frame.view_proj = glm::mat4(1.0f);
+            uniforms.bind(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, raster_pipeline.get_pipeline_layout(), 0,
+                          uniforms.push(frame));
+            pyro::DrawPushConstants draw{};
+            draw.model = glm::scale(glm::mat4(1.0f), glm::vec3(4.0f));
+            draw.tint = glm::vec4(1.0f);
+            pyro::PyroUniformRing::push_draw_data(command_buffer, raster_pipeline.get_pipeline_layout(),
+                                                  VK_SHADER_STAGE_VERTEX_BIT, &draw, sizeof(draw));
+            vkCmdDraw(command_buffer, 3, RASTER_LAYERS, 0, 0);
+            vkCmdEndRendering(command_buffer);
+            uniforms.end_frame();
+        }
+
+    private:
+        pyro::PyroDescriptors *descriptors;
+        pyro::PyroUniformRing uniforms;
+        pyro::Pyropipeline raster_pipeline;
+        std::unique_ptr<pyro::VulkanImage> target;
+        std::unique_ptr<pyro::VulkanBuffer> values;
+        pyro::PyroDescriptorBindings compute_bindings;
+        std::unique_ptr<pyro::PyroComputePipeline> compute_pipeline;
+    };
+
+    class GraphicsSubmitter {
+    public:
+        explicit GraphicsSubmitter(pyro::VulkanDevice *device) :
+            device(device), command_buffer(*device->get_command_buffer(0)), done(device) {}
+
+        VkCommandBuffer begin() const {
+            vkResetCommandBuffer(command_buffer, 0);
+            VkCommandBufferBeginInfo begin_info{};
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            ASSERT_EQUAL(vkBeginCommandBuffer(command_buffer, &begin_info), VK_SUCCESS,
+                         "Failed to begin recording command buffer")
+            return command_buffer;
+        }
+
+        uint64_t submit(pyro::QueueSubmission sync = {}) {
+            ASSERT_EQUAL(vkEndCommandBuffer(command_buffer), VK_SUCCESS, "Failed to record command buffer")
+            sync.signal(done.get_semaphore(), ++value);
+            ASSERT_EQUAL(sync.submit(device->get_graphics_queue(), &command_buffer, 1), VK_SUCCESS,
+                         "Failed to submit command buffer")
+            return value;
+        }
+
+        void wait() const { done.wait(value); }
+
+    private:
+        pyro::VulkanDevice *device;
+        VkCommandBuffer command_buffer;
+        pyro::VulkanTimelineSemaphore done;
+        uint64_t value = 0;
+    };
+
+    double time_frames(Workloads &workloads, const std::function<void()> &frame) {
+        std::vector<double> samples;
+        for (uint32_t i = 0; i < WARMUP_ITERATIONS + ITERATIONS; i++) {
+            workloads.begin_frame();
+            const auto start = std::chrono::steady_clock::now();
+            frame();
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            if (i >= WARMUP_ITERATIONS) {
+                samples.push_back(elapsed.count());
+            }
+        }
+        return median(samples);
+    }
+} // namespace
+
+int main() {
+    pyro::PyroWindow window(64, 64, "PyroCore async compute bench", pyro::WINDOW_HIDDEN | pyro::WINDOW_NOT_RESIZABLE);
+    pyro::VulkanInstance instance;
+    pyro::VulkanDevice device(&instance, &window);
+    pyro::PyroDescriptors descriptors(&device);
+    pyro::PyroAsyncCompute async_compute(&device);
+    Workloads workloads(&device, &descriptors);
+    GraphicsSubmitter graphics(&device);
+
+    const double raster_ms = time_frames(workloads, [&] {
+        workloads.record_raster(graphics.begin());
+        graphics.submit();
+        graphics.wait();
+    });
+    const double compute_ms = time_frames(workloads, [&] {
+        workloads.record_compute(graphics.begin());
+        graphics.submit();
+        graphics.wait();
+    });
+    const double serial_ms = time_frames(workloads, [&] {
+        const VkCommandBuffer command_buffer = graphics.begin();
+        workloads.record_compute(command_buffer);
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+        workloads.record_raster(command_buffer);
+        graphics.submit();
+        graphics.wait();
+    });
+    const double async_ms = time_frames(workloads, [&] {
+        workloads.record_compute(async_compute.begin_frame(0));
+        const uint64_t compute_value = async_compute.submit();
+        workloads.record_raster(graphics.begin());
+        graphics.submit();
+        graphics.wait();
+        async_compute.get_timeline().wait(compute_value);
+    });
+
+    std::cout << std::format("compute queue: {}\n", async_compute.is_async() ? "dedicated" : "shared with graphics");
+    std::cout << std::format("{:<24} {:>10.3f} ms\n", "raster only", raster_ms);
+    std::cout << std::format("{:<24} {:>10.3f} ms\n", "compute only", compute_ms);
+    std::cout << std::format("{:<24} {:>10.3f} ms\n", "serial (one queue)", serial_ms);
+    std::cout << std::format("{:<24} {:>10.3f} ms  ({:.2f}x)\n", "overlapped (async)", async_ms,
+                             async_ms > 0.0 ? serial_ms / async_ms : 0.0);
+    vkDeviceWaitIdle(device.get_logical_device());
+    return 0;
+}
@@ -0,0 +1,362 @@
+//
+// Created by srijan on 3/11/25.
+//
+
+// Builds meshlets for a wall and a sphere, writes them to a .pmesh, and renders a GRID_SIZE x GRID_SIZE field of
+// spheres standing behind the wall through PyroClusterRenderer for FRAME_COUNT frames at 1080p. The camera sways
+// sideways and rises and sinks around the top of the wall, so rows of the field keep appearing over its edge and
+// disappearing again. Reports GPU frame time, meshlets culled per test and the triangles that still reached the
+// vertex stage against the scene's total, with single-phase culling (frustum and normal cone) and with two-phase
+// Hi-Z occlusion culling, on the compute path and, where supported, the mesh shader path. Run from the build
+// directory so assets/shaders/*.spv resolve.
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/core/VulkanDevice.hpp"
+#include "../src/core/VulkanImage.hpp"
+#include "../src/core/VulkanInstance.hpp"
+#include "../src/descriptor/PyroDescriptors.hpp"
+#include "../src/mesh/PyroClusterRenderer.hpp"
+#include "../src/mesh/PyroMeshBuffers.hpp"
+#include "../src/mesh/PyroMeshFile.hpp"
+#include "../src/profiler/PyroGpuTimer.hpp"
+#include "../src/window/PyroWindow.hpp"
+#include "../tools/meshc/MeshCluster.hpp"
+#include "../tools/meshc/MeshImport.hpp"
+#include "../tools/meshc/MeshOptimize.hpp"
+#include "../tools/meshc/MeshWriter.hpp"
+
+namespace {
+    constexpr uint32_t GRID_SIZE = 40;
+    constexpr float GRID_SPACING = 3.0f;
+    constexpr float WALL_HEIGHT = 12.0f;
+    constexpr uint32_t WARMUP_FRAMES = 10;
+    constexpr uint32_t FRAME_COUNT = 300;
+    constexpr VkExtent2D TARGET_EXTENT = {1920, 1080};
+    constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+    constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+    constexpr float FOVY = 1.0471976f; // 60 degrees
+    constexpr float PI = 3.14159265f;
+
+    constexpr uint32_t WALL_MESH = 0;
+    constexpr uint32_t SPHERE_MESH = 1;
+
+    double median(std::vector<double> samples) {
+        std::ranges::sort(samples);
+        return samples[samples.size() / 2];
+    }
+
+    void image_barrier(const VkCommandBuffer command_buffer, const VkImage image, const VkImageAspectFlags aspect,
+                       const VkImageLayout old_layout, const VkImageLayout new_layout,
+                       const VkPipelineStageFlags src_stage, const VkAccessFlags src_access,
+                       const VkPipelineStageFlags dst_stage, const VkAccessFlags dst_access) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = src_access;
+        barrier.dstAccessMask = dst_access;
+        barrier.oldLayout = old_layout;
+        barrier.newLayout = new_layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {aspect, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    void set_vertex(pyro::MeshVertex &vertex, const glm::vec3 position, const glm::vec3 normal, const glm::vec2 uv) {
+        std::copy_n(glm::value_ptr(position), 3, vertex.position);
+        std::copy_n(glm::value_ptr(normal), 3, vertex.normal);
+        std::copy_n(glm::value_ptr(uv), 2, vertex.uv);
+    }
+
+    void add_lattice_indices(pyro::ImportedMesh &mesh, const uint32_t columns, const uint32_t rows) {
+        for (uint32_t y = 0; y < rows; y++) {
+            for (uint32_t x = 0; x < columns; x++) {
+                const uint32_t i = y * (columns + 1) + x;
+                const uint32_t below = i + columns + 1;
+                mesh.indices.insert(mesh.indices.end(), {i, i + 1, below, i + 1, below + 1, below});
+            }
+        }
+    }
+
+    // A unit square in the XY plane, x in [-0.5, 0.5] and y in [0, 1], facing +Z. Finely tessellated so it
+    // splits into many meshlets like any other occluder would.
+    pyro::ImportedMesh create_wall(const uint32_t columns, const uint32_t rows) {
+        pyro::ImportedMesh mesh;
+        mesh.name = "wall";
+        for (uint32_t y = 0; y <= rows; y++) {
+            for (uint32_t x = 0; x <= columns; x++) {
+                const glm::vec2 uv(static_cast<float>(x) / static_cast<float>(columns),
+                                   static_cast<float>(y) / static_cast<float>(rows));
+                set_vertex(mesh.vertices.emplace_back(), glm::vec3(uv.x - 0.5f, uv.y, 0.0f),
+                           glm::vec3(0.0f, 0.0f, 1.0f), uv);
+            }
+        }
+        add_lattice_indices(mesh, columns, rows);
+        return mesh;
+    }
+
+    pyro::ImportedMesh create_sphere(const uint32_t segments, const uint32_t rings) {
+        pyro::ImportedMesh mesh;
+        mesh.name = "sphere";
+        for (uint32_t y = 0; y <= rings; y++) {
+            for (uint32_t x = 0; x <= segments; x++) {
+                const float u = static_cast<float>(x) / static_cast<float>(segments);
+                const float v = static_cast<float>(y) / static_cast<float>(rings);
+                const glm::vec3 normal(std::sin(v * PI) * std::cos(u * 2.0f * PI), std::cos(v * PI),
+                                       std::sin(v * PI) * std::sin(u * 2.0f * PI));
+                set_vertex(mesh.vertices.emplace_back(), normal, normal, {u, v});
+            }
+        }
+        add_lattice_indices(mesh, segments, rings);
+        return mesh;
+    }
+
+    // The wall first, as the early phase draws in instance order; then the field, starting a few units behind
+    // the wall and running away from the camera.
+    std::vector<pyro::MeshInstance> create_instances() {
+        const float extent = static_cast<float>(GRID_SIZE - 1) * GRID_SPACING;
+        std::vector<pyro::MeshInstance> instances;
+        const glm::mat4 wall = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -10.0f));
+        instances.push_back({WALL_MESH, glm::scale(wall, glm::vec3(extent + 20.0f, WALL_HEIGHT, 1.0f))});
+        for (uint32_t z = 0; z < GRID_SIZE; z++) {
+            for (uint32_t x = 0; x < GRID_SIZE; x++) {
+                const glm::vec3 position(static_cast<float>(x) * GRID_SPACING - extent * 0.5f, 1.0f,
+                                         -15.0f - static_cast<float>(z) * GRID_SPACING);
+                instances.push_back({SPHERE_MESH, glm::translate(glm::mat4(1.0f), position)});
+            }
+        }
+        return instances;
+    }
+
+    glm::mat4 camera_view(const uint32_t frame, glm::vec3 &eye) {
+        const float t = static_cast<float>(frame) / static_cast<float>(FRAME_COUNT) * 2.0f * PI;
+        eye = glm::vec3(20.0f * std::sin(t), WALL_HEIGHT + 5.0f * std::sin(3.0f * t), 20.0f);
+        return glm::lookAt(eye, glm::vec3(eye.x * 0.5f, 2.0f, -60.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    struct RunResult {
+        double gpu_ms;
+        double tested;
+        double frustum_culled;
+        double backface_culled;
+        double occlusion_culled;
+        double early_drawn;
+        double late_drawn;
+        double triangles;
+    };
+
+    class SceneRenderer {
+    public:
+        SceneRenderer(pyro::VulkanDevice *device, pyro::PyroDescriptors *descriptors,
+                      const pyro::PyroMeshBuffers *buffers) :
+            device(device), descriptors(descriptors), buffers(buffers), timer(device, 1) {
+            pyro::ImageDesc color_desc{};
+            color_desc.extent = TARGET_EXTENT;
+            color_desc.format = COLOR_FORMAT;
+            color_desc.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            color = std::make_unique<pyro::VulkanImage>(device, color_desc);
+            // Sampled as well: the late phase builds its depth pyramid from the early phase's depth.
+            pyro::ImageDesc depth_desc{};
+            depth_desc.extent = TARGET_EXTENT;
+            depth_desc.format = DEPTH_FORMAT;
+            depth_desc.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            depth_desc.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+            depth = std::make_unique<pyro::VulkanImage>(device, depth_desc);
+
+            projection = glm::perspectiveRH_ZO(
+                    FOVY, static_cast<float>(TARGET_EXTENT.width) / static_cast<float>(TARGET_EXTENT.height), 0.1f,
+                    250.0f);
+            projection[1][1] *= -1.0f;
+        }
+
+        RunResult run(const std::vector<pyro::MeshInstance> &instances, pyro::ClusterRendererConfig config) {
+            config.formats = {{COLOR_FORMAT}, DEPTH_FORMAT};
+            pyro::PyroClusterRenderer renderer(device, descriptors, buffers, config);
+            std::vector<double> gpu_samples;
+            RunResult result{};
+            for (uint32_t frame = 0; frame < WARMUP_FRAMES + FRAME_COUNT; frame++) {
+                // Every frame is waited for, so each slot's counters are already complete; they describe the
+                // frame recorded MAX_FRAMES_IN_FLIGHT frames earlier.
+                const uint32_t frame_index = frame % pyro::MAX_FRAMES_IN_FLIGHT;
+                descriptors->begin_frame(frame_index);
+                renderer.begin_frame(frame_index);
+                if (frame >= WARMUP_FRAMES) {
+                    const pyro::ClusterCullStats &stats = renderer.get_stats();
+                    result.tested += static_cast<double>(stats.tested) / FRAME_COUNT;
+                    result.frustum_culled += static_cast<double>(stats.frustum_culled) / FRAME_COUNT;
+                    result.backface_culled += static_cast<double>(stats.backface_culled) / FRAME_COUNT;
+                    result.occlusion_culled += static_cast<double>(stats.occlusion_culled) / FRAME_COUNT;
+                    result.early_drawn += static_cast<double>(stats.early_drawn) / FRAME_COUNT;
+                    result.late_drawn += static_cast<double>(stats.late_drawn) / FRAME_COUNT;
+                    result.triangles += static_cast<double>(stats.triangles) / FRAME_COUNT;
+                }
+
+                glm::vec3 eye;
+                const glm::mat4 view_proj = projection * camera_view(frame % FRAME_COUNT, eye);
+                const double gpu_ms = draw(renderer, instances, {view_proj, eye});
+                if (frame >= WARMUP_FRAMES) {
+                    gpu_samples.push_back(gpu_ms);
+                }
+            }
+            result.gpu_ms = median(gpu_samples);
+            return result;
+        }
+
+    private:
+        pyro::VulkanDevice *device;
+        pyro::PyroDescriptors *descriptors;
+        const pyro::PyroMeshBuffers *buffers;
+        pyro::PyroGpuTimer timer;
+        std::unique_ptr<pyro::VulkanImage> color;
+        std::unique_ptr<pyro::VulkanImage> depth;
+        glm::mat4 projection{};
+
+        void begin_rendering(const VkCommandBuffer command_buffer, const VkAttachmentLoadOp load_op) const {
+            VkRenderingAttachmentInfo color_attachment{};
+            color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            color_attachment.imageView = color->get_view();
+            color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            color_attachment.loadOp = load_op;
+            color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            VkRenderingAttachmentInfo depth_attachment{};
+            depth_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            depth_attachment.imageView = depth->get_view();
+            depth_attachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+            depth_attachment.loadOp = load_op;
+            depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            depth_attachment.clearValue.depthStencil = {1.0f, 0};
+            VkRenderingInfo rendering_info{};
+            rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+            rendering_info.renderArea = {{0, 0}, TARGET_EXTENT};
+            rendering_info.layerCount = 1;
+            rendering_info.colorAttachmentCount = 1;
+            rendering_info.pColorAttachments = &color_attachment;
+            rendering_info.pDepthAttachment = &depth_attachment;
+            vkCmdBeginRendering(command_buffer, &rendering_info);
+            const VkViewport viewport{0.0f, 0.0f, static_cast<float>(TARGET_EXTENT.width),
+                                      static_cast<float>(TARGET_EXTENT.height), 0.0f, 1.0f};
+            vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+            const VkRect2D scissor{{0, 0}, TARGET_EXTENT};
+            vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+        }
+
+        // One frame as laid out in PyroClusterRenderer's class comment.
+        double draw(pyro::PyroClusterRenderer &renderer, const std::vector<pyro::MeshInstance> &instances,
+                    const pyro::ClusterCullView &view) {
+            const VkCommandBuffer command_buffer = device->begin_single_time_commands();
+            timer.reset(command_buffer);
+            image_barrier(command_buffer, color->get_image(), VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                          VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+            image_barrier(command_buffer, depth->get_image(), VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+                          VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                          VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+
+            const uint32_t scope = timer.begin(command_buffer);
+            renderer.record_cull(command_buffer, instances, view);
+            begin_rendering(command_buffer, VK_ATTACHMENT_LOAD_OP_CLEAR);
+            renderer.record_draw(command_buffer);
+            vkCmdEndRendering(command_buffer);
+            if (renderer.is_two_phase()) {
+                constexpr VkPipelineStageFlags depth_stages =
+                        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                image_barrier(command_buffer, depth->get_image(), VK_IMAGE_ASPECT_DEPTH_BIT,
+                              VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                              depth_stages, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+                renderer.record_late_cull(command_buffer, depth->get_view(), TARGET_EXTENT);
+                image_barrier(command_buffer, depth->get_image(), VK_IMAGE_ASPECT_DEPTH_BIT,
+                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, depth_stages,
+                              VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                      VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+                begin_rendering(command_buffer, VK_ATTACHMENT_LOAD_OP_LOAD);
+                renderer.record_draw(command_buffer);
+                vkCmdEndRendering(command_buffer);
+            }
+            timer.end(command_buffer, scope);
+            device->end_single_time_commands(command_buffer);
+            return timer.resolve(scope).value_or(0.0);
+        }
+    };
+} // namespace
+
+int main() {
+    std::vector<pyro::ImportedMesh> meshes;
+    meshes.push_back(create_wall(128, 32));
+    meshes.push_back(create_sphere(32, 16));
+    for (pyro::ImportedMesh &mesh : meshes) {
+        pyro::optimize_mesh(mesh);
+        pyro::build_meshlets(mesh);
+        std::cout << std::format("{}: {} triangles, {} meshlets\n", mesh.name, mesh.indices.size() / 3,
+                                 mesh.meshlets.size());
+    }
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "pyro_cluster_bench.pmesh";
+    if (!pyro::write_mesh_file(path.string(), meshes)) {
+        return 1;
+    }
+    pyro::PyroMeshFile file;
+    if (!file.open(path.string())) {
+        return 1;
+    }
+
+    pyro::PyroWindow window(64, 64, "PyroCore cluster cull bench", pyro::WINDOW_HIDDEN | pyro::WINDOW_NOT_RESIZABLE);
+    pyro::VulkanInstance instance;
+    pyro::VulkanDevice device(&instance, &window);
+    pyro::PyroDescriptors descriptors(&device);
+    const pyro::PyroMeshBuffers buffers(&device, file);
+    SceneRenderer renderer(&device, &descriptors, &buffers);
+    const std::vector<pyro::MeshInstance> instances = create_instances();
+    uint32_t scene_indices = 0;
+    for (const pyro::MeshInstance &mesh_instance : instances) {
+        scene_indices += static_cast<uint32_t>(meshes[mesh_instance.mesh].indices.size());
+    }
+    const double scene_triangles = scene_indices / 3.0;
+
+    struct Run {
+        std::string name;
+        pyro::ClusterRendererConfig config;
+    };
+    std::vector<Run> runs;
+    for (const bool mesh_shaders : {false, true}) {
+        if (mesh_shaders && !device.get_capabilities().mesh_shader) {
+            continue;
+        }
+        const char *path_name = mesh_shaders ? "mesh" : "compute";
+        pyro::ClusterRendererConfig config{};
+        // The compute path reserves index room for every triangle of every instance.
+        config.max_indices = std::max(config.max_indices, scene_indices);
+        config.use_mesh_shaders = mesh_shaders;
+        config.occlusion_culling = false;
+        runs.push_back({std::format("{}, single phase", path_name), config});
+        config.occlusion_culling = true;
+        runs.push_back({std::format("{}, two-phase Hi-Z", path_name), config});
+    }
+    std::cout << std::format("\n{} instances, {:.2f}M triangles, {} frames at {}x{}\n", instances.size(),
+                             scene_triangles / 1e6, FRAME_COUNT, TARGET_EXTENT.width, TARGET_EXTENT.height);
+    std::cout << std::format("{:<26} {:>8} {:>9} {:>9} {:>9} {:>9} {:>8} {:>8} {:>11} {:>8}\n", "mode", "GPU ms",
+                             "meshlets", "frustum", "cone", "occluded", "early", "late", "Mtri/frame", "culled");
+    for (const Run &run : runs) {
+        const RunResult result = renderer.run(instances, run.config);
+        const double culled_percent = 100.0 * (1.0 - result.triangles / scene_triangles);
+        std::cout << std::format("{:<26} {:>8.3f} {:>9.0f} {:>9.0f} {:>9.0f} {:>9.0f} {:>8.0f} {:>8.0f} {:>11.3f}"
+                                 " {:>7.1f}%\n",
+                                 run.name, result.gpu_ms, result.tested, result.frustum_culled,
+                                 result.backface_culled, result.occlusion_culled, result.early_drawn,
+                                 result.late_drawn, result.triangles / 1e6, culled_percent);
+    }
+    vkDeviceWaitIdle(device.get_logical_device());
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,559 @@
+//
+// Created by srijan on 3/3/25.
+//
+
+// pyro_bench: drives fixed, seeded scenes for a set number of frames into an offscreen target and writes CPU,
+// GPU and wall frame-time percentiles, heap allocations and draw counts per scene as JSON. With --baseline it
+// compares the run against an earlier run's JSON and exits non-zero when any metric grew by more than the
+// threshold, so CI can keep a baseline per machine.
+//
+// Defaults to SDL's offscreen video driver (VK_EXT_headless_surface), so it runs without a display; the
+// SDL_VIDEO_DRIVER environment variable still wins. To run on lavapipe, point the loader at its ICD:
+//
+//     VK_DRIVER_FILES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json ./pyro_bench --out run.json
+//     ./pyro_bench --baseline run.json --threshold 0.1
+//
+// Run from the build directory so assets/shaders/*.spv resolve.
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/core/VulkanBuffer.hpp"
+#include "../src/core/VulkanDevice.hpp"
+#include "../src/core/VulkanImage.hpp"
+#include "../src/core/VulkanInstance.hpp"
+#include "../src/descriptor/PyroDescriptors.hpp"
+#include "../src/profiler/PyroGpuTimer.hpp"
+#include "../src/renderer/PyroRender.hpp"
+#include "../src/renderer/PyroUniformRing.hpp"
+#include "../src/renderer/Pyropipeline.hpp"
+#include "../src/window/PyroWindow.hpp"
+#include "../tools/meshc/Json.hpp"
+
+namespace {
+    std::atomic<uint64_t> allocation_count{0};
+} // namespace
+
+// Every heap allocation in the process is counted, so a scene's count covers the engine code it calls.
+void *operator new(const size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+void *operator new[](const size_t size) { return operator new(size); }
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { std::free(pointer); }
+
+namespace {
+    constexpr VkExtent2D TARGET_EXTENT = {640, 360};
+    constexpr uint32_t TRIANGLE_SPAM_INSTANCES = 1 << 16;
+    constexpr uint32_t MANY_DRAWS_COUNT = 10000;
+    constexpr VkDeviceSize UPLOAD_BYTES_PER_FRAME = 16 * 1024 * 1024;
+    constexpr uint32_t CHURN_DRAWS = 2000;
+
+    struct Options {
+        uint32_t frames = 300;
+        uint32_t warmup = 30;
+        uint32_t seed = 1;
+        std::string scene;
+        std::string out;
+        std::string baseline;
+        double threshold = 0.10;
+    };
+
+    struct Percentiles {
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    struct SceneResult {
+        std::string name;
+        Percentiles cpu_ms;
+        Percentiles gpu_ms;
+        Percentiles frame_ms;
+        double allocations_per_frame = 0.0;
+        double draws_per_frame = 0.0;
+    };
+
+    // Nearest-rank percentiles.
+    Percentiles percentiles(std::vector<double> samples) {
+        if (samples.empty()) {
+            return {};
+        }
+        std::ranges::sort(samples);
+        const auto rank = [&](const double p) {
+            const size_t index = static_cast<size_t>(p * static_cast<double>(samples.size()));
+            return samples[std::min(index, samples.size() - 1)];
+        };
+        return {rank(0.50), rank(0.95), rank(0.99), samples.back()};
+    }
+
+    double elapsed_ms(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Shared by every scene: the engine objects a frame touches and the offscreen target drawn into.
+    struct BenchContext {
+        pyro::VulkanDevice *device;
+        pyro::PyroDescriptors *descriptors;
+        pyro::PyroUniformRing *uniforms;
+        pyro::Pyropipeline *pipeline;
+        const pyro::VulkanImage *target;
+        std::mt19937 *rng;
+    };
+
+    // One frame of a scene: optional work recorded before the rendering scope over the target, then the draws
+    // inside it, which return how many they issued.
+    struct SceneFrame {
+        std::function<void(VkCommandBuffer command_buffer, uint32_t frame)> prepare;
+        std::function<uint32_t(VkCommandBuffer command_buffer, uint32_t frame)> draw;
+    };
+
+    struct Scene {
+        std::string name;
+        std::function<SceneFrame(BenchContext &context)> setup;
+    };
+
+    void bind_frame(const BenchContext &context, const VkCommandBuffer command_buffer,
+                    const pyro::Pyropipeline &pipeline, const uint32_t frame) {
+        pyro::FrameUniforms uniforms{};
+        uniforms.view_proj = glm::mat4(1.0f);
+        uniforms.time = glm::vec4(static_cast<float>(frame), 0.0f, 0.0f, 0.0f);
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.get_pipeline());
+        context.uniforms->bind(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.get_pipeline_layout(), 0,
+                               context.uniforms->push(uniforms));
+    }
+
+    pyro::DrawPushConstants random_draw(std::mt19937 &rng, const float scale) {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> shade(0.2f, 1.0f);
+        pyro::DrawPushConstants draw{};
+        draw.model = glm::mat4(scale);
+        draw.model[3] = glm::vec4(unit(rng), unit(rng), 0.0f, 1.0f);
+        draw.tint = glm::vec4(shade(rng), shade(rng), shade(rng), 1.0f);
+        return draw;
+    }
+
+    // Fill-rate bound: one instanced draw of small overlapping triangles.
+    SceneFrame setup_triangle_spam(BenchContext &context) {
+        const pyro::DrawPushConstants draw = random_draw(*context.rng, 0.1f);
+        const auto draw_frame = [&context, draw](const VkCommandBuffer command_buffer, const uint32_t frame) {
+            bind_frame(context, command_buffer, *context.pipeline, frame);
+            pyro::PyroUniformRing::push_draw_data(command_buffer, context.pipeline->get_pipeline_layout(),
+                                                  VK_SHADER_STAGE_VERTEX_BIT, &draw, sizeof(draw));
+            vkCmdDraw(command_buffer, 3, TRIANGLE_SPAM_INSTANCES, 0, 0);
+            return 1u;
+        };
+        return {nullptr, draw_frame};
+    }
+
+    // Recording bound: thousands of tiny draws, each with its own push constants.
+    SceneFrame setup_many_draws(BenchContext &context) {
+        std::vector<pyro::DrawPushConstants> draws;
+        for (uint32_t i = 0; i < MANY_DRAWS_COUNT; i++) {
+            draws.push_back(random_draw(*context.rng, 0.02f));
+        }
+        const auto draw_frame = [&context, draws = std::move(draws)](const VkCommandBuffer command_buffer,
+                                                                      const uint32_t frame) {
+            bind_frame(context, command_buffer, *context.pipeline, frame);
+            for (const pyro::DrawPushConstants &draw : draws) {
+                pyro::PyroUniformRing::push_draw_data(command_buffer, context.pipeline->get_pipeline_layout(),
+                                                      VK_SHADER_STAGE_VERTEX_BIT, &draw, sizeof(draw));
+                vkCmdDraw(command_buffer, 3, 1, 0, 0);
+            }
+            return static_cast<uint32_t>(draws.size());
+        };
+        return {nullptr, draw_frame};
+    }
+
+    // Transfer bound: UPLOAD_BYTES_PER_FRAME of seeded data written to a staging buffer and copied to device
+    // memory every frame, outside the rendering scope, plus a single draw.
+    SceneFrame setup_heavy_uploads(BenchContext &context) {
+        struct Uploads {
+            std::unique_ptr<pyro::VulkanBuffer> staging;
+            std::unique_ptr<pyro::VulkanBuffer> destination;
+            std::vector<uint32_t> source;
+        };
+        auto uploads = std::make_shared<Uploads>();
+        uploads->staging = std::make_unique<pyro::VulkanBuffer>(
+                context.device, UPLOAD_BYTES_PER_FRAME, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        uploads->destination = std::make_unique<pyro::VulkanBuffer>(
+                context.device, UPLOAD_BYTES_PER_FRAME, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        // Twice the upload so every frame copies a different window of it.
+        uploads->source.resize(2 * UPLOAD_BYTES_PER_FRAME / sizeof(uint32_t));
+        std::ranges::generate(uploads->source, [&] { return static_cast<uint32_t>((*context.rng)()); });
+        const pyro::DrawPushConstants draw = random_draw(*context.rng, 0.5f);
+        const auto prepare = [uploads](const VkCommandBuffer command_buffer, const uint32_t frame) {
+            const size_t words = UPLOAD_BYTES_PER_FRAME / sizeof(uint32_t);
+            uploads->staging->write(uploads->source.data() + frame * 4099 % words, UPLOAD_BYTES_PER_FRAME, 0);
+            uploads->staging->flush();
+            const VkBufferCopy copy{0, 0, UPLOAD_BYTES_PER_FRAME};
+            vkCmdCopyBuffer(command_buffer, uploads->staging->get_buffer(), uploads->destination->get_buffer(), 1,
+                            &copy);
+        };
+        const auto draw_frame = [&context, draw](const VkCommandBuffer command_buffer, const uint32_t frame) {
+            bind_frame(context, command_buffer, *context.pipeline, frame);
+            pyro::PyroUniformRing::push_draw_data(command_buffer, context.pipeline->get_pipeline_layout(),
+                                                  VK_SHADER_STAGE_VERTEX_BIT, &draw, sizeof(draw));
+            vkCmdDraw(command_buffer, 3, 1, 0, 0);
+            return 1u;
+        };
+        return {prepare, draw_frame};
+    }
+
+    // State-change bound: draws alternating between pipelines that differ in blend and cull state.
+    SceneFrame setup_pipeline_churn(BenchContext &context) {
+        auto pipelines = std::make_shared<std::vector<std::unique_ptr<pyro::Pyropipeline>>>();
+        for (const pyro::PipelineBlendMode blend :
+             {pyro::PipelineBlendMode::OPAQUE, pyro::PipelineBlendMode::ALPHA,
+              pyro::PipelineBlendMode::PREMULTIPLIED_ALPHA, pyro::PipelineBlendMode::ADDITIVE}) {
+            for (const VkCullModeFlags cull : {VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT}) {
+                pyro::GraphicsPipelineDesc desc{};
+                desc.blend_mode = blend;
+                desc.cull_mode = cull;
+                desc.formats.color_formats = {context.target->get_desc().format};
+                pipelines->push_back(std::make_unique<pyro::Pyropipeline>(
+                        context.device, std::vector{context.uniforms->get_layout()},
+                        std::vector{pyro::PyroUniformRing::push_constant_range(VK_SHADER_STAGE_VERTEX_BIT,
+                                                                               sizeof(pyro::DrawPushConstants))},
+                        desc));
+            }
+        }
+        std::vector<pyro::DrawPushConstants> draws;
+        for (uint32_t i = 0; i < CHURN_DRAWS; i++) {
+            draws.push_back(random_draw(*context.rng, 0.05f));
+        }
+        const auto draw_frame = [&context, pipelines, draws = std::move(draws)](const VkCommandBuffer command_buffer,
+                                                                                 const uint32_t frame) {
+            for (uint32_t i = 0; i < draws.size(); i++) {
+                const pyro::Pyropipeline &pipeline = *(*pipelines)[i % pipelines->size()];
+                bind_frame(context, command_buffer, pipeline, frame);
+                pyro::PyroUniformRing::push_draw_data(command_buffer, pipeline.get_pipeline_layout(),
+                                                      VK_SHADER_STAGE_VERTEX_BIT, &draws[i], sizeof(draws[i]));
+                vkCmdDraw(command_buffer, 3, 1, 0, 0);
+            }
+            return static_cast<uint32_t>(draws.size());
+        };
+        return {nullptr, draw_frame};
+    }
+
+    void transition_target(const VkCommandBuffer command_buffer, const VkImage image) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    void begin_target(const VkCommandBuffer command_buffer, const pyro::VulkanImage &target) {
+        VkRenderingAttachmentInfo color{};
+        color.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        color.imageView = target.get_view();
+        color.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        VkRenderingInfo rendering_info{};
+        rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        rendering_info.renderArea = {{0, 0}, TARGET_EXTENT};
+        rendering_info.layerCount = 1;
+        rendering_info.colorAttachmentCount = 1;
+        rendering_info.pColorAttachments = &color;
+        vkCmdBeginRendering(command_buffer, &rendering_info);
+        const VkViewport viewport{0.0f, 0.0f, static_cast<float>(TARGET_EXTENT.width),
+                                  static_cast<float>(TARGET_EXTENT.height), 0.0f, 1.0f};
+        vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+        const VkRect2D scissor{{0, 0}, TARGET_EXTENT};
+        vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+    }
+
+    // CPU time covers recording; wall time adds the submit and the wait for the GPU.
+    SceneResult run_scene(BenchContext &context, const Scene &scene, const Options &options) {
+        std::mt19937 rng(options.seed);
+        context.rng = &rng;
+        const SceneFrame frame_work = scene.setup(context);
+        pyro::PyroGpuTimer timer(context.device, 1);
+
+        std::vector<double> cpu_samples;
+        std::vector<double> gpu_samples;
+        std::vector<double> frame_samples;
+        uint64_t allocations = 0;
+        uint64_t draws = 0;
+        for (uint32_t frame = 0; frame < options.warmup + options.frames; frame++) {
+            const uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+            const auto start = std::chrono::steady_clock::now();
+            // Each frame is waited on before the next, so slot 0 is always free.
+            context.descriptors->begin_frame(0);
+            context.uniforms->begin_frame(0);
+            const VkCommandBuffer command_buffer = context.device->begin_single_time_commands();
+            timer.reset(command_buffer);
+            const uint32_t scope = timer.begin(command_buffer);
+            transition_target(command_buffer, context.target->get_image());
+            if (frame_work.prepare) {
+                frame_work.prepare(command_buffer, frame);
+            }
+            begin_target(command_buffer, *context.target);
+            const uint32_t frame_draws = frame_work.draw(command_buffer, frame);
+            vkCmdEndRendering(command_buffer);
+            timer.end(command_buffer, scope);
+            context.uniforms->end_frame();
+            const double cpu_ms = elapsed_ms(start);
+            context.device->end_single_time_commands(command_buffer);
+            const double frame_ms = elapsed_ms(start);
+            const uint64_t frame_allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+            const double gpu_ms = timer.resolve(scope).value_or(0.0);
+            if (frame >= options.warmup) {
+                cpu_samples.push_back(cpu_ms);
+                gpu_samples.push_back(gpu_ms);
+                frame_samples.push_back(frame_ms);
+                allocations += frame_allocations;
+                draws += frame_draws;
+            }
+        }
+        vkDeviceWaitIdle(context.device->get_logical_device());
+
+        SceneResult result;
+        result.name = scene.name;
+        result.cpu_ms = percentiles(std::move(cpu_samples));
+        result.gpu_ms = percentiles(std::move(gpu_samples));
+        result.frame_ms = percentiles(std::move(frame_samples));
+        result.allocations_per_frame = static_cast<double>(allocations) / std::max(options.frames, 1u);
+        result.draws_per_frame = static_cast<double>(draws) / std::max(options.frames, 1u);
+        return result;
+    }
+
+    std::string percentiles_json(const Percentiles &p) {
+        return std::format(R"({{"p50": {:.4f}, "p95": {:.4f}, "p99": {:.4f}, "max": {:.4f}}})", p.p50, p.p95, p.p99,
+                           p.max);
+    }
+
+    std::string to_json(const std::string &device_name, const Options &options,
+                        const std::vector<SceneResult> &results) {
+        std::string json = std::format("{{\n  \"device\": \"{}\",\n  \"frames\": {},\n  \"seed\": {},\n"
+                                       "  \"scenes\": [",
+                                       device_name, options.frames, options.seed);
+        for (size_t i = 0; i < results.size(); i++) {
+            const SceneResult &result = results[i];
+            json += std::format("{}\n    {{\"name\": \"{}\",\n     \"cpu_ms\": {},\n     \"gpu_ms\": {},\n"
+                                "     \"frame_ms\": {},\n     \"allocations_per_frame\": {:.2f},\n"
+                                "     \"draws_per_frame\": {:.2f}}}",
+                                i == 0 ? "" : ",", result.name, percentiles_json(result.cpu_ms),
+                                percentiles_json(result.gpu_ms), percentiles_json(result.frame_ms),
+                                result.allocations_per_frame, result.draws_per_frame);
+        }
+        json += "\n  ]\n}\n";
+        return json;
+    }
+
+    // Metrics compared against the baseline; all of them are worse when larger.
+    struct Metric {
+        const char *path;
+        std::function<double(const SceneResult &)> value;
+        // Differences below this are noise whatever the ratio, e.g. 0.02 ms on a 0.1 ms scene.
+        double slack;
+    };
+
+    const std::vector<Metric> &compared_metrics() {
+        static const std::vector<Metric> metrics = {
+                {"cpu_ms.p50", [](const SceneResult &r) { return r.cpu_ms.p50; }, 0.05},
+                {"cpu_ms.p95", [](const SceneResult &r) { return r.cpu_ms.p95; }, 0.05},
+                {"gpu_ms.p50", [](const SceneResult &r) { return r.gpu_ms.p50; }, 0.05},
+                {"gpu_ms.p95", [](const SceneResult &r) { return r.gpu_ms.p95; }, 0.05},
+                {"frame_ms.p50", [](const SceneResult &r) { return r.frame_ms.p50; }, 0.05},
+                {"frame_ms.p95", [](const SceneResult &r) { return r.frame_ms.p95; }, 0.05},
+                {"allocations_per_frame", [](const SceneResult &r) { return r.allocations_per_frame; }, 0.5},
+                {"draws_per_frame", [](const SceneResult &r) { return r.draws_per_frame; }, 0.5},
+        };
+        return metrics;
+    }
+
+    const pyro::JsonValue *find_path(const pyro::JsonValue &object, const std::string_view path) {
+        const size_t dot = path.find('.');
+        const pyro::JsonValue *value = object.find(path.substr(0, dot));
+        if (!value || dot == std::string_view::npos) {
+            return value;
+        }
+        return find_path(*value, path.substr(dot + 1));
+    }
+
+    // Returns the number of regressions, printing each one.
+    uint32_t compare_to_baseline(const std::vector<SceneResult> &results, const pyro::JsonValue &baseline,
+                                 const double threshold) {
+        const pyro::JsonValue *scenes = baseline.find("scenes");
+        if (!scenes || !scenes->is_array()) {
+            std::cerr << "baseline has no scenes array\n";
+            return 1;
+        }
+        uint32_t regressions = 0;
+        for (const SceneResult &result : results) {
+            const pyro::JsonValue *baseline_scene = nullptr;
+            for (const pyro::JsonValue &scene : scenes->items) {
+                if (scene.string_or("name", "") == result.name) {
+                    baseline_scene = &scene;
+                }
+            }
+            if (!baseline_scene) {
+                std::cerr << std::format("{}: not in baseline, skipped\n", result.name);
+                continue;
+            }
+            for (const Metric &metric : compared_metrics()) {
+                const pyro::JsonValue *expected = find_path(*baseline_scene, metric.path);
+                if (!expected || !expected->is_number()) {
+                    continue;
+                }
+                const double current = metric.value(result);
+                const double limit = std::max(expected->number * (1.0 + threshold), expected->number + metric.slack);
+                if (current > limit) {
+                    std::cerr << std::format("REGRESSION {} {}: {:.4f} vs baseline {:.4f} (limit {:.4f})\n",
+                                             result.name, metric.path, current, expected->number, limit);
+                    regressions++;
+                }
+            }
+        }
+        return regressions;
+    }
+
+    bool parse_uint(const std::string_view text, uint32_t &value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parse_options(const int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; i++) {
+            const std::string_view arg = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << std::format("missing value for {}\n", arg);
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool valid = true;
+            if (arg == "--frames") {
+                valid = parse_uint(value, options.frames) && options.frames > 0;
+            } else if (arg == "--warmup") {
+                valid = parse_uint(value, options.warmup);
+            } else if (arg == "--seed") {
+                valid = parse_uint(value, options.seed);
+            } else if (arg == "--scene") {
+                options.scene = value;
+            } else if (arg == "--out") {
+                options.out = value;
+            } else if (arg == "--baseline") {
+                options.baseline = value;
+            } else if (arg == "--threshold") {
+                options.threshold = std::atof(std::string(value).c_str());
+                valid = options.threshold >= 0.0;
+            } else {
+                valid = false;
+            }
+            if (!valid) {
+                std::cerr << std::format("bad argument {} {}\n", arg, value);
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: pyro_bench [--frames N] [--warmup N] [--seed N] [--scene NAME] [--out FILE]\n"
+                     "                  [--baseline FILE] [--threshold FRACTION]\n";
+        return 2;
+    }
+    // A hint, so SDL_VIDEO_DRIVER in the environment overrides it.
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+
+    pyro::PyroWindow window(64, 64, "PyroCore frame bench", pyro::WINDOW_HIDDEN | pyro::WINDOW_NOT_RESIZABLE);
+    pyro::VulkanInstance instance;
+    pyro::VulkanDevice device(&instance, &window);
+    pyro::PyroDescriptors descriptors(&device);
+    pyro::PyroUniformRing uniforms(&device, &descriptors);
+
+    pyro::ImageDesc target_desc{};
+    target_desc.extent = TARGET_EXTENT;
+    target_desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+    target_desc.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    const pyro::VulkanImage target(&device, target_desc);
+    pyro::GraphicsPipelineDesc pipeline_desc{};
+    pipeline_desc.formats.color_formats = {target_desc.format};
+    pyro::Pyropipeline pipeline(&device, {uniforms.get_layout()},
+                                {pyro::PyroUniformRing::push_constant_range(VK_SHADER_STAGE_VERTEX_BIT,
+                                                                            sizeof(pyro::DrawPushConstants))},
+                                pipeline_desc);
+
+    const std::vector<Scene> scenes = {
+            {"triangle_spam", setup_triangle_spam},
+            {"many_draws", setup_many_draws},
+            {"heavy_uploads", setup_heavy_uploads},
+            {"pipeline_churn", setup_pipeline_churn},
+    };
+    BenchContext context{&device, &descriptors, &uniforms, &pipeline, &target, nullptr};
+    std::vector<SceneResult> results;
+    for (const Scene &scene : scenes) {
+        if (options.scene.empty() || options.scene == scene.name) {
+            std::cerr << std::format("running {}\n", scene.name);
+            results.push_back(run_scene(context, scene, options));
+        }
+    }
+    if (results.empty()) {
+        std::cerr << std::format("unknown scene {}\n", options.scene);
+        return 2;
+    }
+
+    const std::string json = to_json(device.get_properties().deviceName, options, results);
+    if (options.out.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream(options.out) << json;
+    }
+
+    if (options.baseline.empty()) {
+        return 0;
+    }
+    std::ifstream baseline_file(options.baseline);
+    if (!baseline_file) {
+        std::cerr << std::format("cannot open baseline {}\n", options.baseline);
+        return 2;
+    }
+    std::stringstream baseline_text;
+    baseline_text << baseline_file.rdbuf();
+    std::string error;
+    const std::optional<pyro::JsonValue> baseline = pyro::parse_json(baseline_text.str(), error);
+    if (!baseline) {
+        std::cerr << std::format("bad baseline {}: {}\n", options.baseline, error);
+        return 2;
+    }
+    const uint32_t regressions = compare_to_baseline(results, *baseline, options.threshold);
+    std::cerr << std::format("{} regression(s) against {} at {:.0f}% threshold\n", regressions, options.baseline,
+                             options.threshold * 100.0);
+    return regressions == 0 ? 0 : 1;
+}
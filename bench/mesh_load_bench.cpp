@@ -0,0 +1,270 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+// Generates a synthetic scene of SCENE_MB megabytes (first argument, default 256; pass 1024 for the 1 GB case),
+// writes it both as a text .gltf with an embedded base64 buffer and as a .pmesh, then measures loading each into
+// device-local buffers: glTF is read, parsed, decoded and repacked before upload, the .pmesh is mapped and
+// streamed straight into staging. Cold runs drop the files from the page cache first (Linux only), and a plain
+// read() of the .pmesh gives the I/O bound the mapped path should approach. Run from the build directory.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "../src/core/VulkanDevice.hpp"
+#include "../src/core/VulkanInstance.hpp"
+#include "../src/mesh/PyroMeshBuffers.hpp"
+#include "../src/mesh/PyroMeshFile.hpp"
+#include "../src/window/PyroWindow.hpp"
+#include "../tools/meshc/MeshImport.hpp"
+#include "../tools/meshc/MeshWriter.hpp"
+
+namespace {
+    constexpr uint32_t ITERATIONS = 3;
+    constexpr uint32_t MESH_COUNT = 64;
+    // A grid of n x n vertices has 6 (n - 1)^2 indices; per vertex that is about 32 + 24 bytes.
+    constexpr uint64_t BYTES_PER_VERTEX = sizeof(pyro::MeshVertex) + 6 * sizeof(uint32_t);
+
+    double median(std::vector<double> samples) {
+        std::ranges::sort(samples);
+        return samples[samples.size() / 2];
+    }
+
+    double elapsed_ms(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Evicts the file from the page cache so the next read comes from the device. Elsewhere this is a no-op and
+    // "cold" numbers are warm.
+    bool drop_from_page_cache(const std::filesystem::path &path) {
+#ifdef __linux__
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        fdatasync(fd);
+        const bool dropped = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(fd);
+        return dropped;
+#else
+        return false;
+#endif
+    }
+
+    // Rippled grids, so the data is not trivially compressible by the page cache or the drive.
+    std::vector<pyro::ImportedMesh> create_scene(const uint64_t scene_bytes) {
+        const auto side = static_cast<uint32_t>(std::sqrt(static_cast<double>(scene_bytes / BYTES_PER_VERTEX) /
+                                                          MESH_COUNT));
+        std::vector<pyro::ImportedMesh> meshes(MESH_COUNT);
+        for (uint32_t m = 0; m < MESH_COUNT; m++) {
+            pyro::ImportedMesh &mesh = meshes[m];
+            mesh.name = std::format("grid{}", m);
+            mesh.vertices.reserve(static_cast<size_t>(side) * side);
+            for (uint32_t y = 0; y < side; y++) {
+                for (uint32_t x = 0; x < side; x++) {
+                    const float u = static_cast<float>(x) / static_cast<float>(side - 1);
+                    const float v = static_cast<float>(y) / static_cast<float>(side - 1);
+                    const float height = 0.05f * std::sin(u * 37.0f + static_cast<float>(m)) * std::cos(v * 23.0f);
+                    mesh.vertices.push_back({{u + static_cast<float>(m), height, v}, {0.0f, 1.0f, 0.0f}, {u, v}});
+                }
+            }
+            mesh.indices.reserve(static_cast<size_t>(side - 1) * (side - 1) * 6);
+            for (uint32_t y = 0; y + 1 < side; y++) {
+                for (uint32_t x = 0; x + 1 < side; x++) {
+                    const uint32_t i = y * side + x;
+                    mesh.indices.insert(mesh.indices.end(), {i, i + side, i + 1, i + 1, i + side, i + side + 1});
+                }
+            }
+        }
+        return meshes;
+    }
+
+    std::string encode_base64(const std::vector<std::byte> &bytes) {
+        constexpr std::string_view ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        out.reserve((bytes.size() + 2) / 3 * 4);
+        for (size_t i = 0; i < bytes.size(); i += 3) {
+            const size_t remaining = std::min<size_t>(3, bytes.size() - i);
+            uint32_t triple = std::to_integer<uint32_t>(bytes[i]) << 16;
+            triple |= remaining > 1 ? std::to_integer<uint32_t>(bytes[i + 1]) << 8 : 0;
+            triple |= remaining > 2 ? std::to_integer<uint32_t>(bytes[i + 2]) : 0;
+            out += ALPHABET[triple >> 18 & 0x3f];
+            out += ALPHABET[triple >> 12 & 0x3f];
+            out += remaining > 1 ? ALPHABET[triple >> 6 & 0x3f] : '=';
+            out += remaining > 2 ? ALPHABET[triple & 0x3f] : '=';
+        }
+        return out;
+    }
+
+    // One node per mesh with interleaved vertices, the way most exporters lay out a single-buffer .gltf.
+    bool write_gltf(const std::filesystem::path &path, const std::vector<pyro::ImportedMesh> &meshes) {
+        std::vector<std::byte> buffer;
+        std::string nodes;
+        std::string gltf_meshes;
+        std::string accessors;
+        std::string views;
+        for (size_t m = 0; m < meshes.size(); m++) {
+            const pyro::ImportedMesh &mesh = meshes[m];
+            const size_t vertex_offset = buffer.size();
+            const auto *vertices = reinterpret_cast<const std::byte *>(mesh.vertices.data());
+            buffer.insert(buffer.end(), vertices, vertices + mesh.vertices.size() * sizeof(pyro::MeshVertex));
+            const size_t index_offset = buffer.size();
+            const auto *indices = reinterpret_cast<const std::byte *>(mesh.indices.data());
+            buffer.insert(buffer.end(), indices, indices + mesh.indices.size() * sizeof(uint32_t));
+
+            const std::string separator = m == 0 ? "" : ",";
+            const size_t view = m * 2;
+            const size_t accessor = m * 4;
+            views += std::format(R"({}{{"buffer":0,"byteOffset":{},"byteLength":{},"byteStride":{}}},)"
+                                 R"({{"buffer":0,"byteOffset":{},"byteLength":{}}})",
+                                 separator, vertex_offset, index_offset - vertex_offset, sizeof(pyro::MeshVertex),
+                                 index_offset, buffer.size() - index_offset);
+            accessors += std::format(
+                    R"({0}{{"bufferView":{1},"byteOffset":0,"componentType":5126,"count":{2},"type":"VEC3"}},)"
+                    R"({{"bufferView":{1},"byteOffset":12,"componentType":5126,"count":{2},"type":"VEC3"}},)"
+                    R"({{"bufferView":{1},"byteOffset":24,"componentType":5126,"count":{2},"type":"VEC2"}},)"
+                    R"({{"bufferView":{3},"componentType":5125,"count":{4},"type":"SCALAR"}})",
+                    separator, view, mesh.vertices.size(), view + 1, mesh.indices.size());
+            gltf_meshes += std::format(
+                    R"({}{{"name":"{}","primitives":[{{"attributes":{{"POSITION":{},"NORMAL":{},"TEXCOORD_0":{}}},)"
+                    R"("indices":{}}}]}})",
+                    separator, mesh.name, accessor, accessor + 1, accessor + 2, accessor + 3);
+            nodes += std::format(R"({}{{"mesh":{}}})", separator, m);
+        }
+        std::string roots;
+        for (size_t m = 0; m < meshes.size(); m++) {
+            roots += std::format("{}{}", m == 0 ? "" : ",", m);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[)" << roots << R"(]}],"nodes":[)" << nodes
+             << R"(],"meshes":[)" << gltf_meshes << R"(],"accessors":[)" << accessors << R"(],"bufferViews":[)"
+             << views << R"(],"buffers":[{"byteLength":)" << buffer.size()
+             << R"(,"uri":"data:application/octet-stream;base64,)" << encode_base64(buffer) << R"("}]})";
+        return static_cast<bool>(file.flush());
+    }
+
+    // The repacking a runtime glTF loader would do to reach the .pmesh layout.
+    std::unique_ptr<pyro::PyroMeshBuffers> upload_imported(pyro::VulkanDevice &device,
+                                                           const std::vector<pyro::ImportedMesh> &meshes) {
+        std::vector<pyro::MeshEntry> entries;
+        std::vector<pyro::MeshVertex> vertices;
+        std::vector<uint32_t> indices;
+        for (const pyro::ImportedMesh &mesh : meshes) {
+            pyro::MeshEntry entry{};
+            entry.first_vertex = static_cast<uint32_t>(vertices.size());
+            entry.vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+            entry.first_index = static_cast<uint32_t>(indices.size());
+            entry.index_count = static_cast<uint32_t>(mesh.indices.size());
+            entries.push_back(entry);
+            vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+            indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+        }
+        pyro::MeshData data{};
+        data.meshes = entries;
+        data.vertices = std::as_bytes(std::span(vertices));
+        data.indices = std::as_bytes(std::span(indices));
+        return std::make_unique<pyro::PyroMeshBuffers>(&device, data);
+    }
+
+    double read_whole_file_ms(const std::filesystem::path &path) {
+        const auto start = std::chrono::steady_clock::now();
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> chunk(8 << 20);
+        while (file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || file.gcount() > 0) {
+        }
+        return elapsed_ms(start);
+    }
+
+    struct LoadResult {
+        double cold_ms;
+        double warm_ms;
+    };
+
+    template<typename Load>
+    LoadResult measure(const std::filesystem::path &path, Load &&load) {
+        std::vector<double> cold;
+        std::vector<double> warm;
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            drop_from_page_cache(path);
+            auto start = std::chrono::steady_clock::now();
+            load();
+            cold.push_back(elapsed_ms(start));
+            start = std::chrono::steady_clock::now();
+            load();
+            warm.push_back(elapsed_ms(start));
+        }
+        return {median(cold), median(warm)};
+    }
+} // namespace
+
+int main(const int argc, char **argv) {
+    const uint64_t scene_mb = argc > 1 ? std::stoull(argv[1]) : 256;
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path gltf_path = directory / "pyro_mesh_bench.gltf";
+    const std::filesystem::path pmesh_path = directory / "pyro_mesh_bench.pmesh";
+    {
+        const std::vector<pyro::ImportedMesh> scene = create_scene(scene_mb << 20);
+        if (!write_gltf(gltf_path, scene) || !pyro::write_mesh_file(pmesh_path.string(), scene)) {
+            std::cerr << "failed to write the benchmark scene to " << directory << "\n";
+            return 1;
+        }
+    }
+    const uint64_t gltf_bytes = std::filesystem::file_size(gltf_path);
+    const uint64_t pmesh_bytes = std::filesystem::file_size(pmesh_path);
+
+    pyro::PyroWindow window(64, 64, "PyroCore mesh load bench", pyro::WINDOW_HIDDEN | pyro::WINDOW_NOT_RESIZABLE);
+    pyro::VulkanInstance instance;
+    pyro::VulkanDevice device(&instance, &window);
+
+    const LoadResult gltf = measure(gltf_path, [&] {
+        const auto meshes = pyro::import_gltf(gltf_path.string());
+        if (meshes) {
+            upload_imported(device, *meshes);
+        }
+    });
+    const LoadResult pmesh = measure(pmesh_path, [&] {
+        pyro::PyroMeshFile file;
+        if (file.open(pmesh_path.string())) {
+            pyro::PyroMeshBuffers buffers(&device, file);
+        }
+    });
+    std::vector<double> read_samples;
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        drop_from_page_cache(pmesh_path);
+        read_samples.push_back(read_whole_file_ms(pmesh_path));
+    }
+    const double read_ms = median(read_samples);
+
+    const auto gb_per_s = [](const uint64_t bytes, const double ms) {
+        return static_cast<double>(bytes) / (ms * 1e6);
+    };
+    std::cout << std::format("{:<28} {:>12} {:>12} {:>12} {:>12}\n", "", "file MB", "cold ms", "warm ms",
+                             "cold GB/s");
+    std::cout << std::format("{:<28} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.2f}\n", "text glTF (parse + upload)",
+                             gltf_bytes / 1048576.0, gltf.cold_ms, gltf.warm_ms, gb_per_s(gltf_bytes, gltf.cold_ms));
+    std::cout << std::format("{:<28} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.2f}\n", "pmesh (mmap + upload)",
+                             pmesh_bytes / 1048576.0, pmesh.cold_ms, pmesh.warm_ms,
+                             gb_per_s(pmesh_bytes, pmesh.cold_ms));
+    std::cout << std::format("{:<28} {:>12.1f} {:>12.1f} {:>12} {:>12.2f}\n", "pmesh read() only",
+                             pmesh_bytes / 1048576.0, read_ms, "-", gb_per_s(pmesh_bytes, read_ms));
+    std::cout << std::format("{:<28} {:>12.1f}x\n", "pmesh speedup (cold)", gltf.cold_ms / pmesh.cold_ms);
+
+    std::filesystem::remove(gltf_path);
+    std::filesystem::remove(pmesh_path);
+    return 0;
+}
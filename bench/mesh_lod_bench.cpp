@@ -0,0 +1,359 @@
+//
+// Created by srijan on 2/28/25.
+//
+
+// Builds LOD chains for a torus knot and a sphere, writes them to a .pmesh, and flies a camera over a
+// GRID_SIZE x GRID_SIZE field of instances for FRAME_COUNT frames at 1080p. Every frame goes through the mesh
+// culler and is drawn with the selected levels; the camera bobs slightly back and forth along its path, as a
+// walking camera does, so instances near a switch distance are exercised. Reports GPU frame time, culling time,
+// triangles submitted and triangle throughput, the LOD histogram and LOD switches per frame with LOD selection
+// off, on without hysteresis, and on with the default hysteresis. Run from the build directory so
+// assets/shaders/*.spv resolve.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/core/VulkanDevice.hpp"
+#include "../src/core/VulkanImage.hpp"
+#include "../src/core/VulkanInstance.hpp"
+#include "../src/mesh/PyroMeshBuffers.hpp"
+#include "../src/mesh/PyroMeshCuller.hpp"
+#include "../src/mesh/PyroMeshFile.hpp"
+#include "../src/profiler/PyroGpuTimer.hpp"
+#include "../src/renderer/Pyropipeline.hpp"
+#include "../src/window/PyroWindow.hpp"
+#include "../tools/meshc/MeshImport.hpp"
+#include "../tools/meshc/MeshOptimize.hpp"
+#include "../tools/meshc/MeshSimplify.hpp"
+#include "../tools/meshc/MeshWriter.hpp"
+
+namespace {
+    constexpr uint32_t GRID_SIZE = 48;
+    constexpr float GRID_SPACING = 3.0f;
+    constexpr uint32_t WARMUP_FRAMES = 10;
+    constexpr uint32_t FRAME_COUNT = 300;
+    constexpr VkExtent2D TARGET_EXTENT = {1920, 1080};
+    constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+    constexpr float FOVY = 1.0471976f; // 60 degrees
+    constexpr float PI = 3.14159265f;
+
+    struct MeshDraw {
+        glm::mat4 model_view_proj;
+        glm::mat4 model;
+    };
+
+    double median(std::vector<double> samples) {
+        std::ranges::sort(samples);
+        return samples[samples.size() / 2];
+    }
+
+    void transition(const VkCommandBuffer command_buffer, const VkImage image, const VkImageAspectFlags aspect,
+                    const VkImageLayout new_layout, const VkAccessFlags dst_access,
+                    const VkPipelineStageFlags dst_stage) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.dstAccessMask = dst_access;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = new_layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {aspect, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dst_stage, 0, 0, nullptr, 0, nullptr,
+                             1, &barrier);
+    }
+
+    void set_vertex(pyro::MeshVertex &vertex, const glm::vec3 position, const glm::vec3 normal, const glm::vec2 uv) {
+        std::copy_n(glm::value_ptr(position), 3, vertex.position);
+        std::copy_n(glm::value_ptr(normal), 3, vertex.normal);
+        std::copy_n(glm::value_ptr(uv), 2, vertex.uv);
+    }
+
+    void add_lattice_indices(pyro::ImportedMesh &mesh, const uint32_t columns, const uint32_t rows) {
+        for (uint32_t y = 0; y < rows; y++) {
+            for (uint32_t x = 0; x < columns; x++) {
+                const uint32_t i = y * (columns + 1) + x;
+                const uint32_t below = i + columns + 1;
+                mesh.indices.insert(mesh.indices.end(), {i, i + 1, below, i + 1, below + 1, below});
+            }
+        }
+    }
+
+    pyro::ImportedMesh create_sphere(const uint32_t segments, const uint32_t rings) {
+        pyro::ImportedMesh mesh;
+        mesh.name = "sphere";
+        for (uint32_t y = 0; y <= rings; y++) {
+            for (uint32_t x = 0; x <= segments; x++) {
+                const float u = static_cast<float>(x) / static_cast<float>(segments);
+                const float v = static_cast<float>(y) / static_cast<float>(rings);
+                const glm::vec3 normal(std::sin(v * PI) * std::cos(u * 2.0f * PI), std::cos(v * PI),
+                                       std::sin(v * PI) * std::sin(u * 2.0f * PI));
+                set_vertex(mesh.vertices.emplace_back(), normal, normal, {u, v});
+            }
+        }
+        add_lattice_indices(mesh, segments, rings);
+        return mesh;
+    }
+
+    pyro::ImportedMesh create_torus_knot(const uint32_t segments, const uint32_t sides) {
+        pyro::ImportedMesh mesh;
+        mesh.name = "torus knot";
+        const auto curve = [](const float t) {
+            const float r = 2.0f + std::cos(3.0f * t);
+            return glm::vec3(r * std::cos(2.0f * t), std::sin(3.0f * t), r * std::sin(2.0f * t)) * 0.3f;
+        };
+        for (uint32_t s = 0; s <= segments; s++) {
+            const float t = static_cast<float>(s) / static_cast<float>(segments) * 2.0f * PI;
+            const glm::vec3 center = curve(t);
+            const glm::vec3 tangent = glm::normalize(curve(t + 1e-3f) - center);
+            const glm::vec3 side = glm::normalize(glm::cross(tangent, glm::vec3(0.0f, 1.0f, 0.0f)));
+            const glm::vec3 up = glm::cross(side, tangent);
+            for (uint32_t k = 0; k <= sides; k++) {
+                const float angle = static_cast<float>(k) / static_cast<float>(sides) * 2.0f * PI;
+                const glm::vec3 normal = side * std::cos(angle) - up * std::sin(angle);
+                set_vertex(mesh.vertices.emplace_back(), center + normal * 0.12f, normal,
+                           {static_cast<float>(s) / static_cast<float>(segments),
+                            static_cast<float>(k) / static_cast<float>(sides)});
+            }
+        }
+        add_lattice_indices(mesh, sides, segments);
+        return mesh;
+    }
+
+    std::vector<pyro::MeshInstance> create_instances() {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<pyro::MeshInstance> instances;
+        for (uint32_t z = 0; z < GRID_SIZE; z++) {
+            for (uint32_t x = 0; x < GRID_SIZE; x++) {
+                const glm::vec3 position(static_cast<float>(x) * GRID_SPACING, 0.0f,
+                                         -static_cast<float>(z) * GRID_SPACING);
+                const glm::mat4 transform =
+                        glm::rotate(glm::translate(glm::mat4(1.0f), position), unit(rng) * 2.0f * PI,
+                                    glm::vec3(0.0f, 1.0f, 0.0f));
+                instances.push_back({(x + z) % 2, glm::scale(transform, glm::vec3(0.8f + 0.4f * unit(rng)))});
+            }
+        }
+        return instances;
+    }
+
+    // Flies diagonally across the field a little above the instances, bobbing a quarter unit along the view
+    // direction every few frames.
+    glm::mat4 camera_view(const uint32_t frame, glm::vec3 &eye) {
+        const float extent = static_cast<float>(GRID_SIZE - 1) * GRID_SPACING;
+        const float t = static_cast<float>(frame) / static_cast<float>(FRAME_COUNT);
+        const glm::vec3 forward = glm::normalize(glm::vec3(1.0f, -0.15f, -1.0f));
+        eye = glm::vec3(-4.0f + t * extent * 0.5f, 2.5f, 4.0f - t * extent * 0.5f) +
+              forward * (0.25f * std::sin(static_cast<float>(frame) * 1.3f));
+        return glm::lookAt(eye, eye + forward, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    struct RunResult {
+        double gpu_ms;
+        double cull_ms;
+        double triangles;
+        double switches;
+        std::array<double, pyro::MeshCullStats::MAX_TRACKED_LODS> histogram{};
+    };
+
+    class SceneRenderer {
+    public:
+        SceneRenderer(pyro::VulkanDevice *device, const pyro::PyroMeshBuffers *buffers) :
+            device(device), buffers(buffers), timer(device, 1) {
+            pyro::ImageDesc color_desc{};
+            color_desc.extent = TARGET_EXTENT;
+            color_desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+            color_desc.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            color = std::make_unique<pyro::VulkanImage>(device, color_desc);
+            pyro::ImageDesc depth_desc{};
+            depth_desc.extent = TARGET_EXTENT;
+            depth_desc.format = DEPTH_FORMAT;
+            depth_desc.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+            depth_desc.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+            depth = std::make_unique<pyro::VulkanImage>(device, depth_desc);
+
+            const VkCommandBuffer setup = device->begin_single_time_commands();
+            transition(setup, color->get_image(), VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+            transition(setup, depth->get_image(), VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT);
+            device->end_single_time_commands(setup);
+
+            pyro::GraphicsPipelineDesc desc{};
+            desc.vertex_shader = pyro::PyroMeshBuffers::vertex_shader(buffers->get_vertex_format());
+            desc.fragment_shader = "assets/shaders/mesh.frag.spv";
+            desc.vertex_bindings = pyro::PyroMeshBuffers::vertex_bindings(buffers->get_vertex_format());
+            desc.vertex_attributes = pyro::PyroMeshBuffers::vertex_attributes(buffers->get_vertex_format());
+            desc.front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+            desc.formats = {{VK_FORMAT_R8G8B8A8_UNORM}, DEPTH_FORMAT};
+            pipeline = std::make_unique<pyro::Pyropipeline>(
+                    device, std::vector<VkDescriptorSetLayout>{},
+                    std::vector{VkPushConstantRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshDraw)}}, desc);
+
+            projection = glm::perspectiveRH_ZO(
+                    FOVY, static_cast<float>(TARGET_EXTENT.width) / static_cast<float>(TARGET_EXTENT.height), 0.1f,
+                    250.0f);
+            projection[1][1] *= -1.0f;
+        }
+
+        RunResult run(const std::vector<pyro::MeshInstance> &instances, const pyro::LodSelectionConfig &config) {
+            pyro::PyroMeshCuller culler(buffers, config);
+            std::vector<VkDrawIndexedIndirectCommand> draws;
+            std::vector<double> gpu_samples;
+            RunResult result{};
+            for (uint32_t frame = 0; frame < WARMUP_FRAMES + FRAME_COUNT; frame++) {
+                glm::vec3 eye;
+                const glm::mat4 view_proj = projection * camera_view(frame % FRAME_COUNT, eye);
+                const pyro::MeshCullView view{view_proj, eye,
+                                              std::abs(projection[1][1]) * 0.5f *
+                                                      static_cast<float>(TARGET_EXTENT.height)};
+                const auto cull_start = std::chrono::steady_clock::now();
+                culler.cull(instances, view, draws);
+                const double cull_ms =
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cull_start)
+                                .count();
+
+                const double gpu_ms = draw(instances, draws, view_proj);
+                if (frame < WARMUP_FRAMES) {
+                    continue;
+                }
+                const pyro::MeshCullStats &stats = culler.get_stats();
+                gpu_samples.push_back(gpu_ms);
+                result.cull_ms += cull_ms / FRAME_COUNT;
+                result.triangles += static_cast<double>(stats.triangles) / FRAME_COUNT;
+                result.switches += static_cast<double>(stats.lod_switches) / FRAME_COUNT;
+                for (size_t lod = 0; lod < stats.lod_histogram.size(); lod++) {
+                    result.histogram[lod] += stats.lod_histogram[lod] / static_cast<double>(FRAME_COUNT);
+                }
+            }
+            result.gpu_ms = median(gpu_samples);
+            return result;
+        }
+
+    private:
+        pyro::VulkanDevice *device;
+        const pyro::PyroMeshBuffers *buffers;
+        pyro::PyroGpuTimer timer;
+        std::unique_ptr<pyro::VulkanImage> color;
+        std::unique_ptr<pyro::VulkanImage> depth;
+        std::unique_ptr<pyro::Pyropipeline> pipeline;
+        glm::mat4 projection{};
+
+        double draw(const std::vector<pyro::MeshInstance> &instances,
+                    const std::vector<VkDrawIndexedIndirectCommand> &draws, const glm::mat4 &view_proj) {
+            const VkCommandBuffer command_buffer = device->begin_single_time_commands();
+            timer.reset(command_buffer);
+
+            VkRenderingAttachmentInfo color_attachment{};
+            color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            color_attachment.imageView = color->get_view();
+            color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            VkRenderingAttachmentInfo depth_attachment{};
+            depth_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            depth_attachment.imageView = depth->get_view();
+            depth_attachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+            depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            depth_attachment.clearValue.depthStencil = {1.0f, 0};
+            VkRenderingInfo rendering_info{};
+            rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+            rendering_info.renderArea = {{0, 0}, TARGET_EXTENT};
+            rendering_info.layerCount = 1;
+            rendering_info.colorAttachmentCount = 1;
+            rendering_info.pColorAttachments = &color_attachment;
+            rendering_info.pDepthAttachment = &depth_attachment;
+            vkCmdBeginRendering(command_buffer, &rendering_info);
+            const VkViewport viewport{0.0f, 0.0f, static_cast<float>(TARGET_EXTENT.width),
+                                      static_cast<float>(TARGET_EXTENT.height), 0.0f, 1.0f};
+            vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+            const VkRect2D scissor{{0, 0}, TARGET_EXTENT};
+            vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get_pipeline());
+            buffers->bind(command_buffer);
+
+            const uint32_t scope = timer.begin(command_buffer);
+            for (const VkDrawIndexedIndirectCommand &command : draws) {
+                const glm::mat4 &model = instances[command.firstInstance].transform;
+                const MeshDraw push{view_proj * model, model};
+                vkCmdPushConstants(command_buffer, pipeline->get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, 0,
+                                   sizeof(push), &push);
+                vkCmdDrawIndexed(command_buffer, command.indexCount, 1, command.firstIndex, command.vertexOffset, 0);
+            }
+            timer.end(command_buffer, scope);
+            vkCmdEndRendering(command_buffer);
+            device->end_single_time_commands(command_buffer);
+            return timer.resolve(scope).value_or(0.0);
+        }
+    };
+} // namespace
+
+int main() {
+    std::vector<pyro::ImportedMesh> meshes;
+    meshes.push_back(create_torus_knot(2048, 32));
+    meshes.push_back(create_sphere(256, 128));
+    for (pyro::ImportedMesh &mesh : meshes) {
+        pyro::generate_lods(mesh);
+        pyro::optimize_mesh(mesh);
+        std::cout << std::format("{}: {} triangles", mesh.name, mesh.indices.size() / 3);
+        for (const pyro::ImportedLod &lod : mesh.lods) {
+            std::cout << std::format(" -> {} (error {:.4g})", lod.indices.size() / 3, lod.error);
+        }
+        std::cout << "\n";
+    }
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "pyro_lod_bench.pmesh";
+    if (!pyro::write_mesh_file(path.string(), meshes)) {
+        return 1;
+    }
+    pyro::PyroMeshFile file;
+    if (!file.open(path.string())) {
+        return 1;
+    }
+
+    pyro::PyroWindow window(64, 64, "PyroCore mesh LOD bench", pyro::WINDOW_HIDDEN | pyro::WINDOW_NOT_RESIZABLE);
+    pyro::VulkanInstance instance;
+    pyro::VulkanDevice device(&instance, &window);
+    const pyro::PyroMeshBuffers buffers(&device, file);
+    SceneRenderer renderer(&device, &buffers);
+    const std::vector<pyro::MeshInstance> instances = create_instances();
+
+    struct Run {
+        const char *name;
+        pyro::LodSelectionConfig config;
+    };
+    const Run runs[] = {
+            {"LOD off", {1.0f, 0.0f, false}},
+            {"LOD, no hysteresis", {1.0f, 0.0f, true}},
+            {"LOD, hysteresis 0.25", {1.0f, 0.25f, true}},
+    };
+    std::cout << std::format("\n{} instances, {} frames at {}x{}\n", instances.size(), FRAME_COUNT,
+                             TARGET_EXTENT.width, TARGET_EXTENT.height);
+    std::cout << std::format("{:<22} {:>9} {:>9} {:>12} {:>10} {:>10}  {}\n", "mode", "GPU ms", "cull ms",
+                             "Mtri/frame", "Gtri/s", "switches", "instances per LOD");
+    for (const Run &run : runs) {
+        const RunResult result = renderer.run(instances, run.config);
+        std::string histogram;
+        for (const double count : result.histogram) {
+            histogram += std::format("{:>7.0f}", count);
+        }
+        std::cout << std::format("{:<22} {:>9.3f} {:>9.3f} {:>12.2f} {:>10.2f} {:>10.1f}  {}\n", run.name,
+                                 result.gpu_ms, result.cull_ms, result.triangles / 1e6,
+                                 result.triangles / (result.gpu_ms * 1e6), result.switches, histogram);
+    }
+    vkDeviceWaitIdle(device.get_logical_device());
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,357 @@
+//
+// Created by srijan on 2/27/25.
+//
+
+// Runs the converter's optimisation passes one after another over a few test meshes (plus any .obj/.gltf/.glb
+// given as arguments) and reports, per stage, the post-transform cache ACMR/ATVR, the vertex and index bytes,
+// and the GPU time to draw the mesh from VIEW_COUNT directions with depth testing and back-face culling into
+// a 1080p target, measured with timestamp queries. Run from the build directory so assets/shaders/*.spv
+// resolve.
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../src/core/VulkanDevice.hpp"
+#include "../src/core/VulkanImage.hpp"
+#include "../src/core/VulkanInstance.hpp"
+#include "../src/mesh/PyroMeshBuffers.hpp"
+#include "../src/profiler/PyroGpuTimer.hpp"
+#include "../src/renderer/Pyropipeline.hpp"
+#include "../src/window/PyroWindow.hpp"
+#include "../tools/meshc/MeshImport.hpp"
+#include "../tools/meshc/MeshOptimize.hpp"
+
+namespace {
+    constexpr uint32_t WARMUP_ITERATIONS = 3;
+    constexpr uint32_t ITERATIONS = 15;
+    constexpr uint32_t VIEW_COUNT = 8;
+    constexpr VkExtent2D TARGET_EXTENT = {1920, 1080};
+    constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+    constexpr float PI = 3.14159265f;
+
+    struct MeshDraw {
+        glm::mat4 model_view_proj;
+        glm::mat4 model;
+    };
+
+    double median(std::vector<double> samples) {
+        std::ranges::sort(samples);
+        return samples[samples.size() / 2];
+    }
+
+    void transition(const VkCommandBuffer command_buffer, const VkImage image, const VkImageAspectFlags aspect,
+                    const VkImageLayout new_layout, const VkAccessFlags dst_access,
+                    const VkPipelineStageFlags dst_stage) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.dstAccessMask = dst_access;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = new_layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {aspect, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dst_stage, 0, 0, nullptr, 0, nullptr,
+                             1, &barrier);
+    }
+
+    void set_vertex(pyro::MeshVertex &vertex, const glm::vec3 position, const glm::vec3 normal, const glm::vec2 uv) {
+        std::copy_n(glm::value_ptr(position), 3, vertex.position);
+        std::copy_n(glm::value_ptr(normal), 3, vertex.normal);
+        std::copy_n(glm::value_ptr(uv), 2, vertex.uv);
+    }
+
+    // Quads of a (columns + 1) x (rows + 1) vertex lattice in row order, wound counter-clockwise when the
+    // lattice's u runs right and v runs up as seen from outside.
+    void add_lattice_indices(pyro::ImportedMesh &mesh, const uint32_t columns, const uint32_t rows) {
+        for (uint32_t y = 0; y < rows; y++) {
+            for (uint32_t x = 0; x < columns; x++) {
+                const uint32_t i = y * (columns + 1) + x;
+                const uint32_t below = i + columns + 1;
+                mesh.indices.insert(mesh.indices.end(), {i, i + 1, below, i + 1, below + 1, below});
+            }
+        }
+    }
+
+    pyro::ImportedMesh create_sphere(const uint32_t segments, const uint32_t rings) {
+        pyro::ImportedMesh mesh;
+        mesh.name = "sphere (shuffled)";
+        for (uint32_t y = 0; y <= rings; y++) {
+            for (uint32_t x = 0; x <= segments; x++) {
+                const float u = static_cast<float>(x) / static_cast<float>(segments);
+                const float v = static_cast<float>(y) / static_cast<float>(rings);
+                const glm::vec3 normal(std::sin(v * PI) * std::cos(u * 2.0f * PI), std::cos(v * PI),
+                                       std::sin(v * PI) * std::sin(u * 2.0f * PI));
+                set_vertex(mesh.vertices.emplace_back(), normal, normal, {u, v});
+            }
+        }
+        add_lattice_indices(mesh, segments, rings);
+        return mesh;
+    }
+
+    // A (2, 3) torus knot tube: deep concavities and self-occlusion, where triangle order affects overdraw.
+    pyro::ImportedMesh create_torus_knot(const uint32_t segments, const uint32_t sides) {
+        pyro::ImportedMesh mesh;
+        mesh.name = "torus knot";
+        const auto curve = [](const float t) {
+            const float r = 2.0f + std::cos(3.0f * t);
+            return glm::vec3(r * std::cos(2.0f * t), std::sin(3.0f * t), r * std::sin(2.0f * t)) * 0.3f;
+        };
+        for (uint32_t s = 0; s <= segments; s++) {
+            const float t = static_cast<float>(s) / static_cast<float>(segments) * 2.0f * PI;
+            const glm::vec3 center = curve(t);
+            const glm::vec3 tangent = glm::normalize(curve(t + 1e-3f) - center);
+            const glm::vec3 side = glm::normalize(glm::cross(tangent, glm::vec3(0.0f, 1.0f, 0.0f)));
+            const glm::vec3 up = glm::cross(side, tangent);
+            for (uint32_t k = 0; k <= sides; k++) {
+                const float angle = static_cast<float>(k) / static_cast<float>(sides) * 2.0f * PI;
+                const glm::vec3 normal = side * std::cos(angle) - up * std::sin(angle);
+                set_vertex(mesh.vertices.emplace_back(), center + normal * 0.12f, normal,
+                           {static_cast<float>(s) / static_cast<float>(segments),
+                            static_cast<float>(k) / static_cast<float>(sides)});
+            }
+        }
+        add_lattice_indices(mesh, sides, segments);
+        return mesh;
+    }
+
+    // Heightfield in scanline order, as terrain generators emit it.
+    pyro::ImportedMesh create_terrain(const uint32_t size) {
+        pyro::ImportedMesh mesh;
+        mesh.name = "terrain";
+        for (uint32_t y = 0; y <= size; y++) {
+            for (uint32_t x = 0; x <= size; x++) {
+                const float u = static_cast<float>(x) / static_cast<float>(size);
+                const float v = static_cast<float>(y) / static_cast<float>(size);
+                const float height = 0.1f * std::sin(u * 19.0f) * std::cos(v * 13.0f);
+                set_vertex(mesh.vertices.emplace_back(), {u * 2.0f - 1.0f, height, 1.0f - v * 2.0f},
+                           {0.0f, 1.0f, 0.0f}, {u, v});
+            }
+        }
+        add_lattice_indices(mesh, size, size);
+        pyro::generate_normals(mesh);
+        return mesh;
+    }
+
+    void shuffle_triangles(pyro::ImportedMesh &mesh) {
+        std::vector<uint32_t> order(mesh.indices.size() / 3);
+        for (uint32_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::ranges::shuffle(order, std::mt19937(42));
+        std::vector<uint32_t> shuffled;
+        shuffled.reserve(mesh.indices.size());
+        for (const uint32_t t : order) {
+            shuffled.insert(shuffled.end(), mesh.indices.begin() + t * 3, mesh.indices.begin() + t * 3 + 3);
+        }
+        mesh.indices = std::move(shuffled);
+    }
+
+    std::vector<std::byte> vertex_bytes(const pyro::ImportedMesh &mesh, const pyro::MeshVertexFormat format) {
+        if (format == pyro::MeshVertexFormat::QUANTIZED) {
+            std::vector<pyro::QuantizedMeshVertex> quantized(mesh.vertices.size());
+            std::ranges::transform(mesh.vertices, quantized.begin(), pyro::quantize_vertex);
+            const auto bytes = std::as_bytes(std::span(quantized));
+            return {bytes.begin(), bytes.end()};
+        }
+        const auto bytes = std::as_bytes(std::span(mesh.vertices));
+        return {bytes.begin(), bytes.end()};
+    }
+
+    // Scales the mesh's bounding sphere to unit radius around the origin.
+    glm::mat4 fit_transform(const pyro::ImportedMesh &mesh) {
+        glm::vec3 low(std::numeric_limits<float>::max());
+        glm::vec3 high(std::numeric_limits<float>::lowest());
+        for (const pyro::MeshVertex &vertex : mesh.vertices) {
+            low = glm::min(low, glm::make_vec3(vertex.position));
+            high = glm::max(high, glm::make_vec3(vertex.position));
+        }
+        const glm::vec3 center = (low + high) * 0.5f;
+        const float radius = std::max(glm::length(high - center), 1e-6f);
+        return glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / radius)) * glm::translate(glm::mat4(1.0f), -center);
+    }
+
+    class MeshRenderer {
+    public:
+        explicit MeshRenderer(pyro::VulkanDevice *device) : device(device), timer(device, 1) {
+            pyro::ImageDesc color_desc{};
+            color_desc.extent = TARGET_EXTENT;
+            color_desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+            color_desc.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            color = std::make_unique<pyro::VulkanImage>(device, color_desc);
+            pyro::ImageDesc depth_desc{};
+            depth_desc.extent = TARGET_EXTENT;
+            depth_desc.format = DEPTH_FORMAT;
+            depth_desc.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+            depth_desc.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+            depth = std::make_unique<pyro::VulkanImage>(device, depth_desc);
+
+            const VkCommandBuffer setup = device->begin_single_time_commands();
+            transition(setup, color->get_image(), VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+            transition(setup, depth->get_image(), VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT);
+            device->end_single_time_commands(setup);
+
+            for (const pyro::MeshVertexFormat format :
+                 {pyro::MeshVertexFormat::FLOAT32, pyro::MeshVertexFormat::QUANTIZED}) {
+                pyro::GraphicsPipelineDesc desc{};
+                desc.vertex_shader = pyro::PyroMeshBuffers::vertex_shader(format);
+                desc.fragment_shader = "assets/shaders/mesh.frag.spv";
+                desc.vertex_bindings = pyro::PyroMeshBuffers::vertex_bindings(format);
+                desc.vertex_attributes = pyro::PyroMeshBuffers::vertex_attributes(format);
+                // The projection flips y, so counter-clockwise source triangles stay counter-clockwise.
+                desc.front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+                desc.formats = {{VK_FORMAT_R8G8B8A8_UNORM}, DEPTH_FORMAT};
+                pipelines.push_back(std::make_unique<pyro::Pyropipeline>(
+                        device, std::vector<VkDescriptorSetLayout>{},
+                        std::vector{VkPushConstantRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshDraw)}}, desc));
+            }
+        }
+
+        // Median GPU milliseconds for drawing the mesh once from each of VIEW_COUNT directions.
+        double measure(const pyro::PyroMeshBuffers &buffers, const glm::mat4 &model) {
+            const pyro::Pyropipeline &pipeline = *pipelines[static_cast<size_t>(buffers.get_vertex_format())];
+            glm::mat4 projection = glm::perspectiveRH_ZO(
+                    glm::radians(60.0f),
+                    static_cast<float>(TARGET_EXTENT.width) / static_cast<float>(TARGET_EXTENT.height), 0.1f,
+                    10.0f);
+            projection[1][1] *= -1.0f;
+
+            std::vector<double> samples;
+            for (uint32_t i = 0; i < WARMUP_ITERATIONS + ITERATIONS; i++) {
+                const VkCommandBuffer command_buffer = device->begin_single_time_commands();
+                timer.reset(command_buffer);
+
+                VkRenderingAttachmentInfo color_attachment{};
+                color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+                color_attachment.imageView = color->get_view();
+                color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                VkRenderingAttachmentInfo depth_attachment{};
+                depth_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+                depth_attachment.imageView = depth->get_view();
+                depth_attachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+                depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                depth_attachment.clearValue.depthStencil = {1.0f, 0};
+                VkRenderingInfo rendering_info{};
+                rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+                rendering_info.renderArea = {{0, 0}, TARGET_EXTENT};
+                rendering_info.layerCount = 1;
+                rendering_info.colorAttachmentCount = 1;
+                rendering_info.pColorAttachments = &color_attachment;
+                rendering_info.pDepthAttachment = &depth_attachment;
+                vkCmdBeginRendering(command_buffer, &rendering_info);
+                const VkViewport viewport{0.0f, 0.0f, static_cast<float>(TARGET_EXTENT.width),
+                                          static_cast<float>(TARGET_EXTENT.height), 0.0f, 1.0f};
+                vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+                const VkRect2D scissor{{0, 0}, TARGET_EXTENT};
+                vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+                vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.get_pipeline());
+                buffers.bind(command_buffer);
+
+                const uint32_t scope = timer.begin(command_buffer);
+                for (uint32_t view = 0; view < VIEW_COUNT; view++) {
+                    const float angle = static_cast<float>(view) / VIEW_COUNT * 2.0f * PI;
+                    const glm::vec3 eye(2.2f * std::cos(angle), 0.8f * std::sin(angle * 2.0f), 2.2f * std::sin(angle));
+                    const glm::mat4 view_matrix = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+                    const MeshDraw draw{projection * view_matrix * model, model};
+                    vkCmdPushConstants(command_buffer, pipeline.get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, 0,
+                                       sizeof(draw), &draw);
+                    buffers.draw(command_buffer, 0);
+                }
+                timer.end(command_buffer, scope);
+                vkCmdEndRendering(command_buffer);
+                device->end_single_time_commands(command_buffer);
+                if (i >= WARMUP_ITERATIONS) {
+                    samples.push_back(timer.resolve(scope).value_or(0.0));
+                }
+            }
+            return median(samples);
+        }
+
+    private:
+        pyro::VulkanDevice *device;
+        pyro::PyroGpuTimer timer;
+        std::unique_ptr<pyro::VulkanImage> color;
+        std::unique_ptr<pyro::VulkanImage> depth;
+        std::vector<std::unique_ptr<pyro::Pyropipeline>> pipelines;
+    };
+
+    void report(pyro::VulkanDevice &device, MeshRenderer &renderer, pyro::ImportedMesh mesh) {
+        struct Stage {
+            const char *name;
+            pyro::ImportedMesh mesh;
+            pyro::MeshVertexFormat format;
+        };
+        std::vector<Stage> stages;
+        stages.push_back({"input", mesh, pyro::MeshVertexFormat::FLOAT32});
+        pyro::optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+        stages.push_back({"vertex cache", mesh, pyro::MeshVertexFormat::FLOAT32});
+        pyro::optimize_overdraw(mesh.indices, mesh.vertices);
+        stages.push_back({"+ overdraw", mesh, pyro::MeshVertexFormat::FLOAT32});
+        pyro::optimize_vertex_fetch(mesh);
+        stages.push_back({"+ vertex fetch", mesh, pyro::MeshVertexFormat::FLOAT32});
+        stages.push_back({"+ quantized", mesh, pyro::MeshVertexFormat::QUANTIZED});
+
+        std::cout << std::format("\n{} ({} vertices, {} triangles)\n", mesh.name, mesh.vertices.size(),
+                                 mesh.indices.size() / 3);
+        std::cout << std::format("{:<16} {:>9} {:>9} {:>9} {:>12} {:>12} {:>10}\n", "stage", "ACMR/16", "ATVR/16",
+                                 "ACMR/32", "vertex KB", "index KB", "GPU ms");
+        const glm::mat4 model = fit_transform(mesh);
+        for (const Stage &stage : stages) {
+            const pyro::VertexCacheStats cache16 =
+                    pyro::analyze_vertex_cache(stage.mesh.indices, stage.mesh.vertices.size(), 16);
+            const pyro::VertexCacheStats cache32 =
+                    pyro::analyze_vertex_cache(stage.mesh.indices, stage.mesh.vertices.size(), 32);
+            const std::vector<std::byte> vertices = vertex_bytes(stage.mesh, stage.format);
+            pyro::MeshEntry entry{};
+            entry.vertex_count = static_cast<uint32_t>(stage.mesh.vertices.size());
+            entry.index_count = static_cast<uint32_t>(stage.mesh.indices.size());
+            pyro::MeshData data{};
+            data.meshes = std::span(&entry, 1);
+            data.vertices = vertices;
+            data.indices = std::as_bytes(std::span(stage.mesh.indices));
+            data.vertex_format = stage.format;
+            const pyro::PyroMeshBuffers buffers(&device, data);
+            std::cout << std::format("{:<16} {:>9.3f} {:>9.3f} {:>9.3f} {:>12.1f} {:>12.1f} {:>10.3f}\n", stage.name,
+                                     cache16.acmr, cache16.atvr, cache32.acmr, vertices.size() / 1024.0,
+                                     stage.mesh.indices.size() * sizeof(uint32_t) / 1024.0,
+                                     renderer.measure(buffers, model));
+        }
+    }
+} // namespace
+
+int main(const int argc, char **argv) {
+    pyro::PyroWindow window(64, 64, "PyroCore mesh optimize bench", pyro::WINDOW_HIDDEN | pyro::WINDOW_NOT_RESIZABLE);
+    pyro::VulkanInstance instance;
+    pyro::VulkanDevice device(&instance, &window);
+    MeshRenderer renderer(&device);
+
+    pyro::ImportedMesh sphere = create_sphere(512, 256);
+    shuffle_triangles(sphere);
+    report(device, renderer, std::move(sphere));
+    report(device, renderer, create_torus_knot(4096, 48));
+    report(device, renderer, create_terrain(1024));
+    for (int i = 1; i < argc; i++) {
+        const auto meshes = pyro::import_mesh(argv[i]);
+        for (size_t m = 0; meshes && m < meshes->size(); m++) {
+            report(device, renderer, (*meshes)[m]);
+        }
+    }
+    vkDeviceWaitIdle(device.get_logical_device());
+    return 0;
+}
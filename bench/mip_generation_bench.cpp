@@ -0,0 +1,287 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+// Times mip chain generation for square RGBA8 images: the vkCmdBlitImage chain against the single-pass compute
+// downsampler. Then encodes the same sizes to BC1 with PyroBlockCompressor and reports the encode time, both image
+// sizes and the PSNR of the decoded level 0 against its source. Run from the build directory so
+// assets/shaders/*.spv resolve.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "../src/compute/PyroBlockCompressor.hpp"
+#include "../src/compute/PyroMipGenerator.hpp"
+#include "../src/core/VulkanBuffer.hpp"
+#include "../src/core/VulkanDevice.hpp"
+#include "../src/core/VulkanImage.hpp"
+#include "../src/core/VulkanInstance.hpp"
+#include "../src/descriptor/PyroDescriptors.hpp"
+#include "../src/profiler/PyroGpuTimer.hpp"
+#include "../src/window/PyroWindow.hpp"
+
+namespace {
+    constexpr uint32_t WARMUP_ITERATIONS = 5;
+    constexpr uint32_t ITERATIONS = 50;
+
+    double median(std::vector<double> samples) {
+        std::ranges::sort(samples);
+        return samples[samples.size() / 2];
+    }
+
+    double time_generation(pyro::VulkanDevice &device, pyro::PyroDescriptors &descriptors,
+                           pyro::PyroMipGenerator &generator, pyro::PyroGpuTimer &timer, const pyro::VulkanImage &image,
+                           const std::function<void(VkCommandBuffer)> &generate) {
+        std::vector<double> samples;
+        for (uint32_t i = 0; i < WARMUP_ITERATIONS + ITERATIONS; i++) {
+            // The previous submission has completed, so frame 0's transient state can be recycled.
+            descriptors.begin_frame(0);
+            generator.begin_frame(0);
+            const VkCommandBuffer command_buffer = device.begin_single_time_commands();
+            timer.reset(command_buffer);
+
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image.get_image();
+            barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, image.get_desc().mip_levels, 0, 1};
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                                 0, nullptr, 0, nullptr, 1, &barrier);
+            const VkClearColorValue color{{0.25f, 0.5f, 0.75f, 1.0f}};
+            const VkImageSubresourceRange level0{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            vkCmdClearColorImage(command_buffer, image.get_image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1,
+                                 &level0);
+            VkMemoryBarrier clear_done{};
+            clear_done.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            clear_done.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            clear_done.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                                 1, &clear_done, 0, nullptr, 0, nullptr);
+
+            const uint32_t scope = timer.begin(command_buffer);
+            generate(command_buffer);
+            timer.end(command_buffer, scope);
+            device.end_single_time_commands(command_buffer);
+            if (i >= WARMUP_ITERATIONS) {
+                samples.push_back(timer.resolve(scope).value_or(0.0));
+            }
+        }
+        return median(samples);
+    }
+
+    // Smooth gradients with a band of fine detail, so the encoder sees both easy and hard blocks.
+    std::vector<uint32_t> test_pattern(const uint32_t size) {
+        std::vector<uint32_t> pixels(static_cast<size_t>(size) * size);
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const uint32_t r = x * 255 / size;
+                const uint32_t g = y * 255 / size;
+                const double wave = std::sin(x * 0.05) * std::cos(y * 0.03);
+                const uint32_t b = static_cast<uint32_t>(127.5 + 127.5 * wave);
+                pixels[static_cast<size_t>(y) * size + x] = r | g << 8 | b << 16 | 0xFFu << 24;
+            }
+        }
+        return pixels;
+    }
+
+    std::array<uint32_t, 3> rgb565(const uint32_t color) {
+        const uint32_t r = color >> 11 & 0x1F;
+        const uint32_t g = color >> 5 & 0x3F;
+        const uint32_t b = color & 0x1F;
+        return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+    }
+
+    // Mean squared error per channel of the decoded BC1 blocks against the RGB of `pixels`.
+    double bc1_mse(const uint32_t *blocks, const std::vector<uint32_t> &pixels, const uint32_t size) {
+        const uint32_t blocks_per_row = (size + 3) / 4;
+        double squared_error = 0.0;
+        for (uint32_t block_y = 0; block_y < (size + 3) / 4; block_y++) {
+            for (uint32_t block_x = 0; block_x < blocks_per_row; block_x++) {
+                const uint32_t *block = blocks + 2 * (static_cast<size_t>(block_y) * blocks_per_row + block_x);
+                const uint32_t color0 = block[0] & 0xFFFF;
+                const uint32_t color1 = block[0] >> 16;
+                std::array<std::array<uint32_t, 3>, 4> palette{rgb565(color0), rgb565(color1)};
+                for (uint32_t c = 0; c < 3; c++) {
+                    if (color0 > color1) {
+                        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+                    } else {
+                        palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                        palette[3][c] = 0;
+                    }
+                }
+                for (uint32_t i = 0; i < 16; i++) {
+                    const uint32_t x = block_x * 4 + i % 4;
+                    const uint32_t y = block_y * 4 + i / 4;
+                    if (x >= size || y >= size) {
+                        continue;
+                    }
+                    const uint32_t pixel = pixels[static_cast<size_t>(y) * size + x];
+                    const auto &decoded = palette[block[1] >> (2 * i) & 0x3];
+                    for (uint32_t c = 0; c < 3; c++) {
+                        const double error = static_cast<double>(pixel >> (8 * c) & 0xFF) - decoded[c];
+                        squared_error += error * error;
+                    }
+                }
+            }
+        }
+        return squared_error / (3.0 * size * size);
+    }
+
+    // Fills level 0 of `image` with `pixels` and blits the rest of the chain, leaving it in SHADER_READ_ONLY.
+    void upload_mipped(pyro::VulkanDevice &device, const pyro::VulkanImage &image,
+                       const std::vector<uint32_t> &pixels) {
+        const VkDeviceSize bytes = pixels.size() * sizeof(uint32_t);
+        const pyro::VulkanBuffer staging(&device, bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        staging.write(pixels.data(), bytes);
+        staging.flush();
+
+        const pyro::ImageDesc &desc = image.get_desc();
+        const VkCommandBuffer command_buffer = device.begin_single_time_commands();
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image.get_image();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, desc.mip_levels, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {desc.extent.width, desc.extent.height, 1};
+        vkCmdCopyBufferToImage(command_buffer, staging.get_buffer(), image.get_image(),
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+        pyro::PyroMipGenerator::generate_blit(command_buffer, image.get_image(), desc.extent, desc.mip_levels);
+        device.end_single_time_commands(command_buffer);
+    }
+
+    // Copies level 0 of a BC1 image in SHADER_READ_ONLY_OPTIMAL back to the host.
+    std::vector<uint32_t> read_back_bc1(pyro::VulkanDevice &device, const pyro::VulkanImage &image) {
+        const VkExtent2D extent = image.get_desc().extent;
+        const VkDeviceSize bytes = static_cast<VkDeviceSize>((extent.width + 3) / 4) * ((extent.height + 3) / 4) * 8;
+        const pyro::VulkanBuffer readback(&device, bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+
+        const VkCommandBuffer command_buffer = device.begin_single_time_commands();
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image.get_image();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {extent.width, extent.height, 1};
+        vkCmdCopyImageToBuffer(command_buffer, image.get_image(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               readback.get_buffer(), 1, &region);
+        device.end_single_time_commands(command_buffer);
+
+        readback.invalidate();
+        std::vector<uint32_t> blocks(bytes / sizeof(uint32_t));
+        std::memcpy(blocks.data(), readback.get_mapped(), bytes);
+        return blocks;
+    }
+
+    void bench_bc1(pyro::VulkanDevice &device, pyro::PyroDescriptors &descriptors, pyro::PyroGpuTimer &timer) {
+        if (!pyro::PyroBlockCompressor::is_supported(&device)) {
+            std::cout << "BC1 encoding skipped: textureCompressionBC is not supported\n";
+            return;
+        }
+        pyro::PyroBlockCompressor compressor(&device, &descriptors);
+        std::cout << std::format("\n{:>6} {:>12} {:>10} {:>10} {:>7} {:>9}\n", "size", "encode ms", "RGBA8 MiB",
+                                 "BC1 MiB", "ratio", "PSNR dB");
+        for (const uint32_t size: {512u, 1024u, 2048u, 4096u}) {
+            pyro::ImageDesc desc{};
+            desc.extent = {size, size};
+            desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+            desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+            desc.mip_levels = static_cast<uint32_t>(std::floor(std::log2(size))) + 1;
+            const pyro::VulkanImage source(&device, desc);
+            const std::vector<uint32_t> pixels = test_pattern(size);
+            upload_mipped(device, source, pixels);
+
+            std::vector<double> samples;
+            std::unique_ptr<pyro::VulkanImage> encoded;
+            for (uint32_t i = 0; i < WARMUP_ITERATIONS + ITERATIONS; i++) {
+                descriptors.begin_frame(0);
+                compressor.begin_frame(0);
+                const VkCommandBuffer command_buffer = device.begin_single_time_commands();
+                timer.reset(command_buffer);
+                const uint32_t scope = timer.begin(command_buffer);
+                encoded = compressor.compress_bc1(command_buffer, source);
+                timer.end(command_buffer, scope);
+                device.end_single_time_commands(command_buffer);
+                if (i >= WARMUP_ITERATIONS) {
+                    samples.push_back(timer.resolve(scope).value_or(0.0));
+                }
+            }
+
+            const double mse = bc1_mse(read_back_bc1(device, *encoded).data(), pixels, size);
+            const double psnr = mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : INFINITY;
+            constexpr double mib = 1024.0 * 1024.0;
+            const double rgba_mib = static_cast<double>(source.get_memory_size()) / mib;
+            const double bc1_mib = static_cast<double>(encoded->get_memory_size()) / mib;
+            std::cout << std::format("{:>6} {:>12.4f} {:>10.2f} {:>10.2f} {:>6.1f}x {:>9.2f}\n", size,
+                                     median(samples), rgba_mib, bc1_mib, rgba_mib / bc1_mib, psnr);
+        }
+    }
+} // namespace
+
+int main() {
+    pyro::PyroWindow window(64, 64, "PyroCore mip bench", pyro::WINDOW_HIDDEN | pyro::WINDOW_NOT_RESIZABLE);
+    pyro::VulkanInstance instance;
+    pyro::VulkanDevice device(&instance, &window);
+    pyro::PyroDescriptors descriptors(&device);
+    pyro::PyroMipGenerator generator(&device, &descriptors);
+    pyro::PyroGpuTimer timer(&device);
+
+    std::cout << std::format("{:>6} {:>7} {:>12} {:>12} {:>8}\n", "size", "levels", "blit ms", "compute ms",
+                             "speedup");
+    for (const uint32_t size: {512u, 1024u, 2048u, 4096u}) {
+        pyro::ImageDesc desc{};
+        desc.extent = {size, size};
+        desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+        desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                     VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        desc.mip_levels = static_cast<uint32_t>(std::floor(std::log2(size))) + 1;
+        pyro::VulkanImage image(&device, desc);
+
+        const double blit_ms = time_generation(device, descriptors, generator, timer, image, [&](VkCommandBuffer cmd) {
+            pyro::PyroMipGenerator::generate_blit(cmd, image.get_image(), desc.extent, desc.mip_levels);
+        });
+        double compute_ms = 0.0;
+        if (generator.supports(desc.format, desc.extent)) {
+            compute_ms = time_generation(device, descriptors, generator, timer, image, [&](VkCommandBuffer cmd) {
+                generator.generate(cmd, image.get_image(), desc.format, desc.extent, desc.mip_levels);
+            });
+        }
+        std::cout << std::format("{:>6} {:>7} {:>12.4f} {:>12.4f} {:>7.2f}x\n", size, desc.mip_levels, blit_ms,
+                                 compute_ms, compute_ms > 0.0 ? blit_ms / compute_ms : 0.0);
+    }
+    bench_bc1(device, descriptors, timer);
+    vkDeviceWaitIdle(device.get_logical_device());
+    return 0;
+}
@@ -0,0 +1,209 @@
+//
+// Created by srijan on 2/24/25.
+//
+
+// Pushes QUADS_PER_FRAME sprites spread over a few textures, blend modes and layers through the sprite batch each
+// frame and reports draws per frame against the state changes the same quads would cost in submission order,
+// along with the CPU time spent submitting, sorting, writing and recording them. Run from the build directory so
+// assets/shaders/*.spv resolve.
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../src/core/VulkanDevice.hpp"
+#include "../src/core/VulkanImage.hpp"
+#include "../src/core/VulkanInstance.hpp"
+#include "../src/descriptor/PyroDescriptors.hpp"
+#include "../src/renderer/PyroSpriteBatch.hpp"
+#include "../src/window/PyroWindow.hpp"
+
+namespace {
+    constexpr uint32_t WARMUP_ITERATIONS = 5;
+    constexpr uint32_t ITERATIONS = 30;
+    constexpr uint32_t QUADS_PER_FRAME = 1 << 20;
+    constexpr uint32_t TEXTURE_COUNT = 8;
+    constexpr uint32_t LAYER_COUNT = 4;
+    constexpr VkExtent2D TARGET_EXTENT = {1920, 1080};
+
+    double median(std::vector<double> samples) {
+        std::ranges::sort(samples);
+        return samples[samples.size() / 2];
+    }
+
+    double elapsed_ms(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void transition(const VkCommandBuffer command_buffer, const VkImage image, const VkImageLayout old_layout,
+                    const VkImageLayout new_layout, const VkAccessFlags src_access, const VkAccessFlags dst_access,
+                    const VkPipelineStageFlags src_stage, const VkPipelineStageFlags dst_stage) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = src_access;
+        barrier.dstAccessMask = dst_access;
+        barrier.oldLayout = old_layout;
+        barrier.newLayout = new_layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    // Small solid-colour textures, cleared once and left in SHADER_READ_ONLY_OPTIMAL.
+    std::vector<std::unique_ptr<pyro::VulkanImage>> create_textures(pyro::VulkanDevice &device) {
+        std::vector<std::unique_ptr<pyro::VulkanImage>> textures;
+        const VkCommandBuffer command_buffer = device.begin_single_time_commands();
+        for (uint32_t i = 0; i < TEXTURE_COUNT; i++) {
+            pyro::ImageDesc desc{};
+            desc.extent = {64, 64};
+            desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+            desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+            textures.push_back(std::make_unique<pyro::VulkanImage>(&device, desc));
+            const VkImage image = textures.back()->get_image();
+            transition(command_buffer, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                       VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+            const float shade = static_cast<float>(i + 1) / TEXTURE_COUNT;
+            const VkClearColorValue color{{shade, 1.0f - shade, 0.5f, 1.0f}};
+            const VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            vkCmdClearColorImage(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1, &range);
+            transition(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        }
+        device.end_single_time_commands(command_buffer);
+        return textures;
+    }
+
+    // Quads as a UI or particle system would submit them: textures, blend modes and layers interleaved.
+    std::vector<pyro::Sprite> create_sprites(const std::vector<pyro::SpriteTexture> &textures) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> x(0.0f, static_cast<float>(TARGET_EXTENT.width));
+        std::uniform_real_distribution<float> y(0.0f, static_cast<float>(TARGET_EXTENT.height));
+        std::uniform_real_distribution<float> size(2.0f, 24.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::uniform_int_distribution<uint32_t> pick(0, UINT32_MAX);
+        std::vector<pyro::Sprite> sprites(QUADS_PER_FRAME);
+        for (pyro::Sprite &sprite : sprites) {
+            const uint32_t bits = pick(rng);
+            sprite.position = {x(rng), y(rng)};
+            sprite.size = glm::vec2(size(rng));
+            sprite.color = bits | 0x80000000;
+            sprite.rotation = bits & 1 ? angle(rng) : 0.0f;
+            sprite.texture = textures[(bits >> 1) % TEXTURE_COUNT];
+            sprite.layer = static_cast<uint8_t>((bits >> 8) % LAYER_COUNT);
+            sprite.blend = bits & 0x10000 ? pyro::PipelineBlendMode::ADDITIVE : pyro::PipelineBlendMode::ALPHA;
+        }
+        return sprites;
+    }
+
+    // Draws an unsorted batcher would issue: one per change of pipeline or texture in submission order.
+    uint32_t submission_order_draws(const std::vector<pyro::Sprite> &sprites) {
+        uint32_t draws = sprites.empty() ? 0 : 1;
+        for (size_t i = 1; i < sprites.size(); i++) {
+            draws += sprites[i].texture != sprites[i - 1].texture || sprites[i].blend != sprites[i - 1].blend;
+        }
+        return draws;
+    }
+} // namespace
+
+int main() {
+    pyro::PyroWindow window(64, 64, "PyroCore sprite bench", pyro::WINDOW_HIDDEN | pyro::WINDOW_NOT_RESIZABLE);
+    pyro::VulkanInstance instance;
+    pyro::VulkanDevice device(&instance, &window);
+    pyro::PyroDescriptors descriptors(&device);
+
+    pyro::SpriteBatchConfig config{};
+    config.max_quads = QUADS_PER_FRAME;
+    pyro::PyroSpriteBatch batch(&device, &descriptors, config);
+
+    const std::vector<std::unique_ptr<pyro::VulkanImage>> textures = create_textures(device);
+    std::vector<pyro::SpriteTexture> texture_ids;
+    for (const auto &texture : textures) {
+        texture_ids.push_back(batch.register_texture(texture->get_view()));
+    }
+    const std::vector<pyro::Sprite> sprites = create_sprites(texture_ids);
+
+    pyro::ImageDesc target_desc{};
+    target_desc.extent = TARGET_EXTENT;
+    target_desc.format = device.get_swap_chain_image_format();
+    target_desc.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    const pyro::VulkanImage target(&device, target_desc);
+    const VkCommandBuffer setup = device.begin_single_time_commands();
+    transition(setup, target.get_image(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 0,
+               VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+    device.end_single_time_commands(setup);
+
+    std::vector<double> submit_samples;
+    std::vector<double> sort_samples;
+    std::vector<double> write_samples;
+    std::vector<double> record_samples;
+    std::vector<double> cpu_samples;
+    pyro::SpriteBatchStats stats{};
+    for (uint32_t i = 0; i < WARMUP_ITERATIONS + ITERATIONS; i++) {
+        // Each frame is waited on before the next, so slot 0 is always free.
+        descriptors.begin_frame(0);
+        batch.begin_frame(0);
+        const VkCommandBuffer command_buffer = device.begin_single_time_commands();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (const pyro::Sprite &sprite : sprites) {
+            batch.draw(sprite);
+        }
+        const double submit_ms = elapsed_ms(start);
+
+        VkRenderingAttachmentInfo color{};
+        color.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        color.imageView = target.get_view();
+        color.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        VkRenderingInfo rendering_info{};
+        rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        rendering_info.renderArea = {{0, 0}, TARGET_EXTENT};
+        rendering_info.layerCount = 1;
+        rendering_info.colorAttachmentCount = 1;
+        rendering_info.pColorAttachments = &color;
+        vkCmdBeginRendering(command_buffer, &rendering_info);
+        const VkViewport viewport{0.0f, 0.0f, static_cast<float>(TARGET_EXTENT.width),
+                                  static_cast<float>(TARGET_EXTENT.height), 0.0f, 1.0f};
+        vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+        const VkRect2D scissor{{0, 0}, TARGET_EXTENT};
+        vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+        const auto record_start = std::chrono::steady_clock::now();
+        batch.record(command_buffer, TARGET_EXTENT);
+        const double record_ms = elapsed_ms(record_start);
+        const double cpu_ms = elapsed_ms(start);
+        vkCmdEndRendering(command_buffer);
+        device.end_single_time_commands(command_buffer);
+
+        if (i >= WARMUP_ITERATIONS) {
+            stats = batch.get_stats();
+            submit_samples.push_back(submit_ms);
+            sort_samples.push_back(stats.sort_ms);
+            write_samples.push_back(stats.write_ms);
+            record_samples.push_back(record_ms);
+            cpu_samples.push_back(cpu_ms);
+        }
+    }
+
+    std::cout << std::format("{:<32} {:>10}\n", "quads per frame", stats.quads);
+    std::cout << std::format("{:<32} {:>10}\n", "draws per frame", stats.draws);
+    std::cout << std::format("{:<32} {:>10}\n", "draws in submission order", submission_order_draws(sprites));
+    std::cout << std::format("{:<32} {:>10}\n", "pipeline binds", stats.pipeline_binds);
+    std::cout << std::format("{:<32} {:>10}\n", "texture binds", stats.texture_binds);
+    std::cout << std::format("{:<32} {:>10.3f} ms\n", "submit (draw calls)", median(submit_samples));
+    std::cout << std::format("{:<32} {:>10.3f} ms\n", "radix sort", median(sort_samples));
+    std::cout << std::format("{:<32} {:>10.3f} ms\n", "vertex write", median(write_samples));
+    std::cout << std::format("{:<32} {:>10.3f} ms\n", "record (sort + write + draws)", median(record_samples));
+    std::cout << std::format("{:<32} {:>10.3f} ms\n", "CPU total", median(cpu_samples));
+    vkDeviceWaitIdle(device.get_logical_device());
+    return 0;
+}
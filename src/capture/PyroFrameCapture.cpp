@@ -0,0 +1,194 @@
+//
+// Created by srijan on 3/8/25.
+//
+
+#include "PyroFrameCapture.hpp"
+
+#include <filesystem>
+#include <format>
+
+#include "../profiler/PyroTrace.hpp"
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr VkDeviceSize BYTES_PER_PIXEL = 4;
+
+        // Whether `format` can be captured, and its channel order.
+        bool readable_format(const VkFormat format, bool &bgra) {
+            switch (format) {
+                case VK_FORMAT_B8G8R8A8_SRGB:
+                case VK_FORMAT_B8G8R8A8_UNORM:
+                    bgra = true;
+                    return true;
+                case VK_FORMAT_R8G8B8A8_SRGB:
+                case VK_FORMAT_R8G8B8A8_UNORM:
+                    bgra = false;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    } // namespace
+
+    PyroFrameCapture::PyroFrameCapture(VulkanDevice *device, const VkExtent2D extent, FrameCaptureConfig config) :
+        device(device), extent(extent), config(std::move(config)) {
+        const VkDeviceSize frame_bytes = static_cast<VkDeviceSize>(extent.width) * extent.height * BYTES_PER_PIXEL;
+        slots.resize(std::max(this->config.readback_buffers, 1u));
+        for (ReadbackSlot &slot: slots) {
+            // Cached memory where available: the encoders read every byte back on the CPU.
+            slot.buffer = std::make_unique<VulkanBuffer>(device, frame_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                         VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        }
+        for (uint32_t i = 0; i < std::max(this->config.encoder_threads, 1u); i++) {
+            workers.emplace_back(&PyroFrameCapture::encoder_worker, this);
+        }
+    }
+
+    PyroFrameCapture::~PyroFrameCapture() {
+        // Let in-flight copies land so the last frames still get written.
+        vkDeviceWaitIdle(device->get_logical_device());
+        {
+            std::lock_guard lock(mutex);
+            for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; frame++) {
+                queue_completed(frame);
+            }
+            stopping = true;
+        }
+        job_available.notify_all();
+        for (auto &worker: workers) {
+            worker.join();
+        }
+    }
+
+    void PyroFrameCapture::request_screenshot(const std::string &path) {
+        pending_screenshot = path + PyroImageEncoder::file_extension(config.format);
+    }
+
+    bool PyroFrameCapture::wants_capture() const { return dump_every_frame || !pending_screenshot.empty(); }
+
+    void PyroFrameCapture::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        frame_number++;
+        {
+            std::lock_guard lock(mutex);
+            queue_completed(frame_index);
+        }
+        job_available.notify_all();
+    }
+
+    void PyroFrameCapture::queue_completed(const uint32_t frame) {
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            if (slots[i].state == SlotState::COPYING && slots[i].frame_index == frame) {
+                slots[i].state = SlotState::ENCODING;
+                jobs.push_back(i);
+            }
+        }
+    }
+
+    void PyroFrameCapture::record_copy(const VkCommandBuffer command_buffer, const VkImage image,
+                                       const VkFormat format) {
+        bool bgra = false;
+        if (!readable_format(format, bgra)) {
+            if (!warned_unsupported) {
+                LOG(LogLevel::WARNING, "Frame capture does not support format {}", static_cast<int>(format));
+                warned_unsupported = true;
+            }
+            pending_screenshot.clear();
+            return;
+        }
+        std::string path = pending_screenshot.empty()
+                                   ? std::format("{}/frame_{:06}{}", config.directory, frame_number,
+                                                 PyroImageEncoder::file_extension(config.format))
+                                   : std::move(pending_screenshot);
+        pending_screenshot.clear();
+
+        ReadbackSlot *slot = nullptr;
+        {
+            std::lock_guard lock(mutex);
+            for (ReadbackSlot &candidate: slots) {
+                if (candidate.state == SlotState::FREE) {
+                    slot = &candidate;
+                    break;
+                }
+            }
+            if (!slot) {
+                stats.dropped++;
+                return;
+            }
+            slot->state = SlotState::COPYING;
+            slot->frame_index = frame_index;
+            slot->bgra = bgra;
+            slot->path = std::move(path);
+        }
+
+        VkBufferImageCopy region{};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {extent.width, extent.height, 1};
+        vkCmdCopyImageToBuffer(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot->buffer->get_buffer(),
+                               1, &region);
+
+        VkBufferMemoryBarrier2 host_barrier{};
+        host_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        host_barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        host_barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        host_barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+        host_barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+        host_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        host_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        host_barrier.buffer = slot->buffer->get_buffer();
+        host_barrier.size = VK_WHOLE_SIZE;
+        VkDependencyInfo dependency{};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.bufferMemoryBarrierCount = 1;
+        dependency.pBufferMemoryBarriers = &host_barrier;
+        vkCmdPipelineBarrier2(command_buffer, &dependency);
+    }
+
+    FrameCaptureStats PyroFrameCapture::get_stats() const {
+        std::lock_guard lock(mutex);
+        FrameCaptureStats current = stats;
+        current.busy_buffers = 0;
+        for (const ReadbackSlot &slot: slots) {
+            current.busy_buffers += slot.state != SlotState::FREE;
+        }
+        return current;
+    }
+
+    void PyroFrameCapture::encoder_worker() {
+        PyroTrace::get_instance().set_thread_name("capture encoder");
+        while (true) {
+            std::unique_lock lock(mutex);
+            job_available.wait(lock, [&] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            ReadbackSlot &slot = slots[jobs.front()];
+            jobs.pop_front();
+            lock.unlock();
+
+            bool written;
+            {
+                PYRO_ZONE("encode_frame");
+                slot.buffer->invalidate();
+                const CapturedImage image{static_cast<const uint8_t *>(slot.buffer->get_mapped()), extent.width,
+                                          extent.height, slot.bgra};
+                const std::filesystem::path path(slot.path);
+                std::error_code error;
+                if (path.has_parent_path()) {
+                    std::filesystem::create_directories(path.parent_path(), error);
+                }
+                written = PyroImageEncoder::write_file(slot.path, PyroImageEncoder::encode(image, config.format));
+            }
+            if (!written) {
+                LOG(LogLevel::WARNING, "Failed to write captured frame {}", slot.path);
+            }
+
+            lock.lock();
+            (written ? stats.written : stats.failed)++;
+            slot.state = SlotState::FREE;
+        }
+    }
+} // namespace pyro
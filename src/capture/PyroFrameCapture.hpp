@@ -0,0 +1,103 @@
+//
+// Created by srijan on 3/8/25.
+//
+
+#ifndef PYROFRAMECAPTURE_HPP
+#define PYROFRAMECAPTURE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanBuffer.hpp"
+#include "PyroImageEncoder.hpp"
+
+namespace pyro {
+
+    struct FrameCaptureConfig {
+        CaptureFormat format = CaptureFormat::PNG;
+        // Where dumped frames go, as frame_000042.png etc.
+        std::string directory = "captures";
+        // Host-visible buffers frames are copied into. A frame holds its buffer from the copy until its file is
+        // written, so this bounds how far encoding may trail rendering before frames are dropped.
+        uint32_t readback_buffers = MAX_FRAMES_IN_FLIGHT + 2;
+        uint32_t encoder_threads = 2;
+    };
+
+    struct FrameCaptureStats {
+        uint64_t written = 0;
+        // Frames skipped because every readback buffer was still busy.
+        uint64_t dropped = 0;
+        uint64_t failed = 0;
+        uint32_t busy_buffers = 0;
+    };
+
+    // Asynchronous frame readback. record_copy() copies the back buffer into a free buffer of a host-visible
+    // ring; once that frame slot's fence has signalled (begin_frame() for the same slot, MAX_FRAMES_IN_FLIGHT
+    // frames later) the buffer goes to encoder threads, which convert and write it straight from the mapping and
+    // then return it to the ring. The render loop never waits on the GPU or the encoder: with no free buffer a
+    // frame is dropped and counted instead.
+    //
+    // Needs a back buffer created with VK_IMAGE_USAGE_TRANSFER_SRC_BIT in an 8-bit RGBA or BGRA format.
+    class PyroFrameCapture {
+    public:
+        PyroFrameCapture(VulkanDevice *device, VkExtent2D extent, FrameCaptureConfig config = {});
+        ~PyroFrameCapture();
+        PyroFrameCapture(const PyroFrameCapture &) = delete;
+        PyroFrameCapture &operator=(const PyroFrameCapture &) = delete;
+
+        // Captures the next rendered frame to `path`; the format's extension is appended.
+        void request_screenshot(const std::string &path);
+        // Captures every frame into the configured directory until turned off.
+        void set_dump_every_frame(bool enabled) { dump_every_frame = enabled; }
+        bool is_dumping_every_frame() const { return dump_every_frame; }
+        bool wants_capture() const;
+
+        // Hands the readbacks recorded the last time `frame_index` was used to the encoders; call once the slot's
+        // fence has signalled.
+        void begin_frame(uint32_t frame_index);
+        // Copies `image` (in TRANSFER_SRC_OPTIMAL) into a free readback buffer and makes it visible to the host.
+        void record_copy(VkCommandBuffer command_buffer, VkImage image, VkFormat format);
+
+        FrameCaptureStats get_stats() const;
+
+    private:
+        enum class SlotState { FREE, COPYING, ENCODING };
+        struct ReadbackSlot {
+            std::unique_ptr<VulkanBuffer> buffer;
+            SlotState state = SlotState::FREE;
+            uint32_t frame_index = 0;
+            bool bgra = false;
+            std::string path;
+        };
+
+        VulkanDevice *device;
+        VkExtent2D extent;
+        FrameCaptureConfig config;
+        uint32_t frame_index = 0;
+        uint64_t frame_number = 0;
+        std::string pending_screenshot;
+        bool dump_every_frame = false;
+        bool warned_unsupported = false;
+
+        std::vector<ReadbackSlot> slots;
+        std::deque<uint32_t> jobs;
+        std::vector<std::thread> workers;
+        mutable std::mutex mutex;
+        std::condition_variable job_available;
+        bool stopping = false;
+        FrameCaptureStats stats;
+
+        void encoder_worker();
+        // Queues every slot copied in `frame` for encoding; the caller holds the mutex.
+        void queue_completed(uint32_t frame);
+    };
+
+} // namespace pyro
+
+#endif // PYROFRAMECAPTURE_HPP
@@ -0,0 +1,171 @@
+//
+// Created by srijan on 3/8/25.
+//
+
+#include "PyroImageEncoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace pyro {
+    namespace {
+        // Stored deflate blocks carry at most this many bytes each.
+        constexpr size_t MAX_STORED_BLOCK = 65535;
+
+        const std::array<uint32_t, 256> &crc_table() {
+            static const std::array<uint32_t, 256> table = [] {
+                std::array<uint32_t, 256> entries{};
+                for (uint32_t n = 0; n < 256; n++) {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; k++) {
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    }
+                    entries[n] = c;
+                }
+                return entries;
+            }();
+            return table;
+        }
+
+        uint32_t crc32(const uint8_t *data, const size_t size) {
+            const std::array<uint32_t, 256> &table = crc_table();
+            uint32_t c = 0xFFFFFFFFu;
+            for (size_t i = 0; i < size; i++) {
+                c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+            }
+            return c ^ 0xFFFFFFFFu;
+        }
+
+        uint32_t adler32(const std::vector<uint8_t> &data) {
+            constexpr uint32_t modulus = 65521;
+            uint32_t a = 1;
+            uint32_t b = 0;
+            for (const uint8_t byte : data) {
+                a = (a + byte) % modulus;
+                b = (b + a) % modulus;
+            }
+            return (b << 16) | a;
+        }
+
+        void put_u32_be(std::vector<uint8_t> &out, const uint32_t value) {
+            out.push_back(static_cast<uint8_t>(value >> 24));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        void put_chunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+            put_u32_be(out, static_cast<uint32_t>(data.size()));
+            const size_t type_offset = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+            put_u32_be(out, crc32(out.data() + type_offset, out.size() - type_offset));
+        }
+
+        // Red, green and blue of pixel `index`, whatever the channel order.
+        std::array<int, 3> rgb(const CapturedImage &image, const size_t index) {
+            const uint8_t *pixel = image.pixels + index * 4;
+            return image.bgra ? std::array<int, 3>{pixel[2], pixel[1], pixel[0]}
+                              : std::array<int, 3>{pixel[0], pixel[1], pixel[2]};
+        }
+    } // namespace
+
+    std::vector<uint8_t> PyroImageEncoder::encode(const CapturedImage &image, const CaptureFormat format) {
+        return format == CaptureFormat::PNG ? encode_png(image) : encode_yuv420(image);
+    }
+
+    std::vector<uint8_t> PyroImageEncoder::encode_png(const CapturedImage &image) {
+        // Scanlines with filter type 0 (none) in front of each row.
+        std::vector<uint8_t> scanlines;
+        scanlines.reserve((static_cast<size_t>(image.width) * 3 + 1) * image.height);
+        for (uint32_t y = 0; y < image.height; y++) {
+            scanlines.push_back(0);
+            for (uint32_t x = 0; x < image.width; x++) {
+                const auto [r, g, b] = rgb(image, static_cast<size_t>(y) * image.width + x);
+                scanlines.push_back(static_cast<uint8_t>(r));
+                scanlines.push_back(static_cast<uint8_t>(g));
+                scanlines.push_back(static_cast<uint8_t>(b));
+            }
+        }
+
+        // zlib stream of stored deflate blocks.
+        std::vector<uint8_t> idat = {0x78, 0x01};
+        idat.reserve(scanlines.size() + scanlines.size() / MAX_STORED_BLOCK * 5 + 16);
+        size_t offset = 0;
+        do {
+            const size_t length = std::min(MAX_STORED_BLOCK, scanlines.size() - offset);
+            const bool last = offset + length == scanlines.size();
+            idat.push_back(last ? 1 : 0);
+            idat.push_back(static_cast<uint8_t>(length));
+            idat.push_back(static_cast<uint8_t>(length >> 8));
+            idat.push_back(static_cast<uint8_t>(~length));
+            idat.push_back(static_cast<uint8_t>(~length >> 8));
+            idat.insert(idat.end(), scanlines.begin() + static_cast<ptrdiff_t>(offset),
+                        scanlines.begin() + static_cast<ptrdiff_t>(offset + length));
+            offset += length;
+        } while (offset < scanlines.size());
+        put_u32_be(idat, adler32(scanlines));
+
+        std::vector<uint8_t> header;
+        put_u32_be(header, image.width);
+        put_u32_be(header, image.height);
+        // 8-bit truecolour, deflate, adaptive filtering, no interlace.
+        header.insert(header.end(), {8, 2, 0, 0, 0});
+
+        std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        png.reserve(idat.size() + 64);
+        put_chunk(png, "IHDR", header);
+        put_chunk(png, "IDAT", idat);
+        put_chunk(png, "IEND", {});
+        return png;
+    }
+
+    std::vector<uint8_t> PyroImageEncoder::encode_yuv420(const CapturedImage &image) {
+        const uint32_t width = image.width & ~1u;
+        const uint32_t height = image.height & ~1u;
+        const size_t luma_size = static_cast<size_t>(width) * height;
+        std::vector<uint8_t> yuv(luma_size + luma_size / 2);
+        uint8_t *luma = yuv.data();
+        uint8_t *cb = luma + luma_size;
+        uint8_t *cr = cb + luma_size / 4;
+        // BT.709 limited range in 8.8 fixed point; chroma from the average of each 2x2 block.
+        for (uint32_t y = 0; y < height; y += 2) {
+            for (uint32_t x = 0; x < width; x += 2) {
+                int r_sum = 0;
+                int g_sum = 0;
+                int b_sum = 0;
+                for (uint32_t dy = 0; dy < 2; dy++) {
+                    for (uint32_t dx = 0; dx < 2; dx++) {
+                        const auto [r, g, b] = rgb(image, static_cast<size_t>(y + dy) * image.width + x + dx);
+                        luma[static_cast<size_t>(y + dy) * width + x + dx] =
+                                static_cast<uint8_t>(((47 * r + 157 * g + 16 * b + 128) >> 8) + 16);
+                        r_sum += r;
+                        g_sum += g;
+                        b_sum += b;
+                    }
+                }
+                const int r = r_sum / 4;
+                const int g = g_sum / 4;
+                const int b = b_sum / 4;
+                const size_t chroma = static_cast<size_t>(y / 2) * (width / 2) + x / 2;
+                cb[chroma] = static_cast<uint8_t>(((-26 * r - 87 * g + 112 * b + 128) >> 8) + 128);
+                cr[chroma] = static_cast<uint8_t>(((112 * r - 102 * g - 10 * b + 128) >> 8) + 128);
+            }
+        }
+        return yuv;
+    }
+
+    const char *PyroImageEncoder::file_extension(const CaptureFormat format) {
+        return format == CaptureFormat::PNG ? ".png" : ".yuv";
+    }
+
+    bool PyroImageEncoder::write_file(const std::string &path, const std::vector<uint8_t> &data) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    }
+} // namespace pyro
@@ -0,0 +1,44 @@
+//
+// Created by srijan on 3/8/25.
+//
+
+#ifndef PYROIMAGEENCODER_HPP
+#define PYROIMAGEENCODER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pyro {
+
+    enum class CaptureFormat {
+        // Lossless 8-bit RGB, for screenshots and golden-image comparisons.
+        PNG,
+        // Planar 4:2:0 (I420), BT.709 limited range: the frame as raw video, e.g.
+        // `ffmpeg -f rawvideo -pix_fmt yuv420p -s WxH -i frame.yuv`. Odd sizes are rounded down to even.
+        YUV420,
+    };
+
+    // Tightly packed 4-byte pixels as read back from an 8-bit RGBA or BGRA image; alpha is ignored.
+    struct CapturedImage {
+        const uint8_t *pixels = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        bool bgra = false;
+    };
+
+    // CPU encoders for read-back frames. Self-contained so they run on any worker thread without extra
+    // dependencies; the PNG writer stores its deflate stream uncompressed, trading file size for encode speed.
+    class PyroImageEncoder {
+    public:
+        static std::vector<uint8_t> encode(const CapturedImage &image, CaptureFormat format);
+        static std::vector<uint8_t> encode_png(const CapturedImage &image);
+        static std::vector<uint8_t> encode_yuv420(const CapturedImage &image);
+        static const char *file_extension(CaptureFormat format);
+        // Returns false when the file can't be written.
+        static bool write_file(const std::string &path, const std::vector<uint8_t> &data);
+    };
+
+} // namespace pyro
+
+#endif // PYROIMAGEENCODER_HPP
@@ -0,0 +1,95 @@
+//
+// Created by srijan on 2/21/25.
+//
+
+#include "PyroAsyncCompute.hpp"
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    PyroAsyncCompute::PyroAsyncCompute(VulkanDevice *device) : device(device), timeline(device) {
+        VkCommandBufferAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = device->get_compute_command_pool();
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc_info.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+        ASSERT_EQUAL(vkAllocateCommandBuffers(device->get_logical_device(), &alloc_info, command_buffers.data()),
+                     VK_SUCCESS, "Failed to allocate compute command buffers")
+    }
+
+    PyroAsyncCompute::~PyroAsyncCompute() {
+        timeline.wait(get_last_submitted());
+        vkFreeCommandBuffers(device->get_logical_device(), device->get_compute_command_pool(), MAX_FRAMES_IN_FLIGHT,
+                             command_buffers.data());
+    }
+
+    VkCommandBuffer PyroAsyncCompute::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        timeline.wait(frame_values[frame_index]);
+        const VkCommandBuffer command_buffer = command_buffers[frame_index];
+        vkResetCommandBuffer(command_buffer, 0);
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        ASSERT_EQUAL(vkBeginCommandBuffer(command_buffer, &begin_info), VK_SUCCESS,
+                     "Failed to begin recording compute command buffer")
+        return command_buffer;
+    }
+
+    uint64_t PyroAsyncCompute::submit(QueueSubmission sync) {
+        const VkCommandBuffer command_buffer = command_buffers[frame_index];
+        ASSERT_EQUAL(vkEndCommandBuffer(command_buffer), VK_SUCCESS, "Failed to record compute command buffer")
+        const uint64_t value = next_value++;
+        sync.signal(timeline.get_semaphore(), value);
+        ASSERT_EQUAL(sync.submit(device->get_compute_queue(), &command_buffer, 1), VK_SUCCESS,
+                     "Failed to submit compute command buffer")
+        frame_values[frame_index] = value;
+        return value;
+    }
+
+    void PyroAsyncCompute::wait_before(QueueSubmission &graphics, const uint64_t value,
+                                       const VkPipelineStageFlags stage) const {
+        graphics.wait(timeline.get_semaphore(), stage, value);
+    }
+
+    bool PyroAsyncCompute::needs_ownership_transfer() const {
+        const QueueFamilyIndices indices = device->get_indices();
+        return indices.compute_family_index != indices.graphics_family_index;
+    }
+
+    VkBufferMemoryBarrier PyroAsyncCompute::ownership_barrier(const VkBuffer buffer) const {
+        const QueueFamilyIndices indices = device->get_indices();
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = indices.compute_family_index.value();
+        barrier.dstQueueFamilyIndex = indices.graphics_family_index.value();
+        barrier.buffer = buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        return barrier;
+    }
+
+    void PyroAsyncCompute::release_buffer(const VkCommandBuffer command_buffer, const VkBuffer buffer,
+                                          const VkAccessFlags src_access) const {
+        if (!needs_ownership_transfer()) {
+            return;
+        }
+        VkBufferMemoryBarrier barrier = ownership_barrier(buffer);
+        barrier.srcAccessMask = src_access;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0, 0, nullptr, 1, &barrier, 0, nullptr);
+    }
+
+    void PyroAsyncCompute::acquire_buffer(const VkCommandBuffer command_buffer, const VkBuffer buffer,
+                                          const VkPipelineStageFlags dst_stage, const VkAccessFlags dst_access) const {
+        if (!needs_ownership_transfer()) {
+            return;
+        }
+        VkBufferMemoryBarrier barrier = ownership_barrier(buffer);
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = dst_access;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dst_stage, 0, 0, nullptr, 1, &barrier,
+                             0, nullptr);
+    }
+} // namespace pyro
@@ -0,0 +1,60 @@
+//
+// Created by srijan on 2/21/25.
+//
+
+#ifndef PYROASYNCCOMPUTE_HPP
+#define PYROASYNCCOMPUTE_HPP
+
+#include <array>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+#include "../core/VulkanTimelineSemaphore.hpp"
+
+namespace pyro {
+
+    // Per-frame command buffers on the device's compute queue. Every submit() signals the next value of one
+    // timeline semaphore. A graphics submission that consumes the results calls wait_before() with that value,
+    // so culling, simulation or post-processing overlaps whatever graphics work does not depend on it. Without a
+    // separate compute queue, the same calls simply run on the graphics queue.
+    class PyroAsyncCompute {
+    public:
+        explicit PyroAsyncCompute(VulkanDevice *device);
+        ~PyroAsyncCompute();
+        PyroAsyncCompute(const PyroAsyncCompute &) = delete;
+        PyroAsyncCompute &operator=(const PyroAsyncCompute &) = delete;
+
+        // Waits for the previous submission from this frame slot, then starts recording its command buffer.
+        VkCommandBuffer begin_frame(uint32_t frame_index);
+        // Ends and submits the current command buffer after the waits in `sync`. Returns the timeline value
+        // signalled on completion.
+        uint64_t submit(QueueSubmission sync = {});
+        // Makes `graphics` wait at `stage` until the compute submission that returned `value` has completed.
+        void wait_before(QueueSubmission &graphics, uint64_t value, VkPipelineStageFlags stage) const;
+
+        // Queue family ownership transfer for an exclusive buffer written here and read on the graphics queue:
+        // record release_buffer() last in the compute command buffer and acquire_buffer() in the graphics one
+        // before the first read. Both do nothing when the two queues share a family.
+        void release_buffer(VkCommandBuffer command_buffer, VkBuffer buffer, VkAccessFlags src_access) const;
+        void acquire_buffer(VkCommandBuffer command_buffer, VkBuffer buffer, VkPipelineStageFlags dst_stage,
+                            VkAccessFlags dst_access) const;
+
+        bool is_async() const { return device->has_async_compute(); }
+        const VulkanTimelineSemaphore &get_timeline() const { return timeline; }
+        uint64_t get_last_submitted() const { return next_value - 1; }
+
+    private:
+        VulkanDevice *device;
+        VulkanTimelineSemaphore timeline;
+        std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> command_buffers{};
+        std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> frame_values{};
+        uint32_t frame_index = 0;
+        uint64_t next_value = 1;
+
+        bool needs_ownership_transfer() const;
+        VkBufferMemoryBarrier ownership_barrier(VkBuffer buffer) const;
+    };
+
+} // namespace pyro
+
+#endif // PYROASYNCCOMPUTE_HPP
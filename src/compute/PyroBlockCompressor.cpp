@@ -0,0 +1,172 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+#include "PyroBlockCompressor.hpp"
+
+#include <algorithm>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t BC1_BLOCK_BYTES = 8;
+        constexpr uint32_t LOCAL_SIZE = 8;
+
+        PyroDescriptorBindings encoder_bindings(const VkImageView source, const VkBuffer blocks) {
+            PyroDescriptorBindings bindings;
+            bindings.bind_image(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, source,
+                                VK_NULL_HANDLE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            bindings.bind_buffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, blocks, 0,
+                                 VK_WHOLE_SIZE);
+            return bindings;
+        }
+    } // namespace
+
+    PyroBlockCompressor::PyroBlockCompressor(VulkanDevice *device, PyroDescriptors *descriptors) :
+        device(device), descriptors(descriptors) {
+        ASSERT_EQUAL(is_supported(device), true, "BC1 encoding needs textureCompressionBC")
+        pipeline = std::make_unique<PyroComputePipeline>(
+                device, "assets/shaders/bc1_encode.comp.spv",
+                std::vector{descriptors->get_layout(encoder_bindings(VK_NULL_HANDLE, VK_NULL_HANDLE))},
+                std::vector{VkPushConstantRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Params)}});
+    }
+
+    void PyroBlockCompressor::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        retired_buffers[frame_index].clear();
+        retired_images[frame_index].clear();
+    }
+
+    std::unique_ptr<VulkanImage> PyroBlockCompressor::compress_bc1(const VkCommandBuffer command_buffer,
+                                                                   const VulkanImage &source) {
+        ASSERT_EQUAL(source.get_desc().format, VK_FORMAT_R8G8B8A8_UNORM, "BC1 encoding expects an RGBA8 source")
+        ImageDesc desc = source.get_desc();
+        desc.format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        auto image = std::make_unique<VulkanImage>(device, desc);
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image->get_image();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, desc.mip_levels, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+
+        encode(command_buffer, source, *image, 0);
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+        return image;
+    }
+
+    void PyroBlockCompressor::upload_bc1(const VkCommandBuffer command_buffer, const VkBuffer buffer,
+                                         const std::span<const VkBufferImageCopy> regions, const VulkanImage &target,
+                                         const uint32_t target_level) {
+        ASSERT_EQUAL(target.get_desc().format, VK_FORMAT_BC1_RGB_UNORM_BLOCK, "BC1 upload expects a BC1 target")
+        // The shader samples its source, so the RGBA8 levels go through a scratch image first.
+        ImageDesc desc{};
+        desc.extent = {regions[0].imageExtent.width, regions[0].imageExtent.height};
+        desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+        desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        desc.mip_levels = static_cast<uint32_t>(regions.size());
+        auto scratch = std::make_unique<VulkanImage>(device, desc);
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = scratch->get_image();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, desc.mip_levels, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+        std::vector scratch_regions(regions.begin(), regions.end());
+        for (uint32_t level = 0; level < scratch_regions.size(); level++) {
+            scratch_regions[level].imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+        }
+        vkCmdCopyBufferToImage(command_buffer, buffer, scratch->get_image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(scratch_regions.size()), scratch_regions.data());
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+
+        encode(command_buffer, *scratch, target, target_level);
+        retired_images[frame_index].push_back(std::move(scratch));
+    }
+
+    void PyroBlockCompressor::encode(const VkCommandBuffer command_buffer, const VulkanImage &source,
+                                     const VulkanImage &target, const uint32_t target_level) {
+        const ImageDesc &source_desc = source.get_desc();
+        std::vector<uint32_t> first_blocks;
+        uint32_t block_total = 0;
+        for (uint32_t level = 0; level < source_desc.mip_levels; level++) {
+            const uint32_t width = std::max(source_desc.extent.width >> level, 1u);
+            const uint32_t height = std::max(source_desc.extent.height >> level, 1u);
+            first_blocks.push_back(block_total);
+            block_total += ((width + 3) / 4) * ((height + 3) / 4);
+        }
+        auto blocks = std::make_unique<VulkanBuffer>(device, static_cast<VkDeviceSize>(block_total) * BC1_BLOCK_BYTES,
+                                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        pipeline->bind(command_buffer);
+        pipeline->bind_set(command_buffer, 0,
+                           descriptors->allocate_transient(encoder_bindings(source.get_view(), blocks->get_buffer())));
+        for (uint32_t level = 0; level < source_desc.mip_levels; level++) {
+            const uint32_t width = std::max(source_desc.extent.width >> level, 1u);
+            const uint32_t height = std::max(source_desc.extent.height >> level, 1u);
+            const Params params{static_cast<int32_t>(width), static_cast<int32_t>(height), static_cast<int32_t>(level),
+                                first_blocks[level]};
+            pipeline->push_constants(command_buffer, &params, sizeof(params));
+            PyroComputePipeline::dispatch(command_buffer,
+                                          PyroComputePipeline::group_count((width + 3) / 4, LOCAL_SIZE),
+                                          PyroComputePipeline::group_count((height + 3) / 4, LOCAL_SIZE));
+        }
+
+        VkBufferMemoryBarrier buffer_barrier{};
+        buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        buffer_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        buffer_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        buffer_barrier.buffer = blocks->get_buffer();
+        buffer_barrier.offset = 0;
+        buffer_barrier.size = VK_WHOLE_SIZE;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                             0, nullptr, 1, &buffer_barrier, 0, nullptr);
+
+        std::vector<VkBufferImageCopy> regions;
+        for (uint32_t level = 0; level < source_desc.mip_levels; level++) {
+            VkBufferImageCopy region{};
+            region.bufferOffset = static_cast<VkDeviceSize>(first_blocks[level]) * BC1_BLOCK_BYTES;
+            region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, target_level + level, 0, 1};
+            region.imageExtent = {std::max(source_desc.extent.width >> level, 1u),
+                                  std::max(source_desc.extent.height >> level, 1u), 1};
+            regions.push_back(region);
+        }
+        vkCmdCopyBufferToImage(command_buffer, blocks->get_buffer(), target.get_image(),
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()),
+                               regions.data());
+        retired_buffers[frame_index].push_back(std::move(blocks));
+    }
+} // namespace pyro
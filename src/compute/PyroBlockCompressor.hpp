@@ -0,0 +1,70 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+#ifndef PYROBLOCKCOMPRESSOR_HPP
+#define PYROBLOCKCOMPRESSOR_HPP
+
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanBuffer.hpp"
+#include "../core/VulkanImage.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "PyroComputePipeline.hpp"
+
+namespace pyro {
+
+    // Runtime BC1 encoder (assets/shaders/bc1_encode.comp). Encodes every level of an RGBA8 image into a
+    // scratch buffer, then copies the blocks into a BC1 image: 4 bits per texel instead of 32, so textures
+    // generated or uploaded at runtime take an eighth of the memory and sampling bandwidth. Alpha is dropped.
+    // PyroTextureStreamer encodes RGBA8 uploads through upload_bc1() when TextureStreamingConfig::encode_rgba8
+    // is set.
+    class PyroBlockCompressor {
+    public:
+        static bool is_supported(const VulkanDevice *device) {
+            return device->get_capabilities().texture_compression_bc;
+        }
+
+        PyroBlockCompressor(VulkanDevice *device, PyroDescriptors *descriptors);
+        PyroBlockCompressor(const PyroBlockCompressor &) = delete;
+        PyroBlockCompressor &operator=(const PyroBlockCompressor &) = delete;
+
+        // `source` must be R8G8B8A8_UNORM with every level in SHADER_READ_ONLY_OPTIMAL and stay alive until the
+        // command buffer has executed. The returned BC1_RGB_UNORM image ends up in SHADER_READ_ONLY_OPTIMAL.
+        std::unique_ptr<VulkanImage> compress_bc1(VkCommandBuffer command_buffer, const VulkanImage &source);
+        // Encodes RGBA8_UNORM levels on their way from `buffer` to the GPU: `regions` hold consecutive levels,
+        // finest first (their mip levels are ignored), and land in `target` from `target_level` on. `target` must
+        // be BC1 with matching extents and in TRANSFER_DST_OPTIMAL, where it is left.
+        void upload_bc1(VkCommandBuffer command_buffer, VkBuffer buffer, std::span<const VkBufferImageCopy> regions,
+                        const VulkanImage &target, uint32_t target_level);
+        // Frees the scratch buffers and images used MAX_FRAMES_IN_FLIGHT frames ago.
+        void begin_frame(uint32_t frame_index);
+
+    private:
+        struct Params {
+            int32_t width;
+            int32_t height;
+            int32_t level;
+            uint32_t first_block;
+        };
+
+        // Encodes every level of `source` into a scratch buffer and copies the blocks into `target`, which must
+        // already be in TRANSFER_DST_OPTIMAL.
+        void encode(VkCommandBuffer command_buffer, const VulkanImage &source, const VulkanImage &target,
+                    uint32_t target_level);
+
+        VulkanDevice *device;
+        PyroDescriptors *descriptors;
+        std::unique_ptr<PyroComputePipeline> pipeline;
+        uint32_t frame_index = 0;
+        std::array<std::vector<std::unique_ptr<VulkanBuffer>>, MAX_FRAMES_IN_FLIGHT> retired_buffers;
+        std::array<std::vector<std::unique_ptr<VulkanImage>>, MAX_FRAMES_IN_FLIGHT> retired_images;
+    };
+
+} // namespace pyro
+
+#endif // PYROBLOCKCOMPRESSOR_HPP
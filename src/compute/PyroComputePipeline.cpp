@@ -0,0 +1,83 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+#include "PyroComputePipeline.hpp"
+
+#include "../shader/PyroShaderModule.hpp"
+#include "../shader/PyroShaderProgram.hpp"
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    PyroComputePipeline::PyroComputePipeline(VulkanDevice *device, const std::string &path,
+                                             const std::vector<VkDescriptorSetLayout> &set_layouts,
+                                             const std::vector<VkPushConstantRange> &push_constant_ranges) :
+        device(device) {
+        PyroShaderModule computeShader{device, path, PyroShaderModuleType::PYRO_COMPUTE};
+        create(computeShader.getShaderModule(), set_layouts, push_constant_ranges);
+        LOG(LogLevel::DEBUG, "Created compute pipeline from {}", path);
+    }
+
+    PyroComputePipeline::PyroComputePipeline(VulkanDevice *device, const PyroShaderProgram &program,
+                                             const VkSpecializationInfo *specialization,
+                                             const VkPipelineCache pipeline_cache) : device(device) {
+        ASSERT_EQUAL(program.get_stages().size(), 1, "A compute program has exactly one stage")
+        PyroShaderModule computeShader{device, program.get_stages().front().spirv, PyroShaderModuleType::PYRO_COMPUTE};
+        create(computeShader.getShaderModule(), program.get_set_layouts(), program.get_push_constant_ranges(),
+               specialization, pipeline_cache);
+    }
+
+    void PyroComputePipeline::create(const VkShaderModule module, const std::vector<VkDescriptorSetLayout> &set_layouts,
+                                     const std::vector<VkPushConstantRange> &push_constant_ranges,
+                                     const VkSpecializationInfo *specialization,
+                                     const VkPipelineCache pipeline_cache) {
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(set_layouts.size());
+        pipelineLayoutInfo.pSetLayouts = set_layouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size());
+        pipelineLayoutInfo.pPushConstantRanges = push_constant_ranges.data();
+        ASSERT_EQUAL(
+                vkCreatePipelineLayout(device->get_logical_device(), &pipelineLayoutInfo, nullptr, &pipeline_layout),
+                VK_SUCCESS, "Failed to create compute pipeline layout")
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = module;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.stage.pSpecializationInfo = specialization;
+        pipelineInfo.layout = pipeline_layout;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineInfo.basePipelineIndex = -1;
+        ASSERT_EQUAL(vkCreateComputePipelines(device->get_logical_device(), pipeline_cache, 1, &pipelineInfo, nullptr,
+                                              &pipeline),
+                     VK_SUCCESS, "Failed to create compute pipeline")
+    }
+
+    PyroComputePipeline::~PyroComputePipeline() {
+        vkDestroyPipeline(device->get_logical_device(), pipeline, nullptr);
+        vkDestroyPipelineLayout(device->get_logical_device(), pipeline_layout, nullptr);
+    }
+
+    void PyroComputePipeline::bind(const VkCommandBuffer command_buffer) const {
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    }
+
+    void PyroComputePipeline::bind_set(const VkCommandBuffer command_buffer, const uint32_t set_index,
+                                       const VkDescriptorSet set) const {
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, set_index, 1, &set, 0,
+                                nullptr);
+    }
+
+    void PyroComputePipeline::push_constants(const VkCommandBuffer command_buffer, const void *data,
+                                             const uint32_t size) const {
+        vkCmdPushConstants(command_buffer, pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, size, data);
+    }
+
+    void PyroComputePipeline::dispatch(const VkCommandBuffer command_buffer, const uint32_t x, const uint32_t y,
+                                       const uint32_t z) {
+        vkCmdDispatch(command_buffer, x, y, z);
+    }
+} // namespace pyro
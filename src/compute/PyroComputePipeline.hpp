@@ -0,0 +1,53 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+#ifndef PYROCOMPUTEPIPELINE_HPP
+#define PYROCOMPUTEPIPELINE_HPP
+
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+
+namespace pyro {
+    class PyroShaderProgram;
+
+    // A compute pipeline and its layout, built from one SPIR-V module loaded through PyroShaderModule, or from a
+    // PyroShaderProgram whose reflection supplies the layout.
+    class PyroComputePipeline {
+    public:
+        PyroComputePipeline(VulkanDevice *device, const std::string &path,
+                            const std::vector<VkDescriptorSetLayout> &set_layouts = {},
+                            const std::vector<VkPushConstantRange> &push_constant_ranges = {});
+        PyroComputePipeline(VulkanDevice *device, const PyroShaderProgram &program,
+                            const VkSpecializationInfo *specialization = nullptr,
+                            VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+        ~PyroComputePipeline();
+        PyroComputePipeline(const PyroComputePipeline &) = delete;
+        PyroComputePipeline &operator=(const PyroComputePipeline &) = delete;
+
+        void bind(VkCommandBuffer command_buffer) const;
+        void bind_set(VkCommandBuffer command_buffer, uint32_t set_index, VkDescriptorSet set) const;
+        void push_constants(VkCommandBuffer command_buffer, const void *data, uint32_t size) const;
+        static void dispatch(VkCommandBuffer command_buffer, uint32_t x, uint32_t y = 1, uint32_t z = 1);
+        static uint32_t group_count(uint32_t size, uint32_t local_size) { return (size + local_size - 1) / local_size; }
+
+        VkPipeline get_pipeline() const { return pipeline; }
+        VkPipelineLayout get_pipeline_layout() const { return pipeline_layout; }
+
+    private:
+        VulkanDevice *device;
+        VkPipelineLayout pipeline_layout{};
+        VkPipeline pipeline{};
+
+        void create(VkShaderModule module, const std::vector<VkDescriptorSetLayout> &set_layouts,
+                    const std::vector<VkPushConstantRange> &push_constant_ranges,
+                    const VkSpecializationInfo *specialization = nullptr,
+                    VkPipelineCache pipeline_cache = VK_NULL_HANDLE);
+    };
+
+} // namespace pyro
+
+#endif // PYROCOMPUTEPIPELINE_HPP
@@ -0,0 +1,132 @@
+//
+// Created by srijan on 3/2/25.
+//
+
+#include "PyroDepthPyramid.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t TILE_SIZE = 8;
+    } // namespace
+
+    PyroDepthPyramid::PyroDepthPyramid(VulkanDevice *device, PyroDescriptors *descriptors) :
+        device(device), descriptors(descriptors) {
+        layout_bindings.bind_image(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE,
+                                   VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL)
+                .bind_image(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE,
+                            VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+        pipeline = std::make_unique<PyroComputePipeline>(
+                device, "assets/shaders/depth_pyramid.comp.spv",
+                std::vector{descriptors->get_layout(layout_bindings)},
+                std::vector{VkPushConstantRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Params)}});
+        reader_stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        if (device->get_capabilities().mesh_shader) {
+            reader_stages |= VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT;
+        }
+    }
+
+    PyroDepthPyramid::~PyroDepthPyramid() { release(); }
+
+    void PyroDepthPyramid::release() {
+        if (!image) {
+            return;
+        }
+        vkDeviceWaitIdle(device->get_logical_device());
+        descriptors->invalidate_image_view(image->get_view());
+        for (const VkImageView view : level_views) {
+            vkDestroyImageView(device->get_logical_device(), view, nullptr);
+        }
+        level_views.clear();
+        image.reset();
+    }
+
+    void PyroDepthPyramid::allocate(const VkExtent2D depth_extent) {
+        release();
+        this->depth_extent = depth_extent;
+        ImageDesc desc{};
+        desc.extent = {std::max((depth_extent.width + 1) / 2, 1u), std::max((depth_extent.height + 1) / 2, 1u)};
+        desc.format = FORMAT;
+        desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+        desc.mip_levels = std::bit_width(std::max(desc.extent.width, desc.extent.height));
+        image = std::make_unique<VulkanImage>(device, desc);
+
+        for (uint32_t level = 0; level < desc.mip_levels; level++) {
+            VkImageViewCreateInfo view_info{};
+            view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            view_info.image = image->get_image();
+            view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            view_info.format = FORMAT;
+            view_info.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1};
+            VkImageView view;
+            ASSERT_EQUAL(vkCreateImageView(device->get_logical_device(), &view_info, nullptr, &view), VK_SUCCESS,
+                         "Failed to create depth pyramid level view")
+            level_views.push_back(view);
+        }
+        LOG(LogLevel::DEBUG, "Depth pyramid {}x{} with {} levels", desc.extent.width, desc.extent.height,
+            desc.mip_levels);
+    }
+
+    DepthPyramidView PyroDepthPyramid::get_view() const {
+        if (!image) {
+            return {};
+        }
+        return {image->get_view(), image->get_desc().extent, image->get_desc().mip_levels};
+    }
+
+    void PyroDepthPyramid::build(const VkCommandBuffer command_buffer, const VkImageView depth,
+                                 const VkExtent2D depth_extent) {
+        if (!image || depth_extent.width != this->depth_extent.width ||
+            depth_extent.height != this->depth_extent.height) {
+            allocate(depth_extent);
+        }
+
+        // The previous contents are never read again, so the transition only has to wait for last use's readers.
+        VkImageMemoryBarrier image_barrier{};
+        image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        image_barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        image_barrier.image = image->get_image();
+        image_barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, reader_stages, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0,
+                             nullptr, 1, &image_barrier);
+
+        pipeline->bind(command_buffer);
+        VkMemoryBarrier level_barrier{};
+        level_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        level_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        level_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        VkExtent2D src_extent = depth_extent;
+        VkExtent2D dst_extent = image->get_desc().extent;
+        for (uint32_t level = 0; level < level_views.size(); level++) {
+            PyroDescriptorBindings bindings;
+            bindings.bind_image(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT,
+                                level == 0 ? depth : level_views[level - 1], VK_NULL_HANDLE,
+                                level == 0 ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL)
+                    .bind_image(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, level_views[level],
+                                VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+            const Params params{static_cast<int32_t>(src_extent.width), static_cast<int32_t>(src_extent.height),
+                                static_cast<int32_t>(dst_extent.width), static_cast<int32_t>(dst_extent.height)};
+            pipeline->bind_set(command_buffer, 0, descriptors->allocate_transient(bindings));
+            pipeline->push_constants(command_buffer, &params, sizeof(params));
+            PyroComputePipeline::dispatch(command_buffer,
+                                          PyroComputePipeline::group_count(dst_extent.width, TILE_SIZE),
+                                          PyroComputePipeline::group_count(dst_extent.height, TILE_SIZE));
+            // The last level's barrier publishes the whole pyramid to the culling shaders.
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 level + 1 < level_views.size()
+                                         ? static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT)
+                                         : reader_stages,
+                                 0, 1, &level_barrier, 0, nullptr, 0, nullptr);
+            src_extent = dst_extent;
+            dst_extent = {std::max(dst_extent.width / 2, 1u), std::max(dst_extent.height / 2, 1u)};
+        }
+    }
+} // namespace pyro
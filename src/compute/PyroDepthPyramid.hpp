@@ -0,0 +1,70 @@
+//
+// Created by srijan on 3/2/25.
+//
+
+#ifndef PYRODEPTHPYRAMID_HPP
+#define PYRODEPTHPYRAMID_HPP
+
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanImage.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "PyroComputePipeline.hpp"
+
+namespace pyro {
+
+    // A max-reduced depth pyramid (0 near, 1 far) in GENERAL layout. Level 0 is half the depth buffer's size,
+    // rounded up, and covers the same viewport.
+    struct DepthPyramidView {
+        VkImageView view = VK_NULL_HANDLE;
+        VkExtent2D extent{};
+        uint32_t mip_levels = 0;
+    };
+
+    // Hierarchical-Z for occlusion culling, rebuilt from a depth buffer by compute
+    // (assets/shaders/depth_pyramid.comp), one dispatch per level. Each texel holds the farthest depth under it,
+    // so anything whose nearest depth lies behind it is hidden. The R32_SFLOAT pyramid is reallocated when the
+    // depth extent changes.
+    class PyroDepthPyramid {
+    public:
+        static constexpr VkFormat FORMAT = VK_FORMAT_R32_SFLOAT;
+
+        PyroDepthPyramid(VulkanDevice *device, PyroDescriptors *descriptors);
+        ~PyroDepthPyramid();
+        PyroDepthPyramid(const PyroDepthPyramid &) = delete;
+        PyroDepthPyramid &operator=(const PyroDepthPyramid &) = delete;
+
+        // `depth` must be a depth-aspect view in SHADER_READ_ONLY_OPTIMAL whose writes have been made visible to
+        // compute. Waits for earlier compute and task shader reads of the pyramid and makes the result visible to
+        // both.
+        void build(VkCommandBuffer command_buffer, VkImageView depth, VkExtent2D depth_extent);
+
+        DepthPyramidView get_view() const;
+
+    private:
+        struct Params {
+            int32_t src_width;
+            int32_t src_height;
+            int32_t dst_width;
+            int32_t dst_height;
+        };
+
+        VulkanDevice *device;
+        PyroDescriptors *descriptors;
+        PyroDescriptorBindings layout_bindings;
+        std::unique_ptr<PyroComputePipeline> pipeline;
+        std::unique_ptr<VulkanImage> image;
+        // One view per level, for reading the previous level and writing the next.
+        std::vector<VkImageView> level_views;
+        VkExtent2D depth_extent{};
+        VkPipelineStageFlags reader_stages;
+
+        void allocate(VkExtent2D depth_extent);
+        void release();
+    };
+
+} // namespace pyro
+
+#endif // PYRODEPTHPYRAMID_HPP
@@ -0,0 +1,193 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+#include "PyroMipGenerator.hpp"
+
+#include <algorithm>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t TILE_SIZE = 64;
+        constexpr uint32_t COUNTER_BINDING = 13;
+        constexpr VkPipelineStageFlags SHADER_STAGES = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+        VkImageMemoryBarrier level_barrier(const VkImage image, const uint32_t base_level, const uint32_t level_count,
+                                           const VkImageLayout old_layout, const VkImageLayout new_layout,
+                                           const VkAccessFlags src_access, const VkAccessFlags dst_access) {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = src_access;
+            barrier.dstAccessMask = dst_access;
+            barrier.oldLayout = old_layout;
+            barrier.newLayout = new_layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, base_level, level_count, 0, 1};
+            return barrier;
+        }
+    } // namespace
+
+    PyroMipGenerator::PyroMipGenerator(VulkanDevice *device, PyroDescriptors *descriptors) :
+        device(device), descriptors(descriptors) {
+        layout_bindings.bind_image(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE,
+                                   VK_NULL_HANDLE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        for (uint32_t i = 1; i <= MAX_GENERATED_LEVELS; i++) {
+            layout_bindings.bind_image(i, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT,
+                                       VK_NULL_HANDLE, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+        }
+        layout_bindings.bind_buffer(COUNTER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT,
+                                    VK_NULL_HANDLE, 0, sizeof(uint32_t));
+        pipeline = std::make_unique<PyroComputePipeline>(
+                device, "assets/shaders/spd_downsample.comp.spv",
+                std::vector{descriptors->get_layout(layout_bindings)},
+                std::vector{VkPushConstantRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Params)}});
+
+        // Each dispatch gets its own counter so back-to-back generate() calls can overlap on the GPU; the
+        // shader's last workgroup zeroes the counter again on the way out.
+        counter_stride = std::max<VkDeviceSize>(device->get_properties().limits.minStorageBufferOffsetAlignment,
+                                                sizeof(uint32_t));
+        counters = std::make_unique<VulkanBuffer>(device, counter_stride * COUNTER_SLOTS,
+                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        const VkCommandBuffer command_buffer = device->begin_single_time_commands();
+        vkCmdFillBuffer(command_buffer, counters->get_buffer(), 0, VK_WHOLE_SIZE, 0);
+        device->end_single_time_commands(command_buffer);
+    }
+
+    PyroMipGenerator::~PyroMipGenerator() {
+        for (const auto &views: retired_views) {
+            for (const VkImageView view: views) {
+                vkDestroyImageView(device->get_logical_device(), view, nullptr);
+            }
+        }
+        descriptors->invalidate_buffer(counters->get_buffer());
+    }
+
+    bool PyroMipGenerator::supports(const VkFormat format, const VkExtent2D extent) const {
+        if (format != VK_FORMAT_R8G8B8A8_UNORM || std::max(extent.width, extent.height) > 4096) {
+            return false;
+        }
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(device->get_physical_device(), format, &properties);
+        return properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+    }
+
+    void PyroMipGenerator::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        for (const VkImageView view: retired_views[frame_index]) {
+            vkDestroyImageView(device->get_logical_device(), view, nullptr);
+        }
+        retired_views[frame_index].clear();
+    }
+
+    VkImageView PyroMipGenerator::create_level_view(const VkImage image, const VkFormat format,
+                                                    const uint32_t level) const {
+        VkImageViewCreateInfo view_info{};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = image;
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = format;
+        view_info.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1};
+        VkImageView view;
+        ASSERT_EQUAL(vkCreateImageView(device->get_logical_device(), &view_info, nullptr, &view), VK_SUCCESS,
+                     "Failed to create mip level view")
+        return view;
+    }
+
+    void PyroMipGenerator::generate(const VkCommandBuffer command_buffer, const VkImage image, const VkFormat format,
+                                    const VkExtent2D extent, const uint32_t mip_levels) {
+        ASSERT_EQUAL(supports(format, extent), true, "Compute mip generation does not support this image")
+        const uint32_t mip_count = std::min(mip_levels - 1, MAX_GENERATED_LEVELS);
+
+        VkImageMemoryBarrier barriers[2] = {
+                level_barrier(image, 0, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+                              VK_ACCESS_SHADER_READ_BIT),
+                level_barrier(image, 1, VK_REMAINING_MIP_LEVELS, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+                              VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+        };
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             0, nullptr, 0, nullptr, mip_count > 0 ? 2 : 1, barriers);
+        if (mip_count == 0) {
+            return;
+        }
+
+        std::vector<VkImageView> &views = retired_views[frame_index];
+        PyroDescriptorBindings bindings;
+        views.push_back(create_level_view(image, format, 0));
+        bindings.bind_image(0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, views.back(),
+                            VK_NULL_HANDLE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        for (uint32_t level = 1; level <= MAX_GENERATED_LEVELS; level++) {
+            // Bindings past the end of the chain still need a valid view; the shader never writes to them.
+            if (level <= mip_count) {
+                views.push_back(create_level_view(image, format, level));
+            }
+            bindings.bind_image(level, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, views.back(),
+                                VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+        }
+        const VkDeviceSize counter_offset = (next_counter++ % COUNTER_SLOTS) * counter_stride;
+        bindings.bind_buffer(COUNTER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT,
+                             counters->get_buffer(), counter_offset, sizeof(uint32_t));
+
+        const uint32_t groups_x = PyroComputePipeline::group_count(extent.width, TILE_SIZE);
+        const uint32_t groups_y = PyroComputePipeline::group_count(extent.height, TILE_SIZE);
+        const Params params{static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), mip_count,
+                            groups_x * groups_y};
+        pipeline->bind(command_buffer);
+        pipeline->bind_set(command_buffer, 0, descriptors->allocate_transient(bindings));
+        pipeline->push_constants(command_buffer, &params, sizeof(params));
+        PyroComputePipeline::dispatch(command_buffer, groups_x, groups_y);
+
+        barriers[0] = level_barrier(image, 1, VK_REMAINING_MIP_LEVELS, VK_IMAGE_LAYOUT_GENERAL,
+                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_WRITE_BIT,
+                                    VK_ACCESS_SHADER_READ_BIT);
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, SHADER_STAGES, 0, 0, nullptr, 0,
+                             nullptr, 1, barriers);
+    }
+
+    void PyroMipGenerator::generate_blit(const VkCommandBuffer command_buffer, const VkImage image,
+                                         const VkExtent2D extent, const uint32_t mip_levels) {
+        int32_t width = static_cast<int32_t>(extent.width);
+        int32_t height = static_cast<int32_t>(extent.height);
+        for (uint32_t level = 1; level < mip_levels; level++) {
+            // Each level waits for the previous blit, which is what the compute path avoids.
+            VkImageMemoryBarrier barrier = level_barrier(
+                    image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                                 nullptr, 0, nullptr, 1, &barrier);
+
+            const int32_t next_width = std::max(width / 2, 1);
+            const int32_t next_height = std::max(height / 2, 1);
+            VkImageBlit blit{};
+            blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1};
+            blit.srcOffsets[1] = {width, height, 1};
+            blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+            blit.dstOffsets[1] = {next_width, next_height, 1};
+            vkCmdBlitImage(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+            width = next_width;
+            height = next_height;
+        }
+
+        VkImageMemoryBarrier barriers[2] = {
+                level_barrier(image, 0, mip_levels - 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT,
+                              VK_ACCESS_SHADER_READ_BIT),
+                level_barrier(image, mip_levels - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+                              VK_ACCESS_SHADER_READ_BIT),
+        };
+        const uint32_t first = mip_levels > 1 ? 0 : 1;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, SHADER_STAGES, 0, 0, nullptr, 0, nullptr,
+                             2 - first, barriers + first);
+    }
+} // namespace pyro
@@ -0,0 +1,69 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+#ifndef PYROMIPGENERATOR_HPP
+#define PYROMIPGENERATOR_HPP
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanBuffer.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "PyroComputePipeline.hpp"
+
+namespace pyro {
+
+    // Builds mip chains on the GPU. generate() runs the single-pass compute downsampler
+    // (assets/shaders/spd_downsample.comp): one dispatch for the whole chain, no barriers between levels and
+    // level 0 read once. Images it cannot handle go through generate_blit(), the classic vkCmdBlitImage chain.
+    //
+    // Both paths expect every level in TRANSFER_DST_OPTIMAL with level 0 filled in, and leave every level in
+    // SHADER_READ_ONLY_OPTIMAL.
+    class PyroMipGenerator {
+    public:
+        static constexpr uint32_t MAX_GENERATED_LEVELS = 12;
+
+        PyroMipGenerator(VulkanDevice *device, PyroDescriptors *descriptors);
+        ~PyroMipGenerator();
+        PyroMipGenerator(const PyroMipGenerator &) = delete;
+        PyroMipGenerator &operator=(const PyroMipGenerator &) = delete;
+
+        // The compute path needs R8G8B8A8_UNORM with storage support, STORAGE usage on the image and a level 0
+        // no larger than 4096.
+        bool supports(VkFormat format, VkExtent2D extent) const;
+        void generate(VkCommandBuffer command_buffer, VkImage image, VkFormat format, VkExtent2D extent,
+                      uint32_t mip_levels);
+        static void generate_blit(VkCommandBuffer command_buffer, VkImage image, VkExtent2D extent,
+                                  uint32_t mip_levels);
+        // Releases the per-level views created MAX_FRAMES_IN_FLIGHT frames ago.
+        void begin_frame(uint32_t frame_index);
+
+    private:
+        static constexpr uint32_t COUNTER_SLOTS = 128;
+
+        struct Params {
+            int32_t src_width;
+            int32_t src_height;
+            uint32_t mip_count;
+            uint32_t workgroup_count;
+        };
+
+        VkImageView create_level_view(VkImage image, VkFormat format, uint32_t level) const;
+
+        VulkanDevice *device;
+        PyroDescriptors *descriptors;
+        PyroDescriptorBindings layout_bindings;
+        std::unique_ptr<PyroComputePipeline> pipeline;
+        std::unique_ptr<VulkanBuffer> counters;
+        VkDeviceSize counter_stride;
+        uint32_t next_counter = 0;
+        uint32_t frame_index = 0;
+        std::array<std::vector<VkImageView>, MAX_FRAMES_IN_FLIGHT> retired_views;
+    };
+
+} // namespace pyro
+
+#endif // PYROMIPGENERATOR_HPP
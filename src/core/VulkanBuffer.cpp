@@ -0,0 +1,89 @@
+//
+// Created by srijan on 2/18/25.
+//
+
+#include "VulkanBuffer.hpp"
+
+#include <cstring>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    VulkanBuffer::VulkanBuffer(VulkanDevice *device, const VkDeviceSize size, const VkBufferUsageFlags usage,
+                               const VkMemoryPropertyFlags required, const VkMemoryPropertyFlags preferred) :
+        device(device), size(size) {
+        VkBufferCreateInfo buffer_info{};
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.size = size;
+        buffer_info.usage = usage;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        ASSERT_EQUAL(vkCreateBuffer(device->get_logical_device(), &buffer_info, nullptr, &buffer), VK_SUCCESS,
+                     "Failed to create buffer")
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device->get_logical_device(), buffer, &requirements);
+        std::optional<uint32_t> memory_type =
+                device->find_memory_type(requirements.memoryTypeBits, required | preferred);
+        if (!memory_type.has_value()) {
+            memory_type = device->find_memory_type(requirements.memoryTypeBits, required);
+        }
+        ASSERT_EQUAL(memory_type.has_value(), true, "No suitable memory type for buffer")
+        memory_flags = device->get_memory_properties().memoryTypes[memory_type.value()].propertyFlags;
+
+        VkMemoryAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize = requirements.size;
+        allocation_size = requirements.size;
+        alloc_info.memoryTypeIndex = memory_type.value();
+        ASSERT_EQUAL(vkAllocateMemory(device->get_logical_device(), &alloc_info, nullptr, &memory), VK_SUCCESS,
+                     "Failed to allocate buffer memory")
+        vkBindBufferMemory(device->get_logical_device(), buffer, memory, 0);
+
+        if (memory_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            ASSERT_EQUAL(vkMapMemory(device->get_logical_device(), memory, 0, VK_WHOLE_SIZE, 0, &mapped), VK_SUCCESS,
+                         "Failed to map buffer memory")
+        }
+    }
+
+    VulkanBuffer::~VulkanBuffer() {
+        if (mapped) {
+            vkUnmapMemory(device->get_logical_device(), memory);
+        }
+        vkDestroyBuffer(device->get_logical_device(), buffer, nullptr);
+        vkFreeMemory(device->get_logical_device(), memory, nullptr);
+    }
+
+    void VulkanBuffer::write(const void *data, const VkDeviceSize size, const VkDeviceSize offset) const {
+        ASSERT_EQUAL(mapped != nullptr, true, "Buffer is not host visible")
+        std::memcpy(static_cast<char *>(mapped) + offset, data, size);
+    }
+
+    VkMappedMemoryRange VulkanBuffer::atom_range(const VkDeviceSize offset, const VkDeviceSize size) const {
+        const VkDeviceSize atom = device->get_properties().limits.nonCoherentAtomSize;
+        VkMappedMemoryRange range{};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = memory;
+        range.offset = offset / atom * atom;
+        range.size = size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : (offset + size - range.offset + atom - 1) / atom * atom;
+        if (range.size != VK_WHOLE_SIZE && range.offset + range.size > allocation_size) {
+            range.size = VK_WHOLE_SIZE;
+        }
+        return range;
+    }
+
+    void VulkanBuffer::flush(const VkDeviceSize offset, const VkDeviceSize size) const {
+        if (is_coherent() || size == 0) {
+            return;
+        }
+        const VkMappedMemoryRange range = atom_range(offset, size);
+        vkFlushMappedMemoryRanges(device->get_logical_device(), 1, &range);
+    }
+
+    void VulkanBuffer::invalidate(const VkDeviceSize offset, const VkDeviceSize size) const {
+        if (is_coherent() || size == 0) {
+            return;
+        }
+        const VkMappedMemoryRange range = atom_range(offset, size);
+        vkInvalidateMappedMemoryRanges(device->get_logical_device(), 1, &range);
+    }
+} // namespace pyro
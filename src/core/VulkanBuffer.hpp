@@ -0,0 +1,51 @@
+//
+// Created by srijan on 2/18/25.
+//
+
+#ifndef VULKANBUFFER_HPP
+#define VULKANBUFFER_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDevice.hpp"
+
+namespace pyro {
+
+    // A VkBuffer with its own dedicated allocation. Memory is picked from `required` properties, trying
+    // `required | preferred` first. Host-visible buffers are mapped once at creation and stay mapped for their
+    // whole lifetime, so writes are plain memcpy's into get_mapped().
+    class VulkanBuffer {
+    public:
+        VulkanBuffer(VulkanDevice *device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags required,
+                     VkMemoryPropertyFlags preferred = 0);
+        ~VulkanBuffer();
+        VulkanBuffer(const VulkanBuffer &) = delete;
+        VulkanBuffer &operator=(const VulkanBuffer &) = delete;
+
+        void write(const void *data, VkDeviceSize size, VkDeviceSize offset = 0) const;
+        // No-ops on host-coherent memory; otherwise the range is widened to nonCoherentAtomSize.
+        void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+        void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+        VkBuffer get_buffer() const { return buffer; }
+        VkDeviceMemory get_memory() const { return memory; }
+        VkDeviceSize get_size() const { return size; }
+        VkMemoryPropertyFlags get_memory_flags() const { return memory_flags; }
+        void *get_mapped() const { return mapped; }
+        bool is_coherent() const { return memory_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT; }
+
+    private:
+        VkMappedMemoryRange atom_range(VkDeviceSize offset, VkDeviceSize size) const;
+
+        VulkanDevice *device;
+        VkBuffer buffer{};
+        VkDeviceMemory memory{};
+        VkDeviceSize size;
+        VkDeviceSize allocation_size = 0;
+        VkMemoryPropertyFlags memory_flags = 0;
+        void *mapped = nullptr;
+    };
+
+} // namespace pyro
+
+#endif // VULKANBUFFER_HPP
@@ -4,52 +4,146 @@
 
 #include "VulkanDevice.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <queue>
 #include <set>
 #include <vector>
 
+#include "../profiler/PyroStartup.hpp"
 #include "../utils/Logger.hpp"
 #include "../window/PyroWindow.hpp"
 #include "VulkanInstance.hpp"
 
 namespace pyro {
-    VulkanDevice::VulkanDevice(VulkanInstance *instance, PyroWindow *window, int gpu_index) : instance(instance) {
+    namespace {
+        const char *present_mode_name(const VkPresentModeKHR mode) {
+            switch (mode) {
+                case VK_PRESENT_MODE_IMMEDIATE_KHR:
+                    return "IMMEDIATE";
+                case VK_PRESENT_MODE_MAILBOX_KHR:
+                    return "MAILBOX";
+                case VK_PRESENT_MODE_FIFO_KHR:
+                    return "FIFO";
+                case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+                    return "FIFO_RELAXED";
+                default:
+                    return "unknown";
+            }
+        }
+    } // namespace
+
+    VulkanDevice::VulkanDevice(VulkanInstance *instance, PyroWindow *window, int gpu_index,
+                               const PresentConfig &present_config) :
+        instance(instance), presentConfig(present_config) {
+        StartupScope scope("create_device");
         surface = window->create_surface((instance->getInstance()));
         std::multimap devices(listPhysicalDevices());
         ASSERT_EQUAL(gpu_index >= 0 && gpu_index < static_cast<int>(devices.size()), true,
                      "Device gpu_index out of range.")
+        const PhysicalDeviceInfo *physical_device = devices.begin()->second;
         if (gpu_index >= 0 && gpu_index < static_cast<int>(devices.size())) {
             auto it = devices.begin();
             std::advance(it, gpu_index);
-            physicalDevice = it->second;
-        } else {
-            physicalDevice = devices.begin()->second;
+            physical_device = it->second;
         }
-        std::string device_name(get_physical_device_name(&physicalDevice));
-        LOG(LogLevel::INFO, "Created Vulkan device: {}", device_name);
+        physicalDevice = physical_device->handle;
+        LOG(LogLevel::INFO, "Created Vulkan device: {}", physical_device->properties.deviceName);
+        properties = physical_device->properties;
+        memoryProperties = physical_device->memory_properties;
+        capabilities = physical_device->capabilities;
+        LOG(LogLevel::INFO, "Descriptor indexing: {}", capabilities.descriptor_indexing ? "supported" : "unsupported");
+        LOG(LogLevel::INFO, "Mesh shaders: {}", capabilities.mesh_shader ? "supported" : "unsupported");
+        LOG(LogLevel::INFO, "Present wait: {}", capabilities.present_wait ? "supported" : "unsupported");
 
 
         // Creating Logical Device
-        indices = findQueueFamilyIndex(&physicalDevice);
+        indices = findQueueFamilyIndex(*physical_device);
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         const std::set uniqueQueueFamilyIndices = {indices.graphics_family_index.value(),
-                                                   indices.present_family_index.value()};
+                                                   indices.present_family_index.value(),
+                                                   indices.compute_family_index.value()};
+        const std::vector<VkQueueFamilyProperties> &family_properties = physical_device->queue_families;
+
+        // Without a dedicated compute family, a second queue of the graphics family still lets compute
+        // submissions overlap graphics ones. With neither, compute shares the graphics queue.
+        uint32_t compute_queue_index = 0;
+        if (indices.compute_family_index == indices.graphics_family_index &&
+            family_properties[indices.graphics_family_index.value()].queueCount > 1) {
+            compute_queue_index = 1;
+        }
 
-        float queuePriority = 1.0f;
+        const float queuePriorities[] = {1.0f, 1.0f};
         for (const auto &queue_family: uniqueQueueFamilyIndices) {
             VkDeviceQueueCreateInfo queueCreateInfo = {};
             queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
             queueCreateInfo.queueFamilyIndex = queue_family;
-            queueCreateInfo.queueCount = 1;
-            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfo.queueCount = queue_family == indices.compute_family_index ? compute_queue_index + 1 : 1;
+            queueCreateInfo.pQueuePriorities = queuePriorities;
             queueCreateInfos.push_back(queueCreateInfo);
         }
+        VkPhysicalDeviceVulkan12Features features12 = {};
+        features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        if (capabilities.descriptor_indexing) {
+            features12.descriptorIndexing = VK_TRUE;
+            features12.runtimeDescriptorArray = VK_TRUE;
+            features12.descriptorBindingPartiallyBound = VK_TRUE;
+            features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            features12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+            features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            features12.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+        }
+        features12.timelineSemaphore = capabilities.timeline_semaphores;
+        VkPhysicalDeviceVulkan13Features features13 = {};
+        features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        features13.synchronization2 = capabilities.synchronization2;
+        features13.dynamicRendering = capabilities.dynamic_rendering;
+        // Extension feature structs are appended after the newest core struct in the chain.
+        void **feature_chain = &features12.pNext;
+        if (capabilities.api_version >= VK_API_VERSION_1_3) {
+            features12.pNext = &features13;
+            feature_chain = &features13.pNext;
+        }
+        std::vector<const char *> extensions = deviceExtensions;
+        VkPhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features = {};
+        mesh_shader_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+        if (capabilities.mesh_shader) {
+            mesh_shader_features.taskShader = VK_TRUE;
+            mesh_shader_features.meshShader = VK_TRUE;
+            *feature_chain = &mesh_shader_features;
+            feature_chain = &mesh_shader_features.pNext;
+            extensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+        }
+        VkPhysicalDevicePresentIdFeaturesKHR present_id_features = {};
+        present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features = {};
+        present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        if (capabilities.present_wait) {
+            present_id_features.presentId = VK_TRUE;
+            present_wait_features.presentWait = VK_TRUE;
+            *feature_chain = &present_id_features;
+            present_id_features.pNext = &present_wait_features;
+            feature_chain = &present_wait_features.pNext;
+            extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
+        VkPhysicalDeviceFeatures2 features2 = {};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = capabilities.api_version >= VK_API_VERSION_1_2 ? &features12 : nullptr;
+        features2.features.textureCompressionBC = capabilities.texture_compression_bc;
+        features2.features.fragmentStoresAndAtomics = capabilities.fragment_stores_and_atomics;
+        features2.features.multiDrawIndirect = capabilities.multi_draw_indirect;
+        features2.features.drawIndirectFirstInstance = capabilities.multi_draw_indirect;
+
         VkDeviceCreateInfo deviceCreateInfo = {};
         deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceCreateInfo.pNext = &features2;
         deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
-        deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-        deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
+        deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+        deviceCreateInfo.ppEnabledExtensionNames = extensions.data();
 #ifdef PYRO_DEBUG
         deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(instance->validationLayers.size());
         deviceCreateInfo.ppEnabledLayerNames = instance->validationLayers.data();
@@ -58,8 +152,17 @@ namespace pyro {
                      "Failed to create logical device.");
         vkGetDeviceQueue(logicalDevice, indices.graphics_family_index.value(), 0, &graphicsQueue);
         vkGetDeviceQueue(logicalDevice, indices.present_family_index.value(), 0, &presentQueue);
+        vkGetDeviceQueue(logicalDevice, indices.compute_family_index.value(), compute_queue_index, &computeQueue);
         ASSERT_EQUAL(graphicsQueue == nullptr, false, "Failed to find graphics queue on this device")
         ASSERT_EQUAL(presentQueue == nullptr, false, "Failed to find present queue on this device")
+        ASSERT_EQUAL(computeQueue == nullptr, false, "Failed to find compute queue on this device")
+        if (capabilities.present_wait) {
+            waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+                    vkGetDeviceProcAddr(logicalDevice, "vkWaitForPresentKHR"));
+            capabilities.present_wait = waitForPresent != nullptr;
+        }
+        LOG(LogLevel::INFO, "Compute queue: family {} index {}{}", indices.compute_family_index.value(),
+            compute_queue_index, has_async_compute() ? "" : " (shared with graphics)");
         SwapChainSupportDetails swap_support = {};
         vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &swap_support.capabilities);
         uint32_t format_count = 0;
@@ -77,12 +180,16 @@ namespace pyro {
 
         // Creating Swap chain.
         VkSurfaceFormatKHR surface_format = chooseSwapSurfaceFormat(swap_support.formats);
-        VkPresentModeKHR present_mode = chooseSwapPresentMode(swap_support.presentModes);
+        VkPresentModeKHR present_mode = chooseSwapPresentMode(swap_support.presentModes, presentConfig.mode);
         VkExtent2D swap_extent = chooseSwapExtent(swap_support.capabilities, window);
-        uint32_t image_count = swap_support.capabilities.minImageCount + 1;
+        // Fewer images means a shorter present queue and less latency, at the cost of stalling on a late frame.
+        uint32_t image_count = presentConfig.image_count > 0 ? presentConfig.image_count
+                                                             : swap_support.capabilities.minImageCount + 1;
+        image_count = std::max(image_count, swap_support.capabilities.minImageCount);
         if (swap_support.capabilities.maxImageCount > 0 && image_count > swap_support.capabilities.maxImageCount) {
             image_count = swap_support.capabilities.maxImageCount;
         }
+        LOG(LogLevel::INFO, "Present mode {} with {} swap chain images", present_mode_name(present_mode), image_count);
         VkSwapchainCreateInfoKHR swap_create_info = {};
         swap_create_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
         swap_create_info.surface = surface;
@@ -90,7 +197,12 @@ namespace pyro {
         swap_create_info.imageFormat = surface_format.format;
         swap_create_info.imageColorSpace = surface_format.colorSpace;
         swap_create_info.imageExtent = swap_extent;
-        swap_create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        swapChainUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        // Lets frames be copied out of the back buffer for screenshots and frame dumps, and upscaled frames be
+        // blitted in with dynamic resolution.
+        swapChainUsage |= swap_support.capabilities.supportedUsageFlags &
+                          (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+        swap_create_info.imageUsage = swapChainUsage;
         swap_create_info.imageArrayLayers = 1;
         uint32_t queueFamilyIndex[] = {indices.graphics_family_index.value(), indices.present_family_index.value()};
         if (indices.graphics_family_index.value() == indices.present_family_index.value()) {
@@ -111,6 +223,7 @@ namespace pyro {
                      "Failed to create swap chain")
         swapChainExtent = swap_extent;
         swapChainImageFormat = surface_format.format;
+        presentMode = present_mode;
 
         uint32_t swapChainImageCount;
         vkGetSwapchainImagesKHR(logicalDevice, swapChain, &swapChainImageCount, nullptr);
@@ -136,41 +249,51 @@ namespace pyro {
             view_create_info.subresourceRange.layerCount = 1;
             ASSERT_EQUAL(vkCreateImageView(logicalDevice, &view_create_info, nullptr, &swapChainImageViews[i]),
                          VK_SUCCESS, "Failed to create image views")
-            // Create Command pool
-            VkCommandPoolCreateInfo command_pool_create_info = {};
-            command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-            command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-            command_pool_create_info.queueFamilyIndex = indices.graphics_family_index.value();
-            ASSERT_EQUAL(vkCreateCommandPool(logicalDevice, &command_pool_create_info, nullptr, &commandPool),
-                         VK_SUCCESS, "Failed to create command pool")
+        }
+        // Create Command pool
+        VkCommandPoolCreateInfo command_pool_create_info = {};
+        command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        command_pool_create_info.queueFamilyIndex = indices.graphics_family_index.value();
+        ASSERT_EQUAL(vkCreateCommandPool(logicalDevice, &command_pool_create_info, nullptr, &commandPool), VK_SUCCESS,
+                     "Failed to create command pool")
+        command_pool_create_info.queueFamilyIndex = indices.compute_family_index.value();
+        ASSERT_EQUAL(vkCreateCommandPool(logicalDevice, &command_pool_create_info, nullptr, &computeCommandPool),
+                     VK_SUCCESS, "Failed to create compute command pool")
 
-            VkCommandBufferAllocateInfo command_buffer_allocate_info = {};
-            command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            command_buffer_allocate_info.commandPool = commandPool;
-            command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            command_buffer_allocate_info.commandBufferCount = 1;
+        VkCommandBufferAllocateInfo command_buffer_allocate_info = {};
+        command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool = commandPool;
+        command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        command_buffer_allocate_info.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
 
-            ASSERT_EQUAL(vkAllocateCommandBuffers(logicalDevice, &command_buffer_allocate_info, &commandBuffer),
-                         VK_SUCCESS, "Failed to allocate command buffers")
+        ASSERT_EQUAL(vkAllocateCommandBuffers(logicalDevice, &command_buffer_allocate_info, commandBuffers.data()),
+                     VK_SUCCESS, "Failed to allocate command buffers")
 
-            VkSemaphoreCreateInfo semaphore_create_info = {};
-            semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-            VkFenceCreateInfo fence_create_info = {};
-            fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-            fence_create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-            ASSERT_EQUAL(vkCreateSemaphore(logicalDevice, &semaphore_create_info, nullptr, &imageAvailableSemaphore),
-                         VK_SUCCESS, "Failed to create semaphore")
-            ASSERT_EQUAL(vkCreateSemaphore(logicalDevice, &semaphore_create_info, nullptr, &renderFinishedSemaphore),
-                         VK_SUCCESS, "Failed to create semaphore")
-            ASSERT_EQUAL(vkCreateFence(logicalDevice, &fence_create_info, nullptr, &inflightFence), VK_SUCCESS,
+        VkSemaphoreCreateInfo semaphore_create_info = {};
+        semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        VkFenceCreateInfo fence_create_info = {};
+        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fence_create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            ASSERT_EQUAL(
+                    vkCreateSemaphore(logicalDevice, &semaphore_create_info, nullptr, &imageAvailableSemaphores[i]),
+                    VK_SUCCESS, "Failed to create semaphore")
+            ASSERT_EQUAL(
+                    vkCreateSemaphore(logicalDevice, &semaphore_create_info, nullptr, &renderFinishedSemaphores[i]),
+                    VK_SUCCESS, "Failed to create semaphore")
+            ASSERT_EQUAL(vkCreateFence(logicalDevice, &fence_create_info, nullptr, &inflightFences[i]), VK_SUCCESS,
                          "Failed to create fence")
         }
     }
     VulkanDevice::~VulkanDevice() {
         vkDeviceWaitIdle(logicalDevice);
-        vkDestroySemaphore(logicalDevice, renderFinishedSemaphore, nullptr);
-        vkDestroySemaphore(logicalDevice, imageAvailableSemaphore, nullptr);
-        vkDestroyFence(logicalDevice, inflightFence, nullptr);
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            vkDestroySemaphore(logicalDevice, renderFinishedSemaphores[i], nullptr);
+            vkDestroySemaphore(logicalDevice, imageAvailableSemaphores[i], nullptr);
+            vkDestroyFence(logicalDevice, inflightFences[i], nullptr);
+        }
+        vkDestroyCommandPool(logicalDevice, computeCommandPool, nullptr);
         vkDestroyCommandPool(logicalDevice, commandPool, nullptr);
         for (auto imageView: swapChainImageViews) {
             vkDestroyImageView(logicalDevice, imageView, nullptr);
@@ -188,9 +311,25 @@ namespace pyro {
         }
         return formats[0];
     }
-    VkPresentModeKHR VulkanDevice::chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &modes) {
-        for (const auto &mode: modes) {
-            if (mode == VK_PRESENT_MODE_MAILBOX_KHR) {
+    VkPresentModeKHR VulkanDevice::chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &modes,
+                                                         const PresentModePolicy policy) {
+        // Each policy's preference order; FIFO is always supported and ends every list.
+        std::vector<VkPresentModeKHR> preferred;
+        switch (policy) {
+            case PresentModePolicy::IMMEDIATE:
+                preferred = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR};
+                break;
+            case PresentModePolicy::MAILBOX:
+                preferred = {VK_PRESENT_MODE_MAILBOX_KHR};
+                break;
+            case PresentModePolicy::FIFO_RELAXED:
+                preferred = {VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+                break;
+            case PresentModePolicy::FIFO:
+                break;
+        }
+        for (const VkPresentModeKHR mode: preferred) {
+            if (std::ranges::find(modes, mode) != modes.end()) {
                 return mode;
             }
         }
@@ -216,58 +355,76 @@ namespace pyro {
 
         return prop.deviceName;
     }
-    void VulkanDevice::record_command_buffer(const VkCommandBuffer &command_buffer, const uint32_t imageIndex,
-                                             const VkRenderPass &renderPass, const VkPipeline graphics_pipeline,
-                                             std::vector<VkFramebuffer> swapChainFrameBuffers) {
+    std::optional<uint32_t> VulkanDevice::find_memory_type(const uint32_t type_filter,
+                                                           const VkMemoryPropertyFlags properties) const {
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+            const VkMemoryPropertyFlags flags = memoryProperties.memoryTypes[i].propertyFlags;
+            if ((type_filter & (1u << i)) && (flags & properties) == properties) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    VkSampleCountFlagBits VulkanDevice::choose_sample_count(const uint32_t requested) const {
+        const VkSampleCountFlags supported =
+                properties.limits.framebufferColorSampleCounts & properties.limits.framebufferDepthSampleCounts;
+        for (uint32_t count = std::bit_floor(std::clamp(requested, 1u, 64u)); count > 1; count /= 2) {
+            if (supported & count) {
+                return static_cast<VkSampleCountFlagBits>(count);
+            }
+        }
+        return VK_SAMPLE_COUNT_1_BIT;
+    }
+
+    VkResult VulkanDevice::wait_for_present(const uint64_t present_id, const uint64_t timeout_ns) const {
+        ASSERT_EQUAL(waitForPresent != nullptr, true, "Present wait is not enabled on this device")
+        return waitForPresent(logicalDevice, swapChain, present_id, timeout_ns);
+    }
+
+    VkCommandBuffer VulkanDevice::begin_single_time_commands() const {
+        VkCommandBufferAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = commandPool;
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc_info.commandBufferCount = 1;
+        VkCommandBuffer command_buffer;
+        ASSERT_EQUAL(vkAllocateCommandBuffers(logicalDevice, &alloc_info, &command_buffer), VK_SUCCESS,
+                     "Failed to allocate command buffer")
         VkCommandBufferBeginInfo begin_info{};
         begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        begin_info.flags = 0;
-        begin_info.pInheritanceInfo = nullptr;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         ASSERT_EQUAL(vkBeginCommandBuffer(command_buffer, &begin_info), VK_SUCCESS,
                      "Failed to begin recording command buffer")
-        VkRenderPassBeginInfo render_pass_begin_info{};
-        render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        render_pass_begin_info.renderPass = renderPass;
-        render_pass_begin_info.framebuffer = swapChainFrameBuffers[imageIndex];
-        render_pass_begin_info.renderArea.offset = {0, 0};
-        render_pass_begin_info.renderArea.extent = swapChainExtent;
-        const VkClearValue clear_value{0.0f, 0.0f, 0.0f, 1.0f};
-        render_pass_begin_info.clearValueCount = 1;
-        render_pass_begin_info.pClearValues = &clear_value;
-        vkCmdBeginRenderPass(commandBuffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline);
+        return command_buffer;
+    }
 
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = swapChainExtent.width;
-        viewport.height = swapChainExtent.height;
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-        VkRect2D scissor{};
-        scissor.extent = swapChainExtent;
-        scissor.offset = {0, 0};
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-        vkCmdDraw(commandBuffer, 3, 1, 0, 0);
-        vkCmdEndRenderPass(commandBuffer);
-        ASSERT_EQUAL(vkEndCommandBuffer(commandBuffer), VK_SUCCESS, "Failed to record command buffer")
+    void VulkanDevice::end_single_time_commands(const VkCommandBuffer command_buffer) const {
+        ASSERT_EQUAL(vkEndCommandBuffer(command_buffer), VK_SUCCESS, "Failed to record command buffer")
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &command_buffer;
+        ASSERT_EQUAL(vkQueueSubmit(graphicsQueue, 1, &submit_info, VK_NULL_HANDLE), VK_SUCCESS,
+                     "Failed to submit command buffer")
+        vkQueueWaitIdle(graphicsQueue);
+        vkFreeCommandBuffers(logicalDevice, commandPool, 1, &command_buffer);
     }
 
-    QueueFamilyIndices VulkanDevice::findQueueFamilyIndex(const VkPhysicalDevice *device) const {
+    QueueFamilyIndices VulkanDevice::findQueueFamilyIndex(const PhysicalDeviceInfo &device) const {
+        if (const auto cached = queueFamilyCache.find(device.handle); cached != queueFamilyCache.end()) {
+            return cached->second;
+        }
         QueueFamilyIndices q_indices;
-        uint32_t queue_family_count = 0;
-        vkGetPhysicalDeviceQueueFamilyProperties(*device, &queue_family_count, nullptr);
-        ASSERT_EQUAL(queue_family_count != 0, true, "No queue families found.")
-        std::vector<VkQueueFamilyProperties> queueFamilies(queue_family_count);
-        vkGetPhysicalDeviceQueueFamilyProperties(*device, &queue_family_count, queueFamilies.data());
-        int i = 0;
+        const std::vector<VkQueueFamilyProperties> &queueFamilies = device.queue_families;
+        ASSERT_EQUAL(queueFamilies.empty(), false, "No queue families found.")
+        uint32_t i = 0;
         for (const auto &qf: queueFamilies) {
             if (qf.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
                 q_indices.graphics_family_index = i;
             }
             VkBool32 presentSupported = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(*device, i, surface, &presentSupported);
+            vkGetPhysicalDeviceSurfaceSupportKHR(device.handle, i, surface, &presentSupported);
             if (presentSupported) {
                 q_indices.present_family_index = i;
             }
@@ -276,45 +433,45 @@ namespace pyro {
                 break;
             i++;
         }
+        for (uint32_t family = 0; family < queueFamilies.size(); family++) {
+            const VkQueueFlags flags = queueFamilies[family].queueFlags;
+            if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+                q_indices.compute_family_index = family;
+                break;
+            }
+        }
+        if (!q_indices.compute_family_index.has_value()) {
+            q_indices.compute_family_index = q_indices.graphics_family_index;
+        }
+        queueFamilyCache.emplace(device.handle, q_indices);
         return q_indices;
     }
-    std::multimap<int, VkPhysicalDevice, std::greater<>> VulkanDevice::listPhysicalDevices() const {
-        uint32_t deviceCount = 0;
-        vkEnumeratePhysicalDevices(*instance->getInstance(), &deviceCount, nullptr);
-        ASSERT_EQUAL(deviceCount == 0, false, "No Supported GPUs. Please Install Vulkan.")
-        std::vector<VkPhysicalDevice> all_devices(deviceCount);
-        vkEnumeratePhysicalDevices(*instance->getInstance(), &deviceCount, all_devices.data());
-        std::multimap<int, VkPhysicalDevice, std::greater<>> devices;
-        for (auto &device: all_devices) {
-            int score{this->rateDevice(&device)};
-            devices.insert(std::make_pair(score, device));
+    std::multimap<int, const PhysicalDeviceInfo *, std::greater<>> VulkanDevice::listPhysicalDevices() const {
+        const std::vector<PhysicalDeviceInfo> &all_devices = instance->get_physical_devices();
+        ASSERT_EQUAL(all_devices.empty(), false, "No Supported GPUs. Please Install Vulkan.")
+        std::multimap<int, const PhysicalDeviceInfo *, std::greater<>> devices;
+        for (const PhysicalDeviceInfo &device: all_devices) {
+            int score{this->rateDevice(device)};
+            devices.insert(std::make_pair(score, &device));
         }
         return devices;
     }
-    int VulkanDevice::rateDevice(const VkPhysicalDevice *device) const {
-        VkPhysicalDeviceProperties properties;
-        VkPhysicalDeviceFeatures features;
-        uint32_t extension_count = 0;
-        vkEnumerateDeviceExtensionProperties(*device, nullptr, &extension_count, nullptr);
-        std::vector<VkExtensionProperties> extensions(extension_count);
-        vkEnumerateDeviceExtensionProperties(*device, nullptr, &extension_count, extensions.data());
-        vkGetPhysicalDeviceProperties(*device, &properties);
-        vkGetPhysicalDeviceFeatures(*device, &features);
-        std::set<std::string> required_extensions(deviceExtensions.begin(), deviceExtensions.end());
-        for (const auto &[extensionName, specVersion]: extensions) {
-            required_extensions.erase(extensionName);
-        }
-        if (!required_extensions.empty()) {
-            return -1;
+    int VulkanDevice::rateDevice(const PhysicalDeviceInfo &device) const {
+        for (const char *extension: deviceExtensions) {
+            if (!device.has_extension(extension)) {
+                return -1;
+            }
         }
-        if (!features.geometryShader)
+        if (!device.features.geometryShader)
             return -1;
         if (!findQueueFamilyIndex(device).isComplete())
             return -1;
         int score = 0;
-        if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+        if (device.properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
             score += 1000;
-        score += static_cast<int>(properties.limits.maxImageDimension2D);
+        if (device.capabilities.descriptor_indexing)
+            score += 500;
+        score += static_cast<int>(device.properties.limits.maxImageDimension2D);
         return score;
     }
 } // namespace pyro
@@ -5,82 +5,134 @@
 #ifndef VULKANDEVICE_HPP
 #define VULKANDEVICE_HPP
 
+#include <array>
 #include <map>
 #include <optional>
 #include <vulkan/vulkan.h>
 
 #include "../window/PyroWindow.hpp"
 #include "VulkanInstance.hpp"
+#include "VulkanPhysicalDevice.hpp"
 
 namespace pyro {
     const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
     struct SwapChainSupportDetails {
         VkSurfaceCapabilitiesKHR capabilities;
         std::vector<VkSurfaceFormatKHR> formats;
         std::vector<VkPresentModeKHR> presentModes;
     };
+    // Preferred presentation mode; unsupported modes fall back towards FIFO, which every surface supports.
+    enum class PresentModePolicy {
+        // Vsync with a queue; never tears.
+        FIFO,
+        // Vsync, but a late frame is shown immediately and may tear instead of waiting for the next blank.
+        FIFO_RELAXED,
+        // Vsync; a newer frame replaces the queued one, so the CPU never blocks on present.
+        MAILBOX,
+        // No vsync; lowest latency, tears.
+        IMMEDIATE,
+    };
+    struct PresentConfig {
+        PresentModePolicy mode = PresentModePolicy::MAILBOX;
+        // Swap chain images to request, clamped to what the surface allows; 0 picks minImageCount + 1.
+        uint32_t image_count = 0;
+        // Pace frames so input is sampled just before the previous frame reaches the screen (see PyroFramePacer).
+        bool low_latency = false;
+    };
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphics_family_index;
         std::optional<uint32_t> present_family_index;
+        // A compute family without graphics when the device has one, otherwise the graphics family.
+        std::optional<uint32_t> compute_family_index;
         bool isComplete() { return present_family_index.has_value() && graphics_family_index.has_value(); }
     };
     class VulkanDevice {
     public:
-        VulkanDevice(VulkanInstance *instance, PyroWindow *window, int gpu_index = 0);
+        VulkanDevice(VulkanInstance *instance, PyroWindow *window, int gpu_index = 0,
+                     const PresentConfig &present_config = {});
         ~VulkanDevice();
         VulkanDevice(const VulkanDevice &) = delete;
         VulkanDevice &operator=(const VulkanDevice &) = delete;
 
         static std::string get_physical_device_name(const VkPhysicalDevice *device);
-        void record_command_buffer(const VkCommandBuffer &command_buffer, uint32_t imageIndex,
-                                   const VkRenderPass &renderPass, VkPipeline graphics_pipeline,
-                                   std::vector<VkFramebuffer> swapChainFrameBuffers);
-
+        std::optional<uint32_t> find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+        // Highest sample count up to `requested` that both color and depth framebuffers support.
+        VkSampleCountFlagBits choose_sample_count(uint32_t requested) const;
+        // One-off command buffer on the graphics queue; end_single_time_commands() submits it and waits.
+        VkCommandBuffer begin_single_time_commands() const;
+        void end_single_time_commands(VkCommandBuffer command_buffer) const;
+        // Blocks until the present tagged with `present_id` (or a later one) is on screen, or `timeout_ns`
+        // passes. Only valid when the present_wait capability is enabled.
+        VkResult wait_for_present(uint64_t present_id, uint64_t timeout_ns) const;
 
         VkPhysicalDevice get_physical_device() const { return physicalDevice; }
+        const VkPhysicalDeviceProperties &get_properties() const { return properties; }
+        const DeviceCapabilities &get_capabilities() const { return capabilities; }
+        const VkPhysicalDeviceMemoryProperties &get_memory_properties() const { return memoryProperties; }
         QueueFamilyIndices get_indices() const { return indices; }
         VkQueue get_graphics_queue() const { return graphicsQueue; }
         VkQueue get_present_queue() const { return presentQueue; }
+        VkQueue get_compute_queue() const { return computeQueue; }
+        // False when the compute queue is the graphics queue itself.
+        bool has_async_compute() const { return computeQueue != graphicsQueue; }
         VkDevice get_logical_device() const { return logicalDevice; }
         VkSurfaceKHR get_surface() const { return surface; }
         VkCommandPool get_command_pool() const { return commandPool; }
+        VkCommandPool get_compute_command_pool() const { return computeCommandPool; }
         VkExtent2D get_swap_chain_extent() const { return swapChainExtent; }
         VkSwapchainKHR get_swap_chain() const { return swapChain; }
         std::vector<VkImage> get_swap_chain_images() const { return swapChainImages; }
         VkFormat get_swap_chain_image_format() const { return swapChainImageFormat; }
+        VkImageUsageFlags get_swap_chain_usage() const { return swapChainUsage; }
+        VkPresentModeKHR get_present_mode() const { return presentMode; }
+        const PresentConfig &get_present_config() const { return presentConfig; }
         std::vector<VkImageView> get_swap_chain_image_views() const { return swapChainImageViews; }
-        VkSemaphore get_image_available_semaphore() const { return imageAvailableSemaphore; }
-        VkSemaphore get_render_finished_semaphore() const { return renderFinishedSemaphore; }
-        const VkFence *get_inflight_fence() const { return &inflightFence; }
-        const VkCommandBuffer *get_command_buffer() const { return &commandBuffer; }
+        VkSemaphore get_image_available_semaphore(uint32_t frame) const { return imageAvailableSemaphores[frame]; }
+        VkSemaphore get_render_finished_semaphore(uint32_t frame) const { return renderFinishedSemaphores[frame]; }
+        const VkFence *get_inflight_fence(uint32_t frame) const { return &inflightFences[frame]; }
+        const VkCommandBuffer *get_command_buffer(uint32_t frame) const { return &commandBuffers[frame]; }
 
-        std::multimap<int, VkPhysicalDevice, std::greater<>> listPhysicalDevices() const;
-        int rateDevice(const VkPhysicalDevice *device) const;
-        QueueFamilyIndices findQueueFamilyIndex(const VkPhysicalDevice *device) const;
+        // Devices by descending score; unusable ones score -1.
+        std::multimap<int, const PhysicalDeviceInfo *, std::greater<>> listPhysicalDevices() const;
+        int rateDevice(const PhysicalDeviceInfo &device) const;
+        // Surface support is queried once per device; later calls return the cached result.
+        QueueFamilyIndices findQueueFamilyIndex(const PhysicalDeviceInfo &device) const;
 
     private:
         VulkanInstance *instance;
         VkPhysicalDevice physicalDevice;
+        VkPhysicalDeviceProperties properties{};
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
+        DeviceCapabilities capabilities;
         QueueFamilyIndices indices;
+        mutable std::map<VkPhysicalDevice, QueueFamilyIndices> queueFamilyCache;
         VkQueue graphicsQueue{};
         VkQueue presentQueue{};
+        VkQueue computeQueue{};
         VkDevice logicalDevice{};
         VkSurfaceKHR surface;
         VkCommandPool commandPool{};
-        VkCommandBuffer commandBuffer{};
+        VkCommandPool computeCommandPool{};
+        std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> commandBuffers{};
         VkSwapchainKHR swapChain{};
         std::vector<VkImage> swapChainImages;
         VkFormat swapChainImageFormat;
+        VkImageUsageFlags swapChainUsage = 0;
         VkExtent2D swapChainExtent;
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        PresentConfig presentConfig;
+        PFN_vkWaitForPresentKHR waitForPresent = nullptr;
         std::vector<VkImageView> swapChainImageViews;
-        VkSemaphore imageAvailableSemaphore{};
-        VkSemaphore renderFinishedSemaphore{};
-        VkFence inflightFence{};
+        std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> imageAvailableSemaphores{};
+        std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> renderFinishedSemaphores{};
+        std::array<VkFence, MAX_FRAMES_IN_FLIGHT> inflightFences{};
 
 
         void initializeSwapChain(PyroWindow *window) const;
         static VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &formats);
-        static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &modes);
+        static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &modes,
+                                                      PresentModePolicy policy);
         static VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities, PyroWindow *window);
 
 
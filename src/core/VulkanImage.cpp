@@ -0,0 +1,62 @@
+//
+// Created by srijan on 2/19/25.
+//
+
+#include "VulkanImage.hpp"
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    VulkanImage::VulkanImage(VulkanDevice *device, const ImageDesc &desc) : device(device), desc(desc) {
+        VkImageCreateInfo image_info{};
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.format = desc.format;
+        image_info.extent = {desc.extent.width, desc.extent.height, 1};
+        image_info.mipLevels = desc.mip_levels;
+        image_info.arrayLayers = 1;
+        image_info.samples = desc.samples;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.usage = desc.usage;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        ASSERT_EQUAL(vkCreateImage(device->get_logical_device(), &image_info, nullptr, &image), VK_SUCCESS,
+                     "Failed to create image")
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device->get_logical_device(), image, &requirements);
+        std::optional<uint32_t> memory_type = device->find_memory_type(requirements.memoryTypeBits, desc.memory);
+        if (!memory_type.has_value()) {
+            // Extra property bits such as LAZILY_ALLOCATED are hints; fall back to plain device memory.
+            memory_type = device->find_memory_type(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+        ASSERT_EQUAL(memory_type.has_value(), true, "No suitable memory type for image")
+        VkMemoryAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize = requirements.size;
+        alloc_info.memoryTypeIndex = memory_type.value();
+        ASSERT_EQUAL(vkAllocateMemory(device->get_logical_device(), &alloc_info, nullptr, &memory), VK_SUCCESS,
+                     "Failed to allocate image memory")
+        vkBindImageMemory(device->get_logical_device(), image, memory, 0);
+        memory_size = requirements.size;
+
+        VkImageViewCreateInfo view_info{};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = image;
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = desc.format;
+        view_info.subresourceRange.aspectMask = desc.aspect;
+        view_info.subresourceRange.baseMipLevel = 0;
+        view_info.subresourceRange.levelCount = desc.mip_levels;
+        view_info.subresourceRange.baseArrayLayer = 0;
+        view_info.subresourceRange.layerCount = 1;
+        ASSERT_EQUAL(vkCreateImageView(device->get_logical_device(), &view_info, nullptr, &view), VK_SUCCESS,
+                     "Failed to create image view")
+    }
+
+    VulkanImage::~VulkanImage() {
+        vkDestroyImageView(device->get_logical_device(), view, nullptr);
+        vkDestroyImage(device->get_logical_device(), image, nullptr);
+        vkFreeMemory(device->get_logical_device(), memory, nullptr);
+    }
+} // namespace pyro
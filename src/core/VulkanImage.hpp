@@ -0,0 +1,48 @@
+//
+// Created by srijan on 2/19/25.
+//
+
+#ifndef VULKANIMAGE_HPP
+#define VULKANIMAGE_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanDevice.hpp"
+
+namespace pyro {
+
+    struct ImageDesc {
+        VkExtent2D extent{};
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        uint32_t mip_levels = 1;
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+        VkMemoryPropertyFlags memory = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    };
+
+    // A 2D optimal-tiling image with its own dedicated allocation and a view over every mip level.
+    class VulkanImage {
+    public:
+        VulkanImage(VulkanDevice *device, const ImageDesc &desc);
+        ~VulkanImage();
+        VulkanImage(const VulkanImage &) = delete;
+        VulkanImage &operator=(const VulkanImage &) = delete;
+
+        VkImage get_image() const { return image; }
+        VkImageView get_view() const { return view; }
+        const ImageDesc &get_desc() const { return desc; }
+        VkDeviceSize get_memory_size() const { return memory_size; }
+
+    private:
+        VulkanDevice *device;
+        ImageDesc desc;
+        VkImage image{};
+        VkDeviceMemory memory{};
+        VkImageView view{};
+        VkDeviceSize memory_size = 0;
+    };
+
+} // namespace pyro
+
+#endif // VULKANIMAGE_HPP
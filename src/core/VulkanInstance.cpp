@@ -3,10 +3,29 @@
 //
 
 #include "VulkanInstance.hpp"
+#include "../profiler/PyroStartup.hpp"
 #include "../utils/Logger.hpp"
 
 namespace pyro {
-    VulkanInstance::VulkanInstance(PyroWindow *window) {
+    VulkanInstance::VulkanInstance() {
+        // SDL hands out its surface extensions on the thread that owns video; only instance creation (loader,
+        // layers and ICDs, the slow part) moves to the worker.
+        std::vector<const char *> extensions = PyroWindow::get_instance_extensions();
+        ready = std::async(std::launch::async, [this, extensions = std::move(extensions)]() mutable {
+                    create(std::move(extensions));
+                }).share();
+    }
+
+    void VulkanInstance::create(std::vector<const char *> extensions) {
+        {
+            StartupScope scope("create_instance");
+            create_instance(extensions);
+        }
+        StartupScope scope("query_physical_devices");
+        physical_devices = PhysicalDeviceInfo::query_all(instance);
+    }
+
+    void VulkanInstance::create_instance(std::vector<const char *> &extensions) {
         VkApplicationInfo app_info = {};
         app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
         app_info.apiVersion = VK_API_VERSION_1_3;
@@ -15,30 +34,22 @@ namespace pyro {
         app_info.pEngineName = "pyro core";
         app_info.engineVersion = VK_MAKE_VERSION(0, 0, 1);
 
-        uint32_t extension_count = 0;
-        char const *const *extensions = window->get_instance_extensions(&extension_count);
-
         VkInstanceCreateInfo instance_create_info = {};
         instance_create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
         instance_create_info.pApplicationInfo = &app_info;
-        instance_create_info.enabledExtensionCount = extension_count;
-        instance_create_info.ppEnabledExtensionNames = extensions;
         instance_create_info.enabledLayerCount = 0;
 #ifdef PYRO_DEBUG
         ASSERT_EQUAL(checkValidationLayerSupport(), true, "Failed to find Validation Layer");
-        std::vector extensions_vector(extensions, extensions + extension_count);
-        extensions_vector.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
-        instance_create_info.enabledExtensionCount = extensions_vector.size();
-        instance_create_info.ppEnabledExtensionNames = extensions_vector.data();
+        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
         instance_create_info.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
         instance_create_info.ppEnabledLayerNames = validationLayers.data();
 
         std::string ext;
-        for (const auto &i: extensions_vector) {
+        for (const auto &i: extensions) {
             ext += +i;
             ext += ", ";
         }
-        LOG(LogLevel::DEBUG, "{} Extensions: {}", extensions_vector.size(), ext);
+        LOG(LogLevel::DEBUG, "{} Extensions: {}", extensions.size(), ext);
 
         VkDebugUtilsMessengerCreateInfoEXT debug_utils_messenger_create_info = {};
         debug_utils_messenger_create_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
@@ -51,10 +62,12 @@ namespace pyro {
         debug_utils_messenger_create_info.pfnUserCallback = debugCallback;
         instance_create_info.pNext = reinterpret_cast<VkDebugUtilsMessengerEXT *>(&debug_utils_messenger_create_info);
 #endif
+        instance_create_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+        instance_create_info.ppEnabledExtensionNames = extensions.data();
         ASSERT_EQUAL(vkCreateInstance(&instance_create_info, nullptr, &instance), VK_SUCCESS,
                "Failed to create Vulkan Instance")
         LOG(LogLevel::INFO, "Created Vulkan Instance");
-        LOG(LogLevel::DEBUG, "Enabled extensions: {}", extension_count);
+        LOG(LogLevel::DEBUG, "Enabled extensions: {}", extensions.size());
 
 #ifdef PYRO_DEBUG
         auto func = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>(
@@ -66,6 +79,7 @@ namespace pyro {
     }
 
     VulkanInstance::~VulkanInstance() {
+        ready.wait();
 #ifdef PYRO_DEBUG
         auto func = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(
                 vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT"));
@@ -5,9 +5,12 @@
 #ifndef VULKANINSTANCE_HPP
 #define VULKANINSTANCE_HPP
 
+#include <future>
+#include <vector>
 #include <vulkan/vulkan.h>
 
 #include "../window/PyroWindow.hpp"
+#include "VulkanPhysicalDevice.hpp"
 
 namespace pyro {
     class VulkanInstance {
@@ -15,10 +18,19 @@ namespace pyro {
 #ifdef PYRO_DEBUG
         const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
 #endif
-        VulkanInstance(PyroWindow *window);
+        // Creates the instance and queries every physical device on a worker thread, so the caller can create
+        // its window meanwhile; the accessors below wait for it.
+        VulkanInstance();
 
         ~VulkanInstance();
-        VkInstance *getInstance() { return &instance; }
+        VkInstance *getInstance() {
+            ready.get();
+            return &instance;
+        }
+        const std::vector<PhysicalDeviceInfo> &get_physical_devices() {
+            ready.get();
+            return physical_devices;
+        }
 
 #ifdef PYRO_DEBUG
         bool checkValidationLayerSupport();
@@ -26,6 +38,11 @@ namespace pyro {
 
     private:
         VkInstance instance{};
+        std::vector<PhysicalDeviceInfo> physical_devices;
+        std::shared_future<void> ready;
+
+        void create(std::vector<const char *> extensions);
+        void create_instance(std::vector<const char *> &extensions);
 #ifdef PYRO_DEBUG
         VkDebugUtilsMessengerEXT debug_utils_messenger{};
 
@@ -35,8 +52,8 @@ namespace pyro {
                                                             VkDebugUtilsMessageTypeFlagsEXT messageType,
                                                             const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData,
                                                             void *pUserData);
-    };
 #endif
+    };
 } // namespace pyro
 
 #endif // VULKANINSTANCE_HPP
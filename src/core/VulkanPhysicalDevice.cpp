@@ -0,0 +1,133 @@
+//
+// Created by srijan on 3/7/25.
+//
+
+#include "VulkanPhysicalDevice.hpp"
+
+#include <algorithm>
+
+namespace pyro {
+    namespace {
+        DeviceCapabilities query_capabilities(const PhysicalDeviceInfo &info) {
+            DeviceCapabilities caps;
+            const VkPhysicalDeviceFeatures &features = info.features;
+            caps.api_version = info.properties.apiVersion;
+            caps.texture_compression_bc = features.textureCompressionBC;
+            caps.fragment_stores_and_atomics = features.fragmentStoresAndAtomics;
+            caps.multi_draw_indirect = features.multiDrawIndirect && features.drawIndirectFirstInstance;
+            if (caps.api_version < VK_API_VERSION_1_2) {
+                return caps;
+            }
+
+            // Mesh shaders are only used together with 1.3's dynamic rendering and SPIR-V 1.4.
+            const bool has_mesh_shader_extension = caps.api_version >= VK_API_VERSION_1_3 &&
+                                                   info.has_extension(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+            const bool has_present_wait_extensions = info.has_extension(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+                                                     info.has_extension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+            VkPhysicalDeviceVulkan13Features features13 = {};
+            features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            VkPhysicalDeviceVulkan12Features features12 = {};
+            features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            void **feature_chain = &features12.pNext;
+            if (caps.api_version >= VK_API_VERSION_1_3) {
+                features12.pNext = &features13;
+                feature_chain = &features13.pNext;
+            }
+            VkPhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features = {};
+            mesh_shader_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+            if (has_mesh_shader_extension) {
+                *feature_chain = &mesh_shader_features;
+                feature_chain = &mesh_shader_features.pNext;
+            }
+            VkPhysicalDevicePresentIdFeaturesKHR present_id_features = {};
+            present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+            VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features = {};
+            present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+            if (has_present_wait_extensions) {
+                *feature_chain = &present_id_features;
+                present_id_features.pNext = &present_wait_features;
+            }
+            VkPhysicalDeviceFeatures2 features2 = {};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &features12;
+            vkGetPhysicalDeviceFeatures2(info.handle, &features2);
+
+            VkPhysicalDeviceMeshShaderPropertiesEXT mesh_shader_properties = {};
+            mesh_shader_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_PROPERTIES_EXT;
+            VkPhysicalDeviceVulkan12Properties properties12 = {};
+            properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+            properties12.pNext = has_mesh_shader_extension ? &mesh_shader_properties : nullptr;
+            VkPhysicalDeviceProperties2 properties2 = {};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &properties12;
+            vkGetPhysicalDeviceProperties2(info.handle, &properties2);
+
+            caps.timeline_semaphores = features12.timelineSemaphore;
+            caps.synchronization2 = features13.synchronization2;
+            caps.dynamic_rendering = features13.dynamicRendering;
+            caps.descriptor_indexing = features12.descriptorIndexing && features12.runtimeDescriptorArray &&
+                                       features12.descriptorBindingPartiallyBound &&
+                                       features12.descriptorBindingUpdateUnusedWhilePending &&
+                                       features12.descriptorBindingSampledImageUpdateAfterBind &&
+                                       features12.descriptorBindingStorageBufferUpdateAfterBind &&
+                                       features12.shaderSampledImageArrayNonUniformIndexing &&
+                                       features12.shaderStorageBufferArrayNonUniformIndexing;
+            caps.max_update_after_bind_sampled_images =
+                    std::min(properties12.maxDescriptorSetUpdateAfterBindSampledImages,
+                             properties12.maxPerStageDescriptorUpdateAfterBindSampledImages);
+            caps.max_update_after_bind_storage_buffers =
+                    std::min(properties12.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                             properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers);
+            caps.mesh_shader = has_mesh_shader_extension && mesh_shader_features.taskShader &&
+                               mesh_shader_features.meshShader &&
+                               mesh_shader_properties.maxMeshOutputVertices >= 64 &&
+                               mesh_shader_properties.maxMeshOutputPrimitives >= 124;
+            caps.present_wait = has_present_wait_extensions && present_id_features.presentId &&
+                                present_wait_features.presentWait;
+            return caps;
+        }
+    } // namespace
+
+    bool PhysicalDeviceInfo::has_extension(const char *name) const {
+        return std::ranges::any_of(extensions, [name](const std::string &extension) { return extension == name; });
+    }
+
+    PhysicalDeviceInfo PhysicalDeviceInfo::query(const VkPhysicalDevice device) {
+        PhysicalDeviceInfo info;
+        info.handle = device;
+        vkGetPhysicalDeviceProperties(device, &info.properties);
+        vkGetPhysicalDeviceFeatures(device, &info.features);
+        vkGetPhysicalDeviceMemoryProperties(device, &info.memory_properties);
+
+        uint32_t family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count, nullptr);
+        info.queue_families.resize(family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count, info.queue_families.data());
+
+        uint32_t extension_count = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+        std::vector<VkExtensionProperties> extensions(extension_count);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, extensions.data());
+        info.extensions.reserve(extension_count);
+        for (const VkExtensionProperties &extension : extensions) {
+            info.extensions.emplace_back(extension.extensionName);
+        }
+
+        info.capabilities = query_capabilities(info);
+        return info;
+    }
+
+    std::vector<PhysicalDeviceInfo> PhysicalDeviceInfo::query_all(const VkInstance instance) {
+        uint32_t device_count = 0;
+        vkEnumeratePhysicalDevices(instance, &device_count, nullptr);
+        std::vector<VkPhysicalDevice> devices(device_count);
+        vkEnumeratePhysicalDevices(instance, &device_count, devices.data());
+        std::vector<PhysicalDeviceInfo> infos;
+        infos.reserve(device_count);
+        for (const VkPhysicalDevice device : devices) {
+            infos.push_back(query(device));
+        }
+        return infos;
+    }
+} // namespace pyro
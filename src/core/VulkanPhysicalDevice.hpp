@@ -0,0 +1,54 @@
+//
+// Created by srijan on 3/7/25.
+//
+
+#ifndef VULKANPHYSICALDEVICE_HPP
+#define VULKANPHYSICALDEVICE_HPP
+
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace pyro {
+    struct DeviceCapabilities {
+        uint32_t api_version = 0;
+        bool texture_compression_bc = false;
+        // Needed for the texture streaming feedback writes from fragment shaders.
+        bool fragment_stores_and_atomics = false;
+        // multiDrawIndirect with drawIndirectFirstInstance: one indirect call for many commands, each able to
+        // pick its instance data through firstInstance.
+        bool multi_draw_indirect = false;
+        // Core in 1.2; cross-queue synchronisation for async compute.
+        bool timeline_semaphores = false;
+        // Core in 1.3; the render graph records its barriers with vkCmdPipelineBarrier2.
+        bool synchronization2 = false;
+        // Core in 1.3; pipelines and passes are built against attachment formats instead of render passes.
+        bool dynamic_rendering = false;
+        // VK_EXT_descriptor_indexing (core in 1.2) with everything bindless tables rely on.
+        bool descriptor_indexing = false;
+        uint32_t max_update_after_bind_sampled_images = 0;
+        uint32_t max_update_after_bind_storage_buffers = 0;
+        // VK_EXT_mesh_shader with task shaders, and mesh workgroups big enough for a whole meshlet.
+        bool mesh_shader = false;
+        // VK_KHR_present_id with VK_KHR_present_wait: presents can be tagged and waited on until they are shown.
+        bool present_wait = false;
+    };
+    // Everything about a physical device that doesn't depend on a surface, queried once per device (one
+    // extension enumeration, one feature/property chain) so rating and device creation can share it.
+    struct PhysicalDeviceInfo {
+        VkPhysicalDevice handle = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties properties{};
+        VkPhysicalDeviceFeatures features{};
+        VkPhysicalDeviceMemoryProperties memory_properties{};
+        DeviceCapabilities capabilities;
+        std::vector<VkQueueFamilyProperties> queue_families;
+        std::vector<std::string> extensions;
+
+        bool has_extension(const char *name) const;
+
+        static PhysicalDeviceInfo query(VkPhysicalDevice device);
+        static std::vector<PhysicalDeviceInfo> query_all(VkInstance instance);
+    };
+} // namespace pyro
+
+#endif // VULKANPHYSICALDEVICE_HPP
@@ -0,0 +1,84 @@
+//
+// Created by srijan on 2/21/25.
+//
+
+#include "VulkanTimelineSemaphore.hpp"
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    VulkanTimelineSemaphore::VulkanTimelineSemaphore(VulkanDevice *device, const uint64_t initial_value) :
+        device(device) {
+        ASSERT_EQUAL(device->get_capabilities().timeline_semaphores, true, "Timeline semaphores are not supported")
+        VkSemaphoreTypeCreateInfo type_info{};
+        type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        type_info.initialValue = initial_value;
+        VkSemaphoreCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        create_info.pNext = &type_info;
+        ASSERT_EQUAL(vkCreateSemaphore(device->get_logical_device(), &create_info, nullptr, &semaphore), VK_SUCCESS,
+                     "Failed to create timeline semaphore")
+    }
+
+    VulkanTimelineSemaphore::~VulkanTimelineSemaphore() {
+        vkDestroySemaphore(device->get_logical_device(), semaphore, nullptr);
+    }
+
+    uint64_t VulkanTimelineSemaphore::get_value() const {
+        uint64_t value = 0;
+        vkGetSemaphoreCounterValue(device->get_logical_device(), semaphore, &value);
+        return value;
+    }
+
+    bool VulkanTimelineSemaphore::wait(const uint64_t value, const uint64_t timeout) const {
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &semaphore;
+        wait_info.pValues = &value;
+        return vkWaitSemaphores(device->get_logical_device(), &wait_info, timeout) == VK_SUCCESS;
+    }
+
+    void VulkanTimelineSemaphore::signal(const uint64_t value) const {
+        VkSemaphoreSignalInfo signal_info{};
+        signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+        signal_info.semaphore = semaphore;
+        signal_info.value = value;
+        ASSERT_EQUAL(vkSignalSemaphore(device->get_logical_device(), &signal_info), VK_SUCCESS,
+                     "Failed to signal timeline semaphore")
+    }
+
+    void QueueSubmission::wait(const VkSemaphore semaphore, const VkPipelineStageFlags stage, const uint64_t value) {
+        wait_semaphores.push_back(semaphore);
+        wait_stages.push_back(stage);
+        wait_values.push_back(value);
+    }
+
+    void QueueSubmission::signal(const VkSemaphore semaphore, const uint64_t value) {
+        signal_semaphores.push_back(semaphore);
+        signal_values.push_back(value);
+    }
+
+    VkResult QueueSubmission::submit(const VkQueue queue, const VkCommandBuffer *command_buffers,
+                                     const uint32_t command_buffer_count, const VkFence fence) const {
+        VkTimelineSemaphoreSubmitInfo timeline_info{};
+        timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+        timeline_info.pWaitSemaphoreValues = wait_values.data();
+        timeline_info.signalSemaphoreValueCount = static_cast<uint32_t>(signal_values.size());
+        timeline_info.pSignalSemaphoreValues = signal_values.data();
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.pNext = &timeline_info;
+        submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+        submit_info.pWaitSemaphores = wait_semaphores.data();
+        submit_info.pWaitDstStageMask = wait_stages.data();
+        submit_info.commandBufferCount = command_buffer_count;
+        submit_info.pCommandBuffers = command_buffers;
+        submit_info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
+        submit_info.pSignalSemaphores = signal_semaphores.data();
+        return vkQueueSubmit(queue, 1, &submit_info, fence);
+    }
+} // namespace pyro
@@ -0,0 +1,55 @@
+//
+// Created by srijan on 2/21/25.
+//
+
+#ifndef VULKANTIMELINESEMAPHORE_HPP
+#define VULKANTIMELINESEMAPHORE_HPP
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "VulkanDevice.hpp"
+
+namespace pyro {
+
+    // A monotonically increasing 64-bit counter shared by queues and the host. A submission signals a value
+    // when it completes, and other submissions or the host wait for that value.
+    class VulkanTimelineSemaphore {
+    public:
+        explicit VulkanTimelineSemaphore(VulkanDevice *device, uint64_t initial_value = 0);
+        ~VulkanTimelineSemaphore();
+        VulkanTimelineSemaphore(const VulkanTimelineSemaphore &) = delete;
+        VulkanTimelineSemaphore &operator=(const VulkanTimelineSemaphore &) = delete;
+
+        uint64_t get_value() const;
+        // Blocks until the counter reaches `value`. Returns false on timeout.
+        bool wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+        void signal(uint64_t value) const;
+
+        VkSemaphore get_semaphore() const { return semaphore; }
+
+    private:
+        VulkanDevice *device;
+        VkSemaphore semaphore{};
+    };
+
+    // The wait and signal semaphores of one vkQueueSubmit. Binary and timeline semaphores can be mixed;
+    // the value is ignored for binary ones.
+    class QueueSubmission {
+    public:
+        void wait(VkSemaphore semaphore, VkPipelineStageFlags stage, uint64_t value = 0);
+        void signal(VkSemaphore semaphore, uint64_t value = 0);
+        VkResult submit(VkQueue queue, const VkCommandBuffer *command_buffers, uint32_t command_buffer_count,
+                        VkFence fence = VK_NULL_HANDLE) const;
+
+    private:
+        std::vector<VkSemaphore> wait_semaphores;
+        std::vector<VkPipelineStageFlags> wait_stages;
+        std::vector<uint64_t> wait_values;
+        std::vector<VkSemaphore> signal_semaphores;
+        std::vector<uint64_t> signal_values;
+    };
+
+} // namespace pyro
+
+#endif // VULKANTIMELINESEMAPHORE_HPP
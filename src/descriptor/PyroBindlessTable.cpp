@@ -0,0 +1,153 @@
+//
+// Created by srijan on 2/17/25.
+//
+
+#include "PyroBindlessTable.hpp"
+
+#include <algorithm>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    uint32_t PyroBindlessTable::SlotList::acquire() {
+        if (!free_slots.empty()) {
+            const uint32_t index = free_slots.back();
+            free_slots.pop_back();
+            return index;
+        }
+        ASSERT_EQUAL(next < capacity, true, "Bindless table is full")
+        return next++;
+    }
+
+    void PyroBindlessTable::SlotList::release(const uint32_t index, const uint64_t retire_frame) {
+        pending.emplace_back(index, retire_frame);
+    }
+
+    void PyroBindlessTable::SlotList::recycle(const uint64_t frame_number) {
+        std::erase_if(pending, [&](const std::pair<uint32_t, uint64_t> &slot) {
+            if (slot.second > frame_number) {
+                return false;
+            }
+            free_slots.push_back(slot.first);
+            return true;
+        });
+    }
+
+    PyroBindlessTable::PyroBindlessTable(VulkanDevice *device, PyroDescriptorLayoutCache *layout_cache,
+                                         uint32_t max_images, uint32_t max_buffers, const uint32_t max_samplers) :
+        device(device), images(0), buffers(0), samplers(max_samplers) {
+        ASSERT_EQUAL(is_supported(device), true, "Bindless descriptors need descriptor indexing support")
+        const DeviceCapabilities &caps = device->get_capabilities();
+        max_images = std::min(max_images, caps.max_update_after_bind_sampled_images);
+        max_buffers = std::min(max_buffers, caps.max_update_after_bind_storage_buffers);
+        images = SlotList(max_images);
+        buffers = SlotList(max_buffers);
+
+        constexpr VkDescriptorBindingFlags binding_flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                           VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                           VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        DescriptorLayoutInfo info;
+        info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        info.bindings = {
+                {SAMPLED_IMAGE_BINDING, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, max_images, VK_SHADER_STAGE_ALL, nullptr},
+                {STORAGE_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, max_buffers, VK_SHADER_STAGE_ALL, nullptr},
+                {SAMPLER_BINDING, VK_DESCRIPTOR_TYPE_SAMPLER, max_samplers, VK_SHADER_STAGE_ALL, nullptr},
+        };
+        info.binding_flags = {binding_flags, binding_flags, binding_flags};
+        layout = layout_cache->create_layout(info);
+
+        const VkDescriptorPoolSize pool_sizes[] = {
+                {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, max_images},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, max_buffers},
+                {VK_DESCRIPTOR_TYPE_SAMPLER, max_samplers},
+        };
+        VkDescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        pool_info.maxSets = 1;
+        pool_info.poolSizeCount = 3;
+        pool_info.pPoolSizes = pool_sizes;
+        ASSERT_EQUAL(vkCreateDescriptorPool(device->get_logical_device(), &pool_info, nullptr, &pool), VK_SUCCESS,
+                     "Failed to create bindless descriptor pool")
+
+        VkDescriptorSetAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        alloc_info.descriptorPool = pool;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &layout;
+        ASSERT_EQUAL(vkAllocateDescriptorSets(device->get_logical_device(), &alloc_info, &set), VK_SUCCESS,
+                     "Failed to allocate bindless descriptor set")
+        LOG(LogLevel::INFO, "Bindless table: {} images, {} storage buffers, {} samplers", max_images, max_buffers,
+            max_samplers);
+    }
+
+    PyroBindlessTable::~PyroBindlessTable() {
+        // The layout belongs to the layout cache.
+        vkDestroyDescriptorPool(device->get_logical_device(), pool, nullptr);
+    }
+
+    uint32_t PyroBindlessTable::register_image(const VkImageView image_view, const VkImageLayout layout) {
+        const uint32_t index = images.acquire();
+        const VkDescriptorImageInfo image_info{VK_NULL_HANDLE, image_view, layout};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = SAMPLED_IMAGE_BINDING;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        write.pImageInfo = &image_info;
+        vkUpdateDescriptorSets(device->get_logical_device(), 1, &write, 0, nullptr);
+        return index;
+    }
+
+    uint32_t PyroBindlessTable::register_buffer(const VkBuffer buffer, const VkDeviceSize offset,
+                                                const VkDeviceSize range) {
+        const uint32_t index = buffers.acquire();
+        const VkDescriptorBufferInfo buffer_info{buffer, offset, range};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = STORAGE_BUFFER_BINDING;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &buffer_info;
+        vkUpdateDescriptorSets(device->get_logical_device(), 1, &write, 0, nullptr);
+        return index;
+    }
+
+    uint32_t PyroBindlessTable::register_sampler(const VkSampler sampler) {
+        const uint32_t index = samplers.acquire();
+        const VkDescriptorImageInfo sampler_info{sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = SAMPLER_BINDING;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        write.pImageInfo = &sampler_info;
+        vkUpdateDescriptorSets(device->get_logical_device(), 1, &write, 0, nullptr);
+        return index;
+    }
+
+    void PyroBindlessTable::release_image(const uint32_t index) {
+        images.release(index, frame_number + MAX_FRAMES_IN_FLIGHT);
+    }
+
+    void PyroBindlessTable::release_buffer(const uint32_t index) {
+        buffers.release(index, frame_number + MAX_FRAMES_IN_FLIGHT);
+    }
+
+    void PyroBindlessTable::begin_frame(const uint64_t frame_number) {
+        this->frame_number = frame_number;
+        images.recycle(frame_number);
+        buffers.recycle(frame_number);
+    }
+
+    void PyroBindlessTable::bind(const VkCommandBuffer command_buffer, const VkPipelineBindPoint bind_point,
+                                 const VkPipelineLayout layout, const uint32_t set_index) const {
+        vkCmdBindDescriptorSets(command_buffer, bind_point, layout, set_index, 1, &set, 0, nullptr);
+    }
+} // namespace pyro
@@ -0,0 +1,78 @@
+//
+// Created by srijan on 2/17/25.
+//
+
+#ifndef PYROBINDLESSTABLE_HPP
+#define PYROBINDLESSTABLE_HPP
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "PyroDescriptorLayoutCache.hpp"
+
+namespace pyro {
+
+    // One update-after-bind, partially-bound descriptor set holding every sampled image, storage buffer and
+    // sampler in use. Resources are referred to by the 32-bit slot returned from register_*(), handed to shaders
+    // through push constants or instance data, so draws never rebind descriptors. Must match
+    // assets/shaders/include/bindless.glsl.
+    class PyroBindlessTable {
+    public:
+        static constexpr uint32_t SAMPLED_IMAGE_BINDING = 0;
+        static constexpr uint32_t STORAGE_BUFFER_BINDING = 1;
+        static constexpr uint32_t SAMPLER_BINDING = 2;
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        static bool is_supported(const VulkanDevice *device) { return device->get_capabilities().descriptor_indexing; }
+
+        PyroBindlessTable(VulkanDevice *device, PyroDescriptorLayoutCache *layout_cache, uint32_t max_images = 16384,
+                          uint32_t max_buffers = 8192, uint32_t max_samplers = 32);
+        ~PyroBindlessTable();
+        PyroBindlessTable(const PyroBindlessTable &) = delete;
+        PyroBindlessTable &operator=(const PyroBindlessTable &) = delete;
+
+        uint32_t register_image(VkImageView image_view, VkImageLayout layout);
+        uint32_t register_buffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+        uint32_t register_sampler(VkSampler sampler);
+        void release_image(uint32_t index);
+        void release_buffer(uint32_t index);
+
+        void begin_frame(uint64_t frame_number);
+        void bind(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout,
+                  uint32_t set_index) const;
+
+        VkDescriptorSetLayout get_layout() const { return layout; }
+        uint32_t get_image_count() const { return images.in_use(); }
+        uint32_t get_buffer_count() const { return buffers.in_use(); }
+
+    private:
+        // Slot allocator for one binding. Released slots are only recycled once every frame that could still
+        // reference them has retired.
+        class SlotList {
+        public:
+            explicit SlotList(uint32_t capacity) : capacity(capacity) {}
+            uint32_t acquire();
+            void release(uint32_t index, uint64_t retire_frame);
+            void recycle(uint64_t frame_number);
+            uint32_t in_use() const { return next - static_cast<uint32_t>(free_slots.size() + pending.size()); }
+
+        private:
+            uint32_t capacity;
+            uint32_t next = 0;
+            std::vector<uint32_t> free_slots;
+            std::vector<std::pair<uint32_t, uint64_t>> pending;
+        };
+
+        VulkanDevice *device;
+        VkDescriptorSetLayout layout;
+        VkDescriptorPool pool{};
+        VkDescriptorSet set{};
+        SlotList images;
+        SlotList buffers;
+        SlotList samplers;
+        uint64_t frame_number = 0;
+    };
+
+} // namespace pyro
+
+#endif // PYROBINDLESSTABLE_HPP
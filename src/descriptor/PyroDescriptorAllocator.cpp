@@ -0,0 +1,112 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#include "PyroDescriptorAllocator.hpp"
+
+#include <algorithm>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    const std::vector<PyroDescriptorAllocator::PoolSizeRatio> PyroDescriptorAllocator::pool_size_ratios = {
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},         {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},         {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 0.5f},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f}, {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+            {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},          {VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f},
+    };
+
+    PyroDescriptorAllocator::PyroDescriptorAllocator(VulkanDevice *device, const uint32_t initial_sets,
+                                                     const VkDescriptorPoolCreateFlags pool_flags) :
+        device(device), pool_flags(pool_flags), sets_per_pool(initial_sets) {}
+
+    PyroDescriptorAllocator::~PyroDescriptorAllocator() {
+        const VkDevice logical_device = device->get_logical_device();
+        for (const auto pool: used_pools) {
+            vkDestroyDescriptorPool(logical_device, pool, nullptr);
+        }
+        for (const auto pool: free_pools) {
+            vkDestroyDescriptorPool(logical_device, pool, nullptr);
+        }
+        if (current_pool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(logical_device, current_pool, nullptr);
+        }
+    }
+
+    VkDescriptorPool PyroDescriptorAllocator::create_pool(const uint32_t set_count) const {
+        std::vector<VkDescriptorPoolSize> sizes;
+        sizes.reserve(pool_size_ratios.size());
+        for (const auto &[type, ratio]: pool_size_ratios) {
+            sizes.push_back({type, std::max(1u, static_cast<uint32_t>(ratio * static_cast<float>(set_count)))});
+        }
+        VkDescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.flags = pool_flags;
+        pool_info.maxSets = set_count;
+        pool_info.poolSizeCount = static_cast<uint32_t>(sizes.size());
+        pool_info.pPoolSizes = sizes.data();
+
+        VkDescriptorPool pool;
+        ASSERT_EQUAL(vkCreateDescriptorPool(device->get_logical_device(), &pool_info, nullptr, &pool), VK_SUCCESS,
+                     "Failed to create descriptor pool")
+        LOG(LogLevel::DEBUG, "Created descriptor pool for {} sets", set_count);
+        return pool;
+    }
+
+    VkDescriptorPool PyroDescriptorAllocator::grab_pool() {
+        if (!free_pools.empty()) {
+            const VkDescriptorPool pool = free_pools.back();
+            free_pools.pop_back();
+            return pool;
+        }
+        const VkDescriptorPool pool = create_pool(sets_per_pool);
+        sets_per_pool = std::min(sets_per_pool + sets_per_pool / 2, MAX_SETS_PER_POOL);
+        return pool;
+    }
+
+    VkDescriptorSet PyroDescriptorAllocator::allocate(const VkDescriptorSetLayout layout, VkDescriptorPool *out_pool) {
+        if (current_pool == VK_NULL_HANDLE) {
+            current_pool = grab_pool();
+        }
+        VkDescriptorSetAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        alloc_info.descriptorPool = current_pool;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &layout;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkResult result = vkAllocateDescriptorSets(device->get_logical_device(), &alloc_info, &set);
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+            // Current pool is exhausted: retire it until the next reset and retry once with a fresh one.
+            used_pools.push_back(current_pool);
+            current_pool = grab_pool();
+            alloc_info.descriptorPool = current_pool;
+            result = vkAllocateDescriptorSets(device->get_logical_device(), &alloc_info, &set);
+        }
+        ASSERT_EQUAL(result, VK_SUCCESS, "Failed to allocate descriptor set")
+        allocation_count++;
+        if (out_pool != nullptr) {
+            *out_pool = current_pool;
+        }
+        return set;
+    }
+
+    void PyroDescriptorAllocator::free(const VkDescriptorPool pool, const VkDescriptorSet set) {
+        ASSERT_EQUAL((pool_flags & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT) != 0, true,
+                     "Descriptor allocator was not created with individually freeable sets")
+        vkFreeDescriptorSets(device->get_logical_device(), pool, 1, &set);
+    }
+
+    void PyroDescriptorAllocator::reset_pools() {
+        const VkDevice logical_device = device->get_logical_device();
+        for (const auto pool: used_pools) {
+            vkResetDescriptorPool(logical_device, pool, 0);
+            free_pools.push_back(pool);
+        }
+        used_pools.clear();
+        if (current_pool != VK_NULL_HANDLE) {
+            vkResetDescriptorPool(logical_device, current_pool, 0);
+        }
+        allocation_count = 0;
+    }
+} // namespace pyro
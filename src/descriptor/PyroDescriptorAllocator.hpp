@@ -0,0 +1,56 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#ifndef PYRODESCRIPTORALLOCATOR_HPP
+#define PYRODESCRIPTORALLOCATOR_HPP
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+
+namespace pyro {
+
+    // Hands out descriptor sets from a list of pools. When the current pool runs dry another one is taken from
+    // the free list (or created, each new pool larger than the last). reset_pools() recycles every pool at once,
+    // which is how per-frame allocators are cleared.
+    class PyroDescriptorAllocator {
+    public:
+        struct PoolSizeRatio {
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        explicit PyroDescriptorAllocator(VulkanDevice *device, uint32_t initial_sets = 64,
+                                         VkDescriptorPoolCreateFlags pool_flags = 0);
+        ~PyroDescriptorAllocator();
+        PyroDescriptorAllocator(const PyroDescriptorAllocator &) = delete;
+        PyroDescriptorAllocator &operator=(const PyroDescriptorAllocator &) = delete;
+
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout, VkDescriptorPool *out_pool = nullptr);
+        void free(VkDescriptorPool pool, VkDescriptorSet set);
+        void reset_pools();
+
+        uint32_t get_allocation_count() const { return allocation_count; }
+        size_t get_pool_count() const { return used_pools.size() + free_pools.size() + (current_pool ? 1 : 0); }
+
+    private:
+        static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+        static const std::vector<PoolSizeRatio> pool_size_ratios;
+
+        VkDescriptorPool grab_pool();
+        VkDescriptorPool create_pool(uint32_t set_count) const;
+
+        VulkanDevice *device;
+        VkDescriptorPoolCreateFlags pool_flags;
+        uint32_t sets_per_pool;
+        uint32_t allocation_count = 0;
+        VkDescriptorPool current_pool = VK_NULL_HANDLE;
+        std::vector<VkDescriptorPool> used_pools;
+        std::vector<VkDescriptorPool> free_pools;
+    };
+
+} // namespace pyro
+
+#endif // PYRODESCRIPTORALLOCATOR_HPP
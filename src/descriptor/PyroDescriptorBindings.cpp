@@ -0,0 +1,125 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#include "PyroDescriptorBindings.hpp"
+
+#include <algorithm>
+
+#include "../utils/Hash.hpp"
+
+namespace pyro {
+    namespace {
+        bool is_buffer_type(const VkDescriptorType type) {
+            return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+                   type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                   type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        }
+    } // namespace
+
+    void PyroDescriptorBindings::insert(const DescriptorResource &resource) {
+        const auto it = std::lower_bound(
+                resources.begin(), resources.end(), resource.binding,
+                [](const DescriptorResource &r, const uint32_t binding) { return r.binding < binding; });
+        if (it != resources.end() && it->binding == resource.binding) {
+            *it = resource;
+        } else {
+            resources.insert(it, resource);
+        }
+    }
+
+    PyroDescriptorBindings &PyroDescriptorBindings::bind_buffer(const uint32_t binding, const VkDescriptorType type,
+                                                                const VkShaderStageFlags stages, const VkBuffer buffer,
+                                                                const VkDeviceSize offset, const VkDeviceSize range) {
+        DescriptorResource resource{binding, type, stages};
+        resource.buffer = {buffer, offset, range};
+        insert(resource);
+        return *this;
+    }
+
+    PyroDescriptorBindings &PyroDescriptorBindings::bind_image(const uint32_t binding, const VkDescriptorType type,
+                                                               const VkShaderStageFlags stages,
+                                                               const VkImageView image_view, const VkSampler sampler,
+                                                               const VkImageLayout layout) {
+        DescriptorResource resource{binding, type, stages};
+        resource.image = {sampler, image_view, layout};
+        insert(resource);
+        return *this;
+    }
+
+    DescriptorLayoutInfo PyroDescriptorBindings::layout_info() const {
+        DescriptorLayoutInfo info;
+        info.bindings.reserve(resources.size());
+        for (const auto &resource: resources) {
+            VkDescriptorSetLayoutBinding binding{};
+            binding.binding = resource.binding;
+            binding.descriptorType = resource.type;
+            binding.descriptorCount = 1;
+            binding.stageFlags = resource.stages;
+            info.bindings.push_back(binding);
+        }
+        return info;
+    }
+
+    void PyroDescriptorBindings::write(const VkDevice device, const VkDescriptorSet set) const {
+        std::vector<VkWriteDescriptorSet> writes;
+        writes.reserve(resources.size());
+        for (const auto &resource: resources) {
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = set;
+            write.dstBinding = resource.binding;
+            write.descriptorCount = 1;
+            write.descriptorType = resource.type;
+            if (is_buffer_type(resource.type)) {
+                write.pBufferInfo = &resource.buffer;
+            } else {
+                write.pImageInfo = &resource.image;
+            }
+            writes.push_back(write);
+        }
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    bool PyroDescriptorBindings::references_buffer(const VkBuffer buffer) const {
+        return std::any_of(resources.begin(), resources.end(), [&](const DescriptorResource &r) {
+            return is_buffer_type(r.type) && r.buffer.buffer == buffer;
+        });
+    }
+
+    bool PyroDescriptorBindings::references_image_view(const VkImageView image_view) const {
+        return std::any_of(resources.begin(), resources.end(), [&](const DescriptorResource &r) {
+            return !is_buffer_type(r.type) && r.image.imageView == image_view;
+        });
+    }
+
+    bool PyroDescriptorBindings::operator==(const PyroDescriptorBindings &other) const {
+        return std::equal(resources.begin(), resources.end(), other.resources.begin(), other.resources.end(),
+                          [](const DescriptorResource &a, const DescriptorResource &b) {
+                              return a.binding == b.binding && a.type == b.type && a.stages == b.stages &&
+                                     a.buffer.buffer == b.buffer.buffer && a.buffer.offset == b.buffer.offset &&
+                                     a.buffer.range == b.buffer.range && a.image.sampler == b.image.sampler &&
+                                     a.image.imageView == b.image.imageView &&
+                                     a.image.imageLayout == b.image.imageLayout;
+                          });
+    }
+
+    size_t PyroDescriptorBindings::hash() const {
+        size_t seed = resources.size();
+        for (const auto &resource: resources) {
+            hash_combine(seed, resource.binding);
+            hash_combine(seed, static_cast<uint32_t>(resource.type));
+            hash_combine(seed, resource.stages);
+            if (is_buffer_type(resource.type)) {
+                hash_combine(seed, resource.buffer.buffer);
+                hash_combine(seed, resource.buffer.offset);
+                hash_combine(seed, resource.buffer.range);
+            } else {
+                hash_combine(seed, resource.image.sampler);
+                hash_combine(seed, resource.image.imageView);
+                hash_combine(seed, static_cast<uint32_t>(resource.image.imageLayout));
+            }
+        }
+        return seed;
+    }
+} // namespace pyro
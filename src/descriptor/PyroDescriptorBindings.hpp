@@ -0,0 +1,49 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#ifndef PYRODESCRIPTORBINDINGS_HPP
+#define PYRODESCRIPTORBINDINGS_HPP
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "PyroDescriptorLayoutCache.hpp"
+
+namespace pyro {
+
+    struct DescriptorResource {
+        uint32_t binding;
+        VkDescriptorType type;
+        VkShaderStageFlags stages;
+        VkDescriptorBufferInfo buffer{};
+        VkDescriptorImageInfo image{};
+    };
+
+    // Describes the contents of one descriptor set: which resource sits at each binding. The same description
+    // yields the set layout (through the layout cache) and serves as the key for cached descriptor sets.
+    class PyroDescriptorBindings {
+    public:
+        PyroDescriptorBindings &bind_buffer(uint32_t binding, VkDescriptorType type, VkShaderStageFlags stages,
+                                            VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+        PyroDescriptorBindings &bind_image(uint32_t binding, VkDescriptorType type, VkShaderStageFlags stages,
+                                           VkImageView image_view, VkSampler sampler, VkImageLayout layout);
+
+        DescriptorLayoutInfo layout_info() const;
+        void write(VkDevice device, VkDescriptorSet set) const;
+        bool references_buffer(VkBuffer buffer) const;
+        bool references_image_view(VkImageView image_view) const;
+
+        const std::vector<DescriptorResource> &get_resources() const { return resources; }
+        bool operator==(const PyroDescriptorBindings &other) const;
+        size_t hash() const;
+
+    private:
+        void insert(const DescriptorResource &resource);
+
+        std::vector<DescriptorResource> resources;
+    };
+
+} // namespace pyro
+
+#endif // PYRODESCRIPTORBINDINGS_HPP
@@ -0,0 +1,108 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#include "PyroDescriptorLayoutCache.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "../utils/Hash.hpp"
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    bool DescriptorLayoutInfo::operator==(const DescriptorLayoutInfo &other) const {
+        if (flags != other.flags || bindings.size() != other.bindings.size() || binding_flags != other.binding_flags) {
+            return false;
+        }
+        for (size_t i = 0; i < bindings.size(); i++) {
+            const auto &a = bindings[i];
+            const auto &b = other.bindings[i];
+            if (a.binding != b.binding || a.descriptorType != b.descriptorType ||
+                a.descriptorCount != b.descriptorCount || a.stageFlags != b.stageFlags ||
+                a.pImmutableSamplers != b.pImmutableSamplers) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t DescriptorLayoutInfo::hash() const {
+        size_t seed = bindings.size();
+        hash_combine(seed, flags);
+        for (const auto &binding: bindings) {
+            hash_combine(seed, binding.binding);
+            hash_combine(seed, static_cast<uint32_t>(binding.descriptorType));
+            hash_combine(seed, binding.descriptorCount);
+            hash_combine(seed, binding.stageFlags);
+        }
+        for (const auto binding_flag: binding_flags) {
+            hash_combine(seed, binding_flag);
+        }
+        return seed;
+    }
+
+    PyroDescriptorLayoutCache::PyroDescriptorLayoutCache(VulkanDevice *device) : device(device) {}
+
+    PyroDescriptorLayoutCache::~PyroDescriptorLayoutCache() {
+        for (const auto &[info, layout]: layout_cache) {
+            vkDestroyDescriptorSetLayout(device->get_logical_device(), layout, nullptr);
+        }
+        LOG(LogLevel::DEBUG, "Destroyed {} cached descriptor set layouts", layout_cache.size());
+    }
+
+    VkDescriptorSetLayout PyroDescriptorLayoutCache::create_layout(const VkDescriptorSetLayoutCreateInfo *info) {
+        DescriptorLayoutInfo layout_info;
+        layout_info.flags = info->flags;
+        layout_info.bindings.assign(info->pBindings, info->pBindings + info->bindingCount);
+        const auto *flags_info = static_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfo *>(info->pNext);
+        if (flags_info != nullptr &&
+            flags_info->sType == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO) {
+            layout_info.binding_flags.assign(flags_info->pBindingFlags,
+                                             flags_info->pBindingFlags + flags_info->bindingCount);
+        }
+        return create_layout(std::move(layout_info));
+    }
+
+    VkDescriptorSetLayout PyroDescriptorLayoutCache::create_layout(DescriptorLayoutInfo info) {
+        if (!info.binding_flags.empty()) {
+            info.binding_flags.resize(info.bindings.size(), 0);
+        }
+        // Sort bindings (and their flags alongside) so declaration order does not produce distinct layouts.
+        std::vector<size_t> order(info.bindings.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return info.bindings[a].binding < info.bindings[b].binding; });
+        DescriptorLayoutInfo sorted;
+        sorted.flags = info.flags;
+        for (const size_t index: order) {
+            sorted.bindings.push_back(info.bindings[index]);
+            if (!info.binding_flags.empty()) {
+                sorted.binding_flags.push_back(info.binding_flags[index]);
+            }
+        }
+
+        if (const auto it = layout_cache.find(sorted); it != layout_cache.end()) {
+            return it->second;
+        }
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info{};
+        binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        binding_flags_info.bindingCount = static_cast<uint32_t>(sorted.binding_flags.size());
+        binding_flags_info.pBindingFlags = sorted.binding_flags.data();
+
+        VkDescriptorSetLayoutCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        create_info.pNext = sorted.binding_flags.empty() ? nullptr : &binding_flags_info;
+        create_info.flags = sorted.flags;
+        create_info.bindingCount = static_cast<uint32_t>(sorted.bindings.size());
+        create_info.pBindings = sorted.bindings.data();
+
+        VkDescriptorSetLayout layout;
+        ASSERT_EQUAL(vkCreateDescriptorSetLayout(device->get_logical_device(), &create_info, nullptr, &layout),
+                     VK_SUCCESS, "Failed to create descriptor set layout")
+        layout_cache.emplace(std::move(sorted), layout);
+        LOG(LogLevel::DEBUG, "Created descriptor set layout ({} cached)", layout_cache.size());
+        return layout;
+    }
+} // namespace pyro
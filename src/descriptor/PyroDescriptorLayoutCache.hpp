@@ -0,0 +1,48 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#ifndef PYRODESCRIPTORLAYOUTCACHE_HPP
+#define PYRODESCRIPTORLAYOUTCACHE_HPP
+
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+
+namespace pyro {
+
+    struct DescriptorLayoutInfo {
+        // Bindings are kept sorted by binding number so equal layouts hash equally.
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        std::vector<VkDescriptorBindingFlags> binding_flags;
+        VkDescriptorSetLayoutCreateFlags flags = 0;
+
+        bool operator==(const DescriptorLayoutInfo &other) const;
+        size_t hash() const;
+    };
+
+    class PyroDescriptorLayoutCache {
+    public:
+        explicit PyroDescriptorLayoutCache(VulkanDevice *device);
+        ~PyroDescriptorLayoutCache();
+        PyroDescriptorLayoutCache(const PyroDescriptorLayoutCache &) = delete;
+        PyroDescriptorLayoutCache &operator=(const PyroDescriptorLayoutCache &) = delete;
+
+        VkDescriptorSetLayout create_layout(const VkDescriptorSetLayoutCreateInfo *info);
+        VkDescriptorSetLayout create_layout(DescriptorLayoutInfo info);
+        size_t size() const { return layout_cache.size(); }
+
+    private:
+        struct LayoutHash {
+            size_t operator()(const DescriptorLayoutInfo &info) const { return info.hash(); }
+        };
+
+        VulkanDevice *device;
+        std::unordered_map<DescriptorLayoutInfo, VkDescriptorSetLayout, LayoutHash> layout_cache;
+    };
+
+} // namespace pyro
+
+#endif // PYRODESCRIPTORLAYOUTCACHE_HPP
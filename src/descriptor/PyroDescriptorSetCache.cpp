@@ -0,0 +1,61 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#include "PyroDescriptorSetCache.hpp"
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    PyroDescriptorSetCache::PyroDescriptorSetCache(VulkanDevice *device, PyroDescriptorLayoutCache *layout_cache) :
+        device(device), layout_cache(layout_cache),
+        allocator(device, 128, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT) {}
+
+    VkDescriptorSet PyroDescriptorSetCache::get(const PyroDescriptorBindings &bindings) {
+        if (const auto it = sets.find(bindings); it != sets.end()) {
+            hits++;
+            return it->second.set;
+        }
+        misses++;
+        const VkDescriptorSetLayout layout = layout_cache->create_layout(bindings.layout_info());
+        CachedSet cached{};
+        cached.set = allocator.allocate(layout, &cached.pool);
+        bindings.write(device->get_logical_device(), cached.set);
+        sets.emplace(bindings, cached);
+        return cached.set;
+    }
+
+    template<typename Predicate>
+    void PyroDescriptorSetCache::invalidate_if(Predicate predicate) {
+        for (auto it = sets.begin(); it != sets.end();) {
+            if (predicate(it->first)) {
+                pending_frees.push_back({it->second, frame_number + MAX_FRAMES_IN_FLIGHT});
+                it = sets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void PyroDescriptorSetCache::invalidate_buffer(const VkBuffer buffer) {
+        invalidate_if([&](const PyroDescriptorBindings &bindings) { return bindings.references_buffer(buffer); });
+    }
+
+    void PyroDescriptorSetCache::invalidate_image_view(const VkImageView image_view) {
+        invalidate_if(
+                [&](const PyroDescriptorBindings &bindings) { return bindings.references_image_view(image_view); });
+    }
+
+    void PyroDescriptorSetCache::begin_frame(const uint64_t frame_number) {
+        this->frame_number = frame_number;
+        hits = 0;
+        misses = 0;
+        std::erase_if(pending_frees, [&](const PendingFree &pending) {
+            if (pending.release_frame > frame_number) {
+                return false;
+            }
+            allocator.free(pending.cached.pool, pending.cached.set);
+            return true;
+        });
+    }
+} // namespace pyro
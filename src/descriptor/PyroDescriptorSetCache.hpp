@@ -0,0 +1,64 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#ifndef PYRODESCRIPTORSETCACHE_HPP
+#define PYRODESCRIPTORSETCACHE_HPP
+
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "PyroDescriptorAllocator.hpp"
+#include "PyroDescriptorBindings.hpp"
+#include "PyroDescriptorLayoutCache.hpp"
+
+namespace pyro {
+
+    // Long-lived descriptor sets keyed on the resources bound into them. A hit costs a hash lookup and no
+    // vkAllocateDescriptorSets/vkUpdateDescriptorSets call. Entries that reference a destroyed resource are dropped
+    // through invalidate_*() and their sets freed once no frame in flight can still be using them.
+    class PyroDescriptorSetCache {
+    public:
+        PyroDescriptorSetCache(VulkanDevice *device, PyroDescriptorLayoutCache *layout_cache);
+        PyroDescriptorSetCache(const PyroDescriptorSetCache &) = delete;
+        PyroDescriptorSetCache &operator=(const PyroDescriptorSetCache &) = delete;
+
+        VkDescriptorSet get(const PyroDescriptorBindings &bindings);
+        void invalidate_buffer(VkBuffer buffer);
+        void invalidate_image_view(VkImageView image_view);
+        void begin_frame(uint64_t frame_number);
+
+        uint32_t get_hits() const { return hits; }
+        uint32_t get_misses() const { return misses; }
+        size_t size() const { return sets.size(); }
+
+    private:
+        struct CachedSet {
+            VkDescriptorSet set;
+            VkDescriptorPool pool;
+        };
+        struct PendingFree {
+            CachedSet cached;
+            uint64_t release_frame;
+        };
+        struct BindingsHash {
+            size_t operator()(const PyroDescriptorBindings &bindings) const { return bindings.hash(); }
+        };
+
+        template<typename Predicate>
+        void invalidate_if(Predicate predicate);
+
+        VulkanDevice *device;
+        PyroDescriptorLayoutCache *layout_cache;
+        PyroDescriptorAllocator allocator;
+        std::unordered_map<PyroDescriptorBindings, CachedSet, BindingsHash> sets;
+        std::vector<PendingFree> pending_frees;
+        uint64_t frame_number = 0;
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+    };
+
+} // namespace pyro
+
+#endif // PYRODESCRIPTORSETCACHE_HPP
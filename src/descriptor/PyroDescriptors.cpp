@@ -0,0 +1,51 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#include "PyroDescriptors.hpp"
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    PyroDescriptors::PyroDescriptors(VulkanDevice *device) :
+        device(device), layout_cache(device), set_cache(device, &layout_cache) {
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            frame_allocators.push_back(std::make_unique<PyroDescriptorAllocator>(device));
+        }
+        if (PyroBindlessTable::is_supported(device)) {
+            bindless = std::make_unique<PyroBindlessTable>(device, &layout_cache);
+        } else {
+            LOG(LogLevel::WARNING, "Descriptor indexing unavailable, using classic descriptor sets");
+        }
+    }
+
+    void PyroDescriptors::begin_frame(const uint32_t frame_index) {
+        // The caller has waited on this frame's fence, so nothing allocated for it last time is still in use.
+        this->frame_index = frame_index;
+        frame_number++;
+        frame_allocators[frame_index]->reset_pools();
+        set_cache.begin_frame(frame_number);
+        if (bindless) {
+            bindless->begin_frame(frame_number);
+        }
+    }
+
+    VkDescriptorSetLayout PyroDescriptors::get_layout(const PyroDescriptorBindings &bindings) {
+        return layout_cache.create_layout(bindings.layout_info());
+    }
+
+    VkDescriptorSet PyroDescriptors::get_cached_set(const PyroDescriptorBindings &bindings) {
+        return set_cache.get(bindings);
+    }
+
+    VkDescriptorSet PyroDescriptors::allocate_transient(const PyroDescriptorBindings &bindings) {
+        const VkDescriptorSet set = frame_allocators[frame_index]->allocate(get_layout(bindings));
+        bindings.write(device->get_logical_device(), set);
+        return set;
+    }
+
+    DescriptorFrameStats PyroDescriptors::get_frame_stats() const {
+        return {frame_allocators[frame_index]->get_allocation_count() + set_cache.get_misses(), set_cache.get_hits(),
+                set_cache.get_misses()};
+    }
+} // namespace pyro
@@ -0,0 +1,61 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#ifndef PYRODESCRIPTORS_HPP
+#define PYRODESCRIPTORS_HPP
+
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "PyroBindlessTable.hpp"
+#include "PyroDescriptorAllocator.hpp"
+#include "PyroDescriptorBindings.hpp"
+#include "PyroDescriptorLayoutCache.hpp"
+#include "PyroDescriptorSetCache.hpp"
+
+namespace pyro {
+
+    struct DescriptorFrameStats {
+        uint32_t allocations;
+        uint32_t cache_hits;
+        uint32_t cache_misses;
+    };
+
+    // Entry point for descriptor management. Layouts are deduplicated by the layout cache; sets whose bindings
+    // are stable across frames come from the set cache, while sets rebuilt every frame come from the allocator
+    // owned by the current frame in flight, which is reset wholesale in begin_frame(). When the device supports
+    // descriptor indexing a bindless table is created as well; otherwise get_bindless() is null and callers fall
+    // back to classic per-draw sets.
+    class PyroDescriptors {
+    public:
+        explicit PyroDescriptors(VulkanDevice *device);
+        PyroDescriptors(const PyroDescriptors &) = delete;
+        PyroDescriptors &operator=(const PyroDescriptors &) = delete;
+
+        void begin_frame(uint32_t frame_index);
+
+        VkDescriptorSetLayout get_layout(const PyroDescriptorBindings &bindings);
+        VkDescriptorSet get_cached_set(const PyroDescriptorBindings &bindings);
+        VkDescriptorSet allocate_transient(const PyroDescriptorBindings &bindings);
+        void invalidate_buffer(VkBuffer buffer) { set_cache.invalidate_buffer(buffer); }
+        void invalidate_image_view(VkImageView image_view) { set_cache.invalidate_image_view(image_view); }
+
+        PyroDescriptorLayoutCache *get_layout_cache() { return &layout_cache; }
+        PyroBindlessTable *get_bindless() const { return bindless.get(); }
+        DescriptorFrameStats get_frame_stats() const;
+
+    private:
+        VulkanDevice *device;
+        PyroDescriptorLayoutCache layout_cache;
+        PyroDescriptorSetCache set_cache;
+        std::vector<std::unique_ptr<PyroDescriptorAllocator>> frame_allocators;
+        std::unique_ptr<PyroBindlessTable> bindless;
+        uint32_t frame_index = 0;
+        uint64_t frame_number = 0;
+    };
+
+} // namespace pyro
+
+#endif // PYRODESCRIPTORS_HPP
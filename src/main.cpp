@@ -5,11 +5,13 @@
 #include "utils/Logger.hpp"
 
 #include "core/VulkanInstance.hpp"
+#include "profiler/PyroStartup.hpp"
 #include "renderer/PyroRender.hpp"
 #include "renderer/Pyropipeline.hpp"
 #include "window/PyroWindow.hpp"
 
 int main() {
+    pyro::PyroStartup::get_instance().begin();
 #ifdef PYRO_DEBUG
     pyro::Logger::getInstance().setLogLevel(pyro::LogLevel::INFO);
     pyro::Logger::getInstance().enableFileLogging("pyro.log");
@@ -0,0 +1,454 @@
+//
+// Created by srijan on 3/1/25.
+//
+
+#include "PyroClusterRenderer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../profiler/PyroCounters.hpp"
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        // Local size of cluster.task; cluster_cull.comp runs one workgroup per meshlet instead.
+        constexpr uint32_t TASK_WORKGROUP_SIZE = 32;
+        // The compute path puts the instance index in gl_WorkGroupID.y, whose guaranteed limit is 65535.
+        constexpr uint32_t MAX_INSTANCES = 65535;
+
+        constexpr uint32_t CULL_FRUSTUM = 1;
+        constexpr uint32_t CULL_BACKFACE = 2;
+
+        // As in assets/shaders/include/cluster_cull.glsl.
+        constexpr uint32_t PHASE_EARLY = 0;
+        constexpr uint32_t PHASE_LATE = 1;
+        constexpr uint32_t PHASE_SINGLE = 2;
+
+        // Must match ClusterView in assets/shaders/include/cluster.glsl (std140).
+        struct ClusterView {
+            glm::mat4 view_proj;
+            glm::vec4 planes[6];
+            glm::vec4 eye;
+            glm::vec2 pyramid_size;
+            uint32_t pyramid_levels;
+            uint32_t flags;
+        };
+
+        // Must match ClusterInstance in assets/shaders/include/cluster.glsl (std430).
+        struct ClusterInstance {
+            glm::mat4 model;
+            uint32_t first_meshlet;
+            uint32_t meshlet_count;
+            uint32_t first_index;
+            uint32_t first_vertex;
+            float scale;
+            uint32_t visibility_offset;
+            uint32_t pad[2];
+        };
+        static_assert(sizeof(ClusterInstance) == 96);
+        static_assert(sizeof(ClusterCullStats) == 9 * sizeof(uint32_t));
+
+        // Must match ClusterPhase in assets/shaders/include/cluster_cull.glsl.
+        struct PhaseConstants {
+            uint32_t phase;
+            uint32_t draw_offset;
+        };
+
+        // Must match DrawInstance in assets/shaders/mesh_cluster.vert.
+        struct DrawConstants {
+            uint32_t instance_base;
+        };
+
+        VkDeviceSize align_up(const VkDeviceSize size, const VkDeviceSize alignment) {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    PyroClusterRenderer::PyroClusterRenderer(VulkanDevice *device, PyroDescriptors *descriptors,
+                                             const PyroMeshBuffers *buffers, ClusterRendererConfig config) :
+        device(device), descriptors(descriptors), buffers(buffers), config(std::move(config)) {
+        ASSERT_EQUAL(buffers->has_meshlets(), true, "Cluster rendering needs meshes built with meshlets")
+        ASSERT_EQUAL(buffers->get_vertex_format() == MeshVertexFormat::FLOAT32, true,
+                     "Cluster rendering only supports FLOAT32 vertices")
+        this->config.max_instances = std::clamp(this->config.max_instances, 1u, MAX_INSTANCES);
+        mesh_shaders = this->config.use_mesh_shaders && device->get_capabilities().mesh_shader;
+        stages = mesh_shaders ? VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT
+                              : VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+        cull_stage = mesh_shaders ? VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+        VkSamplerCreateInfo sampler_info{};
+        sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.magFilter = VK_FILTER_NEAREST;
+        sampler_info.minFilter = VK_FILTER_NEAREST;
+        sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+        ASSERT_EQUAL(vkCreateSampler(device->get_logical_device(), &sampler_info, nullptr, &pyramid_sampler),
+                     VK_SUCCESS, "Failed to create depth pyramid sampler")
+
+        ImageDesc pyramid_desc{};
+        pyramid_desc.extent = {1, 1};
+        pyramid_desc.format = PyroDepthPyramid::FORMAT;
+        pyramid_desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+        empty_pyramid = std::make_unique<VulkanImage>(device, pyramid_desc);
+        if (this->config.occlusion_culling) {
+            pyramid = std::make_unique<PyroDepthPyramid>(device, descriptors);
+        }
+        // Every flag starts cleared, so the first frame draws everything in its late phase.
+        const VkDeviceSize tracked_meshlets = pyramid ? std::max(this->config.max_tracked_meshlets, 1u) : 1u;
+        visibility_buffer = std::make_unique<VulkanBuffer>(
+                device, tracked_meshlets * sizeof(uint32_t),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        const VkCommandBuffer command_buffer = device->begin_single_time_commands();
+        // The pyramid is bound in GENERAL, which is the layout PyroDepthPyramid leaves its image in.
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = empty_pyramid->get_image();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+        vkCmdFillBuffer(command_buffer, visibility_buffer->get_buffer(), 0, VK_WHOLE_SIZE, 0);
+        device->end_single_time_commands(command_buffer);
+
+        // Layout-only description: the real sets are rebuilt from the frame's buffers in record_phase().
+        const VkShaderStageFlags cull_shader = mesh_shaders ? VK_SHADER_STAGE_TASK_BIT_EXT
+                                                            : VK_SHADER_STAGE_COMPUTE_BIT;
+        layout_bindings.bind_buffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, VK_NULL_HANDLE, 0, VK_WHOLE_SIZE)
+                .bind_buffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, VK_NULL_HANDLE, 0, VK_WHOLE_SIZE)
+                .bind_buffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, VK_NULL_HANDLE, 0, VK_WHOLE_SIZE)
+                .bind_buffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, VK_NULL_HANDLE, 0, VK_WHOLE_SIZE)
+                .bind_buffer(4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, stages, VK_NULL_HANDLE, 0, sizeof(ClusterView))
+                .bind_image(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, stages, VK_NULL_HANDLE, VK_NULL_HANDLE,
+                            VK_IMAGE_LAYOUT_GENERAL)
+                .bind_buffer(6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, VK_NULL_HANDLE, 0,
+                             sizeof(ClusterCullStats))
+                .bind_buffer(10, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, VK_NULL_HANDLE, 0, VK_WHOLE_SIZE);
+        if (mesh_shaders) {
+            layout_bindings.bind_buffer(9, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_MESH_BIT_EXT,
+                                        VK_NULL_HANDLE, 0, VK_WHOLE_SIZE);
+        } else {
+            layout_bindings
+                    .bind_buffer(7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE,
+                                 0, VK_WHOLE_SIZE)
+                    .bind_buffer(8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE,
+                                 0, VK_WHOLE_SIZE);
+        }
+        const std::vector set_layouts{descriptors->get_layout(layout_bindings)};
+        const std::vector push_ranges{VkPushConstantRange{cull_shader, 0, sizeof(PhaseConstants)}};
+
+        GraphicsPipelineDesc desc{};
+        if (mesh_shaders) {
+            desc.task_shader = "assets/shaders/cluster.task.spv";
+            desc.mesh_shader = "assets/shaders/cluster.mesh.spv";
+            draw_mesh_tasks = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(
+                    vkGetDeviceProcAddr(device->get_logical_device(), "vkCmdDrawMeshTasksEXT"));
+        } else {
+            desc.vertex_shader = "assets/shaders/mesh_cluster.vert.spv";
+            desc.vertex_bindings = PyroMeshBuffers::vertex_bindings(MeshVertexFormat::FLOAT32);
+            desc.vertex_attributes = PyroMeshBuffers::vertex_attributes(MeshVertexFormat::FLOAT32);
+            cull_pipeline = std::make_unique<PyroComputePipeline>(device, "assets/shaders/cluster_cull.comp.spv",
+                                                                  set_layouts, push_ranges);
+        }
+        desc.fragment_shader = "assets/shaders/mesh.frag.spv";
+        // meshc writes counter-clockwise triangles.
+        desc.front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        desc.formats = this->config.formats;
+        const std::vector draw_ranges{VkPushConstantRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(DrawConstants)}};
+        draw_pipeline = std::make_unique<Pyropipeline>(device, set_layouts, mesh_shaders ? push_ranges : draw_ranges,
+                                                       desc);
+
+        const VkPhysicalDeviceLimits &limits = device->get_properties().limits;
+        const VkDeviceSize max_instances = this->config.max_instances;
+        view_stride = align_up(sizeof(ClusterView), limits.minUniformBufferOffsetAlignment);
+        instance_stride = align_up(max_instances * sizeof(ClusterInstance), limits.minStorageBufferOffsetAlignment);
+        stats_stride = align_up(sizeof(ClusterCullStats), limits.minStorageBufferOffsetAlignment);
+        draw_stride = align_up(2 * max_instances * sizeof(VkDrawIndexedIndirectCommand),
+                               limits.minStorageBufferOffsetAlignment);
+        index_stride = align_up(static_cast<VkDeviceSize>(this->config.max_indices) * sizeof(uint32_t),
+                                limits.minStorageBufferOffsetAlignment);
+
+        constexpr VkMemoryPropertyFlags host_required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        constexpr VkMemoryPropertyFlags host_preferred =
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        view_buffer = std::make_unique<VulkanBuffer>(device, view_stride * MAX_FRAMES_IN_FLIGHT,
+                                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, host_required,
+                                                     host_preferred);
+        instance_buffer = std::make_unique<VulkanBuffer>(device, instance_stride * MAX_FRAMES_IN_FLIGHT,
+                                                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, host_required,
+                                                         host_preferred);
+        // Read back by the host, so cached memory is preferred over device-local.
+        stats_buffer = std::make_unique<VulkanBuffer>(device, stats_stride * MAX_FRAMES_IN_FLIGHT,
+                                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, host_required,
+                                                      VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        std::memset(stats_buffer->get_mapped(), 0, stats_buffer->get_size());
+        stats_buffer->flush();
+        if (!mesh_shaders) {
+            draw_staging = std::make_unique<VulkanBuffer>(device, draw_stride * MAX_FRAMES_IN_FLIGHT,
+                                                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT, host_required,
+                                                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            draw_buffer = std::make_unique<VulkanBuffer>(device, draw_stride * MAX_FRAMES_IN_FLIGHT,
+                                                         VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            index_buffer = std::make_unique<VulkanBuffer>(device, index_stride * MAX_FRAMES_IN_FLIGHT,
+                                                          VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+    }
+
+    PyroClusterRenderer::~PyroClusterRenderer() {
+        vkDeviceWaitIdle(device->get_logical_device());
+        vkDestroySampler(device->get_logical_device(), pyramid_sampler, nullptr);
+        for (const VulkanBuffer *buffer : {view_buffer.get(), instance_buffer.get(), stats_buffer.get(),
+                                           visibility_buffer.get(), draw_buffer.get(), index_buffer.get()}) {
+            if (buffer) {
+                descriptors->invalidate_buffer(buffer->get_buffer());
+            }
+        }
+        descriptors->invalidate_image_view(empty_pyramid->get_view());
+    }
+
+    void PyroClusterRenderer::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        // The fence for this frame index has been waited on, so its counters are final.
+        const VkDeviceSize offset = frame_index * stats_stride;
+        stats_buffer->invalidate(offset, sizeof(ClusterCullStats));
+        auto *counters = reinterpret_cast<ClusterCullStats *>(static_cast<std::byte *>(stats_buffer->get_mapped()) +
+                                                              offset);
+        stats = *counters;
+        *counters = {};
+        stats_buffer->flush(offset, sizeof(ClusterCullStats));
+        instance_count = 0;
+
+        PyroCounters &counter_sink = PyroCounters::get_instance();
+        counter_sink.set("cluster.tested", stats.tested);
+        counter_sink.set("cluster.frustum_culled", stats.frustum_culled);
+        counter_sink.set("cluster.backface_culled", stats.backface_culled);
+        counter_sink.set("cluster.occlusion_culled", stats.occlusion_culled);
+        counter_sink.set("cluster.early_tested", stats.early_tested);
+        counter_sink.set("cluster.early_drawn", stats.early_drawn);
+        counter_sink.set("cluster.late_drawn", stats.late_drawn);
+        counter_sink.set("cluster.triangles", stats.triangles);
+    }
+
+    void PyroClusterRenderer::record_cull(const VkCommandBuffer command_buffer,
+                                          const std::span<const MeshInstance> instances,
+                                          const ClusterCullView &view) {
+        ClusterView gpu_view{};
+        gpu_view.view_proj = view.view_proj;
+        const std::array<glm::vec4, 6> planes = extract_frustum_planes(view.view_proj);
+        std::copy(planes.begin(), planes.end(), std::begin(gpu_view.planes));
+        gpu_view.eye = glm::vec4(view.eye, 1.0f);
+        // Filled in by record_late_cull() once the pyramid exists.
+        gpu_view.pyramid_size = glm::vec2(1.0f);
+        gpu_view.pyramid_levels = 1;
+        gpu_view.flags = (config.frustum_culling ? CULL_FRUSTUM : 0) | (config.backface_culling ? CULL_BACKFACE : 0);
+        view_buffer->write(&gpu_view, sizeof(gpu_view), frame_index * view_stride);
+
+        // Every instance gets a fixed region of the index buffer sized for all of its meshlets, so the culling
+        // shader can append to it without coordinating with other instances. Both phases share the region.
+        const std::vector<MeshEntry> &meshes = buffers->get_meshes();
+        auto *gpu_instances = reinterpret_cast<ClusterInstance *>(
+                static_cast<std::byte *>(instance_buffer->get_mapped()) + frame_index * instance_stride);
+        auto *draws = mesh_shaders ? nullptr
+                                   : reinterpret_cast<VkDrawIndexedIndirectCommand *>(
+                                             static_cast<std::byte *>(draw_staging->get_mapped()) +
+                                             frame_index * draw_stride);
+        const uint32_t tracked_meshlets = pyramid ? config.max_tracked_meshlets : UINT32_MAX;
+        uint32_t next_index = 0;
+        uint32_t next_visibility = 0;
+        instance_count = 0;
+        max_meshlets = 0;
+        dropped_instances = 0;
+        for (const MeshInstance &instance : instances) {
+            const MeshEntry &mesh = meshes[instance.mesh];
+            if (mesh.meshlet_count == 0) {
+                continue;
+            }
+            // The meshlets partition the full-detail triangles.
+            if (instance_count == config.max_instances ||
+                (!mesh_shaders && mesh.index_count > config.max_indices - next_index) ||
+                mesh.meshlet_count > tracked_meshlets - next_visibility) {
+                dropped_instances++;
+                continue;
+            }
+            gpu_instances[instance_count] = {instance.transform,
+                                             mesh.first_meshlet,
+                                             mesh.meshlet_count,
+                                             next_index,
+                                             mesh.first_vertex,
+                                             max_axis_scale(instance.transform),
+                                             pyramid ? next_visibility : 0,
+                                             {}};
+            if (draws) {
+                // Without multiDrawIndirect the instance goes through DrawConstants instead, as firstInstance
+                // must then be 0.
+                const uint32_t first_instance = device->get_capabilities().multi_draw_indirect ? instance_count : 0;
+                const VkDrawIndexedIndirectCommand draw{0, 1, next_index, static_cast<int32_t>(mesh.first_vertex),
+                                                        first_instance};
+                draws[instance_count] = draw;
+                draws[config.max_instances + instance_count] = draw;
+            }
+            next_index += mesh.index_count;
+            next_visibility += mesh.meshlet_count;
+            max_meshlets = std::max(max_meshlets, mesh.meshlet_count);
+            instance_count++;
+        }
+        if (dropped_instances > 0) {
+            LOG(LogLevel::WARNING, "Cluster renderer over capacity, dropped {} of {} instances", dropped_instances,
+                instances.size());
+        }
+        instance_buffer->flush(frame_index * instance_stride, instance_count * sizeof(ClusterInstance));
+        view_buffer->flush(frame_index * view_stride, sizeof(ClusterView));
+        if (instance_count == 0) {
+            return;
+        }
+
+        // Also orders this frame's culling after the previous frame's late phase, the last writer of the
+        // visibility flags.
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        VkPipelineStageFlags src_stages = cull_stage;
+        if (draws) {
+            const VkDeviceSize first = frame_index * draw_stride;
+            const VkDeviceSize late = config.max_instances * sizeof(VkDrawIndexedIndirectCommand);
+            const VkDeviceSize size = instance_count * sizeof(VkDrawIndexedIndirectCommand);
+            draw_staging->flush(first, late + size);
+            const VkBufferCopy copies[] = {{first, first, size}, {first + late, first + late, size}};
+            vkCmdCopyBuffer(command_buffer, draw_staging->get_buffer(), draw_buffer->get_buffer(), 2, copies);
+            barrier.srcAccessMask |= VK_ACCESS_TRANSFER_WRITE_BIT;
+            src_stages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+        vkCmdPipelineBarrier(command_buffer, src_stages, cull_stage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        record_phase(command_buffer, pyramid ? PHASE_EARLY : PHASE_SINGLE, empty_pyramid->get_view());
+    }
+
+    void PyroClusterRenderer::record_late_cull(const VkCommandBuffer command_buffer, const VkImageView depth,
+                                               const VkExtent2D depth_extent) {
+        if (!pyramid || instance_count == 0) {
+            return;
+        }
+        pyramid->build(command_buffer, depth, depth_extent);
+        const DepthPyramidView pyramid_view = pyramid->get_view();
+        // The early phase has only been recorded, not executed, so its view can still be patched.
+        auto *gpu_view = reinterpret_cast<ClusterView *>(static_cast<std::byte *>(view_buffer->get_mapped()) +
+                                                         frame_index * view_stride);
+        gpu_view->pyramid_size = glm::vec2(static_cast<float>(pyramid_view.extent.width),
+                                           static_cast<float>(pyramid_view.extent.height));
+        gpu_view->pyramid_levels = pyramid_view.mip_levels;
+        view_buffer->flush(frame_index * view_stride, sizeof(ClusterView));
+
+        if (mesh_shaders) {
+            // The early draw's task shaders wrote the counters the late ones add to; the compute path's early
+            // dispatch already ends in an equivalent barrier.
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(command_buffer, cull_stage, cull_stage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+        record_phase(command_buffer, PHASE_LATE, pyramid_view.view);
+    }
+
+    void PyroClusterRenderer::record_phase(const VkCommandBuffer command_buffer, const uint32_t phase,
+                                           const VkImageView pyramid_view) {
+        this->phase = phase;
+        PyroDescriptorBindings bindings;
+        bindings.bind_buffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, buffers->get_meshlet_buffer(), 0,
+                             VK_WHOLE_SIZE)
+                .bind_buffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, buffers->get_meshlet_vertex_buffer(), 0,
+                             VK_WHOLE_SIZE)
+                .bind_buffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, buffers->get_meshlet_triangle_buffer(), 0,
+                             VK_WHOLE_SIZE)
+                .bind_buffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, instance_buffer->get_buffer(),
+                             frame_index * instance_stride, instance_stride)
+                .bind_buffer(4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, stages, view_buffer->get_buffer(),
+                             frame_index * view_stride, sizeof(ClusterView))
+                .bind_image(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, stages, pyramid_view, pyramid_sampler,
+                            VK_IMAGE_LAYOUT_GENERAL)
+                .bind_buffer(6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, stats_buffer->get_buffer(),
+                             frame_index * stats_stride, sizeof(ClusterCullStats))
+                .bind_buffer(10, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages, visibility_buffer->get_buffer(), 0,
+                             VK_WHOLE_SIZE);
+        if (mesh_shaders) {
+            bindings.bind_buffer(9, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_MESH_BIT_EXT,
+                                 buffers->get_vertex_buffer(), 0, VK_WHOLE_SIZE);
+            frame_set = descriptors->get_cached_set(bindings);
+            // Culling happens in the task stage of record_draw().
+            return;
+        }
+        bindings.bind_buffer(7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT,
+                             draw_buffer->get_buffer(), frame_index * draw_stride, draw_stride)
+                .bind_buffer(8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT,
+                             index_buffer->get_buffer(), frame_index * index_stride, index_stride);
+        frame_set = descriptors->get_cached_set(bindings);
+
+        const PhaseConstants constants{phase, phase == PHASE_LATE ? config.max_instances : 0};
+        cull_pipeline->bind(command_buffer);
+        cull_pipeline->bind_set(command_buffer, 0, frame_set);
+        cull_pipeline->push_constants(command_buffer, &constants, sizeof(constants));
+        PyroComputePipeline::dispatch(command_buffer, max_meshlets, instance_count);
+
+        // Besides the draw, the late phase reads the early phase's index counts and rewrites its flags.
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    void PyroClusterRenderer::record_draw(const VkCommandBuffer command_buffer) const {
+        if (instance_count == 0) {
+            return;
+        }
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw_pipeline->get_pipeline());
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw_pipeline->get_pipeline_layout(),
+                                0, 1, &frame_set, 0, nullptr);
+        if (mesh_shaders) {
+            const PhaseConstants constants{phase, 0};
+            vkCmdPushConstants(command_buffer, draw_pipeline->get_pipeline_layout(), VK_SHADER_STAGE_TASK_BIT_EXT, 0,
+                               sizeof(constants), &constants);
+            draw_mesh_tasks(command_buffer, PyroComputePipeline::group_count(max_meshlets, TASK_WORKGROUP_SIZE),
+                            instance_count, 1);
+            return;
+        }
+
+        const VkBuffer vertex_buffer = buffers->get_vertex_buffer();
+        constexpr VkDeviceSize vertex_offset = 0;
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, &vertex_offset);
+        vkCmdBindIndexBuffer(command_buffer, index_buffer->get_buffer(), frame_index * index_stride,
+                             VK_INDEX_TYPE_UINT32);
+        constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        const VkDeviceSize first = frame_index * draw_stride +
+                                   (phase == PHASE_LATE ? static_cast<VkDeviceSize>(config.max_instances) * stride : 0);
+        const VkPipelineLayout layout = draw_pipeline->get_pipeline_layout();
+        if (device->get_capabilities().multi_draw_indirect) {
+            constexpr DrawConstants constants{0};
+            vkCmdPushConstants(command_buffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+            vkCmdDrawIndexedIndirect(command_buffer, draw_buffer->get_buffer(), first, instance_count, stride);
+            return;
+        }
+        for (uint32_t i = 0; i < instance_count; i++) {
+            const DrawConstants constants{i};
+            vkCmdPushConstants(command_buffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+            vkCmdDrawIndexedIndirect(command_buffer, draw_buffer->get_buffer(), first + i * stride, 1, stride);
+        }
+    }
+} // namespace pyro
@@ -0,0 +1,159 @@
+//
+// Created by srijan on 3/1/25.
+//
+
+#ifndef PYROCLUSTERRENDERER_HPP
+#define PYROCLUSTERRENDERER_HPP
+
+#include <array>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../compute/PyroComputePipeline.hpp"
+#include "../compute/PyroDepthPyramid.hpp"
+#include "../core/VulkanBuffer.hpp"
+#include "../core/VulkanImage.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "../renderer/Pyropipeline.hpp"
+#include "PyroMeshBuffers.hpp"
+#include "PyroMeshCuller.hpp"
+
+namespace pyro {
+
+    struct ClusterRendererConfig {
+        uint32_t max_instances = 4096;
+        // Per-frame capacity of the compacted index buffer on the compute path. Every instance reserves room for
+        // all of its meshlets' triangles; instances that no longer fit are dropped.
+        uint32_t max_indices = 1u << 22;
+        // Meshlets, summed over instances, whose visibility is carried between frames for two-phase occlusion
+        // culling; instances past it are dropped.
+        uint32_t max_tracked_meshlets = 1u << 20;
+        // Cull and draw with task and mesh shaders when the device supports them.
+        bool use_mesh_shaders = true;
+        bool frustum_culling = true;
+        bool backface_culling = true;
+        // Two-phase Hi-Z occlusion culling; without it everything is culled and drawn in a single phase.
+        bool occlusion_culling = true;
+        PipelineAttachmentFormats formats;
+    };
+
+    struct ClusterCullView {
+        glm::mat4 view_proj;
+        glm::vec3 eye;
+    };
+
+    // Counters written by the culling shaders; read back once the frame has completed, so they describe the
+    // frame recorded MAX_FRAMES_IN_FLIGHT frames earlier. The culled counts come from the late (or single)
+    // phase, which tests every meshlet.
+    struct ClusterCullStats {
+        uint32_t tested = 0;
+        uint32_t frustum_culled = 0;
+        uint32_t backface_culled = 0;
+        uint32_t occlusion_culled = 0;
+        uint32_t visible = 0;
+        // Meshlets visible last frame, retested and drawn before the depth pyramid is built.
+        uint32_t early_tested = 0;
+        uint32_t early_drawn = 0;
+        // Meshlets that became visible this frame, drawn after the depth pyramid is built.
+        uint32_t late_drawn = 0;
+        uint32_t triangles = 0;
+    };
+
+    // GPU-driven rendering of meshes built with meshlets: every meshlet of every instance is frustum, normal-cone
+    // and occlusion tested on the GPU, so only surviving clusters reach rasterisation.
+    //
+    // Occlusion culling takes two phases per frame. record_cull() draws what was visible last frame; its depth
+    // builds a hierarchical-Z pyramid in record_late_cull(), which then tests every meshlet against it, remembers
+    // the result for the next frame and draws whatever became visible. A frame therefore looks like
+    //
+    //     record_cull(); begin rendering (clear); record_draw(); end rendering;
+    //     record_late_cull(depth); begin rendering (load); record_draw(); end rendering;
+    //
+    // with the depth attachment in SHADER_READ_ONLY_OPTIMAL for record_late_cull(). Visibility is tracked per
+    // instance slot, so instance lists should keep a stable order between frames; a reordered list only costs
+    // a frame of late-phase draws.
+    //
+    // Without mesh shaders a compute pass (assets/shaders/cluster_cull.comp) appends each phase's triangles to
+    // the instance's region of a per-frame index buffer and counts them into that phase's indexed indirect
+    // command for the instance; one multi-draw then renders every instance. With mesh shaders the task stage
+    // (cluster.task) makes the same decisions and launches a mesh workgroup (cluster.mesh) per drawn meshlet,
+    // with no index buffer round trip. Only FLOAT32 vertices are supported.
+    class PyroClusterRenderer {
+    public:
+        PyroClusterRenderer(VulkanDevice *device, PyroDescriptors *descriptors, const PyroMeshBuffers *buffers,
+                            ClusterRendererConfig config = {});
+        ~PyroClusterRenderer();
+        PyroClusterRenderer(const PyroClusterRenderer &) = delete;
+        PyroClusterRenderer &operator=(const PyroClusterRenderer &) = delete;
+
+        // The slot's previous frame must have completed; its culling counters become get_stats() and are
+        // published to PyroCounters.
+        void begin_frame(uint32_t frame_index);
+
+        // Uploads this frame's instances and view and, on the compute path, records the early (or single) phase
+        // culling dispatch. Must be recorded outside rendering scopes.
+        void record_cull(VkCommandBuffer command_buffer, std::span<const MeshInstance> instances,
+                         const ClusterCullView &view);
+        // Builds the depth pyramid from the early phase's depth and records the late phase. Must be recorded
+        // outside rendering scopes; does nothing without occlusion culling.
+        void record_late_cull(VkCommandBuffer command_buffer, VkImageView depth, VkExtent2D depth_extent);
+        // Draws the clusters of the phase culled last; must be called inside a rendering scope whose formats
+        // match config.formats.
+        void record_draw(VkCommandBuffer command_buffer) const;
+
+        bool uses_mesh_shaders() const { return mesh_shaders; }
+        bool is_two_phase() const { return pyramid != nullptr; }
+        const ClusterCullStats &get_stats() const { return stats; }
+        uint32_t get_dropped_instances() const { return dropped_instances; }
+
+    private:
+        VulkanDevice *device;
+        PyroDescriptors *descriptors;
+        const PyroMeshBuffers *buffers;
+        ClusterRendererConfig config;
+        bool mesh_shaders;
+        VkShaderStageFlags stages;
+        VkPipelineStageFlags cull_stage;
+        PFN_vkCmdDrawMeshTasksEXT draw_mesh_tasks = nullptr;
+
+        PyroDescriptorBindings layout_bindings;
+        std::unique_ptr<PyroComputePipeline> cull_pipeline;
+        std::unique_ptr<Pyropipeline> draw_pipeline;
+        VkSampler pyramid_sampler{};
+        // Bound in place of the depth pyramid by phases that don't test occlusion.
+        std::unique_ptr<VulkanImage> empty_pyramid;
+        std::unique_ptr<PyroDepthPyramid> pyramid;
+        std::unique_ptr<VulkanBuffer> visibility_buffer;
+
+        // Per frame in flight, each buffer split into MAX_FRAMES_IN_FLIGHT regions of the given stride. The
+        // draw buffers hold the early (or single) phase's commands followed by the late phase's.
+        std::unique_ptr<VulkanBuffer> view_buffer;
+        std::unique_ptr<VulkanBuffer> instance_buffer;
+        std::unique_ptr<VulkanBuffer> draw_staging;
+        std::unique_ptr<VulkanBuffer> draw_buffer;
+        std::unique_ptr<VulkanBuffer> index_buffer;
+        std::unique_ptr<VulkanBuffer> stats_buffer;
+        VkDeviceSize view_stride;
+        VkDeviceSize instance_stride;
+        VkDeviceSize draw_stride;
+        VkDeviceSize index_stride;
+        VkDeviceSize stats_stride;
+
+        uint32_t frame_index = 0;
+        uint32_t instance_count = 0;
+        uint32_t max_meshlets = 0;
+        uint32_t dropped_instances = 0;
+        // Phase recorded last, as in assets/shaders/include/cluster_cull.glsl.
+        uint32_t phase = 0;
+        VkDescriptorSet frame_set = VK_NULL_HANDLE;
+        ClusterCullStats stats;
+
+        void record_phase(VkCommandBuffer command_buffer, uint32_t phase, VkImageView pyramid_view);
+    };
+
+} // namespace pyro
+
+#endif // PYROCLUSTERRENDERER_HPP
@@ -0,0 +1,112 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#include "PyroMappedFile.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    PyroMappedFile::~PyroMappedFile() { close(); }
+
+    PyroMappedFile::PyroMappedFile(PyroMappedFile &&other) noexcept { *this = std::move(other); }
+
+    PyroMappedFile &PyroMappedFile::operator=(PyroMappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+#ifdef _WIN32
+            file = std::exchange(other.file, nullptr);
+            mapping = std::exchange(other.mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool PyroMappedFile::open(const std::string &path) {
+        close();
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            file = nullptr;
+            LOG(LogLevel::ERROR, "Failed to open {}", path);
+            return false;
+        }
+        LARGE_INTEGER file_size{};
+        GetFileSizeEx(file, &file_size);
+        mapping = file_size.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (view == nullptr) {
+            LOG(LogLevel::ERROR, "Failed to map {}", path);
+            close();
+            return false;
+        }
+        data = static_cast<const std::byte *>(view);
+        size = static_cast<size_t>(file_size.QuadPart);
+        return true;
+    }
+
+    void PyroMappedFile::close() {
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        if (file != nullptr) {
+            CloseHandle(file);
+        }
+        data = nullptr;
+        size = 0;
+        mapping = nullptr;
+        file = nullptr;
+    }
+#else
+    bool PyroMappedFile::open(const std::string &path) {
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            LOG(LogLevel::ERROR, "Failed to open {}", path);
+            return false;
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            LOG(LogLevel::ERROR, "Failed to stat {} or file is empty", path);
+            ::close(fd);
+            return false;
+        }
+        void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping keeps its own reference to the file.
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            LOG(LogLevel::ERROR, "Failed to map {}", path);
+            return false;
+        }
+        madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+        data = static_cast<const std::byte *>(view);
+        size = static_cast<size_t>(info.st_size);
+        return true;
+    }
+
+    void PyroMappedFile::close() {
+        if (data != nullptr) {
+            munmap(const_cast<std::byte *>(data), size);
+        }
+        data = nullptr;
+        size = 0;
+    }
+#endif
+} // namespace pyro
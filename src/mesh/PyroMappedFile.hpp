@@ -0,0 +1,42 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#ifndef PYROMAPPEDFILE_HPP
+#define PYROMAPPEDFILE_HPP
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace pyro {
+
+    // Read-only memory mapping of a whole file. Pages are faulted in on first touch; the mapping is hinted as
+    // sequential so the kernel reads ahead aggressively while the caller streams through it.
+    class PyroMappedFile {
+    public:
+        PyroMappedFile() = default;
+        ~PyroMappedFile();
+        PyroMappedFile(const PyroMappedFile &) = delete;
+        PyroMappedFile &operator=(const PyroMappedFile &) = delete;
+        PyroMappedFile(PyroMappedFile &&other) noexcept;
+        PyroMappedFile &operator=(PyroMappedFile &&other) noexcept;
+
+        bool open(const std::string &path);
+        void close();
+
+        bool is_open() const { return data != nullptr; }
+        std::span<const std::byte> get_bytes() const { return {data, size}; }
+
+    private:
+        const std::byte *data = nullptr;
+        size_t size = 0;
+#ifdef _WIN32
+        void *file = nullptr;
+        void *mapping = nullptr;
+#endif
+    };
+
+} // namespace pyro
+
+#endif // PYROMAPPEDFILE_HPP
@@ -0,0 +1,169 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#include "PyroMeshBuffers.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "../core/VulkanTimelineSemaphore.hpp"
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t STAGING_SLOTS = 2;
+    } // namespace
+
+    PyroMeshBuffers::PyroMeshBuffers(VulkanDevice *device, const PyroMeshFile &file) :
+        PyroMeshBuffers(device, MeshData{file.get_meshes(), file.get_section(MeshSectionType::VERTICES),
+                                         file.get_section(MeshSectionType::INDICES), file.get_header().vertex_format,
+                                         file.get_lods(), file.get_meshlets(),
+                                         file.get_section(MeshSectionType::MESHLET_VERTICES),
+                                         file.get_section(MeshSectionType::MESHLET_TRIANGLES)}) {}
+
+    PyroMeshBuffers::PyroMeshBuffers(VulkanDevice *device, const MeshData &data) :
+        device(device), meshes(data.meshes.begin(), data.meshes.end()), lods(data.lods.begin(), data.lods.end()),
+        format(data.vertex_format), meshlet_count(static_cast<uint32_t>(data.meshlets.size())) {
+        // Zero-sized buffers are invalid, so empty sections still get a minimal allocation.
+        const auto create = [device](const VkDeviceSize size, const VkDeviceSize minimum,
+                                     const VkBufferUsageFlags usage) {
+            return std::make_unique<VulkanBuffer>(device, std::max(size, minimum),
+                                                  usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        };
+        vertex_buffer = create(data.vertices.size(), mesh_vertex_stride(format),
+                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        index_buffer = create(data.indices.size(), sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+        const std::span<const std::byte> meshlet_bytes = std::as_bytes(data.meshlets);
+        meshlet_buffer = create(meshlet_bytes.size(), sizeof(MeshletEntry), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        meshlet_vertex_buffer =
+                create(data.meshlet_vertices.size(), sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        meshlet_triangle_buffer =
+                create(data.meshlet_triangles.size(), sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        const UploadRegion regions[] = {
+                {data.vertices, vertex_buffer.get()},
+                {data.indices, index_buffer.get()},
+                {meshlet_bytes, meshlet_buffer.get()},
+                {data.meshlet_vertices, meshlet_vertex_buffer.get()},
+                {data.meshlet_triangles, meshlet_triangle_buffer.get()},
+        };
+        upload(regions);
+    }
+
+    void PyroMeshBuffers::upload(const std::span<const UploadRegion> regions) const {
+        VkDeviceSize total = 0;
+        for (const UploadRegion &region : regions) {
+            total += region.source.size();
+        }
+        if (total == 0) {
+            return;
+        }
+        const VkDeviceSize chunk = std::min(STAGING_CHUNK_SIZE, total);
+        const VulkanBuffer staging(device, chunk * STAGING_SLOTS, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        const VulkanTimelineSemaphore done(device);
+
+        std::array<VkCommandBuffer, STAGING_SLOTS> command_buffers{};
+        VkCommandBufferAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = device->get_command_pool();
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc_info.commandBufferCount = STAGING_SLOTS;
+        ASSERT_EQUAL(vkAllocateCommandBuffers(device->get_logical_device(), &alloc_info, command_buffers.data()),
+                     VK_SUCCESS, "Failed to allocate mesh upload command buffers")
+
+        // Copy k (1-based) uses slot (k - 1) % 2 and signals k, so before reusing a slot the host waits for k - 2.
+        uint64_t copies = 0;
+        const auto stream = [&](const std::span<const std::byte> source, const VkBuffer destination) {
+            for (VkDeviceSize offset = 0; offset < source.size(); offset += chunk) {
+                const VkDeviceSize size = std::min(chunk, source.size() - offset);
+                const uint32_t slot = copies % STAGING_SLOTS;
+                if (copies >= STAGING_SLOTS) {
+                    done.wait(copies + 1 - STAGING_SLOTS);
+                }
+                std::memcpy(static_cast<std::byte *>(staging.get_mapped()) + slot * chunk, source.data() + offset,
+                            size);
+                staging.flush(slot * chunk, size);
+
+                const VkCommandBuffer command_buffer = command_buffers[slot];
+                vkResetCommandBuffer(command_buffer, 0);
+                VkCommandBufferBeginInfo begin_info{};
+                begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+                ASSERT_EQUAL(vkBeginCommandBuffer(command_buffer, &begin_info), VK_SUCCESS,
+                             "Failed to begin mesh upload command buffer")
+                const VkBufferCopy region{slot * chunk, offset, size};
+                vkCmdCopyBuffer(command_buffer, staging.get_buffer(), destination, 1, &region);
+                ASSERT_EQUAL(vkEndCommandBuffer(command_buffer), VK_SUCCESS, "Failed to record mesh upload")
+
+                QueueSubmission sync;
+                sync.signal(done.get_semaphore(), ++copies);
+                ASSERT_EQUAL(sync.submit(device->get_graphics_queue(), &command_buffer, 1), VK_SUCCESS,
+                             "Failed to submit mesh upload")
+            }
+        };
+        for (const UploadRegion &region : regions) {
+            stream(region.source, region.destination->get_buffer());
+        }
+
+        done.wait(copies);
+        vkFreeCommandBuffers(device->get_logical_device(), device->get_command_pool(), STAGING_SLOTS,
+                             command_buffers.data());
+    }
+
+    void PyroMeshBuffers::bind(const VkCommandBuffer command_buffer) const {
+        const VkBuffer buffer = vertex_buffer->get_buffer();
+        constexpr VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &buffer, &offset);
+        vkCmdBindIndexBuffer(command_buffer, index_buffer->get_buffer(), 0, VK_INDEX_TYPE_UINT32);
+    }
+
+    void PyroMeshBuffers::draw(const VkCommandBuffer command_buffer, const uint32_t mesh,
+                               const uint32_t instance_count) const {
+        const MeshEntry &entry = meshes[mesh];
+        vkCmdDrawIndexed(command_buffer, entry.index_count, instance_count, entry.first_index,
+                         static_cast<int32_t>(entry.first_vertex), 0);
+    }
+
+    void PyroMeshBuffers::draw_lod(const VkCommandBuffer command_buffer, const uint32_t mesh, const uint32_t lod,
+                                   const uint32_t instance_count) const {
+        const MeshLod range = get_lod(mesh, lod);
+        vkCmdDrawIndexed(command_buffer, range.index_count, instance_count, range.first_index,
+                         static_cast<int32_t>(meshes[mesh].first_vertex), 0);
+    }
+
+    MeshLod PyroMeshBuffers::get_lod(const uint32_t mesh, const uint32_t lod) const {
+        const MeshEntry &entry = meshes[mesh];
+        if (entry.lod_count == 0) {
+            return {entry.first_index, entry.index_count, 0.0f, 0};
+        }
+        return lods[entry.first_lod + std::min(lod, entry.lod_count - 1)];
+    }
+
+    std::vector<VkVertexInputBindingDescription> PyroMeshBuffers::vertex_bindings(const MeshVertexFormat format) {
+        return {{0, mesh_vertex_stride(format), VK_VERTEX_INPUT_RATE_VERTEX}};
+    }
+
+    std::vector<VkVertexInputAttributeDescription> PyroMeshBuffers::vertex_attributes(const MeshVertexFormat format) {
+        if (format == MeshVertexFormat::QUANTIZED) {
+            return {
+                    {0, 0, VK_FORMAT_R16G16B16A16_SFLOAT, offsetof(QuantizedMeshVertex, position)},
+                    {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(QuantizedMeshVertex, normal)},
+                    {2, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(QuantizedMeshVertex, uv)},
+            };
+        }
+        return {
+                {0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(MeshVertex, position)},
+                {1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(MeshVertex, normal)},
+                {2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(MeshVertex, uv)},
+        };
+    }
+
+    const char *PyroMeshBuffers::vertex_shader(const MeshVertexFormat format) {
+        return format == MeshVertexFormat::QUANTIZED ? "assets/shaders/mesh_quantized.vert.spv"
+                                                     : "assets/shaders/mesh.vert.spv";
+    }
+} // namespace pyro
@@ -0,0 +1,93 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#ifndef PYROMESHBUFFERS_HPP
+#define PYROMESHBUFFERS_HPP
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanBuffer.hpp"
+#include "PyroMeshFile.hpp"
+
+namespace pyro {
+
+    // The sections of a .pmesh as laid out in the file. `vertices` holds vertex_format vertices and `indices`,
+    // `meshlet_vertices` and `meshlet_triangles` uint32_t's; everything after vertex_format may be empty.
+    struct MeshData {
+        std::span<const MeshEntry> meshes;
+        std::span<const std::byte> vertices;
+        std::span<const std::byte> indices;
+        MeshVertexFormat vertex_format = MeshVertexFormat::FLOAT32;
+        std::span<const MeshLod> lods;
+        std::span<const MeshletEntry> meshlets;
+        std::span<const std::byte> meshlet_vertices;
+        std::span<const std::byte> meshlet_triangles;
+    };
+
+    // Device-local vertex and index buffers holding every mesh of a .pmesh file. The sections are streamed
+    // through two staging chunks: while the GPU copies one, the host fills the other straight from the source
+    // bytes, which for a mapped file means the page cache. Meshlet tables go into storage buffers for cluster
+    // culling, which also reads the vertex buffer as storage on the mesh shader path.
+    class PyroMeshBuffers {
+    public:
+        static constexpr VkDeviceSize STAGING_CHUNK_SIZE = 64ull << 20;
+
+        PyroMeshBuffers(VulkanDevice *device, const PyroMeshFile &file);
+        PyroMeshBuffers(VulkanDevice *device, const MeshData &data);
+
+        // Binds the vertex buffer at binding 0 and the index buffer; the pipeline's vertex input must be the one
+        // returned for get_vertex_format().
+        void bind(VkCommandBuffer command_buffer) const;
+        void draw(VkCommandBuffer command_buffer, uint32_t mesh, uint32_t instance_count = 1) const;
+        void draw_lod(VkCommandBuffer command_buffer, uint32_t mesh, uint32_t lod, uint32_t instance_count = 1) const;
+
+        // Meshes written without LODs report a single level covering the whole mesh.
+        uint32_t get_lod_count(uint32_t mesh) const { return std::max(meshes[mesh].lod_count, 1u); }
+        MeshLod get_lod(uint32_t mesh, uint32_t lod) const;
+
+        const std::vector<MeshEntry> &get_meshes() const { return meshes; }
+        bool has_meshlets() const { return meshlet_count > 0; }
+        uint32_t get_meshlet_count() const { return meshlet_count; }
+        // Storage buffers with the MESHLETS, MESHLET_VERTICES and MESHLET_TRIANGLES sections.
+        VkBuffer get_meshlet_buffer() const { return meshlet_buffer->get_buffer(); }
+        VkBuffer get_meshlet_vertex_buffer() const { return meshlet_vertex_buffer->get_buffer(); }
+        VkBuffer get_meshlet_triangle_buffer() const { return meshlet_triangle_buffer->get_buffer(); }
+        VkBuffer get_vertex_buffer() const { return vertex_buffer->get_buffer(); }
+        MeshVertexFormat get_vertex_format() const { return format; }
+        VkDeviceSize get_uploaded_bytes() const {
+            return vertex_buffer->get_size() + index_buffer->get_size() + meshlet_buffer->get_size() +
+                   meshlet_vertex_buffer->get_size() + meshlet_triangle_buffer->get_size();
+        }
+
+        // Matching GraphicsPipelineDesc vertex input and vertex shader for each vertex format.
+        static std::vector<VkVertexInputBindingDescription> vertex_bindings(MeshVertexFormat format);
+        static std::vector<VkVertexInputAttributeDescription> vertex_attributes(MeshVertexFormat format);
+        static const char *vertex_shader(MeshVertexFormat format);
+
+    private:
+        VulkanDevice *device;
+        std::vector<MeshEntry> meshes;
+        std::vector<MeshLod> lods;
+        MeshVertexFormat format;
+        uint32_t meshlet_count;
+        std::unique_ptr<VulkanBuffer> vertex_buffer;
+        std::unique_ptr<VulkanBuffer> index_buffer;
+        std::unique_ptr<VulkanBuffer> meshlet_buffer;
+        std::unique_ptr<VulkanBuffer> meshlet_vertex_buffer;
+        std::unique_ptr<VulkanBuffer> meshlet_triangle_buffer;
+
+        struct UploadRegion {
+            std::span<const std::byte> source;
+            const VulkanBuffer *destination;
+        };
+        void upload(std::span<const UploadRegion> regions) const;
+    };
+
+} // namespace pyro
+
+#endif // PYROMESHBUFFERS_HPP
@@ -0,0 +1,103 @@
+//
+// Created by srijan on 2/28/25.
+//
+
+#include "PyroMeshCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pyro {
+    namespace {
+        // Keeps the projected error finite for instances the camera is inside of.
+        constexpr float MIN_LOD_DISTANCE = 1e-3f;
+    } // namespace
+
+    // Gribb-Hartmann extraction, normalised so that dot(plane.xyz, p) + plane.w is a signed distance.
+    std::array<glm::vec4, 6> extract_frustum_planes(const glm::mat4 &m) {
+        const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+        std::array<glm::vec4, 6> planes{row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2};
+        for (glm::vec4 &plane : planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return planes;
+    }
+
+    float max_axis_scale(const glm::mat4 &transform) {
+        return std::sqrt(std::max({glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+                                   glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])),
+                                   glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))}));
+    }
+
+    PyroMeshCuller::PyroMeshCuller(const PyroMeshBuffers *buffers, const LodSelectionConfig config) :
+        buffers(buffers), config(config) {
+        for (const MeshEntry &entry : buffers->get_meshes()) {
+            const glm::vec3 min(entry.bounds_min[0], entry.bounds_min[1], entry.bounds_min[2]);
+            const glm::vec3 max(entry.bounds_max[0], entry.bounds_max[1], entry.bounds_max[2]);
+            spheres.push_back({(min + max) * 0.5f, glm::length(max - min) * 0.5f});
+        }
+    }
+
+    // LOD errors grow monotonically along the chain, so the walk stops at the first level over the threshold.
+    uint32_t PyroMeshCuller::select_lod(const uint32_t mesh, const float pixels_per_unit,
+                                        const uint32_t current) const {
+        const uint32_t lod_count = buffers->get_lod_count(mesh);
+        const auto coarsest_within = [&](const float threshold) {
+            uint32_t lod = 0;
+            while (lod + 1 < lod_count && buffers->get_lod(mesh, lod + 1).error * pixels_per_unit <= threshold) {
+                lod++;
+            }
+            return lod;
+        };
+        const uint32_t target = coarsest_within(config.error_threshold);
+        if (target <= current) {
+            return target;
+        }
+        return std::max(current, coarsest_within(config.error_threshold * (1.0f - config.hysteresis)));
+    }
+
+    void PyroMeshCuller::cull(const std::span<const MeshInstance> instances, const MeshCullView &view,
+                              std::vector<VkDrawIndexedIndirectCommand> &draws) {
+        stats = {};
+        draws.clear();
+        if (current_lods.size() != instances.size()) {
+            current_lods.assign(instances.size(), 0);
+        }
+        const std::array<glm::vec4, 6> planes = extract_frustum_planes(view.view_proj);
+
+        for (uint32_t i = 0; i < instances.size(); i++) {
+            const MeshInstance &instance = instances[i];
+            const BoundingSphere &sphere = spheres[instance.mesh];
+            const glm::vec3 center(instance.transform * glm::vec4(sphere.center, 1.0f));
+            const float scale = max_axis_scale(instance.transform);
+            const float radius = sphere.radius * scale;
+            const bool outside = std::ranges::any_of(planes, [&](const glm::vec4 &plane) {
+                return glm::dot(glm::vec3(plane), center) + plane.w < -radius;
+            });
+            if (outside) {
+                stats.culled++;
+                continue;
+            }
+
+            uint32_t lod = 0;
+            if (config.enabled) {
+                const float distance = std::max(glm::length(center - view.eye) - radius, MIN_LOD_DISTANCE);
+                lod = select_lod(instance.mesh, scale * view.projection_scale / distance, current_lods[i]);
+            }
+            if (lod != current_lods[i]) {
+                stats.lod_switches++;
+                current_lods[i] = static_cast<uint8_t>(lod);
+            }
+
+            const MeshLod range = buffers->get_lod(instance.mesh, lod);
+            draws.push_back({range.index_count, 1, range.first_index,
+                             static_cast<int32_t>(buffers->get_meshes()[instance.mesh].first_vertex), i});
+            stats.visible++;
+            stats.triangles += range.index_count / 3;
+            stats.lod_histogram[std::min(lod, MeshCullStats::MAX_TRACKED_LODS - 1)]++;
+        }
+    }
+} // namespace pyro
@@ -0,0 +1,90 @@
+//
+// Created by srijan on 2/28/25.
+//
+
+#ifndef PYROMESHCULLER_HPP
+#define PYROMESHCULLER_HPP
+
+#include <array>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "PyroMeshBuffers.hpp"
+
+namespace pyro {
+
+    struct MeshInstance {
+        uint32_t mesh;
+        glm::mat4 transform;
+    };
+
+    struct MeshCullView {
+        glm::mat4 view_proj;
+        glm::vec3 eye;
+        // Pixels per unit of object-space error at distance 1: viewport height / (2 * tan(fovy / 2)), which is
+        // proj[1][1] * height / 2 for a perspective projection.
+        float projection_scale;
+    };
+
+    struct LodSelectionConfig {
+        // Coarsest level whose projected error stays under this many pixels is chosen.
+        float error_threshold = 1.0f;
+        // An instance only moves to a coarser level once that level's error drops below
+        // error_threshold * (1 - hysteresis), so instances near a switch distance don't alternate every frame.
+        float hysteresis = 0.25f;
+        bool enabled = true;
+    };
+
+    struct MeshCullStats {
+        static constexpr uint32_t MAX_TRACKED_LODS = 8;
+
+        uint32_t visible = 0;
+        uint32_t culled = 0;
+        uint64_t triangles = 0;
+        uint32_t lod_switches = 0;
+        // Visible instances per level; deeper levels are counted in the last bucket.
+        std::array<uint32_t, MAX_TRACKED_LODS> lod_histogram{};
+    };
+
+    // World-space frustum planes of a [0, 1] depth range view-projection: left, right, bottom, top, near, far. A
+    // point is inside when dot(plane.xyz, p) + plane.w >= 0 for all six.
+    std::array<glm::vec4, 6> extract_frustum_planes(const glm::mat4 &view_proj);
+    // Scales an object-space bounding sphere radius to world space under `transform`.
+    float max_axis_scale(const glm::mat4 &transform);
+
+    // CPU culling stage for mesh instances: frustum tests each instance's bounding sphere and picks its level of
+    // detail from the projected screen-space error of the mesh's LOD chain. The chosen level is remembered per
+    // instance slot to apply hysteresis, so instance lists should keep a stable order between frames. Visible
+    // instances come out as indexed indirect commands whose firstInstance is the instance's index.
+    class PyroMeshCuller {
+    public:
+        explicit PyroMeshCuller(const PyroMeshBuffers *buffers, LodSelectionConfig config = {});
+
+        // Replaces `draws` with this view's visible instances.
+        void cull(std::span<const MeshInstance> instances, const MeshCullView &view,
+                  std::vector<VkDrawIndexedIndirectCommand> &draws);
+
+        void set_config(const LodSelectionConfig &config) { this->config = config; }
+        const LodSelectionConfig &get_config() const { return config; }
+        const MeshCullStats &get_stats() const { return stats; }
+
+    private:
+        struct BoundingSphere {
+            glm::vec3 center;
+            float radius;
+        };
+
+        const PyroMeshBuffers *buffers;
+        LodSelectionConfig config;
+        std::vector<BoundingSphere> spheres;
+        std::vector<uint8_t> current_lods;
+        MeshCullStats stats;
+
+        uint32_t select_lod(uint32_t mesh, float pixels_per_unit, uint32_t current) const;
+    };
+
+} // namespace pyro
+
+#endif // PYROMESHCULLER_HPP
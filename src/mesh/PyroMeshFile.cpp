@@ -0,0 +1,101 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#include "PyroMeshFile.hpp"
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    bool PyroMeshFile::open(const std::string &path) {
+        header = nullptr;
+        sections = {};
+        meshes = {};
+        lods = {};
+        meshlets = {};
+        if (!file.open(path)) {
+            return false;
+        }
+        const std::span<const std::byte> bytes = file.get_bytes();
+        const auto *candidate = reinterpret_cast<const MeshFileHeader *>(bytes.data());
+        if (bytes.size() < sizeof(MeshFileHeader) || candidate->magic != MESH_FILE_MAGIC) {
+            LOG(LogLevel::ERROR, "{} is not a mesh file", path);
+            return false;
+        }
+        if (candidate->version != MESH_FILE_VERSION) {
+            LOG(LogLevel::ERROR, "{}: unsupported mesh file version {}, expected {}", path, candidate->version,
+                MESH_FILE_VERSION);
+            return false;
+        }
+        if (candidate->vertex_format > MeshVertexFormat::QUANTIZED ||
+            candidate->vertex_stride != mesh_vertex_stride(candidate->vertex_format)) {
+            LOG(LogLevel::ERROR, "{}: unknown vertex format {} with stride {}", path,
+                static_cast<uint32_t>(candidate->vertex_format), candidate->vertex_stride);
+            return false;
+        }
+        const uint64_t table_end =
+                sizeof(MeshFileHeader) + static_cast<uint64_t>(candidate->section_count) * sizeof(MeshSectionEntry);
+        if (candidate->file_size != bytes.size() || table_end > bytes.size()) {
+            LOG(LogLevel::ERROR, "{}: truncated mesh file", path);
+            return false;
+        }
+        const auto *table = reinterpret_cast<const MeshSectionEntry *>(bytes.data() + sizeof(MeshFileHeader));
+        for (uint32_t i = 0; i < candidate->section_count; i++) {
+            const MeshSectionEntry &section = table[i];
+            if (section.offset % MESH_SECTION_ALIGNMENT != 0 || section.offset < table_end ||
+                section.offset > bytes.size() || section.size > bytes.size() - section.offset) {
+                LOG(LogLevel::ERROR, "{}: section {} is out of bounds or misaligned", path, i);
+                return false;
+            }
+        }
+        header = candidate;
+        sections = {table, candidate->section_count};
+
+        const std::span<const std::byte> mesh_bytes = get_section(MeshSectionType::MESHES);
+        meshes = {reinterpret_cast<const MeshEntry *>(mesh_bytes.data()), mesh_bytes.size() / sizeof(MeshEntry)};
+        const uint64_t vertex_count = get_section(MeshSectionType::VERTICES).size() / header->vertex_stride;
+        const uint64_t index_count = get_section(MeshSectionType::INDICES).size() / sizeof(uint32_t);
+        const std::span<const std::byte> lod_bytes = get_section(MeshSectionType::LODS);
+        lods = {reinterpret_cast<const MeshLod *>(lod_bytes.data()), lod_bytes.size() / sizeof(MeshLod)};
+        const std::span<const std::byte> meshlet_bytes = get_section(MeshSectionType::MESHLETS);
+        meshlets = {reinterpret_cast<const MeshletEntry *>(meshlet_bytes.data()),
+                    meshlet_bytes.size() / sizeof(MeshletEntry)};
+        const uint64_t meshlet_vertex_count = get_section(MeshSectionType::MESHLET_VERTICES).size() / sizeof(uint32_t);
+        const uint64_t meshlet_triangle_count =
+                get_section(MeshSectionType::MESHLET_TRIANGLES).size() / sizeof(uint32_t);
+        for (size_t i = 0; i < meshes.size(); i++) {
+            const MeshEntry &mesh = meshes[i];
+            bool valid = static_cast<uint64_t>(mesh.first_vertex) + mesh.vertex_count <= vertex_count &&
+                         static_cast<uint64_t>(mesh.first_index) + mesh.index_count <= index_count &&
+                         static_cast<uint64_t>(mesh.first_lod) + mesh.lod_count <= lods.size() &&
+                         static_cast<uint64_t>(mesh.first_meshlet) + mesh.meshlet_count <= meshlets.size();
+            for (uint32_t l = 0; valid && l < mesh.lod_count; l++) {
+                const MeshLod &lod = lods[mesh.first_lod + l];
+                valid = static_cast<uint64_t>(lod.first_index) + lod.index_count <= index_count;
+            }
+            for (uint32_t m = 0; valid && m < mesh.meshlet_count; m++) {
+                const MeshletEntry &meshlet = meshlets[mesh.first_meshlet + m];
+                valid = meshlet.vertex_count <= MESHLET_MAX_VERTICES &&
+                        meshlet.triangle_count <= MESHLET_MAX_TRIANGLES &&
+                        static_cast<uint64_t>(meshlet.vertex_offset) + meshlet.vertex_count <= meshlet_vertex_count &&
+                        static_cast<uint64_t>(meshlet.triangle_offset) + meshlet.triangle_count <=
+                                meshlet_triangle_count;
+            }
+            if (!valid) {
+                LOG(LogLevel::ERROR, "{}: mesh {} references data outside its sections", path, i);
+                header = nullptr;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::span<const std::byte> PyroMeshFile::get_section(const MeshSectionType type) const {
+        for (const MeshSectionEntry &section : sections) {
+            if (section.type == type) {
+                return file.get_bytes().subspan(section.offset, section.size);
+            }
+        }
+        return {};
+    }
+} // namespace pyro
@@ -0,0 +1,44 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#ifndef PYROMESHFILE_HPP
+#define PYROMESHFILE_HPP
+
+#include <span>
+#include <string>
+
+#include "PyroMappedFile.hpp"
+#include "PyroMeshFormat.hpp"
+
+namespace pyro {
+
+    // A .pmesh file mapped into memory. open() checks the header, the section table and the index table's
+    // ranges and nothing else: the vertex and index sections are handed out as raw bytes in GPU layout, so no
+    // per-vertex work happens on load.
+    class PyroMeshFile {
+    public:
+        bool open(const std::string &path);
+
+        const MeshFileHeader &get_header() const { return *header; }
+        std::span<const MeshEntry> get_meshes() const { return meshes; }
+        // Every mesh's levels, indexed by MeshEntry::first_lod.
+        std::span<const MeshLod> get_lods() const { return lods; }
+        // Every mesh's meshlets, indexed by MeshEntry::first_meshlet; empty for files built without them.
+        std::span<const MeshletEntry> get_meshlets() const { return meshlets; }
+        // Empty when the file has no such section.
+        std::span<const std::byte> get_section(MeshSectionType type) const;
+        uint64_t get_file_size() const { return file.get_bytes().size(); }
+
+    private:
+        PyroMappedFile file;
+        const MeshFileHeader *header = nullptr;
+        std::span<const MeshSectionEntry> sections;
+        std::span<const MeshEntry> meshes;
+        std::span<const MeshLod> lods;
+        std::span<const MeshletEntry> meshlets;
+    };
+
+} // namespace pyro
+
+#endif // PYROMESHFILE_HPP
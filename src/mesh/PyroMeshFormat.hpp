@@ -0,0 +1,142 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#ifndef PYROMESHFORMAT_HPP
+#define PYROMESHFORMAT_HPP
+
+#include <cstdint>
+
+namespace pyro {
+
+    // On-disk layout of .pmesh files, written by tools/meshc and mapped as-is at runtime:
+    //
+    //   MeshFileHeader | MeshSectionEntry[section_count] | sections...
+    //
+    // Every section starts on a MESH_SECTION_ALIGNMENT boundary and holds data in exactly the layout the GPU or
+    // the engine consumes, so loading is a memcpy per section. Little-endian throughout.
+    constexpr uint32_t MESH_FILE_MAGIC = 0x534d5950; // "PYMS"
+    constexpr uint32_t MESH_FILE_VERSION = 3;
+    constexpr uint64_t MESH_SECTION_ALIGNMENT = 16;
+
+    enum class MeshSectionType : uint32_t {
+        // MeshEntry[], the index table.
+        MESHES = 1,
+        // MeshVertex[] or QuantizedMeshVertex[] (see the header's vertex_format) shared by every mesh.
+        VERTICES = 2,
+        // uint32_t[] shared by every mesh, relative to each mesh's first_vertex.
+        INDICES = 3,
+        // MeshLod[]; each mesh owns lod_count entries from first_lod, finest first. Optional.
+        LODS = 4,
+        // MeshletEntry[]; each mesh owns meshlet_count entries from first_meshlet, covering its full-detail level.
+        // Optional, together with the two sections below.
+        MESHLETS = 5,
+        // uint32_t[]; each meshlet's vertex_count vertices from vertex_offset, relative to the mesh's first_vertex.
+        MESHLET_VERTICES = 6,
+        // uint32_t[]; each meshlet's triangle_count triangles from triangle_offset, as three 8-bit indices into
+        // the meshlet's vertices in the low 24 bits.
+        MESHLET_TRIANGLES = 7,
+    };
+
+    enum class MeshVertexFormat : uint32_t {
+        // MeshVertex.
+        FLOAT32 = 0,
+        // QuantizedMeshVertex.
+        QUANTIZED = 1,
+    };
+
+    // Bound as vertex binding 0: position, normal, uv at locations 0-2.
+    struct MeshVertex {
+        float position[3];
+        float normal[3];
+        float uv[2];
+    };
+
+    // Half the size of MeshVertex: half-float position (w = 1) and uv, and an octahedral-encoded snorm16 normal
+    // that assets/shaders/mesh_quantized.vert decodes. Half positions keep about three significant digits, so
+    // only meshes authored around their own origin should be quantized.
+    struct QuantizedMeshVertex {
+        uint16_t position[4];
+        int16_t normal[2];
+        uint16_t uv[2];
+    };
+
+    struct MeshFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t section_count;
+        uint32_t vertex_stride;
+        uint64_t file_size;
+        MeshVertexFormat vertex_format;
+        uint32_t reserved;
+    };
+
+    struct MeshSectionEntry {
+        MeshSectionType type;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    // first_index and index_count describe the full-detail level, which is also the mesh's first MeshLod.
+    struct MeshEntry {
+        char name[32];
+        uint32_t first_vertex;
+        uint32_t vertex_count;
+        uint32_t first_index;
+        uint32_t index_count;
+        uint32_t first_lod;
+        uint32_t lod_count;
+        float bounds_min[3];
+        float bounds_max[3];
+        uint32_t first_meshlet;
+        uint32_t meshlet_count;
+    };
+
+    // One level of detail: an index range over the mesh's full-detail vertices. `error` bounds the distance
+    // from this level's surface to the original in object units, so error * scale / distance is the projected
+    // error at a given view.
+    struct MeshLod {
+        uint32_t first_index;
+        uint32_t index_count;
+        float error;
+        uint32_t reserved;
+    };
+
+    constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+    constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+    // A cluster of a mesh's full-detail triangles with object-space culling bounds; laid out for std430 reads
+    // by assets/shaders/include/cluster_cull.glsl. Every triangle faces away from a viewer at `eye` when
+    // dot(center - eye, cone_axis) >= cone_cutoff * length(center - eye) + radius; a cone_cutoff of 1 means the
+    // normals are too spread for that test to ever pass.
+    struct MeshletEntry {
+        float center[3];
+        float radius;
+        float cone_axis[3];
+        float cone_cutoff;
+        uint32_t vertex_offset;
+        uint32_t triangle_offset;
+        uint32_t vertex_count;
+        uint32_t triangle_count;
+    };
+
+    static_assert(sizeof(MeshVertex) == 32);
+    static_assert(sizeof(QuantizedMeshVertex) == 16);
+    static_assert(sizeof(MeshFileHeader) == 32);
+    static_assert(sizeof(MeshSectionEntry) == 24);
+    static_assert(sizeof(MeshEntry) == 88);
+    static_assert(sizeof(MeshLod) == 16);
+    static_assert(sizeof(MeshletEntry) == 48);
+
+    constexpr uint32_t mesh_vertex_stride(const MeshVertexFormat format) {
+        return format == MeshVertexFormat::QUANTIZED ? sizeof(QuantizedMeshVertex) : sizeof(MeshVertex);
+    }
+
+    constexpr uint64_t align_mesh_section(const uint64_t offset) {
+        return (offset + MESH_SECTION_ALIGNMENT - 1) & ~(MESH_SECTION_ALIGNMENT - 1);
+    }
+
+} // namespace pyro
+
+#endif // PYROMESHFORMAT_HPP
@@ -0,0 +1,27 @@
+//
+// Created by srijan on 3/2/25.
+//
+
+#include "PyroCounters.hpp"
+
+#include <algorithm>
+
+namespace pyro {
+    // A frame publishes a few dozen counters at most, so a linear scan beats hashing the name.
+    void PyroCounters::set(const std::string_view name, const double value) {
+        const auto it = std::ranges::find(counters, name, &ProfilerCounter::name);
+        if (it == counters.end()) {
+            counters.push_back({std::string(name), value});
+            return;
+        }
+        it->value = value;
+    }
+
+    std::optional<double> PyroCounters::get(const std::string_view name) const {
+        const auto it = std::ranges::find(counters, name, &ProfilerCounter::name);
+        if (it == counters.end()) {
+            return std::nullopt;
+        }
+        return it->value;
+    }
+} // namespace pyro
@@ -0,0 +1,42 @@
+//
+// Created by srijan on 3/2/25.
+//
+
+#ifndef PYROCOUNTERS_HPP
+#define PYROCOUNTERS_HPP
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pyro {
+
+    struct ProfilerCounter {
+        std::string name;
+        double value;
+    };
+
+    // Named per-frame values that subsystems publish for the stats overlay and profiling captures, e.g. how many
+    // clusters culling rejected. A counter keeps its last value until set again and counters are listed in the
+    // order they were first set. Render-thread only.
+    class PyroCounters {
+    public:
+        static PyroCounters &get_instance() {
+            static PyroCounters instance;
+            return instance;
+        }
+
+        void set(std::string_view name, double value);
+        std::optional<double> get(std::string_view name) const;
+        const std::vector<ProfilerCounter> &get_counters() const { return counters; }
+
+    private:
+        PyroCounters() = default;
+
+        std::vector<ProfilerCounter> counters;
+    };
+
+} // namespace pyro
+
+#endif // PYROCOUNTERS_HPP
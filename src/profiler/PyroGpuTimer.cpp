@@ -0,0 +1,112 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+#include "PyroGpuTimer.hpp"
+
+#include "../utils/Logger.hpp"
+#include "PyroTrace.hpp"
+
+namespace pyro {
+    bool PyroGpuTimer::is_supported(const VulkanDevice *device) {
+        const VkPhysicalDeviceLimits &limits = device->get_properties().limits;
+        return limits.timestampComputeAndGraphics && limits.timestampPeriod > 0.0f;
+    }
+
+    PyroGpuTimer::PyroGpuTimer(VulkanDevice *device, const uint32_t max_scopes) :
+        device(device), max_scopes(max_scopes),
+        period_ms(static_cast<double>(device->get_properties().limits.timestampPeriod) / 1e6) {
+        if (!is_supported(device)) {
+            LOG(LogLevel::WARNING, "Timestamp queries unsupported, GPU timings will read as zero");
+        }
+        VkQueryPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        // The extra query is calibrate()'s.
+        pool_info.queryCount = max_scopes * 2 + 1;
+        ASSERT_EQUAL(vkCreateQueryPool(device->get_logical_device(), &pool_info, nullptr, &query_pool), VK_SUCCESS,
+                     "Failed to create timestamp query pool")
+        calibrate();
+    }
+
+    PyroGpuTimer::~PyroGpuTimer() { vkDestroyQueryPool(device->get_logical_device(), query_pool, nullptr); }
+
+    void PyroGpuTimer::reset(const VkCommandBuffer command_buffer) {
+        vkCmdResetQueryPool(command_buffer, query_pool, 0, max_scopes * 2);
+        scope_count = 0;
+    }
+
+    uint32_t PyroGpuTimer::begin(const VkCommandBuffer command_buffer, const VkPipelineStageFlagBits stage) {
+        ASSERT_EQUAL(scope_count < max_scopes, true, "Out of GPU timer scopes")
+        const uint32_t scope = scope_count++;
+        vkCmdWriteTimestamp(command_buffer, stage, query_pool, scope * 2);
+        return scope;
+    }
+
+    void PyroGpuTimer::end(const VkCommandBuffer command_buffer, const uint32_t scope,
+                           const VkPipelineStageFlagBits stage) const {
+        vkCmdWriteTimestamp(command_buffer, stage, query_pool, scope * 2 + 1);
+    }
+
+    std::vector<uint64_t> PyroGpuTimer::read_timestamps() const {
+        std::vector<uint64_t> timestamps(scope_count * 2);
+        vkGetQueryPoolResults(device->get_logical_device(), query_pool, 0, scope_count * 2,
+                              timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+        return timestamps;
+    }
+
+    std::vector<double> PyroGpuTimer::resolve() const {
+        std::vector<double> timings;
+        if (scope_count == 0 || !is_supported(device)) {
+            return std::vector<double>(scope_count, 0.0);
+        }
+        const std::vector<uint64_t> timestamps = read_timestamps();
+        for (uint32_t i = 0; i < scope_count; i++) {
+            timings.push_back(static_cast<double>(timestamps[i * 2 + 1] - timestamps[i * 2]) * period_ms);
+        }
+        return timings;
+    }
+
+    std::optional<double> PyroGpuTimer::resolve(const uint32_t scope) const {
+        if (scope >= scope_count) {
+            return std::nullopt;
+        }
+        return resolve()[scope];
+    }
+
+    std::vector<GpuTimeRange> PyroGpuTimer::resolve_ranges() const {
+        if (scope_count == 0 || !is_supported(device)) {
+            return {};
+        }
+        const std::vector<uint64_t> timestamps = read_timestamps();
+        const double period_ns = period_ms * 1e6;
+        std::vector<GpuTimeRange> ranges;
+        for (uint32_t i = 0; i < scope_count; i++) {
+            ranges.push_back({static_cast<int64_t>(static_cast<double>(timestamps[i * 2]) * period_ns) +
+                                      calibration_offset_ns,
+                              static_cast<int64_t>(static_cast<double>(timestamps[i * 2 + 1]) * period_ns) +
+                                      calibration_offset_ns});
+        }
+        return ranges;
+    }
+
+    void PyroGpuTimer::calibrate() {
+        if (!is_supported(device)) {
+            return;
+        }
+        const uint32_t query = max_scopes * 2;
+        const VkCommandBuffer command_buffer = device->begin_single_time_commands();
+        vkCmdResetQueryPool(command_buffer, query_pool, query, 1);
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool, query);
+        const int64_t submitted_ns = trace_now_ns();
+        device->end_single_time_commands(command_buffer);
+        const int64_t completed_ns = trace_now_ns();
+        uint64_t timestamp = 0;
+        vkGetQueryPoolResults(device->get_logical_device(), query_pool, query, 1, sizeof(timestamp), &timestamp,
+                              sizeof(timestamp), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+        // The write happened somewhere between submission and completion; assume the middle.
+        calibration_offset_ns = (submitted_ns + completed_ns) / 2 -
+                                static_cast<int64_t>(static_cast<double>(timestamp) * period_ms * 1e6);
+    }
+} // namespace pyro
@@ -0,0 +1,64 @@
+//
+// Created by srijan on 2/20/25.
+//
+
+#ifndef PYROGPUTIMER_HPP
+#define PYROGPUTIMER_HPP
+
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+
+namespace pyro {
+
+    // A scope's begin and end on the steady_clock timeline (see trace_now_ns()), in nanoseconds.
+    struct GpuTimeRange {
+        int64_t begin_ns;
+        int64_t end_ns;
+    };
+
+    // Timestamp-query scopes. reset() at the start of a command buffer, then begin()/end() pairs around the
+    // work to time; once the command buffer has completed, resolve() reads every scope back in milliseconds.
+    class PyroGpuTimer {
+    public:
+        static bool is_supported(const VulkanDevice *device);
+
+        explicit PyroGpuTimer(VulkanDevice *device, uint32_t max_scopes = 64);
+        ~PyroGpuTimer();
+        PyroGpuTimer(const PyroGpuTimer &) = delete;
+        PyroGpuTimer &operator=(const PyroGpuTimer &) = delete;
+
+        void reset(VkCommandBuffer command_buffer);
+        uint32_t begin(VkCommandBuffer command_buffer,
+                       VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+        void end(VkCommandBuffer command_buffer, uint32_t scope,
+                 VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT) const;
+        // Blocks until the results are available.
+        std::vector<double> resolve() const;
+        std::optional<double> resolve(uint32_t scope) const;
+        // Every scope placed on the CPU timeline through the offset measured by calibrate(), for merging GPU work
+        // into CPU traces. Blocks like resolve().
+        std::vector<GpuTimeRange> resolve_ranges() const;
+
+        // Measures the offset between GPU timestamps and steady_clock by submitting a lone timestamp write and
+        // waiting for it, accurate to about half that round trip. Done on construction; call again now and then
+        // to absorb clock drift. Must not be called while recording a command buffer that uses this timer.
+        void calibrate();
+
+    private:
+        VulkanDevice *device;
+        VkQueryPool query_pool{};
+        uint32_t max_scopes;
+        uint32_t scope_count = 0;
+        double period_ms;
+        // steady_clock nanoseconds minus GPU timestamp nanoseconds.
+        int64_t calibration_offset_ns = 0;
+
+        std::vector<uint64_t> read_timestamps() const;
+    };
+
+} // namespace pyro
+
+#endif // PYROGPUTIMER_HPP
@@ -0,0 +1,57 @@
+//
+// Created by srijan on 3/7/25.
+//
+
+#include "PyroStartup.hpp"
+
+#include <algorithm>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        double to_ms(const int64_t ns) { return static_cast<double>(ns) / 1e6; }
+    } // namespace
+
+    void PyroStartup::begin() {
+        const std::lock_guard lock(mutex);
+        begin_ns = trace_now_ns();
+        reported = false;
+        steps.clear();
+        threads.clear();
+        thread_index(std::this_thread::get_id());
+    }
+
+    uint32_t PyroStartup::thread_index(const std::thread::id id) {
+        return threads.try_emplace(id, static_cast<uint32_t>(threads.size())).first->second;
+    }
+
+    void PyroStartup::record(const char *name, const int64_t start_ns, const int64_t end_ns) {
+        const std::lock_guard lock(mutex);
+        if (begin_ns == 0) {
+            begin_ns = start_ns;
+        }
+        steps.push_back({name, start_ns, end_ns, thread_index(std::this_thread::get_id())});
+    }
+
+    void PyroStartup::first_frame(const double target_ms) {
+        const int64_t now_ns = trace_now_ns();
+        const std::lock_guard lock(mutex);
+        if (reported) {
+            return;
+        }
+        reported = true;
+        std::ranges::sort(steps, {}, &StartupStep::start_ns);
+        for ([[maybe_unused]] const StartupStep &step : steps) {
+            LOG(LogLevel::INFO, "Startup {:>20} thread {} at {:8.2f} ms took {:8.2f} ms", step.name, step.thread,
+                to_ms(step.start_ns - begin_ns), to_ms(step.end_ns - step.start_ns));
+        }
+        const double first_frame_ms = to_ms(now_ns - begin_ns);
+        if (first_frame_ms > target_ms) {
+            LOG(LogLevel::WARNING, "First frame after {:.2f} ms, over the {:.0f} ms target", first_frame_ms,
+                target_ms);
+        } else {
+            LOG(LogLevel::INFO, "First frame after {:.2f} ms (target {:.0f} ms)", first_frame_ms, target_ms);
+        }
+    }
+} // namespace pyro
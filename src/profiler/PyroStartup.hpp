@@ -0,0 +1,75 @@
+//
+// Created by srijan on 3/7/25.
+//
+
+#ifndef PYROSTARTUP_HPP
+#define PYROSTARTUP_HPP
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "PyroTrace.hpp"
+
+namespace pyro {
+
+    struct StartupStep {
+        // String literal or otherwise static.
+        const char *name;
+        int64_t start_ns;
+        int64_t end_ns;
+        // Order in which threads first recorded a step; 0 is the thread that called begin().
+        uint32_t thread;
+    };
+
+    // Wall-clock breakdown of startup, from begin() to the first presented frame. Steps may be recorded from any
+    // thread, so the log shows which ones overlapped; with PYRO_TRACING they also land in the Chrome trace.
+    class PyroStartup {
+    public:
+        static PyroStartup &get_instance() {
+            static PyroStartup instance;
+            return instance;
+        }
+
+        // Restarts the clock on the calling thread. Without a call, the clock starts at the first step.
+        void begin();
+        void record(const char *name, int64_t start_ns, int64_t end_ns);
+        // Logs every step and the time to first frame against `target_ms`. Only the first call logs.
+        void first_frame(double target_ms);
+
+    private:
+        PyroStartup() = default;
+
+        uint32_t thread_index(std::thread::id id);
+
+        std::mutex mutex;
+        int64_t begin_ns = 0;
+        bool reported = false;
+        std::vector<StartupStep> steps;
+        std::map<std::thread::id, uint32_t> threads;
+    };
+
+    // Records the enclosing scope as one startup step.
+    class StartupScope {
+    public:
+        explicit StartupScope(const char *name) : name(name), start_ns(trace_now_ns()) {}
+        ~StartupScope() {
+            const int64_t end_ns = trace_now_ns();
+            PyroStartup::get_instance().record(name, start_ns, end_ns);
+            if constexpr (PyroTrace::ENABLED) {
+                PyroTrace::get_instance().record_cpu({name, start_ns, end_ns});
+            }
+        }
+        StartupScope(const StartupScope &) = delete;
+        StartupScope &operator=(const StartupScope &) = delete;
+
+    private:
+        const char *name;
+        int64_t start_ns;
+    };
+
+} // namespace pyro
+
+#endif // PYROSTARTUP_HPP
@@ -0,0 +1,84 @@
+//
+// Created by srijan on 3/4/25.
+//
+
+#include "PyroTrace.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+namespace pyro {
+    namespace {
+        // Chrome's trace format wants names as JSON strings; zone names are plain literals, so only quotes and
+        // backslashes need escaping.
+        std::string escape_json(const std::string_view text) {
+            std::string escaped;
+            for (const char c : text) {
+                if (c == '"' || c == '\\') {
+                    escaped += '\\';
+                }
+                escaped += c;
+            }
+            return escaped;
+        }
+    } // namespace
+
+    std::vector<TraceEvent> TraceBuffer::snapshot() const {
+        const uint64_t end = head.load(std::memory_order_acquire);
+        const uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+        std::vector<TraceEvent> copy;
+        copy.reserve(end - begin);
+        for (uint64_t i = begin; i < end; i++) {
+            copy.push_back(events[i % CAPACITY]);
+        }
+        // Slots the writer reached while copying may hold newer events torn against the old ones; drop them.
+        const uint64_t overwritten = head.load(std::memory_order_acquire) - end;
+        copy.erase(copy.begin(), copy.begin() + static_cast<ptrdiff_t>(std::min<uint64_t>(overwritten, copy.size())));
+        return copy;
+    }
+
+    TraceBuffer *PyroTrace::register_thread() {
+        const std::lock_guard lock(mutex);
+        const uint32_t thread_id = static_cast<uint32_t>(buffers.size()) + 1;
+        buffers.push_back(std::make_unique<TraceBuffer>(thread_id, std::format("thread {}", thread_id)));
+        return buffers.back().get();
+    }
+
+    void PyroTrace::set_thread_name(std::string name) {
+        TraceBuffer &buffer = thread_buffer();
+        const std::lock_guard lock(mutex);
+        buffer.set_thread_name(std::move(name));
+    }
+
+    bool PyroTrace::write_chrome_trace(const std::string &path) const {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        const std::lock_guard lock(mutex);
+        std::vector<const TraceBuffer *> tracks{&gpu_buffer};
+        for (const auto &buffer : buffers) {
+            tracks.push_back(buffer.get());
+        }
+
+        // Complete ("X") events with microsecond timestamps, one thread per track.
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        bool first = true;
+        for (const TraceBuffer *track : tracks) {
+            file << std::format(R"({}{{"name": "thread_name", "ph": "M", "pid": 1, "tid": {}, )"
+                                R"("args": {{"name": "{}"}}}})",
+                                first ? "" : ",\n", track->get_thread_id(), escape_json(track->get_thread_name()));
+            first = false;
+            for (const TraceEvent &event : track->snapshot()) {
+                file << std::format(",\n" R"({{"name": "{}", "ph": "X", "pid": 1, "tid": {}, "ts": {:.3f}, )"
+                                    R"("dur": {:.3f}}})",
+                                    escape_json(event.name), track->get_thread_id(),
+                                    static_cast<double>(event.start_ns) / 1000.0,
+                                    static_cast<double>(event.end_ns - event.start_ns) / 1000.0);
+            }
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+} // namespace pyro
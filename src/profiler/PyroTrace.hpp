@@ -0,0 +1,129 @@
+//
+// Created by srijan on 3/4/25.
+//
+
+#ifndef PYROTRACE_HPP
+#define PYROTRACE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pyro {
+
+    // Nanoseconds on the steady_clock timeline, the one every trace zone, CPU or GPU, is placed on.
+    inline int64_t trace_now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+    }
+
+    struct TraceEvent {
+        // String literal or otherwise static; only the pointer is recorded.
+        const char *name;
+        int64_t start_ns;
+        int64_t end_ns;
+    };
+
+    // Fixed ring of one thread's most recent zones. Only the owning thread writes, publishing each event by
+    // bumping `head`; an exporter copies the ring and discards whatever the writer may have overwritten meanwhile.
+    class TraceBuffer {
+    public:
+        static constexpr uint32_t CAPACITY = 1 << 16;
+
+        TraceBuffer(uint32_t thread_id, std::string thread_name) :
+            thread_id(thread_id), thread_name(std::move(thread_name)) {}
+
+        void record(const TraceEvent &event) {
+            const uint64_t index = head.load(std::memory_order_relaxed);
+            events[index % CAPACITY] = event;
+            head.store(index + 1, std::memory_order_release);
+        }
+        // Events still in the ring, oldest first.
+        std::vector<TraceEvent> snapshot() const;
+
+        uint32_t get_thread_id() const { return thread_id; }
+        const std::string &get_thread_name() const { return thread_name; }
+        void set_thread_name(std::string name) { thread_name = std::move(name); }
+
+    private:
+        std::array<TraceEvent, CAPACITY> events{};
+        std::atomic<uint64_t> head{0};
+        uint32_t thread_id;
+        std::string thread_name;
+    };
+
+    // Process-wide CPU and GPU zone recorder. Each thread records into its own TraceBuffer, registered on its
+    // first zone, so recording never takes a lock; GPU zones come from PyroGpuTimer scopes already mapped onto
+    // the CPU timeline and go to a track of their own. write_chrome_trace() exports every ring as Chrome
+    // trace-event JSON, which chrome://tracing and ui.perfetto.dev both load.
+    //
+    // Zones are compiled in with PYRO_TRACING; without it PYRO_ZONE expands to nothing.
+    class PyroTrace {
+    public:
+#ifdef PYRO_TRACING
+        static constexpr bool ENABLED = true;
+#else
+        static constexpr bool ENABLED = false;
+#endif
+
+        static PyroTrace &get_instance() {
+            static PyroTrace instance;
+            return instance;
+        }
+
+        // Names the calling thread's track in exported traces.
+        void set_thread_name(std::string name);
+        void record_cpu(const TraceEvent &event) { thread_buffer().record(event); }
+        // Render thread only.
+        void record_gpu(const TraceEvent &event) { gpu_buffer.record(event); }
+
+        // Returns false when the file can't be written.
+        bool write_chrome_trace(const std::string &path) const;
+
+    private:
+        PyroTrace() : gpu_buffer(GPU_THREAD_ID, "GPU") {}
+
+        static constexpr uint32_t GPU_THREAD_ID = 0;
+
+        TraceBuffer &thread_buffer() {
+            thread_local TraceBuffer *buffer = register_thread();
+            return *buffer;
+        }
+        TraceBuffer *register_thread();
+
+        // Guards registration, naming and export, never recording.
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<TraceBuffer>> buffers;
+        TraceBuffer gpu_buffer;
+    };
+
+    // Records the enclosing scope as one complete event.
+    class TraceZone {
+    public:
+        explicit TraceZone(const char *name) : name(name), start_ns(trace_now_ns()) {}
+        ~TraceZone() { PyroTrace::get_instance().record_cpu({name, start_ns, trace_now_ns()}); }
+        TraceZone(const TraceZone &) = delete;
+        TraceZone &operator=(const TraceZone &) = delete;
+
+    private:
+        const char *name;
+        int64_t start_ns;
+    };
+
+} // namespace pyro
+
+#define PYRO_TRACE_CONCAT_INNER(a, b) a##b
+#define PYRO_TRACE_CONCAT(a, b) PYRO_TRACE_CONCAT_INNER(a, b)
+#ifdef PYRO_TRACING
+#define PYRO_ZONE(name) const pyro::TraceZone PYRO_TRACE_CONCAT(pyro_zone_, __LINE__)(name)
+#else
+#define PYRO_ZONE(name)
+#endif
+
+#endif // PYROTRACE_HPP
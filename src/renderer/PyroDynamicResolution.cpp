@@ -0,0 +1,166 @@
+//
+// Created by srijan on 3/9/25.
+//
+
+#include "PyroDynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t TILE_SIZE = 8;
+        // Aim a little under the budget so noise doesn't push frames over it.
+        constexpr double BUDGET_HEADROOM = 0.9;
+        // Weight of the newest sample in the smoothed GPU time.
+        constexpr double TIME_SMOOTHING = 0.2;
+        // Fraction of the way to the ideal scale moved per frame.
+        constexpr double SCALE_RESPONSE = 0.25;
+        // Scales are multiples of 1/SCALE_STEPS, and a change smaller than one step is ignored.
+        constexpr double SCALE_STEPS = 64.0;
+
+        // Specialization constants of upscale.comp, in key order.
+        enum UpscaleFeature : size_t { FEATURE_SHARPEN };
+
+        ShaderPermutationSpace upscale_features() { return ShaderPermutationSpace({{"SHARPEN", 0, 1}}); }
+    } // namespace
+
+    bool PyroDynamicResolution::is_supported(const VulkanDevice *device) {
+        return device->get_swap_chain_usage() & VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+
+    PyroDynamicResolution::PyroDynamicResolution(VulkanDevice *device, PyroDescriptors *descriptors,
+                                                 DynamicResolutionConfig config) :
+        device(device), descriptors(descriptors), config(config), enabled(config.enabled && is_supported(device)) {
+        this->config.max_scale = std::clamp(config.max_scale, 0.0f, 1.0f);
+        this->config.min_scale = std::clamp(config.min_scale, 0.0f, this->config.max_scale);
+        scale = this->config.max_scale;
+        if (config.enabled && !enabled) {
+            LOG(LogLevel::WARNING, "Swap chain can't be blitted to, dynamic resolution disabled");
+        }
+        if (!enabled) {
+            return;
+        }
+
+        VkSamplerCreateInfo sampler_info{};
+        sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.magFilter = VK_FILTER_LINEAR;
+        sampler_info.minFilter = VK_FILTER_LINEAR;
+        sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        ASSERT_EQUAL(vkCreateSampler(device->get_logical_device(), &sampler_info, nullptr, &sampler), VK_SUCCESS,
+                     "Failed to create upscale sampler")
+        // Layout and push-constant range are reflected from the shader; both filters are one SPIR-V module,
+        // specialized per variant, and both variants are built now so switching filters never stalls a frame.
+        program = std::make_unique<PyroShaderProgram>(descriptors, std::vector<std::string>{"upscale.comp"});
+        ASSERT_EQUAL(program->get_reflection().push_constant_size, sizeof(Params), "upscale.comp Params mismatch")
+        ShaderPermutationSpace features = upscale_features();
+        ASSERT_EQUAL(features.matches(program->get_reflection()), true, "upscale.comp lacks its features")
+        pipelines = std::make_unique<PyroPipelineVariants<PyroComputePipeline>>(
+                device, std::move(features),
+                [this](const VkSpecializationInfo *specialization, const VkPipelineCache pipeline_cache) {
+                    return std::make_unique<PyroComputePipeline>(this->device, *program, specialization,
+                                                                 pipeline_cache);
+                });
+        const ShaderPermutationSpace &space = pipelines->get_space();
+        pipelines->precompile({space.set(0, FEATURE_SHARPEN, 0), space.set(0, FEATURE_SHARPEN, 1)});
+        set_filter(this->config.filter);
+
+        if (PyroGpuTimer::is_supported(device)) {
+            for (auto &timer : timers) {
+                timer = std::make_unique<PyroGpuTimer>(device, 1);
+            }
+        } else {
+            LOG(LogLevel::WARNING, "Timestamp queries unsupported, dynamic resolution fixed at scale {}", scale);
+        }
+    }
+
+    PyroDynamicResolution::~PyroDynamicResolution() {
+        if (sampler != VK_NULL_HANDLE) {
+            vkDestroySampler(device->get_logical_device(), sampler, nullptr);
+        }
+    }
+
+    void PyroDynamicResolution::set_filter(const UpscaleFilter filter) {
+        config.filter = filter;
+        if (pipelines) {
+            const bool sharpen = filter == UpscaleFilter::SHARPENED && config.sharpness > 0.0f;
+            pipeline = &pipelines->get(pipelines->get_space().set(0, FEATURE_SHARPEN, sharpen));
+        }
+    }
+
+    VkExtent2D PyroDynamicResolution::get_render_extent() const {
+        const VkExtent2D output = device->get_swap_chain_extent();
+        return {std::max(static_cast<uint32_t>(std::lround(output.width * scale)), 1u),
+                std::max(static_cast<uint32_t>(std::lround(output.height * scale)), 1u)};
+    }
+
+    void PyroDynamicResolution::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        if (!timers[frame_index] || !timed[frame_index]) {
+            return;
+        }
+        const std::optional<double> frame_ms = timers[frame_index]->resolve(scopes[frame_index]);
+        if (!frame_ms || *frame_ms <= 0.0) {
+            return;
+        }
+        gpu_frame_ms = gpu_frame_ms == 0.0 ? *frame_ms : gpu_frame_ms + (*frame_ms - gpu_frame_ms) * TIME_SMOOTHING;
+
+        const double ideal = scale * std::sqrt(config.frame_budget_ms * BUDGET_HEADROOM / gpu_frame_ms);
+        double next = scale + (ideal - scale) * SCALE_RESPONSE;
+        next = std::clamp(std::round(next * SCALE_STEPS) / SCALE_STEPS, static_cast<double>(config.min_scale),
+                          static_cast<double>(config.max_scale));
+        if (std::abs(next - scale) >= 1.0 / SCALE_STEPS || next == config.min_scale || next == config.max_scale) {
+            scale = static_cast<float>(next);
+        }
+    }
+
+    void PyroDynamicResolution::begin_timing(const VkCommandBuffer command_buffer) {
+        if (!timers[frame_index]) {
+            return;
+        }
+        timers[frame_index]->reset(command_buffer);
+        scopes[frame_index] = timers[frame_index]->begin(command_buffer);
+        timed[frame_index] = true;
+    }
+
+    void PyroDynamicResolution::end_timing(const VkCommandBuffer command_buffer) const {
+        if (timers[frame_index]) {
+            timers[frame_index]->end(command_buffer, scopes[frame_index]);
+        }
+    }
+
+    void PyroDynamicResolution::record_upscale(const VkCommandBuffer command_buffer, const VkImageView source,
+                                               const VkExtent2D source_extent, const VkImageView target,
+                                               const VkExtent2D target_extent) const {
+        const VkExtent2D render = get_render_extent();
+        const float source_width = static_cast<float>(source_extent.width);
+        const float source_height = static_cast<float>(source_extent.height);
+        Params params{};
+        params.uv_scale[0] = static_cast<float>(render.width) / (source_width * target_extent.width);
+        params.uv_scale[1] = static_cast<float>(render.height) / (source_height * target_extent.height);
+        // Half a texel inside the rendered corner, so filtering never picks up stale texels beyond it.
+        params.uv_max[0] = (static_cast<float>(render.width) - 0.5f) / source_width;
+        params.uv_max[1] = (static_cast<float>(render.height) - 0.5f) / source_height;
+        params.texel_size[0] = 1.0f / source_width;
+        params.texel_size[1] = 1.0f / source_height;
+        params.target_size[0] = static_cast<int32_t>(target_extent.width);
+        params.target_size[1] = static_cast<int32_t>(target_extent.height);
+        params.sharpness = config.filter == UpscaleFilter::SHARPENED ? std::clamp(config.sharpness, 0.0f, 1.0f) : 0.0f;
+
+        PyroDescriptorBindings bindings;
+        bindings.bind_image(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT, source, sampler,
+                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+                .bind_image(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, target, VK_NULL_HANDLE,
+                            VK_IMAGE_LAYOUT_GENERAL);
+        pipeline->bind(command_buffer);
+        pipeline->bind_set(command_buffer, 0, descriptors->allocate_transient(bindings));
+        pipeline->push_constants(command_buffer, &params, sizeof(params));
+        PyroComputePipeline::dispatch(command_buffer, PyroComputePipeline::group_count(target_extent.width, TILE_SIZE),
+                                      PyroComputePipeline::group_count(target_extent.height, TILE_SIZE));
+    }
+} // namespace pyro
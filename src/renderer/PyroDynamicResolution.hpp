@@ -0,0 +1,112 @@
+//
+// Created by srijan on 3/9/25.
+//
+
+#ifndef PYRODYNAMICRESOLUTION_HPP
+#define PYRODYNAMICRESOLUTION_HPP
+
+#include <array>
+#include <memory>
+#include <vulkan/vulkan.h>
+
+#include "../compute/PyroComputePipeline.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "../profiler/PyroGpuTimer.hpp"
+#include "../shader/PyroShaderProgram.hpp"
+#include "PyroPipelineVariants.hpp"
+
+namespace pyro {
+
+    enum class UpscaleFilter {
+        BILINEAR,
+        // Bilinear followed by contrast-adaptive sharpening, as in FSR1's RCAS.
+        SHARPENED,
+    };
+
+    struct DynamicResolutionConfig {
+        bool enabled = false;
+        // GPU time per frame the controller steers towards.
+        double frame_budget_ms = 1000.0 / 60.0;
+        float min_scale = 0.5f;
+        // Capped at 1: the scene target is allocated at the swap chain extent.
+        float max_scale = 1.0f;
+        UpscaleFilter filter = UpscaleFilter::SHARPENED;
+        // 0 to 1, for SHARPENED.
+        float sharpness = 0.5f;
+    };
+
+    // Dynamic resolution. The scene is rendered into the top-left corner of a swap-chain-sized SCENE_FORMAT target,
+    // and record_upscale() stretches that corner over the full output with a compute pass
+    // (assets/shaders/upscale.comp). Only the render area changes from frame to frame, so the render graph's
+    // transient placement stays put. The corner's size follows a controller fed by each frame's GPU time: cost
+    // goes roughly with pixel count, so the scale moves by the square root of budget over measured time, damped
+    // and quantised so the resolution doesn't flicker.
+    //
+    // Without timestamp queries the scale stays at max_scale.
+    class PyroDynamicResolution {
+    public:
+        static constexpr VkFormat SCENE_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+        // The upscaled image reaches the swap chain by blit, which needs VK_IMAGE_USAGE_TRANSFER_DST_BIT on it.
+        static bool is_supported(const VulkanDevice *device);
+
+        PyroDynamicResolution(VulkanDevice *device, PyroDescriptors *descriptors, DynamicResolutionConfig config);
+        ~PyroDynamicResolution();
+        PyroDynamicResolution(const PyroDynamicResolution &) = delete;
+        PyroDynamicResolution &operator=(const PyroDynamicResolution &) = delete;
+
+        // False when disabled in the config or unsupported; the scene then renders straight to the swap chain.
+        bool is_enabled() const { return enabled; }
+        // Format scene pipelines must target; UNDEFINED (the swap chain format) when disabled.
+        VkFormat get_scene_format() const { return enabled ? SCENE_FORMAT : VK_FORMAT_UNDEFINED; }
+
+        // Feeds the GPU time of the frame last recorded in `frame_index`, whose fence must have signalled, to
+        // the controller.
+        void begin_frame(uint32_t frame_index);
+        // Bracket the whole command buffer; begin_timing() must come before any render pass.
+        void begin_timing(VkCommandBuffer command_buffer);
+        void end_timing(VkCommandBuffer command_buffer) const;
+
+        // Switches between the precompiled upscale variants; safe while frames are in flight.
+        void set_filter(UpscaleFilter filter);
+        UpscaleFilter get_filter() const { return config.filter; }
+        float get_scale() const { return scale; }
+        // Smoothed GPU frame time the current scale was chosen from; 0 until the first measurement.
+        double get_gpu_frame_ms() const { return gpu_frame_ms; }
+        // The part of the scene target to render this frame.
+        VkExtent2D get_render_extent() const;
+
+        // Upscales the render-extent corner of `source` (SHADER_READ_ONLY_OPTIMAL) over all of `target` (GENERAL,
+        // SCENE_FORMAT).
+        void record_upscale(VkCommandBuffer command_buffer, VkImageView source, VkExtent2D source_extent,
+                            VkImageView target, VkExtent2D target_extent) const;
+
+    private:
+        struct Params {
+            float uv_scale[2];
+            float uv_max[2];
+            float texel_size[2];
+            int32_t target_size[2];
+            float sharpness;
+        };
+
+        VulkanDevice *device;
+        PyroDescriptors *descriptors;
+        DynamicResolutionConfig config;
+        bool enabled;
+        std::unique_ptr<PyroShaderProgram> program;
+        std::unique_ptr<PyroPipelineVariants<PyroComputePipeline>> pipelines;
+        // The variant for config.filter.
+        PyroComputePipeline *pipeline = nullptr;
+        VkSampler sampler = VK_NULL_HANDLE;
+        std::array<std::unique_ptr<PyroGpuTimer>, MAX_FRAMES_IN_FLIGHT> timers;
+        std::array<bool, MAX_FRAMES_IN_FLIGHT> timed{};
+        std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> scopes{};
+        uint32_t frame_index = 0;
+        float scale;
+        double gpu_frame_ms = 0.0;
+    };
+
+} // namespace pyro
+
+#endif // PYRODYNAMICRESOLUTION_HPP
@@ -0,0 +1,86 @@
+//
+// Created by srijan on 3/6/25.
+//
+
+#include "PyroFramePacer.hpp"
+
+#include <SDL3/SDL.h>
+
+#include "../profiler/PyroTrace.hpp"
+
+namespace pyro {
+    namespace {
+        // Bounds a low-latency wait so a present that never completes (e.g. a minimised window) can't hang the
+        // render loop.
+        constexpr uint64_t PRESENT_WAIT_TIMEOUT_NS = 100'000'000;
+        // Presents that were never observed completing are dropped beyond this many.
+        constexpr size_t MAX_PENDING_PRESENTS = 16;
+
+        double elapsed_ms(const uint64_t from_ns, const uint64_t to_ns) {
+            return to_ns > from_ns ? static_cast<double>(to_ns - from_ns) / 1e6 : 0.0;
+        }
+    } // namespace
+
+    PyroFramePacer::PyroFramePacer(const VulkanDevice *device) :
+        device(device), low_latency(device->get_present_config().low_latency),
+        present_wait(device->get_capabilities().present_wait) {
+        latency.present_completion = present_wait;
+    }
+
+    void PyroFramePacer::wait_before_input(const uint32_t frame_index) {
+        PYRO_ZONE("pace_frame");
+        const uint64_t start_ns = SDL_GetTicksNS();
+        if (present_wait) {
+            if (low_latency && !pending.empty()) {
+                collect(pending.back().present_id, PRESENT_WAIT_TIMEOUT_NS);
+            }
+            // Otherwise completions are only polled, so their latency is late by up to the polling interval.
+            while (!pending.empty() && collect(pending.front().present_id, 0)) {
+            }
+        } else if (low_latency) {
+            const uint32_t previous_frame = (frame_index + MAX_FRAMES_IN_FLIGHT - 1) % MAX_FRAMES_IN_FLIGHT;
+            vkWaitForFences(device->get_logical_device(), 1, device->get_inflight_fence(previous_frame), VK_TRUE,
+                            PRESENT_WAIT_TIMEOUT_NS);
+        }
+        latency.pacing_wait_ms = elapsed_ms(start_ns, SDL_GetTicksNS());
+    }
+
+    void PyroFramePacer::mark_input(const uint64_t input_ns) { frame_input_ns = input_ns; }
+
+    void PyroFramePacer::prepare_present(VkPresentInfoKHR &present_info) {
+        if (!present_wait) {
+            return;
+        }
+        present_id_info = {};
+        present_id_info.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        present_id_info.pNext = present_info.pNext;
+        present_id_info.swapchainCount = 1;
+        present_id_info.pPresentIds = &next_present_id;
+        present_info.pNext = &present_id_info;
+    }
+
+    void PyroFramePacer::presented() {
+        if (!present_wait) {
+            latency.input_to_present_ms = elapsed_ms(frame_input_ns, SDL_GetTicksNS());
+            return;
+        }
+        if (pending.size() == MAX_PENDING_PRESENTS) {
+            pending.pop_front();
+        }
+        pending.push_back({next_present_id, frame_input_ns});
+        next_present_id++;
+    }
+
+    bool PyroFramePacer::collect(const uint64_t present_id, const uint64_t timeout_ns) {
+        if (device->wait_for_present(present_id, timeout_ns) != VK_SUCCESS) {
+            return false;
+        }
+        // Waiting on an id also covers every earlier one.
+        const uint64_t now_ns = SDL_GetTicksNS();
+        while (!pending.empty() && pending.front().present_id <= present_id) {
+            latency.input_to_present_ms = elapsed_ms(pending.front().input_ns, now_ns);
+            pending.pop_front();
+        }
+        return true;
+    }
+} // namespace pyro
@@ -0,0 +1,65 @@
+//
+// Created by srijan on 3/6/25.
+//
+
+#ifndef PYROFRAMEPACER_HPP
+#define PYROFRAMEPACER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+
+namespace pyro {
+    // Input-to-present latency of the most recently completed frame and how long pacing blocked for it.
+    struct FrameLatency {
+        double input_to_present_ms = 0.0;
+        double pacing_wait_ms = 0.0;
+        // False when the device lacks present wait and input_to_present_ms only runs to vkQueuePresentKHR.
+        bool present_completion = false;
+    };
+
+    // Tags presents with VK_KHR_present_id and measures, per frame, the time from the input it consumed to the
+    // present completing (VK_KHR_present_wait). With PresentConfig::low_latency, wait_before_input() also blocks
+    // until the previous frame is on screen, so input is sampled as late as possible and frames don't queue up
+    // behind the display. Without present wait it falls back to waiting on the previous frame's fence, and
+    // latency is measured up to the present call.
+    //
+    // Per frame: wait_before_input(), sample input, mark_input(), record and submit, then prepare_present() on
+    // the VkPresentInfoKHR and presented() after vkQueuePresentKHR.
+    class PyroFramePacer {
+    public:
+        explicit PyroFramePacer(const VulkanDevice *device);
+
+        void wait_before_input(uint32_t frame_index);
+        // `input_ns` on the SDL_GetTicksNS() timeline: the oldest input event the frame consumes.
+        void mark_input(uint64_t input_ns);
+        // Chains the frame's present id into `present_info`; a no-op without present wait.
+        void prepare_present(VkPresentInfoKHR &present_info);
+        void presented();
+
+        const FrameLatency &get_latency() const { return latency; }
+
+    private:
+        struct PendingPresent {
+            uint64_t present_id;
+            uint64_t input_ns;
+        };
+
+        const VulkanDevice *device;
+        bool low_latency;
+        bool present_wait;
+        uint64_t next_present_id = 1;
+        uint64_t frame_input_ns = 0;
+        VkPresentIdKHR present_id_info{};
+        // Presents not yet seen completing, oldest first.
+        std::deque<PendingPresent> pending;
+        FrameLatency latency;
+
+        // Retires every pending present up to `present_id`, waiting at most `timeout_ns` for it; false on timeout.
+        bool collect(uint64_t present_id, uint64_t timeout_ns);
+    };
+} // namespace pyro
+
+#endif // PYROFRAMEPACER_HPP
@@ -0,0 +1,113 @@
+//
+// Created by srijan on 3/11/25.
+//
+
+#ifndef PYROPIPELINEVARIANTS_HPP
+#define PYROPIPELINEVARIANTS_HPP
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+#include "../shader/PyroShaderPermutations.hpp"
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+
+    // Pipelines specialized from one shader program, one per ShaderVariantKey: asking for a key again returns the
+    // same pipeline, and all variants go through one VkPipelineCache so the driver can share work between them.
+    // precompile() builds the hot set at load time; a variant first asked for later still works, but stalls the
+    // caller on a pipeline compile, so it is counted and logged. `Pipeline` is Pyropipeline or PyroComputePipeline,
+    // built by the factory from the specialization and cache it is handed.
+    template<typename Pipeline>
+    class PyroPipelineVariants {
+    public:
+        using Factory = std::function<std::unique_ptr<Pipeline>(const VkSpecializationInfo *specialization,
+                                                                VkPipelineCache pipeline_cache)>;
+
+        PyroPipelineVariants(VulkanDevice *device, ShaderPermutationSpace space, Factory factory) :
+            device(device), space(std::move(space)), factory(std::move(factory)) {
+            VkPipelineCacheCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            ASSERT_EQUAL(vkCreatePipelineCache(device->get_logical_device(), &info, nullptr, &pipeline_cache),
+                         VK_SUCCESS, "Failed to create pipeline cache")
+        }
+
+        ~PyroPipelineVariants() {
+            variants.clear();
+            vkDestroyPipelineCache(device->get_logical_device(), pipeline_cache, nullptr);
+        }
+
+        PyroPipelineVariants(const PyroPipelineVariants &) = delete;
+        PyroPipelineVariants &operator=(const PyroPipelineVariants &) = delete;
+
+        // Creates the missing variants among `keys` in parallel, one thread each; hot sets are expected to be small.
+        void precompile(const std::vector<ShaderVariantKey> &keys) {
+            std::lock_guard lock(mutex);
+            std::vector<std::pair<ShaderVariantKey, std::future<std::unique_ptr<Pipeline>>>> jobs;
+            for (const ShaderVariantKey key: keys) {
+                const bool queued = std::ranges::any_of(jobs, [&](const auto &job) { return job.first == key; });
+                if (!variants.contains(key) && !queued) {
+                    jobs.emplace_back(key, std::async(std::launch::async, [this, key] { return create(key); }));
+                }
+            }
+            for (auto &[key, job]: jobs) {
+                variants.emplace(key, job.get());
+            }
+            precompiled = true;
+            LOG(LogLevel::INFO, "Precompiled {} pipeline variants ({} total)", jobs.size(), variants.size());
+        }
+
+        Pipeline &get(const ShaderVariantKey key) {
+            std::lock_guard lock(mutex);
+            if (const auto it = variants.find(key); it != variants.end()) {
+                return *it->second;
+            }
+            if (precompiled) {
+                late_variants++;
+                LOG(LogLevel::WARNING, "Pipeline variant [{}] wasn't precompiled", space.describe(key));
+            }
+            return *variants.emplace(key, create(key)).first->second;
+        }
+
+        const ShaderPermutationSpace &get_space() const { return space; }
+        size_t size() {
+            std::lock_guard lock(mutex);
+            return variants.size();
+        }
+        // Variants created after precompile() had run.
+        uint32_t get_late_variants() {
+            std::lock_guard lock(mutex);
+            return late_variants;
+        }
+
+    private:
+        VulkanDevice *device;
+        ShaderPermutationSpace space;
+        Factory factory;
+        VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+        std::mutex mutex;
+        std::unordered_map<ShaderVariantKey, std::unique_ptr<Pipeline>> variants;
+        bool precompiled = false;
+        uint32_t late_variants = 0;
+
+        // Touches neither `variants` nor the counters, so precompile() can run it on several threads at once;
+        // vkCreate*Pipelines synchronizes the pipeline cache internally.
+        std::unique_ptr<Pipeline> create(const ShaderVariantKey key) const {
+            ASSERT_EQUAL(space.get_key_bits() >= 32 || key < (1u << space.get_key_bits()), true,
+                         "Variant key {:#x} has bits outside the permutation space", key)
+            const ShaderSpecialization specialization = space.specialize(key);
+            const VkSpecializationInfo info = specialization.get_info();
+            return factory(&info, pipeline_cache);
+        }
+    };
+
+} // namespace pyro
+
+#endif // PYROPIPELINEVARIANTS_HPP
@@ -4,51 +4,219 @@
 
 #include "PyroRender.hpp"
 
+#include <format>
+#include <thread>
+
 #include "../core/VulkanDevice.hpp"
 #include "../core/VulkanInstance.hpp"
+#include "../profiler/PyroCounters.hpp"
+#include "../profiler/PyroStartup.hpp"
+#include "../profiler/PyroTrace.hpp"
 #include "../utils/Logger.hpp"
 #include "../window/PyroWindow.hpp"
 #include "Pyropipeline.hpp"
 
 namespace pyro {
 
-    PyroRender::PyroRender() :
-        window(600, 500, "PyroCore", WindowOptions::WINDOW_NOT_RESIZABLE), instance(&window),
-        device(&instance, &window), pyroPipeline(&device) {}
+    namespace {
+        constexpr double OVERLAY_REFRESH_MS = 500.0;
+        constexpr float OVERLAY_TEXT_SIZE = 16.0f;
+        constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+        // Written on exit with PYRO_TRACING; holds the last TraceBuffer::CAPACITY zones of every thread.
+        constexpr const char *TRACE_PATH = "pyro_trace.json";
+        // Startup budget from PyroStartup::begin() to the first present; overshooting it logs a warning.
+        constexpr double FIRST_FRAME_TARGET_MS = 250.0;
+        // Upper bound on how long the input thread sleeps in SDL between samples.
+        constexpr int32_t INPUT_PERIOD_MS = 1;
+        constexpr const char *SCREENSHOT_PREFIX = "captures/screenshot_";
+
+        // `color_format` UNDEFINED renders to the swap chain format.
+        PipelineAttachmentFormats main_pass_formats(const VkFormat color_format, const VkSampleCountFlagBits samples) {
+            PipelineAttachmentFormats formats;
+            if (color_format != VK_FORMAT_UNDEFINED) {
+                formats.color_formats.push_back(color_format);
+            }
+            formats.depth_format = DEPTH_FORMAT;
+            formats.samples = samples;
+            return formats;
+        }
+
+        GraphicsPipelineDesc main_pipeline_desc(const PipelineAttachmentFormats &formats) {
+            GraphicsPipelineDesc desc{};
+            desc.formats = formats;
+            return desc;
+        }
+
+        TextRendererConfig overlay_text_config(const PipelineAttachmentFormats &formats) {
+            TextRendererConfig config{};
+            config.formats = formats;
+            return config;
+        }
+    } // namespace
+
+    PyroRender::PyroRender(const PresentConfig &present_config, const DynamicResolutionConfig &resolution_config,
+                           const uint32_t msaa_samples) :
+        window(600, 500, "PyroCore", WindowOptions::WINDOW_NOT_RESIZABLE),
+        device(&instance, &window, 0, present_config), descriptors(&device), uniforms(&device, &descriptors),
+        dynamic_resolution(&device, &descriptors, resolution_config),
+        main_pipeline_job(std::async(std::launch::async,
+                                     [this, layout = uniforms.get_layout(),
+                                      formats = main_pass_formats(dynamic_resolution.get_scene_format(),
+                                                                  device.choose_sample_count(msaa_samples))] {
+                                         StartupScope scope("main_pipeline");
+                                         return std::make_unique<Pyropipeline>(
+                                                 &device, std::vector{layout},
+                                                 std::vector{PyroUniformRing::push_constant_range(
+                                                         VK_SHADER_STAGE_VERTEX_BIT, sizeof(DrawPushConstants))},
+                                                 main_pipeline_desc(formats));
+                                     })),
+        textures(&device, &descriptors), graph(&device),
+        text(&device, &descriptors,
+             overlay_text_config(main_pass_formats(dynamic_resolution.get_scene_format(),
+                                                   device.choose_sample_count(msaa_samples)))),
+        msaa_samples(device.choose_sample_count(msaa_samples)), pacer(&device),
+        capture(&device, device.get_swap_chain_extent()) {
+        {
+            StartupScope scope("wait_main_pipeline");
+            pyroPipeline = main_pipeline_job.get();
+        }
+        if (this->msaa_samples != VK_SAMPLE_COUNT_1_BIT) {
+            LOG(LogLevel::INFO, "MSAA {}x", static_cast<uint32_t>(this->msaa_samples));
+        }
+        if constexpr (PyroTrace::ENABLED) {
+            for (auto &timer : gpu_timers) {
+                timer = std::make_unique<PyroGpuTimer>(&device);
+            }
+        }
+    }
+
+    void PyroRender::run(const bool threaded_input) {
+        if (threaded_input) {
+            // SDL only pumps events on the thread that created the window, so that thread stays behind for input.
+            std::thread render_thread(&PyroRender::render_loop, this, false);
+            window.get_events().run_input_loop(INPUT_PERIOD_MS);
+            render_thread.join();
+        } else {
+            render_loop(true);
+        }
+        if constexpr (PyroTrace::ENABLED) {
+            if (PyroTrace::get_instance().write_chrome_trace(TRACE_PATH)) {
+                LOG(LogLevel::INFO, "Trace written to {}", TRACE_PATH);
+            } else {
+                LOG(LogLevel::WARNING, "Failed to write trace to {}", TRACE_PATH);
+            }
+        }
+    }
 
-    void PyroRender::run() {
+    void PyroRender::render_loop(const bool pump_events) {
+        PyroTrace::get_instance().set_thread_name("render");
         while (!window.should_close()) {
-            window.poll_events();
+            pacer.wait_before_input(current_frame);
+            if (pump_events) {
+                window.poll_events();
+            }
+            process_input();
             draw_frame();
         }
         vkDeviceWaitIdle(device.get_logical_device());
     }
+
+    void PyroRender::process_input() {
+        PYRO_ZONE("process_input");
+        PyroEvents &events = window.get_events();
+        const uint64_t sample_ns = SDL_GetTicksNS();
+        InputEvent event;
+        uint32_t count = 0;
+        double latency_ms = 0.0;
+        uint64_t input_ns = sample_ns;
+        while (events.poll(event)) {
+            count++;
+            // Age of the oldest event this frame consumed: how long input waited on the render loop.
+            if (count == 1) {
+                latency_ms = static_cast<double>(sample_ns - event.timestamp_ns) / 1e6;
+                input_ns = event.timestamp_ns;
+            }
+            if (event.type == InputEventType::KEY_DOWN && !event.repeat) {
+                if (event.key == KeyCode::F12) {
+                    capture.request_screenshot(std::format("{}{:06}", SCREENSHOT_PREFIX, frame_count));
+                } else if (event.key == KeyCode::F11) {
+                    capture.set_dump_every_frame(!capture.is_dumping_every_frame());
+                } else if (event.key == KeyCode::F10 && dynamic_resolution.is_enabled()) {
+                    dynamic_resolution.set_filter(dynamic_resolution.get_filter() == UpscaleFilter::SHARPENED
+                                                          ? UpscaleFilter::BILINEAR
+                                                          : UpscaleFilter::SHARPENED);
+                }
+            }
+        }
+        pacer.mark_input(input_ns);
+        PyroCounters &counters = PyroCounters::get_instance();
+        counters.set("input.events", count);
+        counters.set("input.latency_ms", latency_ms);
+        counters.set("input.dropped", static_cast<double>(events.get_dropped_events()));
+        const FrameCaptureStats capture_stats = capture.get_stats();
+        counters.set("capture.written", static_cast<double>(capture_stats.written));
+        counters.set("capture.dropped", static_cast<double>(capture_stats.dropped));
+        counters.set("capture.busy_buffers", capture_stats.busy_buffers);
+    }
+
     void PyroRender::draw_frame() {
-        vkWaitForFences(device.get_logical_device(), 1, device.get_inflight_fence(), VK_TRUE, UINT64_MAX);
-        vkResetFences(device.get_logical_device(), 1, device.get_inflight_fence());
+        PYRO_ZONE("frame");
+        {
+            PYRO_ZONE("wait_fence");
+            vkWaitForFences(device.get_logical_device(), 1, device.get_inflight_fence(current_frame), VK_TRUE,
+                            UINT64_MAX);
+        }
+        vkResetFences(device.get_logical_device(), 1, device.get_inflight_fence(current_frame));
+        collect_gpu_zones();
+        descriptors.begin_frame(current_frame);
+        uniforms.begin_frame(current_frame);
+        textures.begin_frame(current_frame);
+        text.begin_frame(current_frame);
+        capture.begin_frame(current_frame);
+        dynamic_resolution.begin_frame(current_frame);
+        if (dynamic_resolution.is_enabled()) {
+            const VkExtent2D render_extent = dynamic_resolution.get_render_extent();
+            PyroCounters &counters = PyroCounters::get_instance();
+            counters.set("resolution.scale", dynamic_resolution.get_scale());
+            counters.set("resolution.gpu_frame_ms", dynamic_resolution.get_gpu_frame_ms());
+            counters.set("resolution.width", render_extent.width);
+            counters.set("resolution.height", render_extent.height);
+        }
+        update_overlay();
         uint32_t image_index;
-        ASSERT_EQUAL(vkAcquireNextImageKHR(device.get_logical_device(), device.get_swap_chain(), UINT64_MAX,
-                                           device.get_image_available_semaphore(), VK_NULL_HANDLE, &image_index),
-                     VK_SUCCESS, "Failed to Acquire next image")
-        vkResetCommandBuffer(*device.get_command_buffer(), 0);
-        device.record_command_buffer(*device.get_command_buffer(), image_index, pyroPipeline.get_render_pass(),
-                                     pyroPipeline.get_pipeline(), pyroPipeline.get_swap_chain_framebuffers());
+        {
+            PYRO_ZONE("acquire");
+            ASSERT_EQUAL(vkAcquireNextImageKHR(device.get_logical_device(), device.get_swap_chain(), UINT64_MAX,
+                                               device.get_image_available_semaphore(current_frame), VK_NULL_HANDLE,
+                                               &image_index),
+                         VK_SUCCESS, "Failed to Acquire next image")
+        }
+        {
+            PYRO_ZONE("record");
+            vkResetCommandBuffer(*device.get_command_buffer(current_frame), 0);
+            record_command_buffer(*device.get_command_buffer(current_frame), image_index);
+        }
+        uniforms.end_frame();
         VkSubmitInfo submit_info = {};
         submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        VkSemaphore wait_semaphores[] = {device.get_image_available_semaphore()};
+        VkSemaphore wait_semaphores[] = {device.get_image_available_semaphore(current_frame)};
         VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
         submit_info.waitSemaphoreCount = 1;
         submit_info.pWaitSemaphores = wait_semaphores;
         submit_info.pWaitDstStageMask = wait_stages;
         submit_info.commandBufferCount = 1;
-        submit_info.pCommandBuffers = device.get_command_buffer();
+        submit_info.pCommandBuffers = device.get_command_buffer(current_frame);
 
-        VkSemaphore signal_semaphores[] = {device.get_render_finished_semaphore()};
+        VkSemaphore signal_semaphores[] = {device.get_render_finished_semaphore(current_frame)};
         submit_info.signalSemaphoreCount = 1;
         submit_info.pSignalSemaphores = signal_semaphores;
 
-        ASSERT_EQUAL(vkQueueSubmit(device.get_graphics_queue(), 1, &submit_info, *(device.get_inflight_fence())),
-                     VK_SUCCESS, "Failed to submit command buffer")
+        {
+            PYRO_ZONE("submit");
+            ASSERT_EQUAL(vkQueueSubmit(device.get_graphics_queue(), 1, &submit_info,
+                                       *device.get_inflight_fence(current_frame)),
+                         VK_SUCCESS, "Failed to submit command buffer")
+        }
         VkPresentInfoKHR present_info = {};
         present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
         present_info.waitSemaphoreCount = 1;
@@ -59,6 +227,242 @@ namespace pyro {
         present_info.pSwapchains = swapchains;
         present_info.pImageIndices = &image_index;
         present_info.pResults = nullptr;
-        vkQueuePresentKHR(device.get_present_queue(), &present_info);
+        pacer.prepare_present(present_info);
+        {
+            PYRO_ZONE("present");
+            vkQueuePresentKHR(device.get_present_queue(), &present_info);
+        }
+        pacer.presented();
+        if (frame_count == 0) {
+            PyroStartup::get_instance().first_frame(FIRST_FRAME_TARGET_MS);
+        }
+        const FrameLatency &latency = pacer.get_latency();
+        PyroCounters::get_instance().set("latency.input_to_present_ms", latency.input_to_present_ms);
+        PyroCounters::get_instance().set("latency.pacing_wait_ms", latency.pacing_wait_ms);
+        current_frame = (current_frame + 1) % MAX_FRAMES_IN_FLIGHT;
+        frame_count++;
+    }
+
+    void PyroRender::collect_gpu_zones() {
+        // The slot's command buffer only exists once the first MAX_FRAMES_IN_FLIGHT frames have been recorded.
+        if (!gpu_timers[current_frame] || frame_count < MAX_FRAMES_IN_FLIGHT) {
+            return;
+        }
+        PYRO_ZONE("collect_gpu_zones");
+        const std::vector<GpuTimeRange> ranges = gpu_timers[current_frame]->resolve_ranges();
+        const std::vector<const char *> &names = gpu_zone_names[current_frame];
+        for (size_t i = 0; i < ranges.size() && i < names.size(); i++) {
+            PyroTrace::get_instance().record_gpu({names[i], ranges[i].begin_ns, ranges[i].end_ns});
+        }
+    }
+
+    uint32_t PyroRender::begin_gpu_zone(const VkCommandBuffer command_buffer, const char *name) {
+        if (!gpu_timers[current_frame]) {
+            return 0;
+        }
+        gpu_zone_names[current_frame].push_back(name);
+        return gpu_timers[current_frame]->begin(command_buffer);
+    }
+
+    void PyroRender::end_gpu_zone(const VkCommandBuffer command_buffer, const uint32_t scope) const {
+        if (gpu_timers[current_frame]) {
+            gpu_timers[current_frame]->end(command_buffer, scope);
+        }
+    }
+
+    // The overlay only changes when the averaging window rolls over, so on every other frame its run is a cache
+    // hit in the text renderer.
+    void PyroRender::update_overlay() {
+        const auto now = std::chrono::steady_clock::now();
+        if (frame_count == 0) {
+            overlay_window_start = now;
+        }
+        overlay_window_frames++;
+        const std::chrono::duration<double, std::milli> window = now - overlay_window_start;
+        if (window.count() >= OVERLAY_REFRESH_MS) {
+            const double frame_ms = window.count() / overlay_window_frames;
+            const RenderGraphStats &graph_stats = graph.get_stats();
+            overlay = std::format("{:.2f} ms  {:.0f} fps\npasses {}  barriers {}", frame_ms, 1000.0 / frame_ms,
+                                  graph_stats.declared_passes - graph_stats.culled_passes, graph_stats.barrier_batches);
+            for (const ProfilerCounter &counter : PyroCounters::get_instance().get_counters()) {
+                overlay += std::format("\n{} {:.0f}", counter.name, counter.value);
+            }
+            overlay_window_start = now;
+            overlay_window_frames = 0;
+        }
+        text.draw_text(overlay, glm::vec2(8.0f), OVERLAY_TEXT_SIZE);
+    }
+
+    void PyroRender::record_command_buffer(const VkCommandBuffer command_buffer, const uint32_t image_index) {
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        begin_info.pInheritanceInfo = nullptr;
+        ASSERT_EQUAL(vkBeginCommandBuffer(command_buffer, &begin_info), VK_SUCCESS,
+                     "Failed to begin recording command buffer")
+        if (gpu_timers[current_frame]) {
+            gpu_timers[current_frame]->reset(command_buffer);
+            gpu_zone_names[current_frame].clear();
+        }
+        dynamic_resolution.begin_timing(command_buffer);
+        const uint32_t frame_zone = begin_gpu_zone(command_buffer, "gpu_frame");
+
+        graph.begin_frame(current_frame);
+        ImportedImage swap_chain_image{};
+        swap_chain_image.image = device.get_swap_chain_images()[image_index];
+        swap_chain_image.view = device.get_swap_chain_image_views()[image_index];
+        swap_chain_image.extent = device.get_swap_chain_extent();
+        swap_chain_image.format = device.get_swap_chain_image_format();
+        // Matches the stage the image-available semaphore is waited on.
+        swap_chain_image.initial_stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        swap_chain_image.final_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        const RenderResource back_buffer = graph.import_image("swap_chain", swap_chain_image);
+        graph.add_pass(
+                "texture_uploads", [](const RenderPassBuilder &builder) { builder.side_effect(); },
+                [this](const RenderPassContext &context) {
+                    const uint32_t zone = begin_gpu_zone(context.command_buffer, "texture_uploads");
+                    textures.record_uploads(context.command_buffer);
+                    text.record_uploads(context.command_buffer);
+                    end_gpu_zone(context.command_buffer, zone);
+                });
+        // With dynamic resolution the scene goes to an offscreen target first, sized for the largest scale. With
+        // MSAA it is drawn multisampled and resolved into that target (or the back buffer) as the pass ends; the
+        // multisampled color and depth only live inside the pass, so the graph makes them transient attachments.
+        RenderResource scene = back_buffer;
+        RenderResource multisampled = INVALID_RENDER_RESOURCE;
+        RenderResource depth = INVALID_RENDER_RESOURCE;
+        graph.add_pass(
+                "main",
+                [&](const RenderPassBuilder &builder) {
+                    const VkExtent2D extent = device.get_swap_chain_extent();
+                    if (dynamic_resolution.is_enabled()) {
+                        scene = builder.create_image(
+                                "scene", TransientImageDesc{extent, PyroDynamicResolution::SCENE_FORMAT});
+                    }
+                    if (msaa_samples != VK_SAMPLE_COUNT_1_BIT) {
+                        const VkFormat format = dynamic_resolution.is_enabled() ? PyroDynamicResolution::SCENE_FORMAT
+                                                                                : device.get_swap_chain_image_format();
+                        multisampled = builder.create_image(
+                                "scene_msaa",
+                                TransientImageDesc{extent, format, VK_IMAGE_ASPECT_COLOR_BIT, 1, msaa_samples});
+                        builder.write(multisampled, ResourceAccess::COLOR_ATTACHMENT);
+                    }
+                    depth = builder.create_image("depth", TransientImageDesc{extent, DEPTH_FORMAT,
+                                                                             VK_IMAGE_ASPECT_DEPTH_BIT, 1,
+                                                                             msaa_samples});
+                    builder.write(scene, ResourceAccess::COLOR_ATTACHMENT);
+                    builder.write(depth, ResourceAccess::DEPTH_ATTACHMENT);
+                },
+                [&](const RenderPassContext &context) {
+                    const uint32_t zone = begin_gpu_zone(context.command_buffer, "main");
+                    if (multisampled != INVALID_RENDER_RESOURCE) {
+                        record_main_pass(context, multisampled, scene, depth);
+                    } else {
+                        record_main_pass(context, scene, INVALID_RENDER_RESOURCE, depth);
+                    }
+                    end_gpu_zone(context.command_buffer, zone);
+                });
+        RenderResource upscaled = INVALID_RENDER_RESOURCE;
+        if (dynamic_resolution.is_enabled()) {
+            graph.add_pass(
+                    "upscale",
+                    [&](const RenderPassBuilder &builder) {
+                        upscaled = builder.create_image(
+                                "upscaled", TransientImageDesc{device.get_swap_chain_extent(),
+                                                               PyroDynamicResolution::SCENE_FORMAT});
+                        builder.read(scene, ResourceAccess::SAMPLED_COMPUTE);
+                        builder.write(upscaled, ResourceAccess::STORAGE_COMPUTE);
+                    },
+                    [&](const RenderPassContext &context) {
+                        const uint32_t zone = begin_gpu_zone(context.command_buffer, "upscale");
+                        dynamic_resolution.record_upscale(context.command_buffer, context.get_view(scene),
+                                                          context.get_extent(scene), context.get_view(upscaled),
+                                                          context.get_extent(upscaled));
+                        end_gpu_zone(context.command_buffer, zone);
+                    });
+            // Storage writes to the swap chain's sRGB formats are rarely supported, so the result is blitted in,
+            // which also does the sRGB encoding.
+            graph.add_pass(
+                    "present_blit",
+                    [&](const RenderPassBuilder &builder) {
+                        builder.read(upscaled, ResourceAccess::TRANSFER_SRC);
+                        builder.write(back_buffer, ResourceAccess::TRANSFER_DST);
+                    },
+                    [&](const RenderPassContext &context) {
+                        const VkExtent2D extent = context.get_extent(back_buffer);
+                        VkImageBlit region{};
+                        region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+                        region.srcOffsets[1] = {static_cast<int32_t>(extent.width),
+                                                static_cast<int32_t>(extent.height), 1};
+                        region.dstSubresource = region.srcSubresource;
+                        region.dstOffsets[1] = region.srcOffsets[1];
+                        vkCmdBlitImage(context.command_buffer, context.get_image(upscaled),
+                                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, context.get_image(back_buffer),
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region, VK_FILTER_NEAREST);
+                    });
+        }
+        if (capture.wants_capture() && (device.get_swap_chain_usage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+            graph.add_pass(
+                    "readback",
+                    [&](const RenderPassBuilder &builder) {
+                        builder.read(back_buffer, ResourceAccess::TRANSFER_SRC);
+                        builder.side_effect();
+                    },
+                    [&](const RenderPassContext &context) {
+                        const uint32_t zone = begin_gpu_zone(context.command_buffer, "readback");
+                        capture.record_copy(context.command_buffer, context.get_image(back_buffer),
+                                            context.get_format(back_buffer));
+                        end_gpu_zone(context.command_buffer, zone);
+                    });
+        }
+        graph.execute(command_buffer);
+        // Attachment bytes a store would have written out this frame, and the lazy memory actually committed.
+        const RenderGraphStats &graph_stats = graph.get_stats();
+        PyroCounters &counters = PyroCounters::get_instance();
+        counters.set("graph.transient_attachment_kib",
+                     static_cast<double>(graph_stats.transient_attachment_bytes) / 1024);
+        counters.set("graph.lazy_kib", static_cast<double>(graph_stats.lazy_bytes) / 1024);
+        counters.set("graph.lazy_committed_kib", static_cast<double>(graph_stats.lazy_committed_bytes) / 1024);
+        end_gpu_zone(command_buffer, frame_zone);
+        dynamic_resolution.end_timing(command_buffer);
+        ASSERT_EQUAL(vkEndCommandBuffer(command_buffer), VK_SUCCESS, "Failed to record command buffer")
+    }
+
+    void PyroRender::record_main_pass(const RenderPassContext &context, const RenderResource target,
+                                      const RenderResource resolve, const RenderResource depth) {
+        const VkCommandBuffer command_buffer = context.command_buffer;
+        RenderingAttachment color{};
+        color.resource = target;
+        // The samples themselves are dropped once averaged into the resolve target.
+        if (resolve != INVALID_RENDER_RESOURCE) {
+            color.resolve = resolve;
+            color.store_op = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        }
+        color.clear_value.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        RenderingAttachment depth_attachment{};
+        depth_attachment.resource = depth;
+        depth_attachment.store_op = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depth_attachment.clear_value.depthStencil = {1.0f, 0};
+        // Only the scaled corner of a dynamic-resolution target is rendered; zero otherwise, i.e. all of it.
+        const VkExtent2D render_extent = dynamic_resolution.is_enabled() ? dynamic_resolution.get_render_extent()
+                                                                         : VkExtent2D{};
+        context.begin_rendering({color}, depth_attachment, render_extent);
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pyroPipeline->get_pipeline());
+
+        // Per-frame data goes through the uniform ring, per-draw data through push constants.
+        FrameUniforms frame{};
+        frame.view_proj = glm::mat4(1.0f);
+        frame.time = glm::vec4(static_cast<float>(frame_count), 0.0f, 0.0f, 0.0f);
+        uniforms.bind(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pyroPipeline->get_pipeline_layout(), 0,
+                      uniforms.push(frame));
+        DrawPushConstants draw{};
+        draw.model = glm::mat4(1.0f);
+        draw.tint = glm::vec4(1.0f);
+        PyroUniformRing::push_draw_data(command_buffer, pyroPipeline->get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT,
+                                        &draw, sizeof(draw));
+        vkCmdDraw(command_buffer, 3, 1, 0, 0);
+        // Laid out against the output size, so the overlay keeps its size on screen whatever the scale.
+        text.record(command_buffer, device.get_swap_chain_extent());
+        context.end_rendering();
     }
 } // namespace pyro
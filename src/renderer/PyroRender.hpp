@@ -5,25 +5,94 @@
 #ifndef PYRORENDER_HPP
 #define PYRORENDER_HPP
 
+#include <array>
+#include <chrono>
+#include <future>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../capture/PyroFrameCapture.hpp"
 #include "../core/VulkanDevice.hpp"
 #include "../core/VulkanInstance.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "../profiler/PyroGpuTimer.hpp"
+#include "../rendergraph/PyroRenderGraph.hpp"
+#include "../text/PyroTextRenderer.hpp"
+#include "../texture/PyroTextureStreamer.hpp"
 #include "../window/PyroWindow.hpp"
+#include "PyroDynamicResolution.hpp"
+#include "PyroFramePacer.hpp"
 #include "PyroRender.hpp"
+#include "PyroUniformRing.hpp"
 #include "Pyropipeline.hpp"
 
 namespace pyro {
+    // Must match FrameData in basic.vert (std140).
+    struct FrameUniforms {
+        glm::mat4 view_proj;
+        glm::vec4 time;
+    };
+    // Must match DrawData in basic.vert; fits the push-constant fast path.
+    struct DrawPushConstants {
+        glm::mat4 model;
+        glm::vec4 tint;
+    };
+    static_assert(sizeof(DrawPushConstants) <= PyroUniformRing::PUSH_CONSTANT_FAST_PATH_SIZE);
+
     class PyroRender {
     public:
-        PyroWindow window;
+        // Startup order follows the declaration order below, with two overlaps: the instance is created on a
+        // worker while the window opens, and the main pipeline compiles on a worker while the resources after it
+        // (font atlas and text pipeline included) are built.
         VulkanInstance instance;
+        PyroWindow window;
         VulkanDevice device;
-        Pyropipeline pyroPipeline;
-        PyroRender();
+        PyroDescriptors descriptors;
+        PyroUniformRing uniforms;
+        PyroDynamicResolution dynamic_resolution;
+        std::future<std::unique_ptr<Pyropipeline>> main_pipeline_job;
+        PyroTextureStreamer textures;
+        PyroRenderGraph graph;
+        PyroTextRenderer text;
+        std::unique_ptr<Pyropipeline> pyroPipeline;
+        // `msaa_samples` is clamped to what the device supports; 1 disables MSAA.
+        explicit PyroRender(const PresentConfig &present_config = {},
+                            const DynamicResolutionConfig &resolution_config = {}, uint32_t msaa_samples = 1);
 
-        void run();
+        // With `threaded_input`, the calling thread becomes a dedicated input thread pumping SDL at about 1 kHz
+        // and the frame loop moves to a new render thread; otherwise events are drained once per frame.
+        void run(bool threaded_input = false);
 
     private:
+        uint32_t current_frame = 0;
+        uint64_t frame_count = 0;
+        VkSampleCountFlagBits msaa_samples = VK_SAMPLE_COUNT_1_BIT;
+        PyroFramePacer pacer;
+        // F12 saves a screenshot, F11 toggles dumping every frame.
+        PyroFrameCapture capture;
+        // Stats overlay, refreshed from frame times averaged over a short window.
+        std::chrono::steady_clock::time_point overlay_window_start;
+        uint32_t overlay_window_frames = 0;
+        std::string overlay;
+        // With PYRO_TRACING, GPU scopes per frame in flight, read back into PyroTrace once the frame's fence
+        // has signalled.
+        std::array<std::unique_ptr<PyroGpuTimer>, MAX_FRAMES_IN_FLIGHT> gpu_timers;
+        std::array<std::vector<const char *>, MAX_FRAMES_IN_FLIGHT> gpu_zone_names;
+
+        void render_loop(bool pump_events);
+        void process_input();
         void draw_frame();
+        void collect_gpu_zones();
+        // Returns the timer scope; a no-op without PYRO_TRACING.
+        uint32_t begin_gpu_zone(VkCommandBuffer command_buffer, const char *name);
+        void end_gpu_zone(VkCommandBuffer command_buffer, uint32_t scope) const;
+        void update_overlay();
+        void record_command_buffer(VkCommandBuffer command_buffer, uint32_t image_index);
+        // `resolve` is the single-sampled target of a multisampled `target`, INVALID_RENDER_RESOURCE without MSAA.
+        void record_main_pass(const RenderPassContext &context, RenderResource target, RenderResource resolve,
+                              RenderResource depth);
     };
 } // namespace pyro
 
@@ -0,0 +1,236 @@
+//
+// Created by srijan on 2/24/25.
+//
+
+#include "PyroSpriteBatch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+
+#include "../utils/Logger.hpp"
+#include "../utils/RadixSort.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t VERTICES_PER_QUAD = 4;
+        constexpr uint32_t INDICES_PER_QUAD = 6;
+        constexpr uint32_t TEXTURE_KEY_BITS = 22;
+        constexpr uint32_t BLEND_KEY_BITS = 2;
+
+        struct SpritePushConstants {
+            glm::vec2 inverse_half_extent;
+        };
+
+        PyroDescriptorBindings texture_bindings(const VkImageView image_view, const VkSampler sampler) {
+            PyroDescriptorBindings bindings;
+            bindings.bind_image(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, image_view,
+                                sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            return bindings;
+        }
+
+        // Layer in the top byte so layers always draw in order, then the pipeline, then the texture.
+        uint32_t sort_key(const Sprite &sprite) {
+            return static_cast<uint32_t>(sprite.layer) << (BLEND_KEY_BITS + TEXTURE_KEY_BITS) |
+                   static_cast<uint32_t>(sprite.blend) << TEXTURE_KEY_BITS | sprite.texture;
+        }
+
+        uint16_t unorm16(const float value) {
+            return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+        }
+
+        double elapsed_ms(const std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    } // namespace
+
+    PyroSpriteBatch::PyroSpriteBatch(VulkanDevice *device, PyroDescriptors *descriptors, SpriteBatchConfig config) :
+        device(device), descriptors(descriptors), config(std::move(config)) {
+        VkSamplerCreateInfo sampler_info{};
+        sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.magFilter = VK_FILTER_LINEAR;
+        sampler_info.minFilter = VK_FILTER_LINEAR;
+        sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.minLod = 0.0f;
+        sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+        ASSERT_EQUAL(vkCreateSampler(device->get_logical_device(), &sampler_info, nullptr, &sampler), VK_SUCCESS,
+                     "Failed to create sprite sampler")
+        set_layout = descriptors->get_layout(texture_bindings(VK_NULL_HANDLE, VK_NULL_HANDLE));
+
+        GraphicsPipelineDesc desc{};
+        desc.vertex_shader = "assets/shaders/sprite.vert.spv";
+        desc.fragment_shader = "assets/shaders/sprite.frag.spv";
+        desc.vertex_bindings = {{0, sizeof(SpriteVertex), VK_VERTEX_INPUT_RATE_VERTEX}};
+        desc.vertex_attributes = {
+                {0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(SpriteVertex, position)},
+                {1, 0, VK_FORMAT_R16G16_UNORM, offsetof(SpriteVertex, uv)},
+                {2, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(SpriteVertex, color)},
+        };
+        desc.cull_mode = VK_CULL_MODE_NONE;
+        desc.formats = this->config.formats;
+        for (size_t blend = 0; blend < pipelines.size(); blend++) {
+            desc.blend_mode = static_cast<PipelineBlendMode>(blend);
+            pipelines[blend] = std::make_unique<Pyropipeline>(
+                    device, std::vector{set_layout},
+                    std::vector{VkPushConstantRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(SpritePushConstants)}}, desc);
+        }
+
+        const VkDeviceSize frame_bytes =
+                static_cast<VkDeviceSize>(this->config.max_quads) * VERTICES_PER_QUAD * sizeof(SpriteVertex);
+        vertices = std::make_unique<VulkanBuffer>(device, frame_bytes * MAX_FRAMES_IN_FLIGHT,
+                                                  VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                  VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        create_index_buffer();
+        sprites.reserve(this->config.max_quads);
+        LOG(LogLevel::INFO, "Sprite batch: {} quads per frame, {} KiB vertex stream", this->config.max_quads,
+            vertices->get_size() / 1024);
+    }
+
+    PyroSpriteBatch::~PyroSpriteBatch() {
+        vkDeviceWaitIdle(device->get_logical_device());
+        vkDestroySampler(device->get_logical_device(), sampler, nullptr);
+    }
+
+    // The indices never change, so they live in device-local memory behind a one-off staging copy.
+    void PyroSpriteBatch::create_index_buffer() {
+        const VkDeviceSize size = static_cast<VkDeviceSize>(config.max_quads) * INDICES_PER_QUAD * sizeof(uint32_t);
+        const VulkanBuffer staging(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        auto *out = static_cast<uint32_t *>(staging.get_mapped());
+        for (uint32_t quad = 0; quad < config.max_quads; quad++) {
+            const uint32_t base = quad * VERTICES_PER_QUAD;
+            out[0] = base;
+            out[1] = base + 1;
+            out[2] = base + 2;
+            out[3] = base + 2;
+            out[4] = base + 3;
+            out[5] = base;
+            out += INDICES_PER_QUAD;
+        }
+        indices = std::make_unique<VulkanBuffer>(device, size,
+                                                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        const VkCommandBuffer command_buffer = device->begin_single_time_commands();
+        const VkBufferCopy region{0, 0, size};
+        vkCmdCopyBuffer(command_buffer, staging.get_buffer(), indices->get_buffer(), 1, &region);
+        device->end_single_time_commands(command_buffer);
+    }
+
+    SpriteTexture PyroSpriteBatch::register_texture(const VkImageView image_view, const VkSampler sampler) {
+        ASSERT_EQUAL(textures.size() < (1u << TEXTURE_KEY_BITS), true, "Out of sprite texture slots")
+        textures.push_back(texture_bindings(image_view, sampler != VK_NULL_HANDLE ? sampler : this->sampler));
+        return static_cast<SpriteTexture>(textures.size() - 1);
+    }
+
+    void PyroSpriteBatch::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        sprites.clear();
+        stats = {};
+    }
+
+    void PyroSpriteBatch::draw(const Sprite &sprite) {
+        if (sprites.size() == config.max_quads) {
+            if (stats.dropped_quads++ == 0) {
+                LOG(LogLevel::WARNING, "Sprite batch full at {} quads, dropping further quads this frame",
+                    config.max_quads);
+            }
+            return;
+        }
+        sprites.push_back(sprite);
+    }
+
+    // Expands the sorted quads into the vertex stream and merges neighbours that share a pipeline and texture
+    // into runs. Layers only order the sort, so equal state on either side of a layer boundary still merges.
+    void PyroSpriteBatch::write_vertices(SpriteVertex *out) {
+        runs.clear();
+        for (uint32_t quad = 0; quad < keys.size(); quad++) {
+            const Sprite &sprite = sprites[static_cast<uint32_t>(keys[quad])];
+            if (runs.empty() || runs.back().blend != sprite.blend || runs.back().texture != sprite.texture) {
+                runs.push_back({sprite.blend, sprite.texture, quad, 0});
+            }
+            runs.back().quad_count++;
+
+            const uint16_t u0 = unorm16(sprite.uv.x);
+            const uint16_t v0 = unorm16(sprite.uv.y);
+            const uint16_t u1 = unorm16(sprite.uv.z);
+            const uint16_t v1 = unorm16(sprite.uv.w);
+            glm::vec2 corners[VERTICES_PER_QUAD] = {sprite.position, sprite.position + glm::vec2(sprite.size.x, 0.0f),
+                                                    sprite.position + sprite.size,
+                                                    sprite.position + glm::vec2(0.0f, sprite.size.y)};
+            if (sprite.rotation != 0.0f) {
+                const glm::vec2 centre = sprite.position + sprite.size * 0.5f;
+                const float c = std::cos(sprite.rotation);
+                const float s = std::sin(sprite.rotation);
+                for (glm::vec2 &corner : corners) {
+                    const glm::vec2 d = corner - centre;
+                    corner = centre + glm::vec2(d.x * c - d.y * s, d.x * s + d.y * c);
+                }
+            }
+            out[0] = {corners[0], {u0, v0}, sprite.color};
+            out[1] = {corners[1], {u1, v0}, sprite.color};
+            out[2] = {corners[2], {u1, v1}, sprite.color};
+            out[3] = {corners[3], {u0, v1}, sprite.color};
+            out += VERTICES_PER_QUAD;
+        }
+    }
+
+    void PyroSpriteBatch::record(const VkCommandBuffer command_buffer, const VkExtent2D extent) {
+        stats.quads = static_cast<uint32_t>(sprites.size());
+        if (sprites.empty()) {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        keys.resize(sprites.size());
+        for (uint32_t i = 0; i < sprites.size(); i++) {
+            keys[i] = static_cast<uint64_t>(sort_key(sprites[i])) << 32 | i;
+        }
+        radix_sort_by_key(keys, scratch);
+        stats.sort_ms = elapsed_ms(start);
+
+        start = std::chrono::steady_clock::now();
+        const uint32_t first_vertex = frame_index * config.max_quads * VERTICES_PER_QUAD;
+        write_vertices(static_cast<SpriteVertex *>(vertices->get_mapped()) + first_vertex);
+        const VkDeviceSize vertex_bytes = keys.size() * VERTICES_PER_QUAD * sizeof(SpriteVertex);
+        vertices->flush(first_vertex * sizeof(SpriteVertex), vertex_bytes);
+        stats.write_ms = elapsed_ms(start);
+
+        const VkBuffer vertex_buffer = vertices->get_buffer();
+        constexpr VkDeviceSize vertex_offset = 0;
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, &vertex_offset);
+        vkCmdBindIndexBuffer(command_buffer, indices->get_buffer(), 0, VK_INDEX_TYPE_UINT32);
+
+        const SpritePushConstants push{glm::vec2(2.0f / static_cast<float>(extent.width),
+                                                 2.0f / static_cast<float>(extent.height))};
+        const Pyropipeline *bound_pipeline = nullptr;
+        SpriteTexture bound_texture = UINT32_MAX;
+        for (const Run &run : runs) {
+            const Pyropipeline *pipeline = pipelines[static_cast<size_t>(run.blend)].get();
+            if (pipeline != bound_pipeline) {
+                // Every pipeline shares one layout, so the bound set and push constants stay valid across switches.
+                vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get_pipeline());
+                if (bound_pipeline == nullptr) {
+                    vkCmdPushConstants(command_buffer, pipeline->get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, 0,
+                                       sizeof(push), &push);
+                }
+                bound_pipeline = pipeline;
+                stats.pipeline_binds++;
+            }
+            if (run.texture != bound_texture) {
+                const VkDescriptorSet set = descriptors->get_cached_set(textures[run.texture]);
+                vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                        pipeline->get_pipeline_layout(), 0, 1, &set, 0, nullptr);
+                bound_texture = run.texture;
+                stats.texture_binds++;
+            }
+            vkCmdDrawIndexed(command_buffer, run.quad_count * INDICES_PER_QUAD, 1, 0,
+                             static_cast<int32_t>(first_vertex + run.first_quad * VERTICES_PER_QUAD), 0);
+            stats.draws++;
+        }
+    }
+} // namespace pyro
@@ -0,0 +1,117 @@
+//
+// Created by srijan on 2/24/25.
+//
+
+#ifndef PYROSPRITEBATCH_HPP
+#define PYROSPRITEBATCH_HPP
+
+#include <array>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanBuffer.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "Pyropipeline.hpp"
+
+namespace pyro {
+
+    using SpriteTexture = uint32_t;
+
+    // Must match the vertex inputs of assets/shaders/sprite.vert.
+    struct SpriteVertex {
+        glm::vec2 position;
+        uint16_t uv[2];
+        uint32_t color;
+    };
+
+    struct Sprite {
+        // Top-left corner and size in pixels, origin at the top-left of the render area.
+        glm::vec2 position{};
+        glm::vec2 size{};
+        // u0, v0, u1, v1.
+        glm::vec4 uv{0.0f, 0.0f, 1.0f, 1.0f};
+        // RGBA8 with red in the lowest byte, multiplied with the texture.
+        uint32_t color = 0xffffffff;
+        // Radians, clockwise about the centre.
+        float rotation = 0.0f;
+        SpriteTexture texture = 0;
+        // Quads draw in layer order; within a layer they are grouped by blend mode and texture.
+        uint8_t layer = 0;
+        PipelineBlendMode blend = PipelineBlendMode::ALPHA;
+    };
+
+    struct SpriteBatchConfig {
+        uint32_t max_quads = 1 << 16;
+        PipelineAttachmentFormats formats;
+    };
+
+    struct SpriteBatchStats {
+        uint32_t quads = 0;
+        uint32_t dropped_quads = 0;
+        uint32_t draws = 0;
+        uint32_t pipeline_binds = 0;
+        uint32_t texture_binds = 0;
+        double sort_ms = 0.0;
+        double write_ms = 0.0;
+    };
+
+    // Collects textured quads for a frame and draws them with as few vkCmdDrawIndexed calls as possible. Quads
+    // are keyed on (layer, blend mode, texture) and radix sorted, then expanded in sorted order into a persistently
+    // mapped vertex stream with one region per frame in flight. Every run of quads sharing a pipeline and texture
+    // becomes one draw against a static index buffer holding the quad pattern for max_quads quads, with the run's
+    // start passed as vertexOffset. The sort is stable, so quads sharing a key keep their submission order.
+    class PyroSpriteBatch {
+    public:
+        PyroSpriteBatch(VulkanDevice *device, PyroDescriptors *descriptors, SpriteBatchConfig config = {});
+        ~PyroSpriteBatch();
+        PyroSpriteBatch(const PyroSpriteBatch &) = delete;
+        PyroSpriteBatch &operator=(const PyroSpriteBatch &) = delete;
+
+        // The image must be in SHADER_READ_ONLY_OPTIMAL whenever the batch draws it. A null sampler uses the
+        // batch's linear clamp-to-edge sampler.
+        SpriteTexture register_texture(VkImageView image_view, VkSampler sampler = VK_NULL_HANDLE);
+
+        // Drops the previous frame's quads. The slot's previous frame must have completed.
+        void begin_frame(uint32_t frame_index);
+        void draw(const Sprite &sprite);
+        // Sorts and uploads this frame's quads and records their draws. Must be called inside a rendering scope
+        // whose attachment formats match config.formats.
+        void record(VkCommandBuffer command_buffer, VkExtent2D extent);
+
+        const SpriteBatchStats &get_stats() const { return stats; }
+        uint32_t get_max_quads() const { return config.max_quads; }
+
+    private:
+        struct Run {
+            PipelineBlendMode blend;
+            SpriteTexture texture;
+            uint32_t first_quad;
+            uint32_t quad_count;
+        };
+
+        VulkanDevice *device;
+        PyroDescriptors *descriptors;
+        SpriteBatchConfig config;
+        VkSampler sampler{};
+        VkDescriptorSetLayout set_layout;
+        std::array<std::unique_ptr<Pyropipeline>, 4> pipelines;
+        std::unique_ptr<VulkanBuffer> vertices;
+        std::unique_ptr<VulkanBuffer> indices;
+        std::vector<PyroDescriptorBindings> textures;
+        uint32_t frame_index = 0;
+
+        std::vector<Sprite> sprites;
+        std::vector<uint64_t> keys;
+        std::vector<uint64_t> scratch;
+        std::vector<Run> runs;
+        SpriteBatchStats stats;
+
+        void create_index_buffer();
+        void write_vertices(SpriteVertex *out);
+    };
+
+} // namespace pyro
+
+#endif // PYROSPRITEBATCH_HPP
@@ -0,0 +1,86 @@
+//
+// Created by srijan on 2/18/25.
+//
+
+#include "PyroUniformRing.hpp"
+
+#include <algorithm>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        VkDeviceSize align_up(const VkDeviceSize value, const VkDeviceSize alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    PyroUniformRing::PyroUniformRing(VulkanDevice *device, PyroDescriptors *descriptors, const VkDeviceSize frame_size,
+                                     const VkDeviceSize max_block_size, const VkShaderStageFlags stages) :
+        device(device) {
+        const VkPhysicalDeviceLimits &limits = device->get_properties().limits;
+        alignment = std::max<VkDeviceSize>(limits.minUniformBufferOffsetAlignment, 16);
+        this->max_block_size =
+                align_up(std::min<VkDeviceSize>(max_block_size, limits.maxUniformBufferRange), alignment);
+        this->frame_size = align_up(frame_size, alignment);
+
+        // The descriptor range is max_block_size wide at every offset, so the last frame's region needs that much
+        // slack behind it to keep dynamic_offset + range inside the buffer.
+        const VkDeviceSize total_size = this->frame_size * MAX_FRAMES_IN_FLIGHT + this->max_block_size;
+        ASSERT_EQUAL(total_size <= UINT32_MAX, true, "Uniform ring too large for 32-bit dynamic offsets")
+        // Prefer host-visible VRAM (resizable BAR) so the shader reads do not cross the bus.
+        buffer = std::make_unique<VulkanBuffer>(device, total_size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        bindings.bind_buffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, stages, buffer->get_buffer(), 0,
+                             this->max_block_size);
+        layout = descriptors->get_layout(bindings);
+        set = descriptors->get_cached_set(bindings);
+        LOG(LogLevel::INFO, "Uniform ring: {} KiB per frame, {} byte alignment, {} byte blocks",
+            this->frame_size / 1024, alignment, this->max_block_size);
+    }
+
+    void PyroUniformRing::begin_frame(const uint32_t frame_index) {
+        // The frame's fence has been waited on, so its region is no longer read by the device.
+        this->frame_index = frame_index;
+        head = frame_index * frame_size;
+    }
+
+    void PyroUniformRing::end_frame() const {
+        const VkDeviceSize start = frame_index * frame_size;
+        buffer->flush(start, head - start);
+    }
+
+    UniformAllocation PyroUniformRing::allocate(const VkDeviceSize size) {
+        ASSERT_EQUAL(size <= max_block_size, true, "Uniform block larger than the ring's descriptor range")
+        const VkDeviceSize aligned = align_up(size, alignment);
+        ASSERT_EQUAL(head + aligned <= (frame_index + 1) * frame_size, true, "Uniform ring exhausted for this frame")
+        const UniformAllocation allocation{static_cast<char *>(buffer->get_mapped()) + head,
+                                           static_cast<uint32_t>(head)};
+        head += aligned;
+        return allocation;
+    }
+
+    void PyroUniformRing::bind(const VkCommandBuffer command_buffer, const VkPipelineBindPoint bind_point,
+                               const VkPipelineLayout layout, const uint32_t set_index,
+                               const uint32_t dynamic_offset) const {
+        vkCmdBindDescriptorSets(command_buffer, bind_point, layout, set_index, 1, &set, 1, &dynamic_offset);
+    }
+
+    void PyroUniformRing::push_draw_data(const VkCommandBuffer command_buffer, const VkPipelineLayout layout,
+                                         const VkShaderStageFlags stages, const void *data, const uint32_t size) {
+        ASSERT_EQUAL(size <= PUSH_CONSTANT_FAST_PATH_SIZE && size % 4 == 0, true,
+                     "Push constant data must be a multiple of 4 bytes and at most 128 bytes")
+        vkCmdPushConstants(command_buffer, layout, stages, 0, size, data);
+    }
+
+    VkPushConstantRange PyroUniformRing::push_constant_range(const VkShaderStageFlags stages, const uint32_t size) {
+        VkPushConstantRange range{};
+        range.stageFlags = stages;
+        range.offset = 0;
+        range.size = size;
+        return range;
+    }
+} // namespace pyro
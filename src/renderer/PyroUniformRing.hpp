@@ -0,0 +1,75 @@
+//
+// Created by srijan on 2/18/25.
+//
+
+#ifndef PYROUNIFORMRING_HPP
+#define PYROUNIFORMRING_HPP
+
+#include <memory>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanBuffer.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+
+namespace pyro {
+
+    struct UniformAllocation {
+        void *data;
+        uint32_t dynamic_offset;
+    };
+
+    // Persistently mapped uniform buffer split into one region per frame in flight. Each allocation bumps a
+    // cursor inside the current frame's region by a multiple of minUniformBufferOffsetAlignment, and the shader
+    // sees it through one UNIFORM_BUFFER_DYNAMIC descriptor whose dynamic offset selects the allocation, so
+    // updating thousands of draws costs a memcpy each and never a map, a buffer or a descriptor write.
+    //
+    // Per-draw data no larger than PUSH_CONSTANT_FAST_PATH_SIZE should go through push_draw_data() instead.
+    class PyroUniformRing {
+    public:
+        // Guaranteed minimum for maxPushConstantsSize.
+        static constexpr uint32_t PUSH_CONSTANT_FAST_PATH_SIZE = 128;
+
+        PyroUniformRing(VulkanDevice *device, PyroDescriptors *descriptors, VkDeviceSize frame_size = 4 * 1024 * 1024,
+                        VkDeviceSize max_block_size = 1024, VkShaderStageFlags stages = VK_SHADER_STAGE_ALL_GRAPHICS);
+        PyroUniformRing(const PyroUniformRing &) = delete;
+        PyroUniformRing &operator=(const PyroUniformRing &) = delete;
+
+        void begin_frame(uint32_t frame_index);
+        // Makes this frame's writes visible to the device; call before submitting.
+        void end_frame() const;
+
+        UniformAllocation allocate(VkDeviceSize size);
+        template<typename T>
+        uint32_t push(const T &value) {
+            const UniformAllocation allocation = allocate(sizeof(T));
+            *static_cast<T *>(allocation.data) = value;
+            return allocation.dynamic_offset;
+        }
+        void bind(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout,
+                  uint32_t set_index, uint32_t dynamic_offset) const;
+
+        static void push_draw_data(VkCommandBuffer command_buffer, VkPipelineLayout layout, VkShaderStageFlags stages,
+                                   const void *data, uint32_t size);
+        static VkPushConstantRange push_constant_range(VkShaderStageFlags stages,
+                                                       uint32_t size = PUSH_CONSTANT_FAST_PATH_SIZE);
+
+        const PyroDescriptorBindings &get_bindings() const { return bindings; }
+        VkDescriptorSetLayout get_layout() const { return layout; }
+        VkDeviceSize get_frame_usage() const { return head - frame_index * frame_size; }
+
+    private:
+        VulkanDevice *device;
+        std::unique_ptr<VulkanBuffer> buffer;
+        PyroDescriptorBindings bindings;
+        VkDescriptorSetLayout layout;
+        VkDescriptorSet set;
+        VkDeviceSize alignment;
+        VkDeviceSize frame_size;
+        VkDeviceSize max_block_size;
+        uint32_t frame_index = 0;
+        VkDeviceSize head = 0;
+    };
+
+} // namespace pyro
+
+#endif // PYROUNIFORMRING_HPP
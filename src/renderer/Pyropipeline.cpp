@@ -4,25 +4,88 @@
 
 #include "Pyropipeline.hpp"
 
+#include <memory>
+
 #include "../shader/PyroShaderModule.hpp"
+#include "../shader/PyroShaderProgram.hpp"
 #include "../utils/Logger.hpp"
 
 namespace pyro {
-    Pyropipeline::Pyropipeline(VulkanDevice *device) : device(device) {
-        PyroShaderModule vertexShader{device, "assets/shaders/basic.vert.spv", PyroShaderModuleType::PYRO_VERTEX};
-        PyroShaderModule fragmentShader{device, "assets/shaders/basic.frag.spv", PyroShaderModuleType::PYRO_FRAGMENT};
-        VkPipelineShaderStageCreateInfo vertexShaderStageInfo{};
-        vertexShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        vertexShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-        vertexShaderStageInfo.module = vertexShader.getShaderModule();
-        vertexShaderStageInfo.pName = "main";
-        VkPipelineShaderStageCreateInfo fragmentShaderStageInfo{};
-        fragmentShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        fragmentShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        fragmentShaderStageInfo.module = fragmentShader.getShaderModule();
-        fragmentShaderStageInfo.pName = "main";
-
-        VkPipelineShaderStageCreateInfo shaderStages[] = {vertexShaderStageInfo, fragmentShaderStageInfo};
+    namespace {
+        PyroShaderModuleType module_type(const VkShaderStageFlagBits stage) {
+            switch (stage) {
+                case VK_SHADER_STAGE_VERTEX_BIT:
+                    return PyroShaderModuleType::PYRO_VERTEX;
+                case VK_SHADER_STAGE_GEOMETRY_BIT:
+                    return PyroShaderModuleType::PYRO_GEOMETRY;
+                case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+                case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+                    return PyroShaderModuleType::PYRO_TESS;
+                case VK_SHADER_STAGE_TASK_BIT_EXT:
+                    return PyroShaderModuleType::PYRO_TASK;
+                case VK_SHADER_STAGE_MESH_BIT_EXT:
+                    return PyroShaderModuleType::PYRO_MESH;
+                default:
+                    return PyroShaderModuleType::PYRO_FRAGMENT;
+            }
+        }
+
+        GraphicsPipelineDesc with_program(GraphicsPipelineDesc desc, const PyroShaderProgram &program) {
+            desc.program = &program;
+            return desc;
+        }
+    } // namespace
+
+    Pyropipeline::Pyropipeline(VulkanDevice *device, const std::vector<VkDescriptorSetLayout> &set_layouts,
+                               const std::vector<VkPushConstantRange> &push_constant_ranges,
+                               GraphicsPipelineDesc desc) : device(device), formats(std::move(desc.formats)) {
+        ASSERT_EQUAL(device->get_capabilities().dynamic_rendering, true, "Dynamic rendering is not supported")
+        if (this->formats.color_formats.empty()) {
+            this->formats.color_formats.push_back(device->get_swap_chain_image_format());
+        }
+        const bool mesh_pipeline = desc.program ? (desc.program->get_reflection().stages & VK_SHADER_STAGE_MESH_BIT_EXT)
+                                                  : !desc.mesh_shader.empty();
+        if (mesh_pipeline) {
+            ASSERT_EQUAL(device->get_capabilities().mesh_shader, true, "Mesh shaders are not supported")
+        }
+        // Modules only need to live until the pipeline is created.
+        std::vector<std::unique_ptr<PyroShaderModule>> modules;
+        std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+        const auto add_module = [&](std::unique_ptr<PyroShaderModule> module, const VkShaderStageFlagBits stage) {
+            modules.push_back(std::move(module));
+            VkPipelineShaderStageCreateInfo stageInfo{};
+            stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stageInfo.stage = stage;
+            stageInfo.module = modules.back()->getShaderModule();
+            stageInfo.pName = "main";
+            stageInfo.pSpecializationInfo = desc.specialization;
+            shaderStages.push_back(stageInfo);
+        };
+        const auto add_stage = [&](const std::string &path, const PyroShaderModuleType type,
+                                   const VkShaderStageFlagBits stage) {
+            add_module(std::make_unique<PyroShaderModule>(device, path, type), stage);
+        };
+        if (desc.program) {
+            for (const ShaderStageCode &code: desc.program->get_stages()) {
+                add_module(std::make_unique<PyroShaderModule>(device, code.spirv, module_type(code.stage)),
+                           code.stage);
+            }
+            const ShaderReflection &reflection = desc.program->get_reflection();
+            if (desc.vertex_bindings.empty() && !reflection.vertex_inputs.empty()) {
+                desc.vertex_bindings = {reflection.vertex_binding()};
+                desc.vertex_attributes = reflection.vertex_attributes();
+            }
+        } else {
+            if (mesh_pipeline) {
+                if (!desc.task_shader.empty()) {
+                    add_stage(desc.task_shader, PyroShaderModuleType::PYRO_TASK, VK_SHADER_STAGE_TASK_BIT_EXT);
+                }
+                add_stage(desc.mesh_shader, PyroShaderModuleType::PYRO_MESH, VK_SHADER_STAGE_MESH_BIT_EXT);
+            } else {
+                add_stage(desc.vertex_shader, PyroShaderModuleType::PYRO_VERTEX, VK_SHADER_STAGE_VERTEX_BIT);
+            }
+            add_stage(desc.fragment_shader, PyroShaderModuleType::PYRO_FRAGMENT, VK_SHADER_STAGE_FRAGMENT_BIT);
+        }
 
         VkPipelineDynamicStateCreateInfo dynamic_states_create_info{};
         dynamic_states_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
@@ -32,10 +95,10 @@ namespace pyro {
 
         VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
         vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 0;
-        vertexInputInfo.vertexAttributeDescriptionCount = 0;
-        vertexInputInfo.pVertexBindingDescriptions = nullptr;
-        vertexInputInfo.pVertexAttributeDescriptions = nullptr;
+        vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(desc.vertex_bindings.size());
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(desc.vertex_attributes.size());
+        vertexInputInfo.pVertexBindingDescriptions = desc.vertex_bindings.data();
+        vertexInputInfo.pVertexAttributeDescriptions = desc.vertex_attributes.data();
 
         VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
         inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -67,8 +130,8 @@ namespace pyro {
         rasterizer.rasterizerDiscardEnable = VK_FALSE;
         rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
         rasterizer.lineWidth = 1.0f;
-        rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-        rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+        rasterizer.cullMode = desc.cull_mode;
+        rasterizer.frontFace = desc.front_face;
         rasterizer.depthBiasEnable = VK_FALSE;
         rasterizer.depthBiasConstantFactor = 0.0f;
         rasterizer.depthBiasClamp = 0.0f;
@@ -78,11 +141,19 @@ namespace pyro {
         multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
         multisampling.sampleShadingEnable = VK_FALSE;
         multisampling.pSampleMask = nullptr;
-        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        multisampling.rasterizationSamples = this->formats.samples;
         multisampling.alphaToCoverageEnable = VK_FALSE;
         multisampling.alphaToOneEnable = VK_FALSE;
         multisampling.minSampleShading = 1.0f;
 
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = desc.depth_test ? VK_TRUE : VK_FALSE;
+        depthStencil.depthWriteEnable = desc.depth_write ? VK_TRUE : VK_FALSE;
+        depthStencil.depthCompareOp = desc.depth_compare;
+        depthStencil.minDepthBounds = 0.0f;
+        depthStencil.maxDepthBounds = 1.0f;
+
         VkPipelineColorBlendAttachmentState colorBlendAttachment{};
         colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
                                               VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
@@ -93,13 +164,36 @@ namespace pyro {
         colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
         colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
         colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        switch (desc.blend_mode) {
+            case PipelineBlendMode::OPAQUE:
+                break;
+            case PipelineBlendMode::ALPHA:
+                colorBlendAttachment.blendEnable = VK_TRUE;
+                colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+                colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                break;
+            case PipelineBlendMode::PREMULTIPLIED_ALPHA:
+                colorBlendAttachment.blendEnable = VK_TRUE;
+                colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                break;
+            case PipelineBlendMode::ADDITIVE:
+                colorBlendAttachment.blendEnable = VK_TRUE;
+                colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+                colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+                colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+                break;
+        }
+
+        const std::vector colorBlendAttachments(this->formats.color_formats.size(), colorBlendAttachment);
 
         VkPipelineColorBlendStateCreateInfo colorBlending{};
         colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         colorBlending.logicOpEnable = VK_FALSE;
         colorBlending.logicOp = VK_LOGIC_OP_COPY;
-        colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
+        colorBlending.attachmentCount = static_cast<uint32_t>(colorBlendAttachments.size());
+        colorBlending.pAttachments = colorBlendAttachments.data();
         colorBlending.blendConstants[0] = 0.0f;
         colorBlending.blendConstants[1] = 0.0f;
         colorBlending.blendConstants[2] = 0.0f;
@@ -107,101 +201,57 @@ namespace pyro {
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount = 0;
-        pipelineLayoutInfo.pSetLayouts = nullptr;
-        pipelineLayoutInfo.pushConstantRangeCount = 0;
-        pipelineLayoutInfo.pPushConstantRanges = nullptr;
-
-        VkAttachmentDescription colorAttachments{};
-        colorAttachments.format = device->get_swap_chain_image_format();
-        colorAttachments.samples = VK_SAMPLE_COUNT_1_BIT;
-        colorAttachments.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        colorAttachments.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        colorAttachments.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        colorAttachments.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachments.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachments.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-        VkAttachmentReference colorAttachmentReference{};
-        colorAttachmentReference.attachment = 0;
-        colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription subpass{};
-        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.colorAttachmentCount = 1;
-        subpass.pColorAttachments = &colorAttachmentReference;
-
-        VkSubpassDependency dependency{};
-        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-        dependency.dstSubpass = 0;
-        dependency.srcAccessMask = 0;
-        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-        VkRenderPassCreateInfo renderPassInfo{};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassInfo.attachmentCount = 1;
-        renderPassInfo.pAttachments = &colorAttachments;
-        renderPassInfo.subpassCount = 1;
-        renderPassInfo.pSubpasses = &subpass;
-        renderPassInfo.dependencyCount = 1;
-        renderPassInfo.pDependencies = &dependency;
-
-        ASSERT_EQUAL(vkCreateRenderPass(device->get_logical_device(), &renderPassInfo, nullptr, &render_pass),
-                     VK_SUCCESS, "Failed to create render pass");
+        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(set_layouts.size());
+        pipelineLayoutInfo.pSetLayouts = set_layouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size());
+        pipelineLayoutInfo.pPushConstantRanges = push_constant_ranges.data();
+
+        // Dynamic rendering: the pipeline only records attachment formats, no render pass or framebuffers.
+        VkPipelineRenderingCreateInfo renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(this->formats.color_formats.size());
+        renderingInfo.pColorAttachmentFormats = this->formats.color_formats.data();
+        renderingInfo.depthAttachmentFormat = this->formats.depth_format;
+
         ASSERT_EQUAL(
                 vkCreatePipelineLayout(device->get_logical_device(), &pipelineLayoutInfo, nullptr, &pipeline_layout),
                 VK_SUCCESS, "Failed to create pipeline layout")
 
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = 2;
-        pipelineInfo.pStages = shaderStages;
+        pipelineInfo.pNext = &renderingInfo;
+        pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+        pipelineInfo.pStages = shaderStages.data();
 
-        pipelineInfo.pVertexInputState = &vertexInputInfo;
-        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pVertexInputState = mesh_pipeline ? nullptr : &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = mesh_pipeline ? nullptr : &inputAssembly;
         pipelineInfo.pViewportState = &viewportState;
         pipelineInfo.pRasterizationState = &rasterizer;
         pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState =
+                this->formats.depth_format != VK_FORMAT_UNDEFINED ? &depthStencil : nullptr;
         pipelineInfo.pColorBlendState = &colorBlending;
         pipelineInfo.pDynamicState = &dynamic_states_create_info;
 
         pipelineInfo.layout = pipeline_layout;
 
-        pipelineInfo.renderPass = render_pass;
+        pipelineInfo.renderPass = VK_NULL_HANDLE;
         pipelineInfo.subpass = 0;
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
         pipelineInfo.basePipelineIndex = -1;
 
-        ASSERT_EQUAL(vkCreateGraphicsPipelines(device->get_logical_device(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
-                                               &pipeline),
+        ASSERT_EQUAL(vkCreateGraphicsPipelines(device->get_logical_device(), desc.pipeline_cache, 1, &pipelineInfo,
+                                               nullptr, &pipeline),
                      VK_SUCCESS, "Failed to create pipeline")
-
-        // Creating Frame Buffers
-        swap_chain_framebuffers.resize(device->get_swap_chain_image_views().size());
-        for (uint32_t i = 0; i < device->get_swap_chain_image_views().size(); i++) {
-            VkImageView attachment_view[] = {device->get_swap_chain_image_views()[i]};
-            VkFramebufferCreateInfo framebuffer_create_info = {};
-            framebuffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-            framebuffer_create_info.renderPass = render_pass;
-            framebuffer_create_info.attachmentCount = 1;
-            framebuffer_create_info.pAttachments = attachment_view;
-            framebuffer_create_info.width = device->get_swap_chain_extent().width;
-            framebuffer_create_info.height = device->get_swap_chain_extent().height;
-            framebuffer_create_info.layers = 1;
-            ASSERT_EQUAL(vkCreateFramebuffer(device->get_logical_device(), &framebuffer_create_info, nullptr,
-                                             &swap_chain_framebuffers[i]),
-                         VK_SUCCESS, "Failed to create framebuffer")
-        }
     }
+
+    Pyropipeline::Pyropipeline(VulkanDevice *device, const PyroShaderProgram &program, GraphicsPipelineDesc desc) :
+        Pyropipeline(device, program.get_set_layouts(), program.get_push_constant_ranges(),
+                     with_program(std::move(desc), program)) {}
+
     Pyropipeline::~Pyropipeline() {
         vkDeviceWaitIdle(device->get_logical_device());
-        for (auto swap_chain_framebuffer : swap_chain_framebuffers) {
-            vkDestroyFramebuffer(device->get_logical_device(), swap_chain_framebuffer, nullptr);
-        }
         vkDestroyPipeline(device->get_logical_device(), pipeline, nullptr);
         vkDestroyPipelineLayout(device->get_logical_device(), pipeline_layout, nullptr);
-        vkDestroyRenderPass(device->get_logical_device(), render_pass, nullptr);
     }
 } // namespace pyro
@@ -4,20 +4,64 @@
 
 #ifndef PYROPIPELINE_HPP
 #define PYROPIPELINE_HPP
+#include <string>
+
 #include "../core/VulkanDevice.hpp"
 
 namespace pyro {
+    class PyroShaderProgram;
+
+    // The attachment formats a pipeline renders to. Under dynamic rendering they are all a pipeline is tied to,
+    // so it can draw into any images with matching formats.
+    struct PipelineAttachmentFormats {
+        // Empty means the swap chain format.
+        std::vector<VkFormat> color_formats;
+        VkFormat depth_format = VK_FORMAT_UNDEFINED;
+        // Must match the attachments' sample count; see VulkanDevice::choose_sample_count().
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    };
+
+    enum class PipelineBlendMode { OPAQUE, ALPHA, PREMULTIPLIED_ALPHA, ADDITIVE };
+
+    // Fixed-function state and shaders of a graphics pipeline. The defaults describe the built-in triangle.
+    struct GraphicsPipelineDesc {
+        std::string vertex_shader = "assets/shaders/basic.vert.spv";
+        std::string fragment_shader = "assets/shaders/basic.frag.spv";
+        // Setting mesh_shader (needs DeviceCapabilities::mesh_shader) replaces the vertex shader and vertex input
+        // with an optional task shader and a mesh shader.
+        std::string task_shader;
+        std::string mesh_shader;
+        std::vector<VkVertexInputBindingDescription> vertex_bindings;
+        std::vector<VkVertexInputAttributeDescription> vertex_attributes;
+        VkCullModeFlags cull_mode = VK_CULL_MODE_BACK_BIT;
+        VkFrontFace front_face = VK_FRONT_FACE_CLOCKWISE;
+        PipelineBlendMode blend_mode = PipelineBlendMode::OPAQUE;
+        // Depth state is only applied when formats.depth_format is set.
+        bool depth_test = true;
+        bool depth_write = true;
+        VkCompareOp depth_compare = VK_COMPARE_OP_LESS_OR_EQUAL;
+        PipelineAttachmentFormats formats;
+        // When set, the program's stages replace the shader paths above, and its reflected vertex inputs fill the
+        // vertex input when vertex_bindings is empty. Only read during construction.
+        const PyroShaderProgram *program = nullptr;
+        // Applied to every stage; see ShaderPermutationSpace.
+        const VkSpecializationInfo *specialization = nullptr;
+        VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+    };
 
     class Pyropipeline {
     public:
-        Pyropipeline(VulkanDevice *device);
+        explicit Pyropipeline(VulkanDevice *device, const std::vector<VkDescriptorSetLayout> &set_layouts = {},
+                              const std::vector<VkPushConstantRange> &push_constant_ranges = {},
+                              GraphicsPipelineDesc desc = {});
+        // Layout, stages and vertex input all come from the program's reflection.
+        Pyropipeline(VulkanDevice *device, const PyroShaderProgram &program, GraphicsPipelineDesc desc = {});
         ~Pyropipeline();
         std::vector<VkDynamicState> get_dynamic_states() const { return dynamic_states; }
         VkPipelineLayout get_pipeline_layout() const { return pipeline_layout; }
         VulkanDevice *get_device() const { return device; }
-        VkRenderPass get_render_pass() const { return render_pass; }
         VkPipeline get_pipeline() const { return pipeline; }
-        std::vector<VkFramebuffer> get_swap_chain_framebuffers() const { return swap_chain_framebuffers; }
+        const PipelineAttachmentFormats &get_attachment_formats() const { return formats; }
 
     private:
         const std::vector<VkDynamicState> dynamic_states = {
@@ -26,9 +70,8 @@ namespace pyro {
         };
         VkPipelineLayout pipeline_layout;
         VulkanDevice *device;
-        VkRenderPass render_pass;
         VkPipeline pipeline;
-        std::vector<VkFramebuffer> swap_chain_framebuffers;
+        PipelineAttachmentFormats formats;
     };
 
 } // namespace pyro
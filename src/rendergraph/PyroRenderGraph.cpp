@@ -0,0 +1,523 @@
+//
+// Created by srijan on 2/22/25.
+//
+
+#include "PyroRenderGraph.hpp"
+
+#include <algorithm>
+
+#include "../profiler/PyroTrace.hpp"
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        struct AccessInfo {
+            VkPipelineStageFlags2 stages;
+            VkAccessFlags2 read_access;
+            VkAccessFlags2 write_access;
+            VkImageLayout layout;
+            VkImageUsageFlags usage;
+        };
+
+        constexpr VkPipelineStageFlags2 GRAPHICS_SHADER_STAGES =
+                VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        constexpr VkPipelineStageFlags2 FRAGMENT_TEST_STAGES =
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+
+        AccessInfo access_info(const ResourceAccess access) {
+            switch (access) {
+                case ResourceAccess::COLOR_ATTACHMENT:
+                    return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT,
+                            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT};
+                case ResourceAccess::DEPTH_ATTACHMENT:
+                    return {FRAGMENT_TEST_STAGES, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+                case ResourceAccess::DEPTH_READ:
+                    return {FRAGMENT_TEST_STAGES, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_2_NONE,
+                            VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+                case ResourceAccess::SAMPLED_GRAPHICS:
+                    return {GRAPHICS_SHADER_STAGES, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_ACCESS_2_NONE,
+                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT};
+                case ResourceAccess::SAMPLED_COMPUTE:
+                    return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                            VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT};
+                case ResourceAccess::STORAGE_GRAPHICS:
+                    return {GRAPHICS_SHADER_STAGES, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT};
+                case ResourceAccess::STORAGE_COMPUTE:
+                    return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT};
+                case ResourceAccess::TRANSFER_SRC:
+                    return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_ACCESS_2_NONE,
+                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+                case ResourceAccess::TRANSFER_DST:
+                    return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_NONE, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+                case ResourceAccess::INDIRECT_BUFFER:
+                    return {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+                            VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED, 0};
+                case ResourceAccess::VERTEX_BUFFER:
+                    return {VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+                            VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED, 0};
+                case ResourceAccess::INDEX_BUFFER:
+                    return {VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT, VK_ACCESS_2_NONE,
+                            VK_IMAGE_LAYOUT_UNDEFINED, 0};
+                case ResourceAccess::UNIFORM_BUFFER:
+                    return {GRAPHICS_SHADER_STAGES | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                            VK_ACCESS_2_UNIFORM_READ_BIT, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED, 0};
+            }
+            return {};
+        }
+    } // namespace
+
+    RenderResource RenderPassBuilder::create_image(const std::string &name, const TransientImageDesc &desc) const {
+        PyroRenderGraph::Resource resource;
+        resource.name = name;
+        resource.desc = desc;
+        graph->resources.push_back(resource);
+        return static_cast<RenderResource>(graph->resources.size() - 1);
+    }
+
+    void RenderPassBuilder::read(const RenderResource resource, const ResourceAccess access) const {
+        graph->use(pass, resource, access, true, false);
+    }
+
+    void RenderPassBuilder::write(const RenderResource resource, const ResourceAccess access) const {
+        graph->use(pass, resource, access, false, true);
+    }
+
+    void RenderPassBuilder::read_write(const RenderResource resource, const ResourceAccess access) const {
+        graph->use(pass, resource, access, true, true);
+    }
+
+    void RenderPassBuilder::side_effect() const { graph->passes[pass].side_effect = true; }
+
+    VkImage RenderPassContext::get_image(const RenderResource resource) const {
+        return graph->resources[resource].image;
+    }
+
+    VkImageView RenderPassContext::get_view(const RenderResource resource) const {
+        return graph->resources[resource].view;
+    }
+
+    VkBuffer RenderPassContext::get_buffer(const RenderResource resource) const {
+        return graph->resources[resource].vk_buffer;
+    }
+
+    VkExtent2D RenderPassContext::get_extent(const RenderResource resource) const {
+        return graph->resources[resource].desc.extent;
+    }
+
+    VkFormat RenderPassContext::get_format(const RenderResource resource) const {
+        return graph->resources[resource].desc.format;
+    }
+
+    void RenderPassContext::begin_rendering(const std::vector<RenderingAttachment> &color_attachments,
+                                            const RenderingAttachment &depth_attachment,
+                                            const VkExtent2D render_extent) const {
+        const auto attachment_info = [&](const RenderingAttachment &attachment) {
+            const PyroRenderGraph::Resource &resource = graph->resources[attachment.resource];
+            VkRenderingAttachmentInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            info.imageView = resource.view;
+            info.imageLayout = resource.layout;
+            info.resolveMode = VK_RESOLVE_MODE_NONE;
+            if (attachment.resolve != INVALID_RENDER_RESOURCE) {
+                const PyroRenderGraph::Resource &target = graph->resources[attachment.resolve];
+                info.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+                info.resolveImageView = target.view;
+                info.resolveImageLayout = target.layout;
+            }
+            info.loadOp = attachment.load_op;
+            info.storeOp = attachment.store_op;
+            info.clearValue = attachment.clear_value;
+            return info;
+        };
+        std::vector<VkRenderingAttachmentInfo> colors;
+        colors.reserve(color_attachments.size());
+        for (const auto &attachment: color_attachments) {
+            colors.push_back(attachment_info(attachment));
+        }
+        const bool has_depth = depth_attachment.resource != INVALID_RENDER_RESOURCE;
+        const VkRenderingAttachmentInfo depth = has_depth ? attachment_info(depth_attachment)
+                                                          : VkRenderingAttachmentInfo{};
+        const RenderResource first = color_attachments.empty() ? depth_attachment.resource
+                                                               : color_attachments.front().resource;
+        const VkExtent2D extent = render_extent.width > 0 && render_extent.height > 0 ? render_extent
+                                                                                       : get_extent(first);
+
+        VkRenderingInfo rendering_info{};
+        rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        rendering_info.renderArea = {{0, 0}, extent};
+        rendering_info.layerCount = 1;
+        rendering_info.colorAttachmentCount = static_cast<uint32_t>(colors.size());
+        rendering_info.pColorAttachments = colors.data();
+        rendering_info.pDepthAttachment = has_depth ? &depth : nullptr;
+        vkCmdBeginRendering(command_buffer, &rendering_info);
+
+        const VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height),
+                                  0.0f, 1.0f};
+        vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+        const VkRect2D scissor{{0, 0}, extent};
+        vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+    }
+
+    void RenderPassContext::end_rendering() const { vkCmdEndRendering(command_buffer); }
+
+    PyroRenderGraph::PyroRenderGraph(VulkanDevice *device) : device(device), transients(device) {
+        ASSERT_EQUAL(device->get_capabilities().synchronization2, true, "The render graph needs synchronization2")
+    }
+
+    void PyroRenderGraph::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        passes.clear();
+        resources.clear();
+        transient_images = nullptr;
+        transient_owners.clear();
+        stats = {};
+    }
+
+    RenderResource PyroRenderGraph::import_image(const std::string &name, const ImportedImage &image) {
+        Resource resource;
+        resource.name = name;
+        resource.imported = true;
+        resource.desc = {image.extent, image.format, image.aspect, image.mip_levels, VK_SAMPLE_COUNT_1_BIT};
+        resource.image = image.image;
+        resource.view = image.view;
+        resource.final_layout = image.final_layout;
+        resource.layout = image.initial_layout;
+        resource.write_stages = image.initial_stages;
+        resource.write_access = image.initial_access;
+        resources.push_back(resource);
+        return static_cast<RenderResource>(resources.size() - 1);
+    }
+
+    RenderResource PyroRenderGraph::import_buffer(const std::string &name, const VkBuffer buffer) {
+        Resource resource;
+        resource.name = name;
+        resource.imported = true;
+        resource.buffer = true;
+        resource.vk_buffer = buffer;
+        resources.push_back(resource);
+        return static_cast<RenderResource>(resources.size() - 1);
+    }
+
+    void PyroRenderGraph::add_pass(const std::string &name, const SetupCallback &setup, ExecuteCallback execute) {
+        Pass pass;
+        pass.name = name;
+        pass.execute = std::move(execute);
+        passes.push_back(std::move(pass));
+        RenderPassBuilder builder(this, static_cast<uint32_t>(passes.size() - 1));
+        setup(builder);
+    }
+
+    void PyroRenderGraph::use(const uint32_t pass, const RenderResource resource, const ResourceAccess access,
+                              const bool read, const bool write) {
+        ASSERT_EQUAL(resource < resources.size(), true, "Unknown render graph resource")
+        Resource &target = resources[resource];
+        const AccessInfo info = access_info(access);
+        ASSERT_EQUAL(target.buffer, info.usage == 0, "Resource access doesn't match the resource type")
+        target.usage |= info.usage;
+        passes[pass].uses.push_back({resource, access, read, write});
+    }
+
+    std::vector<uint32_t> PyroRenderGraph::cull() const {
+        // Walk backwards from what is observable outside the graph: imported resources and side effects. A pass
+        // survives if it writes something a surviving later pass (or the outside) still needs.
+        std::vector<bool> needed(resources.size());
+        for (size_t i = 0; i < resources.size(); i++) {
+            needed[i] = resources[i].imported;
+        }
+        std::vector<uint32_t> alive;
+        for (size_t p = passes.size(); p-- > 0;) {
+            const Pass &pass = passes[p];
+            bool keep = pass.side_effect;
+            for (const auto &use: pass.uses) {
+                keep = keep || (use.write && needed[use.resource]);
+            }
+            if (!keep) {
+                continue;
+            }
+            alive.push_back(static_cast<uint32_t>(p));
+            for (const auto &use: pass.uses) {
+                if (use.write && !use.read) {
+                    needed[use.resource] = false;
+                }
+            }
+            for (const auto &use: pass.uses) {
+                if (use.read) {
+                    needed[use.resource] = true;
+                }
+            }
+        }
+        std::ranges::reverse(alive);
+        return alive;
+    }
+
+    std::vector<uint32_t> PyroRenderGraph::sort(const std::vector<uint32_t> &alive) const {
+        // Dependency edges follow declaration order: read-after-write, write-after-write and write-after-read.
+        std::vector<std::vector<uint32_t>> successors(passes.size());
+        std::vector<uint32_t> indegree(passes.size(), 0);
+        const auto add_edge = [&](const uint32_t from, const uint32_t to) {
+            if (from != to && std::ranges::find(successors[from], to) == successors[from].end()) {
+                successors[from].push_back(to);
+                indegree[to]++;
+            }
+        };
+        std::vector<uint32_t> last_writer(resources.size(), UINT32_MAX);
+        std::vector<std::vector<uint32_t>> readers(resources.size());
+        for (const uint32_t p: alive) {
+            for (const auto &use: passes[p].uses) {
+                if (last_writer[use.resource] != UINT32_MAX) {
+                    add_edge(last_writer[use.resource], p);
+                }
+                if (use.write) {
+                    for (const uint32_t reader: readers[use.resource]) {
+                        add_edge(reader, p);
+                    }
+                }
+            }
+            for (const auto &use: passes[p].uses) {
+                if (use.write) {
+                    last_writer[use.resource] = p;
+                    readers[use.resource].clear();
+                } else {
+                    readers[use.resource].push_back(p);
+                }
+            }
+        }
+
+        // Kahn's algorithm. Among ready passes, prefer one that doesn't depend on the pass just scheduled, so
+        // producers and consumers drift apart and the GPU has independent work to overlap with each barrier.
+        std::vector<uint32_t> ready;
+        for (const uint32_t p: alive) {
+            if (indegree[p] == 0) {
+                ready.push_back(p);
+            }
+        }
+        std::vector<uint32_t> order;
+        order.reserve(alive.size());
+        while (!ready.empty()) {
+            auto pick = ready.begin();
+            if (!order.empty()) {
+                const std::vector<uint32_t> &previous = successors[order.back()];
+                const auto independent = std::ranges::find_if(ready, [&](const uint32_t p) {
+                    return std::ranges::find(previous, p) == previous.end();
+                });
+                if (independent != ready.end()) {
+                    pick = independent;
+                }
+            }
+            const uint32_t p = *pick;
+            ready.erase(pick);
+            order.push_back(p);
+            for (const uint32_t next: successors[p]) {
+                if (--indegree[next] == 0) {
+                    ready.insert(std::ranges::upper_bound(ready, next), next);
+                }
+            }
+        }
+        return order;
+    }
+
+    void PyroRenderGraph::allocate_transients(const std::vector<uint32_t> &order) {
+        for (uint32_t position = 0; position < order.size(); position++) {
+            for (const auto &use: passes[order[position]].uses) {
+                Resource &resource = resources[use.resource];
+                resource.first_pass = std::min(resource.first_pass, position);
+                resource.last_pass = std::max(resource.last_pass, position);
+            }
+        }
+        std::vector<TransientImageRequest> requests;
+        std::vector<RenderResource> owners;
+        constexpr VkImageUsageFlags ATTACHMENT_USAGE =
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        for (RenderResource r = 0; r < resources.size(); r++) {
+            Resource &resource = resources[r];
+            if (resource.imported || resource.first_pass == UINT32_MAX) {
+                continue;
+            }
+            VkImageUsageFlags usage = resource.usage;
+            // Nothing after the pass reads it, so it never has to leave tile memory.
+            if (resource.first_pass == resource.last_pass && !(usage & ~ATTACHMENT_USAGE)) {
+                usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+            }
+            resource.transient_index = static_cast<uint32_t>(requests.size());
+            requests.push_back({resource.desc, usage, resource.first_pass, resource.last_pass});
+            owners.push_back(r);
+        }
+        transient_images = &transients.acquire(frame_index, requests);
+        for (size_t i = 0; i < owners.size(); i++) {
+            resources[owners[i]].image = (*transient_images)[i].image;
+            resources[owners[i]].view = (*transient_images)[i].view;
+        }
+        stats.transient_images = static_cast<uint32_t>(requests.size());
+        stats.transient_requested_bytes = transients.get_requested_bytes(frame_index);
+        stats.transient_allocated_bytes = transients.get_allocated_bytes(frame_index);
+        stats.transient_attachments = 0;
+        stats.transient_attachment_bytes = 0;
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (requests[i].usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) {
+                stats.transient_attachments++;
+                stats.transient_attachment_bytes += (*transient_images)[i].size;
+            }
+        }
+        stats.lazy_bytes = transients.get_lazy_bytes(frame_index);
+        stats.lazy_committed_bytes = transients.get_lazy_committed_bytes(frame_index);
+        transient_owners = std::move(owners);
+    }
+
+    void PyroRenderGraph::record_barriers(const VkCommandBuffer command_buffer, const Pass &pass) {
+        std::vector<VkImageMemoryBarrier2> image_barriers;
+        std::vector<VkBufferMemoryBarrier2> buffer_barriers;
+        for (const auto &use: pass.uses) {
+            Resource &resource = resources[use.resource];
+            const AccessInfo info = access_info(use.access);
+            const VkAccessFlags2 dst_access = (use.read ? info.read_access : VK_ACCESS_2_NONE) |
+                                              (use.write ? info.write_access : VK_ACCESS_2_NONE);
+            const bool layout_change = !resource.buffer && resource.layout != info.layout;
+
+            VkPipelineStageFlags2 src_stages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 src_access = VK_ACCESS_2_NONE;
+            bool needs_barrier = layout_change;
+            if (use.write || layout_change) {
+                // Writes and layout transitions wait for the last write and every read since.
+                src_stages = resource.write_stages | resource.read_stages;
+                src_access = resource.write_access;
+                needs_barrier = needs_barrier || src_stages != VK_PIPELINE_STAGE_2_NONE;
+            } else if (resource.write_stages != VK_PIPELINE_STAGE_2_NONE &&
+                       ((info.stages & ~resource.read_stages) || (dst_access & ~resource.read_access))) {
+                // Reads wait for the last write unless an earlier barrier already made it visible to them.
+                src_stages = resource.write_stages;
+                src_access = resource.write_access;
+                needs_barrier = true;
+            }
+            if (resource.transient_index != UINT32_MAX && resource.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+                // First use of an aliased image: whatever occupied its memory before must be done with it.
+                for (const uint32_t predecessor: (*transient_images)[resource.transient_index].predecessors) {
+                    const Resource &previous = resources[transient_owners[predecessor]];
+                    src_stages |= previous.write_stages | previous.read_stages;
+                    src_access |= previous.write_access;
+                }
+            }
+
+            if (needs_barrier) {
+                if (resource.buffer) {
+                    VkBufferMemoryBarrier2 barrier{};
+                    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+                    barrier.srcStageMask = src_stages;
+                    barrier.srcAccessMask = src_access;
+                    barrier.dstStageMask = info.stages;
+                    barrier.dstAccessMask = dst_access;
+                    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                    barrier.buffer = resource.vk_buffer;
+                    barrier.offset = 0;
+                    barrier.size = VK_WHOLE_SIZE;
+                    buffer_barriers.push_back(barrier);
+                } else {
+                    VkImageMemoryBarrier2 barrier{};
+                    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+                    barrier.srcStageMask = src_stages;
+                    barrier.srcAccessMask = src_access;
+                    barrier.dstStageMask = info.stages;
+                    barrier.dstAccessMask = dst_access;
+                    barrier.oldLayout = resource.layout;
+                    barrier.newLayout = info.layout;
+                    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                    barrier.image = resource.image;
+                    barrier.subresourceRange = {resource.desc.aspect, 0, resource.desc.mip_levels, 0, 1};
+                    image_barriers.push_back(barrier);
+                }
+            }
+
+            if (use.write) {
+                resource.write_stages = info.stages;
+                resource.write_access = info.write_access;
+                resource.read_stages = VK_PIPELINE_STAGE_2_NONE;
+                resource.read_access = VK_ACCESS_2_NONE;
+            } else if (layout_change) {
+                // Later accesses chain through this barrier, which performed the transition and already made
+                // the previous write available, so there is no write access left to pair with these stages.
+                resource.write_stages = info.stages;
+                resource.write_access = VK_ACCESS_2_NONE;
+                resource.read_stages = info.stages;
+                resource.read_access = dst_access;
+            } else {
+                resource.read_stages |= info.stages;
+                resource.read_access |= dst_access;
+            }
+            if (!resource.buffer) {
+                resource.layout = info.layout;
+            }
+        }
+        flush_barriers(command_buffer, image_barriers, buffer_barriers);
+    }
+
+    void PyroRenderGraph::record_final_transitions(const VkCommandBuffer command_buffer) {
+        std::vector<VkImageMemoryBarrier2> image_barriers;
+        for (auto &resource: resources) {
+            if (!resource.imported || resource.buffer || resource.final_layout == VK_IMAGE_LAYOUT_UNDEFINED ||
+                resource.final_layout == resource.layout) {
+                continue;
+            }
+            VkImageMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = resource.write_stages | resource.read_stages;
+            barrier.srcAccessMask = resource.write_access;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+            barrier.dstAccessMask = VK_ACCESS_2_NONE;
+            barrier.oldLayout = resource.layout;
+            barrier.newLayout = resource.final_layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = resource.image;
+            barrier.subresourceRange = {resource.desc.aspect, 0, resource.desc.mip_levels, 0, 1};
+            image_barriers.push_back(barrier);
+            resource.layout = resource.final_layout;
+        }
+        flush_barriers(command_buffer, image_barriers, {});
+    }
+
+    void PyroRenderGraph::flush_barriers(const VkCommandBuffer command_buffer,
+                                         const std::vector<VkImageMemoryBarrier2> &image_barriers,
+                                         const std::vector<VkBufferMemoryBarrier2> &buffer_barriers) {
+        if (image_barriers.empty() && buffer_barriers.empty()) {
+            return;
+        }
+        VkDependencyInfo dependency_info{};
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.bufferMemoryBarrierCount = static_cast<uint32_t>(buffer_barriers.size());
+        dependency_info.pBufferMemoryBarriers = buffer_barriers.data();
+        dependency_info.imageMemoryBarrierCount = static_cast<uint32_t>(image_barriers.size());
+        dependency_info.pImageMemoryBarriers = image_barriers.data();
+        vkCmdPipelineBarrier2(command_buffer, &dependency_info);
+        stats.barrier_batches++;
+        stats.image_barriers += static_cast<uint32_t>(image_barriers.size());
+        stats.buffer_barriers += static_cast<uint32_t>(buffer_barriers.size());
+    }
+
+    void PyroRenderGraph::execute(const VkCommandBuffer command_buffer) {
+        stats.declared_passes = static_cast<uint32_t>(passes.size());
+        std::vector<uint32_t> order;
+        {
+            PYRO_ZONE("graph_compile");
+            const std::vector<uint32_t> alive = cull();
+            stats.culled_passes = static_cast<uint32_t>(passes.size() - alive.size());
+            order = sort(alive);
+            allocate_transients(order);
+        }
+        PYRO_ZONE("graph_record");
+        for (const uint32_t p: order) {
+            record_barriers(command_buffer, passes[p]);
+            RenderPassContext context(this, command_buffer);
+            passes[p].execute(context);
+        }
+        record_final_transitions(command_buffer);
+    }
+} // namespace pyro
@@ -0,0 +1,212 @@
+//
+// Created by srijan on 2/22/25.
+//
+
+#ifndef PYRORENDERGRAPH_HPP
+#define PYRORENDERGRAPH_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+#include "PyroTransientPool.hpp"
+
+namespace pyro {
+
+    using RenderResource = uint32_t;
+    constexpr RenderResource INVALID_RENDER_RESOURCE = UINT32_MAX;
+
+    // How a pass touches a resource; each maps to the pipeline stages, access mask and image layout involved.
+    enum class ResourceAccess {
+        COLOR_ATTACHMENT,
+        DEPTH_ATTACHMENT,
+        DEPTH_READ,
+        SAMPLED_GRAPHICS,
+        SAMPLED_COMPUTE,
+        STORAGE_GRAPHICS,
+        STORAGE_COMPUTE,
+        TRANSFER_SRC,
+        TRANSFER_DST,
+        INDIRECT_BUFFER,
+        VERTEX_BUFFER,
+        INDEX_BUFFER,
+        UNIFORM_BUFFER,
+    };
+
+    struct ImportedImage {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkExtent2D extent{};
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        uint32_t mip_levels = 1;
+        // State when the graph starts. The stages should cover any semaphore wait guarding the image.
+        VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags2 initial_stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        VkAccessFlags2 initial_access = VK_ACCESS_2_NONE;
+        // Layout to leave the image in; UNDEFINED keeps the last pass's layout.
+        VkImageLayout final_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+    struct RenderGraphStats {
+        uint32_t declared_passes = 0;
+        uint32_t culled_passes = 0;
+        uint32_t barrier_batches = 0;
+        uint32_t image_barriers = 0;
+        uint32_t buffer_barriers = 0;
+        uint32_t transient_images = 0;
+        // Transient memory with one allocation per image versus what the aliased placement uses.
+        VkDeviceSize transient_requested_bytes = 0;
+        VkDeviceSize transient_allocated_bytes = 0;
+        // Attachments used by a single pass, created with TRANSIENT_ATTACHMENT usage. With storeOp DONT_CARE these
+        // bytes are never written out to memory.
+        uint32_t transient_attachments = 0;
+        VkDeviceSize transient_attachment_bytes = 0;
+        // The part of them in lazily allocated memory, and how much of that the driver actually committed.
+        VkDeviceSize lazy_bytes = 0;
+        VkDeviceSize lazy_committed_bytes = 0;
+    };
+
+    // One attachment of a dynamic rendering scope. The image must be declared by the pass as a COLOR_ATTACHMENT,
+    // DEPTH_ATTACHMENT or DEPTH_READ use; the layout comes from that declaration.
+    struct RenderingAttachment {
+        RenderResource resource = INVALID_RENDER_RESOURCE;
+        // Color only: a single-sampled image the multisampled attachment is averaged into at the end of rendering.
+        // The pass must declare it as a COLOR_ATTACHMENT write.
+        RenderResource resolve = INVALID_RENDER_RESOURCE;
+        VkAttachmentLoadOp load_op = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        VkAttachmentStoreOp store_op = VK_ATTACHMENT_STORE_OP_STORE;
+        VkClearValue clear_value{};
+    };
+
+    class PyroRenderGraph;
+
+    // Handed to a pass's setup callback to declare what it creates, reads and writes.
+    class RenderPassBuilder {
+    public:
+        RenderResource create_image(const std::string &name, const TransientImageDesc &desc) const;
+        void read(RenderResource resource, ResourceAccess access) const;
+        void write(RenderResource resource, ResourceAccess access) const;
+        // Both, for attachments that are loaded or blended and storage images updated in place.
+        void read_write(RenderResource resource, ResourceAccess access) const;
+        // Keeps the pass even when nothing reads its outputs (uploads, readbacks, debug output).
+        void side_effect() const;
+
+    private:
+        friend class PyroRenderGraph;
+        RenderPassBuilder(PyroRenderGraph *graph, uint32_t pass) : graph(graph), pass(pass) {}
+
+        PyroRenderGraph *graph;
+        uint32_t pass;
+    };
+
+    // Handed to a pass's execute callback; resolves resources to the Vulkan objects backing them this frame.
+    class RenderPassContext {
+    public:
+        VkCommandBuffer command_buffer;
+
+        VkImage get_image(RenderResource resource) const;
+        VkImageView get_view(RenderResource resource) const;
+        VkBuffer get_buffer(RenderResource resource) const;
+        VkExtent2D get_extent(RenderResource resource) const;
+        VkFormat get_format(RenderResource resource) const;
+
+        // vkCmdBeginRendering over the given attachments, with the render area, viewport and scissor set to the
+        // extent of the first one, or to the top-left `render_extent` of them when that is non-zero.
+        void begin_rendering(const std::vector<RenderingAttachment> &color_attachments,
+                             const RenderingAttachment &depth_attachment = {}, VkExtent2D render_extent = {}) const;
+        void end_rendering() const;
+
+    private:
+        friend class PyroRenderGraph;
+        RenderPassContext(const PyroRenderGraph *graph, const VkCommandBuffer command_buffer) :
+            command_buffer(command_buffer), graph(graph) {}
+
+        const PyroRenderGraph *graph;
+    };
+
+    // Frame graph rebuilt every frame: passes declare the resources they use, then execute() culls passes whose
+    // results nobody consumes, orders the rest topologically, places transient images in aliased memory and
+    // records each pass behind a single batched vkCmdPipelineBarrier2 covering every hazard and layout
+    // transition it needs. Images created and consumed by one attachment-only pass, such as depth or MSAA color
+    // that gets resolved, are made TRANSIENT_ATTACHMENT so they can live in lazily allocated memory.
+    class PyroRenderGraph {
+    public:
+        using SetupCallback = std::function<void(RenderPassBuilder &)>;
+        using ExecuteCallback = std::function<void(RenderPassContext &)>;
+
+        explicit PyroRenderGraph(VulkanDevice *device);
+        PyroRenderGraph(const PyroRenderGraph &) = delete;
+        PyroRenderGraph &operator=(const PyroRenderGraph &) = delete;
+
+        // Clears the previous frame's passes and resources. The slot's previous frame must have completed.
+        void begin_frame(uint32_t frame_index);
+        RenderResource import_image(const std::string &name, const ImportedImage &image);
+        RenderResource import_buffer(const std::string &name, VkBuffer buffer);
+        void add_pass(const std::string &name, const SetupCallback &setup, ExecuteCallback execute);
+        void execute(VkCommandBuffer command_buffer);
+
+        const RenderGraphStats &get_stats() const { return stats; }
+
+    private:
+        friend class RenderPassBuilder;
+        friend class RenderPassContext;
+
+        struct ResourceUse {
+            RenderResource resource;
+            ResourceAccess access;
+            bool read;
+            bool write;
+        };
+        struct Pass {
+            std::string name;
+            std::vector<ResourceUse> uses;
+            ExecuteCallback execute;
+            bool side_effect = false;
+        };
+        struct Resource {
+            std::string name;
+            bool imported = false;
+            bool buffer = false;
+            TransientImageDesc desc;
+            VkImageUsageFlags usage = 0;
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            VkBuffer vk_buffer = VK_NULL_HANDLE;
+            VkImageLayout final_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            uint32_t first_pass = UINT32_MAX;
+            uint32_t last_pass = 0;
+            uint32_t transient_index = UINT32_MAX;
+            // Hazard tracking while recording: the last write and the reads that have seen it since.
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags2 write_stages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 write_access = VK_ACCESS_2_NONE;
+            VkPipelineStageFlags2 read_stages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 read_access = VK_ACCESS_2_NONE;
+        };
+
+        VulkanDevice *device;
+        PyroTransientPool transients;
+        uint32_t frame_index = 0;
+        std::vector<Pass> passes;
+        std::vector<Resource> resources;
+        // Backing images from the pool, and the resource each one belongs to.
+        const std::vector<TransientImage> *transient_images = nullptr;
+        std::vector<RenderResource> transient_owners;
+        RenderGraphStats stats;
+
+        void use(uint32_t pass, RenderResource resource, ResourceAccess access, bool read, bool write);
+        std::vector<uint32_t> cull() const;
+        std::vector<uint32_t> sort(const std::vector<uint32_t> &alive) const;
+        void allocate_transients(const std::vector<uint32_t> &order);
+        void record_barriers(VkCommandBuffer command_buffer, const Pass &pass);
+        void record_final_transitions(VkCommandBuffer command_buffer);
+        void flush_barriers(VkCommandBuffer command_buffer, const std::vector<VkImageMemoryBarrier2> &image_barriers,
+                            const std::vector<VkBufferMemoryBarrier2> &buffer_barriers);
+    };
+
+} // namespace pyro
+
+#endif // PYRORENDERGRAPH_HPP
@@ -0,0 +1,235 @@
+//
+// Created by srijan on 2/22/25.
+//
+
+#include "PyroTransientPool.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        bool same_request(const TransientImageRequest &a, const TransientImageRequest &b) {
+            return a.desc.extent.width == b.desc.extent.width && a.desc.extent.height == b.desc.extent.height &&
+                   a.desc.format == b.desc.format && a.desc.aspect == b.desc.aspect &&
+                   a.desc.mip_levels == b.desc.mip_levels && a.desc.samples == b.desc.samples &&
+                   a.usage == b.usage && a.first_pass == b.first_pass && a.last_pass == b.last_pass;
+        }
+
+        bool lifetimes_overlap(const TransientImageRequest &a, const TransientImageRequest &b) {
+            return a.first_pass <= b.last_pass && b.first_pass <= a.last_pass;
+        }
+
+        bool ranges_overlap(const VkDeviceSize a_offset, const VkDeviceSize a_size, const VkDeviceSize b_offset,
+                            const VkDeviceSize b_size) {
+            return a_offset < b_offset + b_size && b_offset < a_offset + a_size;
+        }
+
+        VkDeviceSize align_up(const VkDeviceSize value, const VkDeviceSize alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        VkDeviceMemory allocate(const VkDevice device, const VkDeviceSize size, const uint32_t type) {
+            VkMemoryAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            alloc_info.allocationSize = size;
+            alloc_info.memoryTypeIndex = type;
+            VkDeviceMemory memory;
+            ASSERT_EQUAL(vkAllocateMemory(device, &alloc_info, nullptr, &memory), VK_SUCCESS,
+                         "Failed to allocate transient memory")
+            return memory;
+        }
+    } // namespace
+
+    PyroTransientPool::PyroTransientPool(VulkanDevice *device) : device(device) {}
+
+    PyroTransientPool::~PyroTransientPool() {
+        for (auto &slot: slots) {
+            release(slot);
+        }
+    }
+
+    const std::vector<TransientImage> &PyroTransientPool::acquire(const uint32_t frame_index,
+                                                                  const std::vector<TransientImageRequest> &requests) {
+        Slot &slot = slots[frame_index];
+        if (slot.requests.size() == requests.size() &&
+            std::equal(requests.begin(), requests.end(), slot.requests.begin(), same_request)) {
+            return slot.images;
+        }
+        release(slot);
+        slot.requests = requests;
+        build(slot);
+        if (!requests.empty()) {
+            LOG(LogLevel::INFO, "Render graph transients: {} images, {} KiB aliased into {} KiB, {} KiB lazy",
+                requests.size(), slot.requested_bytes / 1024, slot.allocated_bytes / 1024, slot.lazy_bytes / 1024);
+        }
+        return slot.images;
+    }
+
+    VkDeviceSize PyroTransientPool::get_lazy_committed_bytes(const uint32_t frame_index) const {
+        VkDeviceSize committed = 0;
+        for (const VkDeviceMemory memory: slots[frame_index].lazy_memories) {
+            VkDeviceSize bytes = 0;
+            vkGetDeviceMemoryCommitment(device->get_logical_device(), memory, &bytes);
+            committed += bytes;
+        }
+        return committed;
+    }
+
+    void PyroTransientPool::build(Slot &slot) const {
+        const VkDevice logical_device = device->get_logical_device();
+        const size_t count = slot.requests.size();
+        slot.images.assign(count, {});
+        std::vector<VkMemoryRequirements> requirements(count);
+        for (size_t i = 0; i < count; i++) {
+            const TransientImageRequest &request = slot.requests[i];
+            VkImageCreateInfo image_info{};
+            image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            image_info.imageType = VK_IMAGE_TYPE_2D;
+            image_info.format = request.desc.format;
+            image_info.extent = {request.desc.extent.width, request.desc.extent.height, 1};
+            image_info.mipLevels = request.desc.mip_levels;
+            image_info.arrayLayers = 1;
+            image_info.samples = request.desc.samples;
+            image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+            image_info.usage = request.usage;
+            image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            ASSERT_EQUAL(vkCreateImage(logical_device, &image_info, nullptr, &slot.images[i].image), VK_SUCCESS,
+                         "Failed to create transient image")
+            vkGetImageMemoryRequirements(logical_device, slot.images[i].image, &requirements[i]);
+            slot.images[i].size = requirements[i].size;
+        }
+
+        // Lazily allocated images stay out of the aliased allocation: their memory type differs, and memory that
+        // is never committed has nothing to gain from sharing.
+        slot.lazy_bytes = 0;
+        std::vector<bool> lazy(count, false);
+        for (size_t i = 0; i < count; i++) {
+            if (!(slot.requests[i].usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)) {
+                continue;
+            }
+            const std::optional<uint32_t> type = device->find_memory_type(requirements[i].memoryTypeBits,
+                                                                          VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+            if (!type.has_value()) {
+                continue;
+            }
+            lazy[i] = true;
+            const VkDeviceMemory memory = allocate(logical_device, requirements[i].size, type.value());
+            slot.lazy_memories.push_back(memory);
+            slot.lazy_bytes += requirements[i].size;
+            vkBindImageMemory(logical_device, slot.images[i].image, memory, 0);
+        }
+
+        // One device-local type every image accepts; without one, each image gets its own allocation.
+        uint32_t shared_type_bits = ~0u;
+        for (size_t i = 0; i < count; i++) {
+            if (!lazy[i]) {
+                shared_type_bits &= requirements[i].memoryTypeBits;
+            }
+        }
+        const std::optional<uint32_t> shared_type =
+                device->find_memory_type(shared_type_bits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        // Largest first, each at the lowest offset that doesn't collide with an image alive at the same time.
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::stable_sort(order, [&](const uint32_t a, const uint32_t b) {
+            return requirements[a].size > requirements[b].size;
+        });
+        std::vector<uint32_t> placed;
+        VkDeviceSize shared_size = 0;
+        slot.requested_bytes = 0;
+        slot.allocated_bytes = 0;
+        for (const uint32_t index: order) {
+            if (lazy[index]) {
+                continue;
+            }
+            slot.requested_bytes += requirements[index].size;
+            if (!shared_type.has_value()) {
+                continue;
+            }
+            VkDeviceSize offset = 0;
+            bool moved = true;
+            while (moved) {
+                moved = false;
+                for (const uint32_t other: placed) {
+                    if (lifetimes_overlap(slot.requests[index], slot.requests[other]) &&
+                        ranges_overlap(offset, requirements[index].size, slot.images[other].offset,
+                                       slot.images[other].size)) {
+                        offset = align_up(slot.images[other].offset + slot.images[other].size,
+                                          requirements[index].alignment);
+                        moved = true;
+                    }
+                }
+            }
+            slot.images[index].offset = offset;
+            shared_size = std::max(shared_size, offset + requirements[index].size);
+            placed.push_back(index);
+        }
+
+        if (shared_type.has_value() && shared_size > 0) {
+            const VkDeviceMemory memory = allocate(logical_device, shared_size, shared_type.value());
+            slot.memories.push_back(memory);
+            slot.allocated_bytes += shared_size;
+            for (const uint32_t index: placed) {
+                vkBindImageMemory(logical_device, slot.images[index].image, memory, slot.images[index].offset);
+            }
+        } else if (!shared_type.has_value()) {
+            for (size_t i = 0; i < count; i++) {
+                if (lazy[i]) {
+                    continue;
+                }
+                const std::optional<uint32_t> type =
+                        device->find_memory_type(requirements[i].memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                ASSERT_EQUAL(type.has_value(), true, "No suitable memory type for transient image")
+                const VkDeviceMemory memory = allocate(logical_device, requirements[i].size, type.value());
+                slot.memories.push_back(memory);
+                slot.allocated_bytes += requirements[i].size;
+                vkBindImageMemory(logical_device, slot.images[i].image, memory, 0);
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            TransientImage &image = slot.images[i];
+            for (const uint32_t other: placed) {
+                if (!lazy[i] && slot.requests[other].last_pass < slot.requests[i].first_pass &&
+                    ranges_overlap(image.offset, image.size, slot.images[other].offset, slot.images[other].size)) {
+                    image.predecessors.push_back(other);
+                }
+            }
+            const TransientImageDesc &desc = slot.requests[i].desc;
+            VkImageViewCreateInfo view_info{};
+            view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            view_info.image = image.image;
+            view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            view_info.format = desc.format;
+            view_info.subresourceRange = {desc.aspect, 0, desc.mip_levels, 0, 1};
+            ASSERT_EQUAL(vkCreateImageView(logical_device, &view_info, nullptr, &image.view), VK_SUCCESS,
+                         "Failed to create transient image view")
+        }
+    }
+
+    void PyroTransientPool::release(Slot &slot) const {
+        const VkDevice logical_device = device->get_logical_device();
+        for (const auto &image: slot.images) {
+            vkDestroyImageView(logical_device, image.view, nullptr);
+            vkDestroyImage(logical_device, image.image, nullptr);
+        }
+        for (const VkDeviceMemory memory: slot.memories) {
+            vkFreeMemory(logical_device, memory, nullptr);
+        }
+        for (const VkDeviceMemory memory: slot.lazy_memories) {
+            vkFreeMemory(logical_device, memory, nullptr);
+        }
+        slot.requests.clear();
+        slot.images.clear();
+        slot.memories.clear();
+        slot.lazy_memories.clear();
+        slot.requested_bytes = 0;
+        slot.allocated_bytes = 0;
+        slot.lazy_bytes = 0;
+    }
+} // namespace pyro
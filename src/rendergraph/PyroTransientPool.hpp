@@ -0,0 +1,86 @@
+//
+// Created by srijan on 2/22/25.
+//
+
+#ifndef PYROTRANSIENTPOOL_HPP
+#define PYROTRANSIENTPOOL_HPP
+
+#include <array>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanDevice.hpp"
+
+namespace pyro {
+
+    struct TransientImageDesc {
+        VkExtent2D extent{};
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        uint32_t mip_levels = 1;
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    };
+
+    // One transient image of a compiled graph. Lifetimes are positions in the pass execution order, inclusive.
+    struct TransientImageRequest {
+        TransientImageDesc desc;
+        VkImageUsageFlags usage = 0;
+        uint32_t first_pass = 0;
+        uint32_t last_pass = 0;
+    };
+
+    struct TransientImage {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        // Earlier images sharing some of this one's memory; their last accesses must finish before its first.
+        std::vector<uint32_t> predecessors;
+    };
+
+    // Backing memory for render graph transients. Images whose lifetimes don't overlap are placed at overlapping
+    // offsets of one allocation per frame slot, so the slot needs only the peak of the live set rather than the
+    // sum of every intermediate target. The placement is kept while the requests stay the same, which is the
+    // steady state for a graph rebuilt every frame.
+    //
+    // Requests with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT get lazily allocated memory of their own where the
+    // device has it (tile-based GPUs), which is only committed if the attachment ever leaves tile memory.
+    class PyroTransientPool {
+    public:
+        explicit PyroTransientPool(VulkanDevice *device);
+        ~PyroTransientPool();
+        PyroTransientPool(const PyroTransientPool &) = delete;
+        PyroTransientPool &operator=(const PyroTransientPool &) = delete;
+
+        // The slot's previous frame must have completed. The result is indexed like `requests`.
+        const std::vector<TransientImage> &acquire(uint32_t frame_index,
+                                                   const std::vector<TransientImageRequest> &requests);
+
+        // Sum of the aliased image sizes, i.e. what separate allocations would have cost.
+        VkDeviceSize get_requested_bytes(uint32_t frame_index) const { return slots[frame_index].requested_bytes; }
+        VkDeviceSize get_allocated_bytes(uint32_t frame_index) const { return slots[frame_index].allocated_bytes; }
+        // Size of the lazily allocated images, which allocated_bytes leaves out, and how much of it is committed.
+        VkDeviceSize get_lazy_bytes(uint32_t frame_index) const { return slots[frame_index].lazy_bytes; }
+        VkDeviceSize get_lazy_committed_bytes(uint32_t frame_index) const;
+
+    private:
+        struct Slot {
+            std::vector<TransientImageRequest> requests;
+            std::vector<TransientImage> images;
+            std::vector<VkDeviceMemory> memories;
+            std::vector<VkDeviceMemory> lazy_memories;
+            VkDeviceSize requested_bytes = 0;
+            VkDeviceSize allocated_bytes = 0;
+            VkDeviceSize lazy_bytes = 0;
+        };
+
+        VulkanDevice *device;
+        std::array<Slot, MAX_FRAMES_IN_FLIGHT> slots;
+
+        void build(Slot &slot) const;
+        void release(Slot &slot) const;
+    };
+
+} // namespace pyro
+
+#endif // PYROTRANSIENTPOOL_HPP
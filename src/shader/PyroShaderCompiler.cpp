@@ -0,0 +1,294 @@
+//
+// Created by srijan on 3/10/25.
+//
+
+#include "PyroShaderCompiler.hpp"
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#ifdef PYRO_SHADERC
+#include <atomic>
+#include <shaderc/shaderc.hpp>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#endif
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr const char *SHADER_ASSET_DIR = "assets/shaders";
+        constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+        // Empty unless the whole file is a SPIR-V module, so a damaged cache entry reads as a miss.
+        std::vector<uint32_t> read_words(const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file.is_open()) {
+                return {};
+            }
+            const auto size = static_cast<size_t>(file.tellg());
+            if (size == 0 || size % sizeof(uint32_t) != 0) {
+                return {};
+            }
+            std::vector<uint32_t> words(size / sizeof(uint32_t));
+            file.seekg(0);
+            file.read(reinterpret_cast<char *>(words.data()), static_cast<std::streamsize>(size));
+            return file && words[0] == SPIRV_MAGIC ? words : std::vector<uint32_t>{};
+        }
+
+#ifdef PYRO_SHADERC
+        // Bump when the compile options change, so stale entries miss.
+        constexpr uint32_t CACHE_FORMAT_VERSION = 1;
+
+        // Stable across runs and builds, unlike std::hash.
+        uint64_t fnv1a(const std::string_view data, uint64_t hash = 0xcbf29ce484222325ULL) {
+            for (const char c: data) {
+                hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+            }
+            return hash;
+        }
+
+        std::optional<std::string> read_text(const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open()) {
+                return std::nullopt;
+            }
+            std::stringstream stream;
+            stream << file.rdbuf();
+            return stream.str();
+        }
+
+        // Unique to this process and call, so concurrent writers of the same entry never share a temporary.
+        std::string temporary_suffix() {
+            static std::atomic<uint32_t> counter = 0;
+#ifdef _WIN32
+            const int pid = _getpid();
+#else
+            const int pid = getpid();
+#endif
+            return std::format(".{}.{}.tmp", pid, counter.fetch_add(1, std::memory_order_relaxed));
+        }
+
+        // Written under a temporary name and renamed, so a concurrent or interrupted run never reads half a file.
+        void write_words(const std::filesystem::path &path, const std::vector<uint32_t> &words) {
+            std::error_code error;
+            std::filesystem::create_directories(path.parent_path(), error);
+            const std::filesystem::path temporary = path.string() + temporary_suffix();
+            {
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                if (!file.is_open()) {
+                    LOG(LogLevel::WARNING, "Failed to write shader cache entry {}", path.string());
+                    return;
+                }
+                file.write(reinterpret_cast<const char *>(words.data()),
+                           static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+            }
+            std::filesystem::rename(temporary, path, error);
+            if (error) {
+                std::filesystem::remove(temporary, error);
+            }
+        }
+
+        // Tries `path` as given, then the source tree's shader directory, then the working directory's.
+        std::filesystem::path resolve_source(const std::string &path) {
+            std::vector<std::filesystem::path> candidates = {path};
+#ifdef PYRO_SHADER_SOURCE_DIR
+            candidates.emplace_back(std::filesystem::path(PYRO_SHADER_SOURCE_DIR) / path);
+#endif
+            candidates.emplace_back(std::filesystem::path(SHADER_ASSET_DIR) / path);
+            for (const std::filesystem::path &candidate: candidates) {
+                if (std::filesystem::is_regular_file(candidate)) {
+                    return candidate;
+                }
+            }
+            return path;
+        }
+
+        shaderc_shader_kind shader_kind(const VkShaderStageFlagBits stage) {
+            switch (stage) {
+                case VK_SHADER_STAGE_VERTEX_BIT:
+                    return shaderc_vertex_shader;
+                case VK_SHADER_STAGE_FRAGMENT_BIT:
+                    return shaderc_fragment_shader;
+                case VK_SHADER_STAGE_GEOMETRY_BIT:
+                    return shaderc_geometry_shader;
+                case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+                    return shaderc_tess_control_shader;
+                case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+                    return shaderc_tess_evaluation_shader;
+                case VK_SHADER_STAGE_TASK_BIT_EXT:
+                    return shaderc_task_shader;
+                case VK_SHADER_STAGE_MESH_BIT_EXT:
+                    return shaderc_mesh_shader;
+                default:
+                    return shaderc_compute_shader;
+            }
+        }
+
+        // Resolves #include "x" against the including file's directory and #include <x> like a top-level source.
+        class Includer final : public shaderc::CompileOptions::IncluderInterface {
+        public:
+            shaderc_include_result *GetInclude(const char *requested_source, const shaderc_include_type type,
+                                               const char *requesting_source, size_t) override {
+                auto *include = new Include;
+                const std::filesystem::path path =
+                        type == shaderc_include_type_relative
+                                ? std::filesystem::path(requesting_source).parent_path() / requested_source
+                                : resolve_source(requested_source);
+                if (const std::optional<std::string> text = read_text(path)) {
+                    include->name = path.string();
+                    include->content = text.value();
+                } else {
+                    // shaderc reports an empty source name as a failed include, with the content as the message.
+                    include->content = std::format("cannot open {}", path.string());
+                }
+                include->result.source_name = include->name.c_str();
+                include->result.source_name_length = include->name.size();
+                include->result.content = include->content.c_str();
+                include->result.content_length = include->content.size();
+                include->result.user_data = include;
+                return &include->result;
+            }
+
+            void ReleaseInclude(shaderc_include_result *data) override {
+                delete static_cast<Include *>(data->user_data);
+            }
+
+        private:
+            struct Include {
+                shaderc_include_result result{};
+                std::string name;
+                std::string content;
+            };
+        };
+#endif
+    } // namespace
+
+    std::vector<uint32_t> PyroShaderCompiler::compile(const std::string &path,
+                                                      const std::vector<ShaderDefine> &defines) {
+#ifdef PYRO_SHADERC
+        const VkShaderStageFlagBits stage = stage_of(path);
+        const std::filesystem::path source_path = resolve_source(path);
+        const std::optional<std::string> source = read_text(source_path);
+        if (!source) {
+            LOG(LogLevel::ERROR, "Failed to open shader source {}", path);
+            count(&ShaderCacheStats::failures);
+            return {};
+        }
+
+        shaderc::CompileOptions options;
+        for (const ShaderDefine &define: defines) {
+            options.AddMacroDefinition(define.name, define.value);
+        }
+        options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+        options.SetIncluder(std::make_unique<Includer>());
+
+        // Preprocessing is cheap next to compiling, and its output already folds in the defines and includes.
+        const shaderc::Compiler compiler;
+        const shaderc_shader_kind kind = shader_kind(stage);
+        const std::string name = source_path.string();
+        const shaderc::PreprocessedSourceCompilationResult preprocessed =
+                compiler.PreprocessGlsl(source.value(), kind, name.c_str(), options);
+        if (preprocessed.GetCompilationStatus() != shaderc_compilation_status_success) {
+            LOG(LogLevel::ERROR, "Failed to preprocess {}:\n{}", path, preprocessed.GetErrorMessage());
+            count(&ShaderCacheStats::failures);
+            return {};
+        }
+        const std::string text(preprocessed.cbegin(), preprocessed.cend());
+
+        uint64_t key = fnv1a(text);
+        key = fnv1a(std::format("|{}|{}|{}", static_cast<uint32_t>(stage), CACHE_FORMAT_VERSION, VK_HEADER_VERSION),
+                    key);
+        std::filesystem::path cache_path;
+        {
+            std::lock_guard lock(mutex);
+            cache_path = std::filesystem::path(cache_directory) / std::format("{:016x}.spv", key);
+        }
+        if (std::vector<uint32_t> cached = read_words(cache_path); !cached.empty()) {
+            count(&ShaderCacheStats::hits);
+            return cached;
+        }
+
+        const shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(text, kind, name.c_str(), options);
+        if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+            LOG(LogLevel::ERROR, "Failed to compile {}:\n{}", path, result.GetErrorMessage());
+            count(&ShaderCacheStats::failures);
+            return {};
+        }
+        std::vector<uint32_t> spirv(result.cbegin(), result.cend());
+        write_words(cache_path, spirv);
+        count(&ShaderCacheStats::misses);
+        LOG(LogLevel::INFO, "Compiled {} ({} words, {} defines)", path, spirv.size(), defines.size());
+        return spirv;
+#else
+        if (!defines.empty()) {
+            LOG(LogLevel::ERROR, "{} needs defines, but runtime shader compilation isn't built in (PYRO_SHADERC)",
+                path);
+            count(&ShaderCacheStats::failures);
+            return {};
+        }
+        return load_precompiled(path);
+#endif
+    }
+
+    VkShaderStageFlagBits PyroShaderCompiler::stage_of(const std::string &path) {
+        const std::string extension = std::filesystem::path(path).extension().string();
+        if (extension == ".vert") {
+            return VK_SHADER_STAGE_VERTEX_BIT;
+        }
+        if (extension == ".frag") {
+            return VK_SHADER_STAGE_FRAGMENT_BIT;
+        }
+        if (extension == ".geom") {
+            return VK_SHADER_STAGE_GEOMETRY_BIT;
+        }
+        if (extension == ".tesc") {
+            return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        }
+        if (extension == ".tese") {
+            return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        }
+        if (extension == ".task") {
+            return VK_SHADER_STAGE_TASK_BIT_EXT;
+        }
+        if (extension == ".mesh") {
+            return VK_SHADER_STAGE_MESH_BIT_EXT;
+        }
+        return VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    void PyroShaderCompiler::set_cache_directory(const std::string &directory) {
+        std::lock_guard lock(mutex);
+        cache_directory = directory;
+    }
+
+    ShaderCacheStats PyroShaderCompiler::get_stats() {
+        std::lock_guard lock(mutex);
+        return stats;
+    }
+
+    std::vector<uint32_t> PyroShaderCompiler::load_precompiled(const std::string &path) {
+        const std::filesystem::path spv_path = std::filesystem::path(SHADER_ASSET_DIR) /
+                                               (std::filesystem::path(path).filename().string() + ".spv");
+        std::vector<uint32_t> spirv = read_words(spv_path);
+        if (spirv.empty()) {
+            LOG(LogLevel::ERROR, "No precompiled SPIR-V for {} at {}", path, spv_path.string());
+            count(&ShaderCacheStats::failures);
+            return {};
+        }
+        count(&ShaderCacheStats::hits);
+        return spirv;
+    }
+
+    void PyroShaderCompiler::count(uint32_t ShaderCacheStats::*counter) {
+        std::lock_guard lock(mutex);
+        ++(stats.*counter);
+    }
+} // namespace pyro
@@ -0,0 +1,61 @@
+//
+// Created by srijan on 3/10/25.
+//
+
+#ifndef PYROSHADERCOMPILER_HPP
+#define PYROSHADERCOMPILER_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace pyro {
+
+    struct ShaderDefine {
+        std::string name;
+        std::string value;
+    };
+
+    struct ShaderCacheStats {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t failures = 0;
+    };
+
+    // Compiles GLSL from assets/shaders at runtime (shaderc, when built with PYRO_SHADERC) and keeps the SPIR-V in
+    // an on-disk cache. Entries are keyed by a hash of the preprocessed source, so editing a shader, one of its
+    // #includes or the defines all miss; a hit skips everything after preprocessing. Without shaderc, only
+    // define-less shaders resolve, to the build's precompiled assets/shaders/<name>.spv.
+    //
+    // Thread-safe: pipelines compile on worker threads during startup.
+    class PyroShaderCompiler {
+    public:
+        static PyroShaderCompiler &get_instance() {
+            static PyroShaderCompiler instance;
+            return instance;
+        }
+
+        // `path` is a source under assets/shaders (e.g. "upscale.comp"); the stage comes from its extension. Empty,
+        // with the compiler's messages logged, on failure.
+        std::vector<uint32_t> compile(const std::string &path, const std::vector<ShaderDefine> &defines = {});
+        static VkShaderStageFlagBits stage_of(const std::string &path);
+
+        void set_cache_directory(const std::string &directory);
+        ShaderCacheStats get_stats();
+
+    private:
+        PyroShaderCompiler() = default;
+
+        std::mutex mutex;
+        std::string cache_directory = "shader_cache";
+        ShaderCacheStats stats;
+
+        std::vector<uint32_t> load_precompiled(const std::string &path);
+        void count(uint32_t ShaderCacheStats::*counter);
+    };
+
+} // namespace pyro
+
+#endif // PYROSHADERCOMPILER_HPP
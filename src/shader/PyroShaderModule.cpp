@@ -20,6 +20,15 @@ namespace pyro {
     }
     PyroShaderModule::PyroShaderModule(VulkanDevice *device, const std::string &path, const PyroShaderModuleType type) :
         PyroShaderModule(device, ShaderLoader::loadSPV(path), type) {}
+    PyroShaderModule::PyroShaderModule(VulkanDevice *device, const std::vector<uint32_t> &spirv,
+                                       const PyroShaderModuleType type) : type(type), device_(device) {
+        VkShaderModuleCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        info.codeSize = spirv.size() * sizeof(uint32_t);
+        info.pCode = spirv.data();
+        ASSERT_EQUAL(vkCreateShaderModule(device->get_logical_device(), &info, nullptr, &shader_module), VK_SUCCESS,
+                     "Failed to create shader module")
+    }
     PyroShaderModule::~PyroShaderModule() {
         vkDestroyShaderModule(device_->get_logical_device(), shader_module, nullptr);
     }
@@ -16,11 +16,16 @@ namespace pyro {
         PYRO_FRAGMENT,
         PYRO_GEOMETRY,
         PYRO_TESS,
+        PYRO_COMPUTE,
+        PYRO_TASK,
+        PYRO_MESH,
     };
     class PyroShaderModule {
     public:
         PyroShaderModule(VulkanDevice *device, const std::vector<char> &code, PyroShaderModuleType type);
         PyroShaderModule(VulkanDevice *device, const std::string &path, PyroShaderModuleType type);
+        // From SPIR-V words, e.g. PyroShaderCompiler output.
+        PyroShaderModule(VulkanDevice *device, const std::vector<uint32_t> &spirv, PyroShaderModuleType type);
         ~PyroShaderModule();
         VkShaderModule &getShaderModule() {return shader_module;};
         PyroShaderModuleType get_type() const { return type; }
@@ -0,0 +1,80 @@
+//
+// Created by srijan on 3/11/25.
+//
+
+#include "PyroShaderPermutations.hpp"
+
+#include <format>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    VkSpecializationInfo ShaderSpecialization::get_info() const {
+        VkSpecializationInfo info{};
+        info.mapEntryCount = static_cast<uint32_t>(entries.size());
+        info.pMapEntries = entries.data();
+        info.dataSize = data.size() * sizeof(uint32_t);
+        info.pData = data.data();
+        return info;
+    }
+
+    ShaderPermutationSpace::ShaderPermutationSpace(std::vector<ShaderFeature> features) :
+        features(std::move(features)) {
+        for (const ShaderFeature &feature: this->features) {
+            ASSERT_EQUAL(feature.bits >= 1 && feature.bits <= 31, true, "Feature {} has a bad width", feature.name)
+            offsets.push_back(key_bits);
+            key_bits += feature.bits;
+        }
+        ASSERT_EQUAL(key_bits <= 32, true, "Shader features need {} key bits, more than 32", key_bits)
+    }
+
+    uint32_t ShaderPermutationSpace::mask(const size_t feature) const {
+        return ((1u << features[feature].bits) - 1) << offsets[feature];
+    }
+
+    ShaderVariantKey ShaderPermutationSpace::set(const ShaderVariantKey key, const size_t feature,
+                                                 const uint32_t value) const {
+        ASSERT_EQUAL(value < (1u << features[feature].bits), true, "{}={} doesn't fit its key field",
+                     features[feature].name, value)
+        return (key & ~mask(feature)) | ((value << offsets[feature]) & mask(feature));
+    }
+
+    uint32_t ShaderPermutationSpace::get(const ShaderVariantKey key, const size_t feature) const {
+        return (key & mask(feature)) >> offsets[feature];
+    }
+
+    ShaderSpecialization ShaderPermutationSpace::specialize(const ShaderVariantKey key) const {
+        ShaderSpecialization specialization;
+        for (size_t i = 0; i < features.size(); i++) {
+            const auto offset = static_cast<uint32_t>(specialization.data.size() * sizeof(uint32_t));
+            specialization.entries.push_back({features[i].constant_id, offset, sizeof(uint32_t)});
+            specialization.data.push_back(get(key, i));
+        }
+        return specialization;
+    }
+
+    bool ShaderPermutationSpace::matches(const ShaderReflection &reflection) const {
+        bool matched = true;
+        for (const ShaderFeature &feature: features) {
+            const ReflectedSpecConstant *constant = reflection.find_spec_constant(feature.constant_id);
+            if (!constant) {
+                LOG(LogLevel::ERROR, "Shader has no specialization constant {} for feature {}", feature.constant_id,
+                    feature.name);
+                matched = false;
+            } else if (constant->is_bool && feature.bits != 1) {
+                LOG(LogLevel::ERROR, "Feature {} is {} bits wide but constant {} is a bool", feature.name,
+                    feature.bits, feature.constant_id);
+                matched = false;
+            }
+        }
+        return matched;
+    }
+
+    std::string ShaderPermutationSpace::describe(const ShaderVariantKey key) const {
+        std::string description;
+        for (size_t i = 0; i < features.size(); i++) {
+            description += std::format("{}{}={}", i ? " " : "", features[i].name, get(key, i));
+        }
+        return description;
+    }
+} // namespace pyro
@@ -0,0 +1,67 @@
+//
+// Created by srijan on 3/11/25.
+//
+
+#ifndef PYROSHADERPERMUTATIONS_HPP
+#define PYROSHADERPERMUTATIONS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "PyroShaderReflection.hpp"
+
+namespace pyro {
+
+    // Packed feature values of one shader variant; see ShaderPermutationSpace.
+    using ShaderVariantKey = uint32_t;
+
+    // A specialization constant exposed as a field of the variant key.
+    struct ShaderFeature {
+        // Only used in logs.
+        std::string name;
+        // The shader's layout(constant_id = N).
+        uint32_t constant_id = 0;
+        // Width of the field: 1 for a bool toggle, more for a small count (4 bits hold 0-15 lights).
+        uint32_t bits = 1;
+    };
+
+    // Storage behind a VkSpecializationInfo; must outlive pipeline creation.
+    struct ShaderSpecialization {
+        std::vector<VkSpecializationMapEntry> entries;
+        std::vector<uint32_t> data;
+
+        VkSpecializationInfo get_info() const;
+    };
+
+    // The features one SPIR-V module can be specialized on, packed into a ShaderVariantKey so variants are cheap to
+    // hash and compare. Each feature becomes a 32-bit specialization constant (a VkBool32 for toggles) and the
+    // driver folds the branches on it when the pipeline is created, so features cost neither extra GLSL files nor
+    // extra SPIR-V. The key space is bounded by the total width, at most 32 bits.
+    class ShaderPermutationSpace {
+    public:
+        ShaderPermutationSpace() = default;
+        explicit ShaderPermutationSpace(std::vector<ShaderFeature> features);
+
+        // `key` with `feature` (an index into the constructor's list) set to `value`.
+        ShaderVariantKey set(ShaderVariantKey key, size_t feature, uint32_t value) const;
+        uint32_t get(ShaderVariantKey key, size_t feature) const;
+        ShaderSpecialization specialize(ShaderVariantKey key) const;
+        // False, with the offending features logged, when `reflection` doesn't declare one of the constants.
+        bool matches(const ShaderReflection &reflection) const;
+        // E.g. "SHARPEN=1 LIGHTS=4".
+        std::string describe(ShaderVariantKey key) const;
+        uint32_t get_key_bits() const { return key_bits; }
+
+    private:
+        std::vector<ShaderFeature> features;
+        std::vector<uint32_t> offsets;
+        uint32_t key_bits = 0;
+
+        uint32_t mask(size_t feature) const;
+    };
+
+} // namespace pyro
+
+#endif // PYROSHADERPERMUTATIONS_HPP
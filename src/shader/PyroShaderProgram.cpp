@@ -0,0 +1,36 @@
+//
+// Created by srijan on 3/10/25.
+//
+
+#include "PyroShaderProgram.hpp"
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    PyroShaderProgram::PyroShaderProgram(PyroDescriptors *descriptors, const std::vector<std::string> &sources,
+                                         const std::vector<ShaderDefine> &defines) {
+        for (const std::string &source: sources) {
+            std::vector<uint32_t> spirv = PyroShaderCompiler::get_instance().compile(source, defines);
+            ASSERT_EQUAL(spirv.empty(), false, "Failed to compile shader {}", source)
+            std::optional<ShaderReflection> stage_reflection = ShaderReflection::reflect(spirv);
+            ASSERT_EQUAL(stage_reflection.has_value(), true, "Failed to reflect shader {}", source)
+            if (!stage_reflection) {
+                continue;
+            }
+            ASSERT_EQUAL(reflection.merge(stage_reflection.value()), true, "Stages of {} disagree", source)
+            stages.push_back({PyroShaderCompiler::stage_of(source), std::move(spirv)});
+        }
+
+        for (const ReflectedBinding &binding: reflection.bindings) {
+            if (binding.count == 0) {
+                LOG(LogLevel::WARNING, "Set {} binding {} is a runtime array and is left out of the reflected layout",
+                    binding.set, binding.binding);
+            }
+        }
+        for (uint32_t set = 0; set < reflection.get_set_count(); set++) {
+            set_layouts.push_back(descriptors->get_layout_cache()->create_layout(reflection.layout_info(set)));
+        }
+        LOG(LogLevel::DEBUG, "Reflected {} stages: {} sets, {} bindings, {} push constant bytes", stages.size(),
+            set_layouts.size(), reflection.bindings.size(), reflection.push_constant_size);
+    }
+} // namespace pyro
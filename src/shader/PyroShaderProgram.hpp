@@ -0,0 +1,50 @@
+//
+// Created by srijan on 3/10/25.
+//
+
+#ifndef PYROSHADERPROGRAM_HPP
+#define PYROSHADERPROGRAM_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../descriptor/PyroDescriptors.hpp"
+#include "PyroShaderCompiler.hpp"
+#include "PyroShaderReflection.hpp"
+
+namespace pyro {
+
+    struct ShaderStageCode {
+        VkShaderStageFlagBits stage;
+        std::vector<uint32_t> spirv;
+    };
+
+    // The stages of one pipeline compiled from GLSL through PyroShaderCompiler, with the set layouts and
+    // push-constant ranges reflected from them, so the layout can't drift from the shaders. Layouts come from the
+    // shared layout cache: a set declared identically to a PyroDescriptorBindings (same types and stages) gets the
+    // same handle, so sets built with allocate_transient()/get_cached_set() stay compatible.
+    class PyroShaderProgram {
+    public:
+        // `sources` are paths under assets/shaders, one per stage, e.g. {"basic.vert", "basic.frag"}.
+        PyroShaderProgram(PyroDescriptors *descriptors, const std::vector<std::string> &sources,
+                          const std::vector<ShaderDefine> &defines = {});
+
+        const std::vector<ShaderStageCode> &get_stages() const { return stages; }
+        const ShaderReflection &get_reflection() const { return reflection; }
+        // One layout per set up to the highest used; sets the shaders skip get an empty layout.
+        const std::vector<VkDescriptorSetLayout> &get_set_layouts() const { return set_layouts; }
+        std::vector<VkPushConstantRange> get_push_constant_ranges() const {
+            return reflection.push_constant_ranges();
+        }
+
+    private:
+        std::vector<ShaderStageCode> stages;
+        ShaderReflection reflection;
+        std::vector<VkDescriptorSetLayout> set_layouts;
+    };
+
+} // namespace pyro
+
+#endif // PYROSHADERPROGRAM_HPP
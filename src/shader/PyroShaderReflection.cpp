@@ -0,0 +1,614 @@
+//
+// Created by srijan on 3/10/25.
+//
+
+#include "PyroShaderReflection.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+        constexpr size_t SPIRV_HEADER_WORDS = 5;
+
+        // The subset of the SPIR-V grammar reflection needs.
+        enum Op : uint16_t {
+            OP_ENTRY_POINT = 15,
+            OP_TYPE_INT = 21,
+            OP_TYPE_FLOAT = 22,
+            OP_TYPE_VECTOR = 23,
+            OP_TYPE_MATRIX = 24,
+            OP_TYPE_IMAGE = 25,
+            OP_TYPE_SAMPLER = 26,
+            OP_TYPE_SAMPLED_IMAGE = 27,
+            OP_TYPE_ARRAY = 28,
+            OP_TYPE_RUNTIME_ARRAY = 29,
+            OP_TYPE_STRUCT = 30,
+            OP_TYPE_POINTER = 32,
+            OP_CONSTANT = 43,
+            OP_SPEC_CONSTANT_TRUE = 48,
+            OP_SPEC_CONSTANT_FALSE = 49,
+            OP_SPEC_CONSTANT = 50,
+            OP_VARIABLE = 59,
+            OP_DECORATE = 71,
+            OP_MEMBER_DECORATE = 72,
+            OP_TYPE_ACCELERATION_STRUCTURE = 5341,
+        };
+        enum Decoration : uint32_t {
+            DECORATION_SPEC_ID = 1,
+            DECORATION_BUFFER_BLOCK = 3,
+            DECORATION_ARRAY_STRIDE = 6,
+            DECORATION_MATRIX_STRIDE = 7,
+            DECORATION_BUILT_IN = 11,
+            DECORATION_LOCATION = 30,
+            DECORATION_BINDING = 33,
+            DECORATION_DESCRIPTOR_SET = 34,
+            DECORATION_OFFSET = 35,
+        };
+        enum StorageClass : uint32_t {
+            STORAGE_UNIFORM_CONSTANT = 0,
+            STORAGE_INPUT = 1,
+            STORAGE_UNIFORM = 2,
+            STORAGE_PUSH_CONSTANT = 9,
+            STORAGE_STORAGE_BUFFER = 12,
+        };
+        constexpr uint32_t DIM_BUFFER = 5;
+        constexpr uint32_t DIM_SUBPASS_DATA = 6;
+        constexpr uint32_t IMAGE_STORAGE = 2;
+
+        VkShaderStageFlags stage_of(const uint32_t execution_model) {
+            switch (execution_model) {
+                case 0:
+                    return VK_SHADER_STAGE_VERTEX_BIT;
+                case 1:
+                    return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+                case 2:
+                    return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+                case 3:
+                    return VK_SHADER_STAGE_GEOMETRY_BIT;
+                case 4:
+                    return VK_SHADER_STAGE_FRAGMENT_BIT;
+                case 5:
+                    return VK_SHADER_STAGE_COMPUTE_BIT;
+                case 5364:
+                    return VK_SHADER_STAGE_TASK_BIT_EXT;
+                case 5365:
+                    return VK_SHADER_STAGE_MESH_BIT_EXT;
+                default:
+                    return 0;
+            }
+        }
+
+        // Fewest words, opcode word included, a well-formed instruction of each parsed opcode has, so the
+        // operands read below are always present.
+        uint32_t min_word_count(const uint16_t opcode) {
+            switch (opcode) {
+                case OP_TYPE_SAMPLER:
+                case OP_TYPE_STRUCT:
+                case OP_TYPE_ACCELERATION_STRUCTURE:
+                    return 2;
+                case OP_TYPE_FLOAT:
+                case OP_TYPE_SAMPLED_IMAGE:
+                case OP_TYPE_RUNTIME_ARRAY:
+                case OP_SPEC_CONSTANT_TRUE:
+                case OP_SPEC_CONSTANT_FALSE:
+                case OP_DECORATE:
+                    return 3;
+                case OP_ENTRY_POINT:
+                case OP_TYPE_INT:
+                case OP_TYPE_VECTOR:
+                case OP_TYPE_MATRIX:
+                case OP_TYPE_ARRAY:
+                case OP_TYPE_POINTER:
+                case OP_CONSTANT:
+                case OP_SPEC_CONSTANT:
+                case OP_VARIABLE:
+                case OP_MEMBER_DECORATE:
+                    return 4;
+                case OP_TYPE_IMAGE:
+                    return 9;
+                default:
+                    return 1;
+            }
+        }
+
+        struct Type {
+            uint16_t opcode = 0;
+            // Operands after the result id.
+            std::vector<uint32_t> operands;
+        };
+
+        bool is_scalar(const Type *type) {
+            return type && (type->opcode == OP_TYPE_INT || type->opcode == OP_TYPE_FLOAT);
+        }
+
+        struct Decorations {
+            std::optional<uint32_t> spec_id;
+            std::optional<uint32_t> set;
+            std::optional<uint32_t> binding;
+            std::optional<uint32_t> location;
+            bool built_in = false;
+            bool buffer_block = false;
+            uint32_t array_stride = 0;
+        };
+        struct MemberDecorations {
+            uint32_t offset = 0;
+            uint32_t matrix_stride = 0;
+            bool built_in = false;
+        };
+        struct SpecConstant {
+            uint32_t id;
+            uint32_t type;
+            uint16_t opcode;
+            uint32_t value;
+        };
+        struct Variable {
+            uint32_t id;
+            uint32_t pointer_type;
+            uint32_t storage_class;
+        };
+
+        struct Module {
+            VkShaderStageFlags stages = 0;
+            std::unordered_map<uint32_t, Type> types;
+            std::unordered_map<uint32_t, uint32_t> constants;
+            std::unordered_map<uint32_t, Decorations> decorations;
+            std::unordered_map<uint32_t, std::vector<MemberDecorations>> members;
+            std::vector<SpecConstant> spec_constants;
+            std::vector<Variable> variables;
+
+            const Type *type(const uint32_t id) const {
+                const auto it = types.find(id);
+                return it != types.end() ? &it->second : nullptr;
+            }
+
+            const Decorations &decorations_of(const uint32_t id) const {
+                static const Decorations none;
+                const auto it = decorations.find(id);
+                return it != decorations.end() ? it->second : none;
+            }
+
+            MemberDecorations &member(const uint32_t id, const uint32_t index) {
+                std::vector<MemberDecorations> &list = members[id];
+                if (list.size() <= index) {
+                    list.resize(index + 1);
+                }
+                return list[index];
+            }
+
+            MemberDecorations member_of(const uint32_t id, const uint32_t index) const {
+                const auto it = members.find(id);
+                return it != members.end() && index < it->second.size() ? it->second[index] : MemberDecorations{};
+            }
+
+            // The type a pointer points to, or `id` itself for anything else.
+            uint32_t pointee(const uint32_t id) const {
+                const Type *pointer = type(id);
+                return pointer && pointer->opcode == OP_TYPE_POINTER && pointer->operands.size() >= 2
+                               ? pointer->operands[1]
+                               : id;
+            }
+
+            // Size in bytes under the module's explicit layout; 0 for opaque or unknown types.
+            uint32_t size_of(const uint32_t id, const uint32_t matrix_stride = 0) const {
+                std::vector<uint32_t> enclosing;
+                return size_of(id, matrix_stride, enclosing);
+            }
+
+            // `enclosing` holds the types being sized further up, so a type that contains itself sizes as 0
+            // instead of recursing forever.
+            uint32_t size_of(const uint32_t id, const uint32_t matrix_stride, std::vector<uint32_t> &enclosing) const {
+                const Type *t = type(id);
+                if (!t || std::ranges::find(enclosing, id) != enclosing.end()) {
+                    return 0;
+                }
+                enclosing.push_back(id);
+                uint32_t size = 0;
+                switch (t->opcode) {
+                    case OP_TYPE_INT:
+                    case OP_TYPE_FLOAT:
+                        size = t->operands[0] / 8;
+                        break;
+                    case OP_TYPE_VECTOR:
+                        size = t->operands[1] * size_of(t->operands[0], 0, enclosing);
+                        break;
+                    case OP_TYPE_MATRIX:
+                        size = t->operands[1] * (matrix_stride ? matrix_stride : size_of(t->operands[0], 0, enclosing));
+                        break;
+                    case OP_TYPE_ARRAY: {
+                        const auto length = constants.find(t->operands[1]);
+                        const uint32_t stride = decorations_of(id).array_stride;
+                        if (length != constants.end()) {
+                            size = length->second *
+                                   (stride ? stride : size_of(t->operands[0], matrix_stride, enclosing));
+                        }
+                        break;
+                    }
+                    case OP_TYPE_STRUCT:
+                        for (uint32_t i = 0; i < t->operands.size(); i++) {
+                            const MemberDecorations member = member_of(id, i);
+                            size = std::max(size,
+                                            member.offset + size_of(t->operands[i], member.matrix_stride, enclosing));
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                enclosing.pop_back();
+                return size;
+            }
+        };
+
+        bool parse(const std::vector<uint32_t> &spirv, Module &module) {
+            if (spirv.size() < SPIRV_HEADER_WORDS || spirv[0] != SPIRV_MAGIC) {
+                LOG(LogLevel::ERROR, "Not a SPIR-V module");
+                return false;
+            }
+            for (size_t i = SPIRV_HEADER_WORDS; i < spirv.size();) {
+                const uint32_t word_count = spirv[i] >> 16;
+                const auto opcode = static_cast<uint16_t>(spirv[i] & 0xFFFF);
+                if (word_count == 0 || i + word_count > spirv.size()) {
+                    LOG(LogLevel::ERROR, "Truncated SPIR-V instruction at word {}", i);
+                    return false;
+                }
+                if (word_count < min_word_count(opcode)) {
+                    LOG(LogLevel::ERROR, "SPIR-V instruction {} at word {} is missing operands", opcode, i);
+                    return false;
+                }
+                const uint32_t *words = &spirv[i];
+                switch (opcode) {
+                    case OP_ENTRY_POINT:
+                        module.stages |= stage_of(words[1]);
+                        break;
+                    case OP_DECORATE: {
+                        Decorations &decorations = module.decorations[words[1]];
+                        const uint32_t literal = word_count > 3 ? words[3] : 0;
+                        switch (words[2]) {
+                            case DECORATION_SPEC_ID:
+                                decorations.spec_id = literal;
+                                break;
+                            case DECORATION_BUFFER_BLOCK:
+                                decorations.buffer_block = true;
+                                break;
+                            case DECORATION_ARRAY_STRIDE:
+                                decorations.array_stride = literal;
+                                break;
+                            case DECORATION_BUILT_IN:
+                                decorations.built_in = true;
+                                break;
+                            case DECORATION_LOCATION:
+                                decorations.location = literal;
+                                break;
+                            case DECORATION_BINDING:
+                                decorations.binding = literal;
+                                break;
+                            case DECORATION_DESCRIPTOR_SET:
+                                decorations.set = literal;
+                                break;
+                            default:
+                                break;
+                        }
+                        break;
+                    }
+                    case OP_MEMBER_DECORATE: {
+                        MemberDecorations &member = module.member(words[1], words[2]);
+                        const uint32_t literal = word_count > 4 ? words[4] : 0;
+                        if (words[3] == DECORATION_OFFSET) {
+                            member.offset = literal;
+                        } else if (words[3] == DECORATION_MATRIX_STRIDE) {
+                            member.matrix_stride = literal;
+                        } else if (words[3] == DECORATION_BUILT_IN) {
+                            member.built_in = true;
+                        }
+                        break;
+                    }
+                    case OP_TYPE_INT:
+                    case OP_TYPE_FLOAT:
+                    case OP_TYPE_VECTOR:
+                    case OP_TYPE_MATRIX:
+                    case OP_TYPE_IMAGE:
+                    case OP_TYPE_SAMPLER:
+                    case OP_TYPE_SAMPLED_IMAGE:
+                    case OP_TYPE_ARRAY:
+                    case OP_TYPE_RUNTIME_ARRAY:
+                    case OP_TYPE_STRUCT:
+                    case OP_TYPE_POINTER:
+                    case OP_TYPE_ACCELERATION_STRUCTURE:
+                        module.types[words[1]] = {opcode, std::vector(words + 2, words + word_count)};
+                        break;
+                    case OP_CONSTANT:
+                        module.constants[words[2]] = words[3];
+                        break;
+                    case OP_SPEC_CONSTANT_TRUE:
+                    case OP_SPEC_CONSTANT_FALSE:
+                    case OP_SPEC_CONSTANT:
+                        module.spec_constants.push_back({words[2], words[1], opcode, word_count >= 4 ? words[3] : 0});
+                        break;
+                    case OP_VARIABLE:
+                        module.variables.push_back({words[2], words[1], words[3]});
+                        break;
+                    default:
+                        break;
+                }
+                i += word_count;
+            }
+            return true;
+        }
+
+        VkDescriptorType descriptor_type(const Module &module, const uint32_t type_id, const uint32_t storage_class) {
+            const Type *type = module.type(type_id);
+            if (!type) {
+                return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+            }
+            if (storage_class == STORAGE_STORAGE_BUFFER) {
+                return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            }
+            if (storage_class == STORAGE_UNIFORM) {
+                // Pre-1.3 SPIR-V spells storage buffers as Uniform blocks decorated BufferBlock.
+                return module.decorations_of(type_id).buffer_block ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+                                                                   : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            }
+            switch (type->opcode) {
+                case OP_TYPE_SAMPLER:
+                    return VK_DESCRIPTOR_TYPE_SAMPLER;
+                case OP_TYPE_SAMPLED_IMAGE:
+                    return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                case OP_TYPE_IMAGE: {
+                    const uint32_t dim = type->operands[1];
+                    const bool storage = type->operands[5] == IMAGE_STORAGE;
+                    if (dim == DIM_SUBPASS_DATA) {
+                        return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                    }
+                    if (dim == DIM_BUFFER) {
+                        return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                                       : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                    }
+                    return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                case OP_TYPE_ACCELERATION_STRUCTURE:
+                    return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                default:
+                    return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+            }
+        }
+
+        bool by_constant_id(const ReflectedSpecConstant &a, const ReflectedSpecConstant &b) {
+            return a.constant_id < b.constant_id;
+        }
+
+        VkFormat vertex_format(const Module &module, const uint32_t type_id) {
+            const Type *type = module.type(type_id);
+            uint32_t components = 1;
+            if (type && type->opcode == OP_TYPE_VECTOR) {
+                components = type->operands[1];
+                type = module.type(type->operands[0]);
+            }
+            if (!is_scalar(type) || type->operands[0] != 32 || components < 1 || components > 4) {
+                return VK_FORMAT_UNDEFINED;
+            }
+            static constexpr VkFormat FLOAT_FORMATS[] = {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT,
+                                                         VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+            static constexpr VkFormat SINT_FORMATS[] = {VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT,
+                                                        VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT};
+            static constexpr VkFormat UINT_FORMATS[] = {VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT,
+                                                        VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT};
+            if (type->opcode == OP_TYPE_FLOAT) {
+                return FLOAT_FORMATS[components - 1];
+            }
+            if (type->opcode == OP_TYPE_INT) {
+                return type->operands[1] ? SINT_FORMATS[components - 1] : UINT_FORMATS[components - 1];
+            }
+            return VK_FORMAT_UNDEFINED;
+        }
+    } // namespace
+
+    std::optional<ShaderReflection> ShaderReflection::reflect(const std::vector<uint32_t> &spirv) {
+        Module module;
+        if (!parse(spirv, module)) {
+            return std::nullopt;
+        }
+        ShaderReflection reflection;
+        reflection.stages = module.stages;
+        for (const Variable &variable: module.variables) {
+            const Decorations &decorations = module.decorations_of(variable.id);
+            uint32_t type_id = module.pointee(variable.pointer_type);
+
+            if (variable.storage_class == STORAGE_PUSH_CONSTANT) {
+                const Type *type = module.type(type_id);
+                if (!type || type->opcode != OP_TYPE_STRUCT) {
+                    continue;
+                }
+                uint32_t begin = UINT32_MAX;
+                for (uint32_t i = 0; i < type->operands.size(); i++) {
+                    begin = std::min(begin, module.member_of(type_id, i).offset);
+                }
+                reflection.push_constant_stages = module.stages;
+                reflection.push_constant_offset = begin == UINT32_MAX ? 0 : begin;
+                reflection.push_constant_size = module.size_of(type_id) - reflection.push_constant_offset;
+                continue;
+            }
+
+            if (variable.storage_class == STORAGE_INPUT) {
+                const Type *type = module.type(type_id);
+                const bool built_in_block = type && type->opcode == OP_TYPE_STRUCT &&
+                                            module.member_of(type_id, 0).built_in;
+                if (!(module.stages & VK_SHADER_STAGE_VERTEX_BIT) || decorations.built_in || built_in_block ||
+                    !decorations.location.has_value()) {
+                    continue;
+                }
+                ReflectedVertexInput input;
+                input.location = decorations.location.value();
+                input.format = vertex_format(module, type_id);
+                input.size = module.size_of(type_id);
+                if (input.format == VK_FORMAT_UNDEFINED) {
+                    LOG(LogLevel::WARNING, "Vertex input at location {} has no reflectable format", input.location);
+                    continue;
+                }
+                reflection.vertex_inputs.push_back(input);
+                continue;
+            }
+
+            if (variable.storage_class != STORAGE_UNIFORM_CONSTANT && variable.storage_class != STORAGE_UNIFORM &&
+                variable.storage_class != STORAGE_STORAGE_BUFFER) {
+                continue;
+            }
+            if (!decorations.binding.has_value()) {
+                continue;
+            }
+            ReflectedBinding binding;
+            binding.set = decorations.set.value_or(0);
+            binding.binding = decorations.binding.value();
+            binding.stages = module.stages;
+            // Bounded by the type count: an array chain longer than that must loop back on itself.
+            size_t depth = 0;
+            for (const Type *type = module.type(type_id); type && depth <= module.types.size(); depth++) {
+                if (type->opcode == OP_TYPE_ARRAY) {
+                    const auto length = module.constants.find(type->operands[1]);
+                    binding.count *= length != module.constants.end() ? length->second : 1;
+                } else if (type->opcode == OP_TYPE_RUNTIME_ARRAY) {
+                    binding.count = 0;
+                } else {
+                    break;
+                }
+                type_id = type->operands[0];
+                type = module.type(type_id);
+            }
+            binding.type = depth > module.types.size() ? VK_DESCRIPTOR_TYPE_MAX_ENUM
+                                                       : descriptor_type(module, type_id, variable.storage_class);
+            if (binding.type == VK_DESCRIPTOR_TYPE_MAX_ENUM) {
+                LOG(LogLevel::WARNING, "Unrecognised resource at set {} binding {}", binding.set, binding.binding);
+                continue;
+            }
+            reflection.bindings.push_back(binding);
+        }
+        for (const SpecConstant &constant: module.spec_constants) {
+            const std::optional<uint32_t> spec_id = module.decorations_of(constant.id).spec_id;
+            if (!spec_id) {
+                continue;
+            }
+            const Type *type = module.type(constant.type);
+            if (constant.opcode == OP_SPEC_CONSTANT && (!is_scalar(type) || type->operands[0] != 32)) {
+                LOG(LogLevel::WARNING, "Specialization constant {} isn't a 32-bit scalar", spec_id.value());
+                continue;
+            }
+            ReflectedSpecConstant reflected;
+            reflected.constant_id = spec_id.value();
+            reflected.is_bool = constant.opcode != OP_SPEC_CONSTANT;
+            reflected.default_value = constant.opcode == OP_SPEC_CONSTANT ? constant.value
+                                                                          : constant.opcode == OP_SPEC_CONSTANT_TRUE;
+            reflection.spec_constants.push_back(reflected);
+        }
+        std::ranges::sort(reflection.spec_constants, by_constant_id);
+        std::ranges::sort(reflection.bindings, [](const ReflectedBinding &a, const ReflectedBinding &b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+        std::ranges::sort(reflection.vertex_inputs, [](const ReflectedVertexInput &a, const ReflectedVertexInput &b) {
+            return a.location < b.location;
+        });
+        return reflection;
+    }
+
+    bool ShaderReflection::merge(const ShaderReflection &other) {
+        for (const ReflectedBinding &binding: other.bindings) {
+            const auto it = std::ranges::find_if(bindings, [&](const ReflectedBinding &existing) {
+                return existing.set == binding.set && existing.binding == binding.binding;
+            });
+            if (it == bindings.end()) {
+                bindings.push_back(binding);
+                continue;
+            }
+            if (it->type != binding.type) {
+                LOG(LogLevel::ERROR, "Stages disagree on the type of set {} binding {}", binding.set, binding.binding);
+                return false;
+            }
+            it->stages |= binding.stages;
+            it->count = it->count == 0 || binding.count == 0 ? 0 : std::max(it->count, binding.count);
+        }
+        std::ranges::sort(bindings, [](const ReflectedBinding &a, const ReflectedBinding &b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+
+        if (other.push_constant_size > 0) {
+            if (push_constant_size == 0) {
+                push_constant_offset = other.push_constant_offset;
+                push_constant_size = other.push_constant_size;
+            } else {
+                const uint32_t end = std::max(push_constant_offset + push_constant_size,
+                                              other.push_constant_offset + other.push_constant_size);
+                push_constant_offset = std::min(push_constant_offset, other.push_constant_offset);
+                push_constant_size = end - push_constant_offset;
+            }
+            push_constant_stages |= other.push_constant_stages;
+        }
+        if (other.stages & VK_SHADER_STAGE_VERTEX_BIT) {
+            vertex_inputs = other.vertex_inputs;
+        }
+        for (const ReflectedSpecConstant &constant: other.spec_constants) {
+            const ReflectedSpecConstant *existing = find_spec_constant(constant.constant_id);
+            if (existing && existing->is_bool != constant.is_bool) {
+                LOG(LogLevel::ERROR, "Stages disagree on the type of specialization constant {}",
+                    constant.constant_id);
+                return false;
+            }
+            if (!existing) {
+                spec_constants.push_back(constant);
+            }
+        }
+        std::ranges::sort(spec_constants, by_constant_id);
+        stages |= other.stages;
+        return true;
+    }
+
+    const ReflectedSpecConstant *ShaderReflection::find_spec_constant(const uint32_t constant_id) const {
+        const auto it = std::ranges::find_if(spec_constants, [&](const ReflectedSpecConstant &constant) {
+            return constant.constant_id == constant_id;
+        });
+        return it != spec_constants.end() ? &*it : nullptr;
+    }
+
+    uint32_t ShaderReflection::get_set_count() const { return bindings.empty() ? 0 : bindings.back().set + 1; }
+
+    DescriptorLayoutInfo ShaderReflection::layout_info(const uint32_t set) const {
+        DescriptorLayoutInfo info;
+        for (const ReflectedBinding &binding: bindings) {
+            if (binding.set != set || binding.count == 0) {
+                continue;
+            }
+            VkDescriptorSetLayoutBinding layout_binding{};
+            layout_binding.binding = binding.binding;
+            layout_binding.descriptorType = binding.type;
+            layout_binding.descriptorCount = binding.count;
+            layout_binding.stageFlags = binding.stages;
+            info.bindings.push_back(layout_binding);
+        }
+        return info;
+    }
+
+    std::vector<VkPushConstantRange> ShaderReflection::push_constant_ranges() const {
+        if (push_constant_size == 0) {
+            return {};
+        }
+        return {{push_constant_stages, push_constant_offset, push_constant_size}};
+    }
+
+    VkVertexInputBindingDescription ShaderReflection::vertex_binding() const {
+        uint32_t stride = 0;
+        for (const ReflectedVertexInput &input: vertex_inputs) {
+            stride += input.size;
+        }
+        return {0, stride, VK_VERTEX_INPUT_RATE_VERTEX};
+    }
+
+    std::vector<VkVertexInputAttributeDescription> ShaderReflection::vertex_attributes() const {
+        std::vector<VkVertexInputAttributeDescription> attributes;
+        uint32_t offset = 0;
+        for (const ReflectedVertexInput &input: vertex_inputs) {
+            attributes.push_back({input.location, 0, input.format, offset});
+            offset += input.size;
+        }
+        return attributes;
+    }
+} // namespace pyro
@@ -0,0 +1,74 @@
+//
+// Created by srijan on 3/10/25.
+//
+
+#ifndef PYROSHADERREFLECTION_HPP
+#define PYROSHADERREFLECTION_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../descriptor/PyroDescriptorLayoutCache.hpp"
+
+namespace pyro {
+
+    struct ReflectedBinding {
+        uint32_t set = 0;
+        uint32_t binding = 0;
+        VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+        // Array size; 0 for a runtime-sized array.
+        uint32_t count = 1;
+        VkShaderStageFlags stages = 0;
+    };
+
+    struct ReflectedSpecConstant {
+        uint32_t constant_id = 0;
+        // Bool, int or float; only 32-bit scalars are reflected.
+        bool is_bool = false;
+        // Bit pattern of the default value.
+        uint32_t default_value = 0;
+    };
+
+    struct ReflectedVertexInput {
+        uint32_t location = 0;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t size = 0;
+    };
+
+    // What SPIR-V modules expect of the pipeline layout and vertex input, read from their decorations: descriptor
+    // bindings per set, the push-constant block's byte range and the vertex stage's inputs. Vertex inputs get
+    // 32-bit formats matching their GLSL types; packed attributes (e.g. R16G16_UNORM) still have to be declared.
+    struct ShaderReflection {
+        VkShaderStageFlags stages = 0;
+        // Sorted by set, then binding.
+        std::vector<ReflectedBinding> bindings;
+        VkShaderStageFlags push_constant_stages = 0;
+        uint32_t push_constant_offset = 0;
+        uint32_t push_constant_size = 0;
+        // Sorted by location; built-ins are left out.
+        std::vector<ReflectedVertexInput> vertex_inputs;
+        // Sorted by constant id.
+        std::vector<ReflectedSpecConstant> spec_constants;
+
+        // nullopt, with the reason logged, when `spirv` isn't a module this can read.
+        static std::optional<ShaderReflection> reflect(const std::vector<uint32_t> &spirv);
+
+        // Folds in another stage of the same program; false when the two disagree on a binding's type.
+        bool merge(const ShaderReflection &other);
+
+        const ReflectedSpecConstant *find_spec_constant(uint32_t constant_id) const;
+        // One past the highest set used.
+        uint32_t get_set_count() const;
+        // Runtime-sized arrays are left out; they need a layout with variable descriptor counts.
+        DescriptorLayoutInfo layout_info(uint32_t set) const;
+        std::vector<VkPushConstantRange> push_constant_ranges() const;
+        // All inputs interleaved in binding 0, tightly packed in location order.
+        VkVertexInputBindingDescription vertex_binding() const;
+        std::vector<VkVertexInputAttributeDescription> vertex_attributes() const;
+    };
+
+} // namespace pyro
+
+#endif // PYROSHADERREFLECTION_HPP
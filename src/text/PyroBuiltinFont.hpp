@@ -0,0 +1,22 @@
+//
+// Created by srijan on 2/25/25.
+//
+
+#ifndef PYROBUILTINFONT_HPP
+#define PYROBUILTINFONT_HPP
+
+#include <cstdint>
+
+namespace pyro {
+
+    // Monospaced 8x8 bitmap font covering printable ASCII, compiled in so text works without any font assets.
+    constexpr uint32_t BUILTIN_FONT_CELL = 8;
+    constexpr uint32_t BUILTIN_FONT_FIRST = 0x20;
+    constexpr uint32_t BUILTIN_FONT_LAST = 0x7e;
+
+    // BUILTIN_FONT_CELL rows of one byte each, bit 0 leftmost, or null when the font has no such glyph.
+    const uint8_t *builtin_font_glyph(uint32_t codepoint);
+
+} // namespace pyro
+
+#endif // PYROBUILTINFONT_HPP
@@ -0,0 +1,254 @@
+//
+// Created by srijan on 2/25/25.
+//
+
+#include "PyroGlyphAtlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "../utils/Logger.hpp"
+#include "PyroBuiltinFont.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr float FAR_AWAY = 1e20f;
+        constexpr uint32_t FALLBACK_CODEPOINT = '?';
+
+        uint16_t unorm16(const uint32_t texel, const uint32_t size) {
+            return static_cast<uint16_t>(static_cast<uint64_t>(texel) * 65535 / size);
+        }
+
+        // Felzenszwalb-Huttenlocher: exact squared distance to the nearest zero of `f` along one line, via the
+        // lower envelope of the parabolas rooted at each sample.
+        void distance_transform_1d(const float *f, float *d, const uint32_t n, std::vector<uint32_t> &v,
+                                   std::vector<float> &z) {
+            uint32_t k = 0;
+            v[0] = 0;
+            z[0] = -std::numeric_limits<float>::infinity();
+            z[1] = std::numeric_limits<float>::infinity();
+            for (uint32_t q = 1; q < n; q++) {
+                const auto fq = static_cast<float>(q);
+                float s;
+                while (true) {
+                    const auto vk = static_cast<float>(v[k]);
+                    s = (f[q] + fq * fq - (f[v[k]] + vk * vk)) / (2.0f * fq - 2.0f * vk);
+                    if (s > z[k] || k == 0) {
+                        break;
+                    }
+                    k--;
+                }
+                k++;
+                v[k] = q;
+                z[k] = s;
+                z[k + 1] = std::numeric_limits<float>::infinity();
+            }
+            k = 0;
+            for (uint32_t q = 0; q < n; q++) {
+                while (z[k + 1] < static_cast<float>(q)) {
+                    k++;
+                }
+                const float delta = static_cast<float>(q) - static_cast<float>(v[k]);
+                d[q] = delta * delta + f[v[k]];
+            }
+        }
+
+        // Separable 2D transform over a square grid: columns, then rows.
+        void distance_transform(std::vector<float> &grid, const uint32_t width) {
+            std::vector<float> line(width);
+            std::vector<float> result(width);
+            std::vector<uint32_t> v(width);
+            std::vector<float> z(width + 1);
+            for (uint32_t x = 0; x < width; x++) {
+                for (uint32_t y = 0; y < width; y++) {
+                    line[y] = grid[y * width + x];
+                }
+                distance_transform_1d(line.data(), result.data(), width, v, z);
+                for (uint32_t y = 0; y < width; y++) {
+                    grid[y * width + x] = result[y];
+                }
+            }
+            for (uint32_t y = 0; y < width; y++) {
+                distance_transform_1d(&grid[y * width], result.data(), width, v, z);
+                std::copy(result.begin(), result.end(), grid.begin() + y * width);
+            }
+        }
+    } // namespace
+
+    PyroGlyphAtlas::PyroGlyphAtlas(VulkanDevice *device, const GlyphAtlasConfig config) :
+        device(device), config(config) {
+        ImageDesc desc{};
+        desc.extent = {config.size, config.size};
+        desc.format = VK_FORMAT_R8_UNORM;
+        desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        image = std::make_unique<VulkanImage>(device, desc);
+        // Everything added in a frame fits in one atlas' worth of texels, since glyphs never overlap.
+        staging = std::make_unique<VulkanBuffer>(
+                device, static_cast<VkDeviceSize>(config.size) * config.size * MAX_FRAMES_IN_FLIGHT,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+
+    const GlyphInfo &PyroGlyphAtlas::get_glyph(const uint32_t codepoint) {
+        if (const auto it = glyphs.find(codepoint); it != glyphs.end()) {
+            return it->second;
+        }
+        if (const GlyphInfo *glyph = add_glyph(codepoint)) {
+            return *glyph;
+        }
+        // Remember the fallback so a missing codepoint is only looked up once.
+        GlyphInfo fallback{};
+        fallback.advance = 1.0f;
+        if (codepoint != FALLBACK_CODEPOINT) {
+            fallback = get_glyph(FALLBACK_CODEPOINT);
+        }
+        return glyphs[codepoint] = fallback;
+    }
+
+    const GlyphInfo *PyroGlyphAtlas::add_glyph(const uint32_t codepoint) {
+        const uint8_t *bitmap = builtin_font_glyph(codepoint);
+        if (bitmap == nullptr) {
+            return nullptr;
+        }
+        GlyphInfo glyph{};
+        glyph.advance = 1.0f;
+        if (std::all_of(bitmap, bitmap + BUILTIN_FONT_CELL, [](const uint8_t row) { return row == 0; })) {
+            return &(glyphs[codepoint] = glyph);
+        }
+
+        const uint32_t scale = std::max(config.resolution / BUILTIN_FONT_CELL, 1u);
+        const uint32_t width = BUILTIN_FONT_CELL * scale + 2 * config.spread;
+        VkOffset2D offset{};
+        if (!pack({width, width}, offset)) {
+            if (!full_warned) {
+                LOG(LogLevel::WARNING, "Glyph atlas full at {} glyphs, falling back to '?'", glyphs.size());
+                full_warned = true;
+            }
+            return nullptr;
+        }
+        pending.push_back({offset, {width, width}, pending_texels.size()});
+        build_distance_field(bitmap, width, pending_texels);
+
+        const auto x = static_cast<uint32_t>(offset.x);
+        const auto y = static_cast<uint32_t>(offset.y);
+        glyph.uv[0] = unorm16(x, config.size);
+        glyph.uv[1] = unorm16(y, config.size);
+        glyph.uv[2] = unorm16(x + width, config.size);
+        glyph.uv[3] = unorm16(y + width, config.size);
+        const auto em = static_cast<float>(BUILTIN_FONT_CELL * scale);
+        glyph.offset = glm::vec2(-static_cast<float>(config.spread) / em);
+        glyph.size = glm::vec2(static_cast<float>(width) / em);
+        glyph.visible = true;
+        return &(glyphs[codepoint] = glyph);
+    }
+
+    bool PyroGlyphAtlas::pack(const VkExtent2D extent, VkOffset2D &offset) {
+        if (shelf_x + extent.width > config.size) {
+            shelf_y += shelf_height;
+            shelf_x = 0;
+            shelf_height = 0;
+        }
+        if (extent.width > config.size || shelf_y + extent.height > config.size) {
+            return false;
+        }
+        offset = {static_cast<int32_t>(shelf_x), static_cast<int32_t>(shelf_y)};
+        shelf_x += extent.width;
+        shelf_height = std::max(shelf_height, extent.height);
+        return true;
+    }
+
+    // Upscales the bitmap by nearest neighbour into a width x width grid centred in the padding, then encodes the
+    // signed distance to the outline (measured between texel centres) as 0.5 - distance / (2 * spread).
+    void PyroGlyphAtlas::build_distance_field(const uint8_t *bitmap, const uint32_t width,
+                                              std::vector<uint8_t> &out) const {
+        const uint32_t scale = std::max(config.resolution / BUILTIN_FONT_CELL, 1u);
+        const uint32_t texels = width * width;
+        std::vector<bool> covered(texels);
+        std::vector<float> to_inside(texels);
+        std::vector<float> to_outside(texels);
+        for (uint32_t y = 0; y < width; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                const bool in_cell = x >= config.spread && y >= config.spread;
+                const uint32_t gx = in_cell ? (x - config.spread) / scale : BUILTIN_FONT_CELL;
+                const uint32_t gy = in_cell ? (y - config.spread) / scale : BUILTIN_FONT_CELL;
+                const bool inside = gx < BUILTIN_FONT_CELL && gy < BUILTIN_FONT_CELL && (bitmap[gy] >> gx & 1);
+                covered[y * width + x] = inside;
+                to_inside[y * width + x] = inside ? 0.0f : FAR_AWAY;
+                to_outside[y * width + x] = inside ? FAR_AWAY : 0.0f;
+            }
+        }
+        distance_transform(to_inside, width);
+        distance_transform(to_outside, width);
+
+        const size_t first = out.size();
+        out.resize(first + texels);
+        const float range = 2.0f * static_cast<float>(config.spread);
+        for (uint32_t i = 0; i < texels; i++) {
+            const float distance = covered[i] ? -(std::sqrt(to_outside[i]) - 0.5f) : std::sqrt(to_inside[i]) - 0.5f;
+            const float value = std::clamp(0.5f - distance / range, 0.0f, 1.0f);
+            out[first + i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+        }
+    }
+
+    void PyroGlyphAtlas::begin_frame(const uint32_t frame_index) { this->frame_index = frame_index; }
+
+    void PyroGlyphAtlas::record_uploads(const VkCommandBuffer command_buffer) {
+        if (initialised && pending.empty()) {
+            return;
+        }
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        // Placed glyphs keep their texels; earlier frames may still be sampling them.
+        barrier.oldLayout = initialised ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image->get_image();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+        if (!initialised) {
+            constexpr VkClearColorValue clear{};
+            vkCmdClearColorImage(command_buffer, image->get_image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear, 1,
+                                 &barrier.subresourceRange);
+            VkMemoryBarrier clear_done{};
+            clear_done.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            clear_done.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            clear_done.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1,
+                                 &clear_done, 0, nullptr, 0, nullptr);
+            initialised = true;
+        }
+
+        if (!pending.empty()) {
+            const VkDeviceSize base = static_cast<VkDeviceSize>(frame_index) * config.size * config.size;
+            std::memcpy(static_cast<char *>(staging->get_mapped()) + base, pending_texels.data(),
+                        pending_texels.size());
+            std::vector<VkBufferImageCopy> regions;
+            for (const PendingUpload &upload : pending) {
+                VkBufferImageCopy region{};
+                region.bufferOffset = base + upload.first_texel;
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+                region.imageOffset = {upload.offset.x, upload.offset.y, 0};
+                region.imageExtent = {upload.extent.width, upload.extent.height, 1};
+                regions.push_back(region);
+            }
+            vkCmdCopyBufferToImage(command_buffer, staging->get_buffer(), image->get_image(),
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()),
+                                   regions.data());
+            pending.clear();
+            pending_texels.clear();
+        }
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+    }
+} // namespace pyro
@@ -0,0 +1,91 @@
+//
+// Created by srijan on 2/25/25.
+//
+
+#ifndef PYROGLYPHATLAS_HPP
+#define PYROGLYPHATLAS_HPP
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanBuffer.hpp"
+#include "../core/VulkanImage.hpp"
+
+namespace pyro {
+
+    struct GlyphInfo {
+        // Atlas rectangle as unorm16 u0, v0, u1, v1.
+        uint16_t uv[4];
+        // Quad relative to the pen position, in ems, y down. Includes the distance field's padding.
+        glm::vec2 offset;
+        glm::vec2 size;
+        float advance;
+        // Whitespace has no quad.
+        bool visible;
+    };
+
+    struct GlyphAtlasConfig {
+        uint32_t size = 512;
+        // Atlas texels per em.
+        uint32_t resolution = 32;
+        // Texels of distance encoded on each side of an edge; also the padding around every glyph.
+        uint32_t spread = 4;
+    };
+
+    // Single-channel signed distance field atlas, filled on demand. The first request for a codepoint rasterises
+    // it from the built-in font at `resolution` texels per em, runs an exact Euclidean distance transform over it,
+    // and shelf-packs the result next to the glyphs already present; glyphs never move once placed, so only the
+    // new rectangles are uploaded. The field stores 0.5 on the outline, rising inside, and stays sharp under
+    // magnification because the shader resolves the edge per pixel.
+    class PyroGlyphAtlas {
+    public:
+        static constexpr float LINE_HEIGHT = 1.25f;
+
+        explicit PyroGlyphAtlas(VulkanDevice *device, GlyphAtlasConfig config = {});
+        PyroGlyphAtlas(const PyroGlyphAtlas &) = delete;
+        PyroGlyphAtlas &operator=(const PyroGlyphAtlas &) = delete;
+
+        // Codepoints without a glyph, or that no longer fit, fall back to '?'.
+        const GlyphInfo &get_glyph(uint32_t codepoint);
+
+        void begin_frame(uint32_t frame_index);
+        // Uploads every glyph added since the last call and leaves the atlas in SHADER_READ_ONLY_OPTIMAL. Must be
+        // recorded outside rendering scopes, before any draw sampling the atlas.
+        void record_uploads(VkCommandBuffer command_buffer);
+
+        VkImageView get_view() const { return image->get_view(); }
+        uint32_t get_glyph_count() const { return static_cast<uint32_t>(glyphs.size()); }
+
+    private:
+        struct PendingUpload {
+            VkOffset2D offset;
+            VkExtent2D extent;
+            size_t first_texel;
+        };
+
+        VulkanDevice *device;
+        GlyphAtlasConfig config;
+        std::unique_ptr<VulkanImage> image;
+        std::unique_ptr<VulkanBuffer> staging;
+        uint32_t frame_index = 0;
+        bool initialised = false;
+        std::unordered_map<uint32_t, GlyphInfo> glyphs;
+        std::vector<PendingUpload> pending;
+        std::vector<uint8_t> pending_texels;
+        // Shelf packer state: glyphs are placed left to right along the current shelf.
+        uint32_t shelf_x = 0;
+        uint32_t shelf_y = 0;
+        uint32_t shelf_height = 0;
+        bool full_warned = false;
+
+        const GlyphInfo *add_glyph(uint32_t codepoint);
+        bool pack(VkExtent2D extent, VkOffset2D &offset);
+        void build_distance_field(const uint8_t *bitmap, uint32_t width, std::vector<uint8_t> &out) const;
+    };
+
+} // namespace pyro
+
+#endif // PYROGLYPHATLAS_HPP
@@ -0,0 +1,168 @@
+//
+// Created by srijan on 2/25/25.
+//
+
+#include "PyroTextRenderer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t VERTICES_PER_GLYPH = 6;
+        // Runs not drawn for this many frames are dropped from the cache, checked every EVICTION_INTERVAL frames.
+        constexpr uint64_t RUN_LIFETIME_FRAMES = 240;
+        constexpr uint64_t EVICTION_INTERVAL = 60;
+
+        struct TextPushConstants {
+            glm::vec2 inverse_half_extent;
+        };
+    } // namespace
+
+    PyroTextRenderer::PyroTextRenderer(VulkanDevice *device, PyroDescriptors *descriptors, TextRendererConfig config) :
+        device(device), descriptors(descriptors), config(std::move(config)), atlas(device, this->config.atlas) {
+        VkSamplerCreateInfo sampler_info{};
+        sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.magFilter = VK_FILTER_LINEAR;
+        sampler_info.minFilter = VK_FILTER_LINEAR;
+        sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        ASSERT_EQUAL(vkCreateSampler(device->get_logical_device(), &sampler_info, nullptr, &sampler), VK_SUCCESS,
+                     "Failed to create glyph sampler")
+        bindings.bind_image(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT,
+                            atlas.get_view(), sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        GraphicsPipelineDesc desc{};
+        desc.vertex_shader = "assets/shaders/text.vert.spv";
+        desc.fragment_shader = "assets/shaders/text.frag.spv";
+        desc.vertex_bindings = {{0, sizeof(TextInstance), VK_VERTEX_INPUT_RATE_INSTANCE}};
+        desc.vertex_attributes = {
+                {0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(TextInstance, position)},
+                {1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(TextInstance, size)},
+                {2, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(TextInstance, uv)},
+                {3, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(TextInstance, color)},
+        };
+        desc.cull_mode = VK_CULL_MODE_NONE;
+        desc.blend_mode = PipelineBlendMode::ALPHA;
+        // Overlays draw over whatever depth the scene left behind.
+        desc.depth_test = false;
+        desc.depth_write = false;
+        desc.formats = this->config.formats;
+        pipeline = std::make_unique<Pyropipeline>(
+                device, std::vector{descriptors->get_layout(bindings)},
+                std::vector{VkPushConstantRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(TextPushConstants)}}, desc);
+
+        const VkDeviceSize frame_bytes = static_cast<VkDeviceSize>(this->config.max_glyphs) * sizeof(TextInstance);
+        instances = std::make_unique<VulkanBuffer>(device, frame_bytes * MAX_FRAMES_IN_FLIGHT,
+                                                   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                           VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+
+    PyroTextRenderer::~PyroTextRenderer() {
+        vkDeviceWaitIdle(device->get_logical_device());
+        vkDestroySampler(device->get_logical_device(), sampler, nullptr);
+    }
+
+    void PyroTextRenderer::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        frame_number++;
+        atlas.begin_frame(frame_index);
+        if (frame_number % EVICTION_INTERVAL == 0) {
+            std::erase_if(runs, [this](const auto &entry) {
+                return frame_number - entry.second.last_used > RUN_LIFETIME_FRAMES;
+            });
+        }
+        stats = {};
+        stats.cached_runs = static_cast<uint32_t>(runs.size());
+    }
+
+    // Lays the text out in ems from the origin. The built-in font is monospaced, so shaping is a pen walk with
+    // line breaks; bytes outside ASCII map to the fallback glyph.
+    const PyroTextRenderer::ShapedRun &PyroTextRenderer::shape(const std::string_view text) {
+        auto [entry, inserted] = runs.try_emplace(std::hash<std::string_view>{}(text));
+        ShapedRun &run = entry->second;
+        run.last_used = frame_number;
+        // A hash collision simply reshapes the entry for the newer string.
+        if (!inserted && run.text == text) {
+            return run;
+        }
+
+        stats.shaped_runs++;
+        run.text = text;
+        run.glyphs.clear();
+        run.extent = glm::vec2(0.0f);
+        glm::vec2 pen(0.0f);
+        for (const char c : text) {
+            if (c == '\n') {
+                pen = glm::vec2(0.0f, pen.y + PyroGlyphAtlas::LINE_HEIGHT);
+                continue;
+            }
+            const GlyphInfo &glyph = atlas.get_glyph(static_cast<unsigned char>(c));
+            if (glyph.visible) {
+                ShapedGlyph shaped{};
+                shaped.offset = pen + glyph.offset;
+                shaped.size = glyph.size;
+                std::copy(std::begin(glyph.uv), std::end(glyph.uv), std::begin(shaped.uv));
+                run.glyphs.push_back(shaped);
+            }
+            pen.x += glyph.advance;
+            run.extent = glm::max(run.extent, glm::vec2(pen.x, pen.y + 1.0f));
+        }
+        return run;
+    }
+
+    glm::vec2 PyroTextRenderer::measure(const std::string_view text, const float size) {
+        return shape(text).extent * size;
+    }
+
+    glm::vec2 PyroTextRenderer::draw_text(const std::string_view text, const glm::vec2 position, const float size,
+                                          const uint32_t color) {
+        const ShapedRun &run = shape(text);
+        stats.runs++;
+        auto *out = static_cast<TextInstance *>(instances->get_mapped()) +
+                    static_cast<size_t>(frame_index) * config.max_glyphs + stats.glyphs;
+        const uint32_t room = config.max_glyphs - stats.glyphs;
+        const auto count = static_cast<uint32_t>(std::min<size_t>(run.glyphs.size(), room));
+        if (count < run.glyphs.size()) {
+            if (stats.dropped_glyphs == 0) {
+                LOG(LogLevel::WARNING, "Text instance stream full at {} glyphs, dropping further text this frame",
+                    config.max_glyphs);
+            }
+            stats.dropped_glyphs += static_cast<uint32_t>(run.glyphs.size()) - count;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            const ShapedGlyph &glyph = run.glyphs[i];
+            out[i] = {position + glyph.offset * size, glyph.size * size,
+                      {glyph.uv[0], glyph.uv[1], glyph.uv[2], glyph.uv[3]}, color};
+        }
+        stats.glyphs += count;
+        return run.extent * size;
+    }
+
+    void PyroTextRenderer::record(const VkCommandBuffer command_buffer, const VkExtent2D extent) {
+        if (stats.glyphs == 0) {
+            return;
+        }
+        const VkDeviceSize first = static_cast<VkDeviceSize>(frame_index) * config.max_glyphs * sizeof(TextInstance);
+        instances->flush(first, stats.glyphs * sizeof(TextInstance));
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get_pipeline());
+        const VkDescriptorSet set = descriptors->get_cached_set(bindings);
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get_pipeline_layout(), 0, 1,
+                                &set, 0, nullptr);
+        const TextPushConstants push{glm::vec2(2.0f / static_cast<float>(extent.width),
+                                               2.0f / static_cast<float>(extent.height))};
+        vkCmdPushConstants(command_buffer, pipeline->get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(push),
+                           &push);
+        const VkBuffer buffer = instances->get_buffer();
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &buffer, &first);
+        vkCmdDraw(command_buffer, VERTICES_PER_GLYPH, stats.glyphs, 0, 0);
+    }
+} // namespace pyro
@@ -0,0 +1,103 @@
+//
+// Created by srijan on 2/25/25.
+//
+
+#ifndef PYROTEXTRENDERER_HPP
+#define PYROTEXTRENDERER_HPP
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../core/VulkanBuffer.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "../renderer/Pyropipeline.hpp"
+#include "PyroGlyphAtlas.hpp"
+
+namespace pyro {
+
+    // Must match the instance inputs of assets/shaders/text.vert.
+    struct TextInstance {
+        glm::vec2 position;
+        glm::vec2 size;
+        uint16_t uv[4];
+        uint32_t color;
+    };
+
+    struct TextRendererConfig {
+        uint32_t max_glyphs = 16384;
+        GlyphAtlasConfig atlas;
+        PipelineAttachmentFormats formats;
+    };
+
+    struct TextFrameStats {
+        uint32_t glyphs = 0;
+        uint32_t dropped_glyphs = 0;
+        uint32_t runs = 0;
+        uint32_t shaped_runs = 0;
+        uint32_t cached_runs = 0;
+    };
+
+    // Screen-space text from a signed distance field glyph atlas. Strings are shaped once into glyph quads in em
+    // units and cached under their hash, so drawing unchanged text is a lookup plus a scaled copy into this
+    // frame's instance stream; runs not drawn for a while are evicted. Everything drawn in a frame goes out as
+    // one instanced draw.
+    class PyroTextRenderer {
+    public:
+        PyroTextRenderer(VulkanDevice *device, PyroDescriptors *descriptors, TextRendererConfig config = {});
+        ~PyroTextRenderer();
+        PyroTextRenderer(const PyroTextRenderer &) = delete;
+        PyroTextRenderer &operator=(const PyroTextRenderer &) = delete;
+
+        // The slot's previous frame must have completed.
+        void begin_frame(uint32_t frame_index);
+        // `position` is the top-left of the first line in pixels and `size` the em height in pixels; '\n' starts
+        // a new line. Returns the pixel extent of the text.
+        glm::vec2 draw_text(std::string_view text, glm::vec2 position, float size, uint32_t color = 0xffffffff);
+        glm::vec2 measure(std::string_view text, float size);
+
+        // Uploads glyphs first used this frame. Must be recorded outside rendering scopes, after this frame's
+        // draw_text() calls and before record().
+        void record_uploads(VkCommandBuffer command_buffer) { atlas.record_uploads(command_buffer); }
+        // Draws this frame's text; must be called inside a rendering scope whose formats match config.formats.
+        void record(VkCommandBuffer command_buffer, VkExtent2D extent);
+
+        const TextFrameStats &get_stats() const { return stats; }
+        PyroGlyphAtlas &get_atlas() { return atlas; }
+
+    private:
+        struct ShapedGlyph {
+            glm::vec2 offset;
+            glm::vec2 size;
+            uint16_t uv[4];
+        };
+        struct ShapedRun {
+            std::string text;
+            std::vector<ShapedGlyph> glyphs;
+            glm::vec2 extent;
+            uint64_t last_used;
+        };
+
+        VulkanDevice *device;
+        PyroDescriptors *descriptors;
+        TextRendererConfig config;
+        PyroGlyphAtlas atlas;
+        VkSampler sampler{};
+        PyroDescriptorBindings bindings;
+        std::unique_ptr<Pyropipeline> pipeline;
+        std::unique_ptr<VulkanBuffer> instances;
+        std::unordered_map<size_t, ShapedRun> runs;
+        uint32_t frame_index = 0;
+        uint64_t frame_number = 0;
+        TextFrameStats stats;
+
+        const ShapedRun &shape(std::string_view text);
+    };
+
+} // namespace pyro
+
+#endif // PYROTEXTRENDERER_HPP
@@ -0,0 +1,302 @@
+//
+// Created by srijan on 2/19/25.
+//
+
+#include "PyroTextureFile.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32,
+                                                 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        constexpr uint32_t fourcc(const char (&code)[5]) {
+            return static_cast<uint32_t>(code[0]) | static_cast<uint32_t>(code[1]) << 8 |
+                   static_cast<uint32_t>(code[2]) << 16 | static_cast<uint32_t>(code[3]) << 24;
+        }
+
+        // Subset of DDS_HEADER / DDS_PIXELFORMAT; all fields are little-endian uint32.
+        struct DdsHeader {
+            uint32_t size;
+            uint32_t flags;
+            uint32_t height;
+            uint32_t width;
+            uint32_t pitch_or_linear_size;
+            uint32_t depth;
+            uint32_t mip_map_count;
+            uint32_t reserved1[11];
+            uint32_t pf_size;
+            uint32_t pf_flags;
+            uint32_t pf_fourcc;
+            uint32_t pf_rgb_bit_count;
+            uint32_t pf_masks[4];
+            uint32_t caps[4];
+            uint32_t reserved2;
+        };
+        static_assert(sizeof(DdsHeader) == 124);
+
+        struct DdsHeaderDx10 {
+            uint32_t dxgi_format;
+            uint32_t resource_dimension;
+            uint32_t misc_flag;
+            uint32_t array_size;
+            uint32_t misc_flags2;
+        };
+
+        constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+        constexpr uint32_t DDPF_FOURCC = 0x4;
+        constexpr uint32_t DDPF_RGB = 0x40;
+        constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+        constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+        VkFormat dxgi_to_vk(const uint32_t dxgi_format) {
+            switch (dxgi_format) {
+                case 28: return VK_FORMAT_R8G8B8A8_UNORM;
+                case 29: return VK_FORMAT_R8G8B8A8_SRGB;
+                case 87: return VK_FORMAT_B8G8R8A8_UNORM;
+                case 91: return VK_FORMAT_B8G8R8A8_SRGB;
+                case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+                case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+                case 74: return VK_FORMAT_BC2_UNORM_BLOCK;
+                case 75: return VK_FORMAT_BC2_SRGB_BLOCK;
+                case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+                case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+                case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+                case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+                case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+                case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+                case 95: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+                case 96: return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+                case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+                case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+                default: return VK_FORMAT_UNDEFINED;
+            }
+        }
+
+        template<typename T>
+        bool read_struct(std::ifstream &file, T &value) {
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+
+        // A full chain down to 1x1: log2 of the larger extent, plus one.
+        uint32_t max_level_count(const uint32_t width, const uint32_t height) {
+            return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+        }
+
+        uint64_t file_size(std::ifstream &file) {
+            const std::streampos position = file.tellg();
+            file.seekg(0, std::ios::end);
+            const auto size = static_cast<uint64_t>(file.tellg());
+            file.seekg(position);
+            return size;
+        }
+    } // namespace
+
+    uint64_t TextureFileInfo::chain_size(const uint32_t first_level) const {
+        uint64_t size = 0;
+        for (uint32_t i = first_level; i < mip_count(); i++) {
+            size += levels[i].size;
+        }
+        return size;
+    }
+
+    bool PyroTextureFile::is_block_compressed(const VkFormat format) {
+        return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK;
+    }
+
+    uint32_t PyroTextureFile::format_block_bytes(const VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                return 4;
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            case VK_FORMAT_BC4_UNORM_BLOCK:
+            case VK_FORMAT_BC4_SNORM_BLOCK:
+                return 8;
+            case VK_FORMAT_BC2_UNORM_BLOCK:
+            case VK_FORMAT_BC2_SRGB_BLOCK:
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+            case VK_FORMAT_BC5_SNORM_BLOCK:
+            case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+            case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
+    uint64_t PyroTextureFile::level_size(const VkFormat format, const uint32_t width, const uint32_t height) {
+        if (is_block_compressed(format)) {
+            return static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4) * format_block_bytes(format);
+        }
+        return static_cast<uint64_t>(width) * height * format_block_bytes(format);
+    }
+
+    std::optional<TextureFileInfo> PyroTextureFile::read_info(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            LOG(LogLevel::ERROR, "Failed to open texture {}", path);
+            return std::nullopt;
+        }
+        uint8_t magic[12] = {};
+        file.read(reinterpret_cast<char *>(magic), sizeof(magic));
+        std::optional<TextureFileInfo> info;
+        if (file && std::memcmp(magic, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0) {
+            info = read_ktx2(file);
+        } else if (file && std::memcmp(magic, "DDS ", 4) == 0) {
+            file.clear();
+            file.seekg(4);
+            info = read_dds(file);
+        }
+        if (!info.has_value() || format_block_bytes(info->format) == 0 || info->levels.empty()) {
+            LOG(LogLevel::ERROR, "Unsupported texture file {}", path);
+            return std::nullopt;
+        }
+        return info;
+    }
+
+    std::optional<TextureFileInfo> PyroTextureFile::read_ktx2(std::ifstream &file) {
+        struct {
+            uint32_t vk_format;
+            uint32_t type_size;
+            uint32_t pixel_width;
+            uint32_t pixel_height;
+            uint32_t pixel_depth;
+            uint32_t layer_count;
+            uint32_t face_count;
+            uint32_t level_count;
+            uint32_t supercompression_scheme;
+            uint32_t dfd_byte_offset;
+            uint32_t dfd_byte_length;
+            uint32_t kvd_byte_offset;
+            uint32_t kvd_byte_length;
+            uint64_t sgd_byte_offset;
+            uint64_t sgd_byte_length;
+        } header{};
+        if (!read_struct(file, header)) {
+            return std::nullopt;
+        }
+        if (header.pixel_depth > 0 || header.layer_count > 1 || header.face_count != 1 ||
+            header.supercompression_scheme != 0) {
+            return std::nullopt;
+        }
+        TextureFileInfo info;
+        info.format = static_cast<VkFormat>(header.vk_format);
+        info.width = header.pixel_width;
+        info.height = std::max(header.pixel_height, 1u);
+        const uint32_t level_count = std::max(header.level_count, 1u);
+        if (info.width == 0 || format_block_bytes(info.format) == 0 ||
+            level_count > max_level_count(info.width, info.height)) {
+            return std::nullopt;
+        }
+        // The level index is untrusted: every level must hold exactly its extent's worth of data, inside the file,
+        // or read_levels() would size its buffer and the upload from whatever the file claims.
+        const uint64_t size = file_size(file);
+        for (uint32_t i = 0; i < level_count; i++) {
+            uint64_t index[3];
+            if (!read_struct(file, index)) {
+                return std::nullopt;
+            }
+            const TextureLevel level{index[0], index[1], std::max(info.width >> i, 1u), std::max(info.height >> i, 1u)};
+            if (level.size != level_size(info.format, level.width, level.height) || level.offset > size ||
+                level.size > size - level.offset) {
+                return std::nullopt;
+            }
+            info.levels.push_back(level);
+        }
+        return info;
+    }
+
+    std::optional<TextureFileInfo> PyroTextureFile::read_dds(std::ifstream &file) {
+        DdsHeader header{};
+        if (!read_struct(file, header) || header.size != sizeof(DdsHeader)) {
+            return std::nullopt;
+        }
+        if ((header.caps[1] & DDSCAPS2_CUBEMAP) || header.depth > 1) {
+            return std::nullopt;
+        }
+        TextureFileInfo info;
+        uint64_t data_offset = 4 + sizeof(DdsHeader);
+        if ((header.pf_flags & DDPF_FOURCC) && header.pf_fourcc == fourcc("DX10")) {
+            DdsHeaderDx10 dx10{};
+            if (!read_struct(file, dx10) || dx10.array_size > 1 || (dx10.misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE)) {
+                return std::nullopt;
+            }
+            info.format = dxgi_to_vk(dx10.dxgi_format);
+            data_offset += sizeof(DdsHeaderDx10);
+        } else if (header.pf_flags & DDPF_FOURCC) {
+            switch (header.pf_fourcc) {
+                case fourcc("DXT1"): info.format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK; break;
+                case fourcc("DXT3"): info.format = VK_FORMAT_BC2_UNORM_BLOCK; break;
+                case fourcc("DXT5"): info.format = VK_FORMAT_BC3_UNORM_BLOCK; break;
+                case fourcc("ATI1"):
+                case fourcc("BC4U"): info.format = VK_FORMAT_BC4_UNORM_BLOCK; break;
+                case fourcc("ATI2"):
+                case fourcc("BC5U"): info.format = VK_FORMAT_BC5_UNORM_BLOCK; break;
+                default: return std::nullopt;
+            }
+        } else if ((header.pf_flags & DDPF_RGB) && header.pf_rgb_bit_count == 32) {
+            if (header.pf_masks[0] == 0x000000FF && header.pf_masks[2] == 0x00FF0000) {
+                info.format = VK_FORMAT_R8G8B8A8_UNORM;
+            } else if (header.pf_masks[0] == 0x00FF0000 && header.pf_masks[2] == 0x000000FF) {
+                info.format = VK_FORMAT_B8G8R8A8_UNORM;
+            }
+        }
+        info.width = header.width;
+        info.height = header.height;
+        const uint32_t level_count = (header.flags & DDSD_MIPMAPCOUNT) ? std::max(header.mip_map_count, 1u) : 1;
+        if (info.width == 0 || info.height == 0 || format_block_bytes(info.format) == 0 ||
+            level_count > max_level_count(info.width, info.height)) {
+            return std::nullopt;
+        }
+        // DDS stores the chain finest-first with no index; offsets follow from the level sizes, which come from an
+        // untrusted header and so must still land inside the file.
+        const uint64_t file_bytes = file_size(file);
+        for (uint32_t i = 0; i < level_count; i++) {
+            const uint32_t width = std::max(info.width >> i, 1u);
+            const uint32_t height = std::max(info.height >> i, 1u);
+            const uint64_t size = level_size(info.format, width, height);
+            if (data_offset > file_bytes || size > file_bytes - data_offset) {
+                return std::nullopt;
+            }
+            info.levels.push_back({data_offset, size, width, height});
+            data_offset += size;
+        }
+        return info;
+    }
+
+    bool PyroTextureFile::read_levels(const std::string &path, const TextureFileInfo &info, const uint32_t first_level,
+                                      const uint32_t last_level, std::vector<char> &out,
+                                      std::vector<uint64_t> &level_offsets) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        for (uint32_t i = first_level; i <= last_level && i < info.mip_count(); i++) {
+            const TextureLevel &level = info.levels[i];
+            const uint64_t start = out.size();
+            level_offsets.push_back(start);
+            out.resize(start + level.size);
+            file.seekg(static_cast<std::streamoff>(level.offset));
+            if (!file.read(out.data() + start, static_cast<std::streamsize>(level.size))) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace pyro
@@ -0,0 +1,57 @@
+//
+// Created by srijan on 2/19/25.
+//
+
+#ifndef PYROTEXTUREFILE_HPP
+#define PYROTEXTUREFILE_HPP
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace pyro {
+
+    struct TextureLevel {
+        uint64_t offset;
+        uint64_t size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct TextureFileInfo {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        // Level 0 is full resolution.
+        std::vector<TextureLevel> levels;
+
+        uint32_t mip_count() const { return static_cast<uint32_t>(levels.size()); }
+        // Bytes of levels [first_level, mip_count), i.e. an image whose finest level is first_level.
+        uint64_t chain_size(uint32_t first_level) const;
+    };
+
+    // Reader for pre-mipped texture containers: KTX2 (without supercompression) and DDS (legacy FourCC and DX10
+    // headers). Only 2D, single-layer images in RGBA8/BGRA8 or BC1-BC7 are accepted. Headers and levels are read
+    // separately so a streamer can fetch exactly the mips it needs.
+    class PyroTextureFile {
+    public:
+        static std::optional<TextureFileInfo> read_info(const std::string &path);
+        // Appends levels [first_level, last_level] to `out` in that order, recording where each one starts.
+        static bool read_levels(const std::string &path, const TextureFileInfo &info, uint32_t first_level,
+                                uint32_t last_level, std::vector<char> &out, std::vector<uint64_t> &level_offsets);
+
+        static bool is_block_compressed(VkFormat format);
+        // Bytes per 4x4 block for BC formats, per texel otherwise; 0 when the format is unsupported.
+        static uint32_t format_block_bytes(VkFormat format);
+        static uint64_t level_size(VkFormat format, uint32_t width, uint32_t height);
+
+    private:
+        static std::optional<TextureFileInfo> read_ktx2(std::ifstream &file);
+        static std::optional<TextureFileInfo> read_dds(std::ifstream &file);
+    };
+
+} // namespace pyro
+
+#endif // PYROTEXTUREFILE_HPP
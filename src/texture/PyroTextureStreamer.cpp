@@ -0,0 +1,544 @@
+//
+// Created by srijan on 2/19/25.
+//
+
+#include "PyroTextureStreamer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../utils/Logger.hpp"
+
+namespace pyro {
+    PyroTextureStreamer::PyroTextureStreamer(VulkanDevice *device, PyroDescriptors *descriptors,
+                                             const TextureStreamingConfig &config) :
+        device(device), descriptors(descriptors), bindless(descriptors->get_bindless()), config(config) {
+        VkSamplerCreateInfo sampler_info{};
+        sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.magFilter = VK_FILTER_LINEAR;
+        sampler_info.minFilter = VK_FILTER_LINEAR;
+        sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.minLod = 0.0f;
+        sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+        ASSERT_EQUAL(vkCreateSampler(device->get_logical_device(), &sampler_info, nullptr, &sampler), VK_SUCCESS,
+                     "Failed to create texture sampler")
+
+        staging = std::make_unique<VulkanBuffer>(device, config.staging_bytes_per_frame * MAX_FRAMES_IN_FLIGHT,
+                                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        // One uint per handle per frame in flight; shaders atomicMin the finest level they wanted.
+        const VkDeviceSize feedback_region = config.max_textures * sizeof(uint32_t);
+        feedback = std::make_unique<VulkanBuffer>(device, feedback_region * MAX_FRAMES_IN_FLIGHT,
+                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                                  VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        std::memset(feedback->get_mapped(), 0xFF, feedback_region * MAX_FRAMES_IN_FLIGHT);
+        feedback->flush();
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            PyroDescriptorBindings bindings;
+            bindings.bind_buffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                 VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT, feedback->get_buffer(),
+                                 i * feedback_region, feedback_region);
+            feedback_layout = descriptors->get_layout(bindings);
+            feedback_sets[i] = descriptors->get_cached_set(bindings);
+        }
+
+        if (config.encode_rgba8) {
+            if (PyroBlockCompressor::is_supported(device)) {
+                compressor = std::make_unique<PyroBlockCompressor>(device, descriptors);
+            } else {
+                LOG(LogLevel::WARNING, "BC textures are not supported by this device; RGBA8 uploads stay RGBA8");
+            }
+        }
+
+        for (uint32_t i = 0; i < std::max(config.io_threads, 1u); i++) {
+            workers.emplace_back(&PyroTextureStreamer::io_worker, this);
+        }
+        LOG(LogLevel::INFO, "Texture streaming: {} MiB budget, {} MiB staging per frame, {} I/O threads",
+            config.budget_bytes / (1024 * 1024), config.staging_bytes_per_frame / (1024 * 1024), workers.size());
+    }
+
+    PyroTextureStreamer::~PyroTextureStreamer() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        job_available.notify_all();
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        descriptors->invalidate_buffer(feedback->get_buffer());
+        vkDestroySampler(device->get_logical_device(), sampler, nullptr);
+    }
+
+    TextureHandle PyroTextureStreamer::request(const std::string &path) {
+        if (const auto it = handles_by_path.find(path); it != handles_by_path.end()) {
+            return it->second;
+        }
+        TextureHandle handle;
+        if (!free_handles.empty()) {
+            handle = free_handles.back();
+            free_handles.pop_back();
+        } else {
+            ASSERT_EQUAL(textures.size() < config.max_textures, true, "Too many streamed textures")
+            handle = static_cast<TextureHandle>(textures.size());
+            textures.emplace_back();
+        }
+        StreamedTexture &texture = textures[handle];
+        const uint32_t generation = texture.generation + 1;
+        texture = StreamedTexture{};
+        texture.path = path;
+        texture.alive = true;
+        texture.generation = generation;
+        texture.last_requested_frame = frame_number;
+        // The tail level is unknown until the header is read; any value other than NO_LEVEL marks the load.
+        texture.loading_mip = 0;
+        handles_by_path.emplace(path, handle);
+        // Header and mip tail in one job, ahead of every promotion.
+        submit({handle, generation, NO_LEVEL, 0, 0, path, {}});
+        return handle;
+    }
+
+    void PyroTextureStreamer::release(const TextureHandle handle) {
+        StreamedTexture &texture = textures[handle];
+        if (!texture.alive) {
+            return;
+        }
+        retire(texture);
+        handles_by_path.erase(texture.path);
+        texture.alive = false;
+        texture.generation++;
+        free_handles.push_back(handle);
+    }
+
+    void PyroTextureStreamer::request_mip(const TextureHandle handle, const uint32_t mip) {
+        StreamedTexture &texture = textures[handle];
+        if (!texture.alive) {
+            return;
+        }
+        texture.requested_mip = std::min(texture.requested_mip, mip);
+        texture.last_requested_frame = frame_number;
+    }
+
+    void PyroTextureStreamer::begin_frame(const uint32_t frame_index) {
+        this->frame_index = frame_index;
+        frame_number++;
+        uploads = 0;
+        evictions = 0;
+        staging_head = frame_index * config.staging_bytes_per_frame;
+        if (compressor) {
+            compressor->begin_frame(frame_index);
+        }
+
+        std::erase_if(retired, [&](const RetiredImage &image) {
+            if (image.release_frame > frame_number) {
+                return false;
+            }
+            resident_bytes -= image.image->get_memory_size();
+            retiring_bytes -= image.image->get_memory_size();
+            return true;
+        });
+
+        // The fence for this frame index has been waited on, so its feedback region is complete.
+        const VkDeviceSize feedback_region = config.max_textures * sizeof(uint32_t);
+        feedback->invalidate(frame_index * feedback_region, feedback_region);
+        uint32_t *requests = static_cast<uint32_t *>(feedback->get_mapped()) + frame_index * config.max_textures;
+        for (TextureHandle handle = 0; handle < textures.size(); handle++) {
+            if (requests[handle] != NO_LEVEL) {
+                request_mip(handle, requests[handle]);
+            }
+        }
+        std::memset(requests, 0xFF, feedback_region);
+        feedback->flush(frame_index * feedback_region, feedback_region);
+
+        schedule();
+        for (StreamedTexture &texture: textures) {
+            texture.requested_mip = NO_LEVEL;
+        }
+    }
+
+    void PyroTextureStreamer::schedule() {
+        struct Candidate {
+            TextureHandle handle;
+            uint32_t level;
+            uint64_t size;
+        };
+        std::vector<Candidate> candidates;
+        for (TextureHandle handle = 0; handle < textures.size(); handle++) {
+            const StreamedTexture &texture = textures[handle];
+            if (!texture.alive || !texture.has_info || texture.failed || texture.loading_mip != NO_LEVEL ||
+                texture.demoting || texture.requested_mip == NO_LEVEL) {
+                continue;
+            }
+            if (texture.resident_mip == NO_LEVEL) {
+                // Dropped by an eviction and wanted again: start over from the tail.
+                candidates.push_back({handle, NO_LEVEL, 0});
+                continue;
+            }
+            if (texture.requested_mip >= texture.resident_mip) {
+                continue;
+            }
+            const uint32_t level = texture.resident_mip - 1;
+            if (texture.info.levels[level].size > config.staging_bytes_per_frame) {
+                continue;
+            }
+            candidates.push_back({handle, level, texture.info.levels[level].size});
+        }
+        // Coarsest first: every texture gets its cheap levels before anyone gets an expensive one.
+        std::ranges::sort(candidates, {}, &Candidate::size);
+
+        std::unique_lock lock(mutex);
+        uint32_t in_flight = pending_loads;
+        lock.unlock();
+        for (const Candidate &candidate: candidates) {
+            if (in_flight >= config.max_pending_loads) {
+                break;
+            }
+            StreamedTexture &texture = textures[candidate.handle];
+            const uint32_t first_level = candidate.level == NO_LEVEL ? tail_level(texture.info) : candidate.level;
+            const VkDeviceSize needed = estimate_image_size(texture, first_level);
+            if (resident_bytes + reserved_bytes + needed > config.budget_bytes) {
+                // Memory released by evictions only comes back once the frames using it retire, so try again
+                // in a later frame rather than overshooting the budget now.
+                make_room(needed, candidate.handle);
+                break;
+            }
+            reserved_bytes += needed;
+            texture.loading_mip = first_level;
+            submit({candidate.handle, texture.generation, candidate.level, candidate.size, needed, texture.path,
+                    texture.info});
+            in_flight++;
+        }
+    }
+
+    bool PyroTextureStreamer::make_room(const VkDeviceSize needed, const TextureHandle requester) {
+        const VkDeviceSize committed = resident_bytes + reserved_bytes + needed;
+        if (committed <= config.budget_bytes) {
+            return true;
+        }
+        // Retired images still count until their frames are done with them, but they are already on the way out:
+        // only evict for what they don't cover, or every frame spent waiting on them would claim more victims.
+        if (committed - std::min(committed, retiring_bytes) <= config.budget_bytes) {
+            return false;
+        }
+        VkDeviceSize shortfall = committed - retiring_bytes - config.budget_bytes;
+        std::vector<TextureHandle> victims;
+        for (TextureHandle handle = 0; handle < textures.size(); handle++) {
+            const StreamedTexture &texture = textures[handle];
+            if (handle != requester && texture.alive && texture.image && texture.loading_mip == NO_LEVEL &&
+                !texture.demoting && texture.last_requested_frame < frame_number) {
+                victims.push_back(handle);
+            }
+        }
+        std::ranges::sort(victims, {},
+                          [&](const TextureHandle handle) { return textures[handle].last_requested_frame; });
+
+        for (const TextureHandle handle: victims) {
+            StreamedTexture &texture = textures[handle];
+            const VkDeviceSize current = texture.image->get_memory_size();
+            const uint32_t next_level = texture.resident_mip + 1;
+            const VkDeviceSize demoted = estimate_image_size(texture, next_level);
+            if (next_level <= tail_level(texture.info) &&
+                resident_bytes + reserved_bytes + demoted <= config.budget_bytes) {
+                texture.demoting = true;
+                reserved_bytes += demoted;
+                pending_demotions.push_back({handle, texture.generation, demoted});
+                shortfall -= std::min(shortfall, current - std::min(current, demoted));
+            } else {
+                // Only the tail is left, or there is no headroom for the smaller copy: drop it outright.
+                retire(texture);
+                shortfall -= std::min(shortfall, current);
+            }
+            evictions++;
+            if (shortfall == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t PyroTextureStreamer::tail_level(const TextureFileInfo &info) const {
+        for (uint32_t i = 0; i < info.mip_count(); i++) {
+            if (std::max(info.levels[i].width, info.levels[i].height) <= config.mip_tail_size) {
+                return i;
+            }
+        }
+        return info.mip_count() - 1;
+    }
+
+    VkFormat PyroTextureStreamer::resident_format(const StreamedTexture &texture) {
+        return texture.encode_bc1 ? VK_FORMAT_BC1_RGB_UNORM_BLOCK : texture.info.format;
+    }
+
+    VkDeviceSize PyroTextureStreamer::estimate_image_size(const StreamedTexture &texture,
+                                                          const uint32_t first_level) const {
+        // Optimal tiling pads small levels; round each chain up to a 64 KiB page like most allocators would.
+        constexpr VkDeviceSize page = 64 * 1024;
+        VkDeviceSize size = texture.info.chain_size(first_level);
+        if (texture.encode_bc1) {
+            size = 0;
+            for (uint32_t i = first_level; i < texture.info.mip_count(); i++) {
+                size += PyroTextureFile::level_size(VK_FORMAT_BC1_RGB_UNORM_BLOCK, texture.info.levels[i].width,
+                                                    texture.info.levels[i].height);
+            }
+        }
+        return (size + page - 1) / page * page;
+    }
+
+    void PyroTextureStreamer::submit(LoadJob job) {
+        {
+            std::lock_guard lock(mutex);
+            jobs.push(std::move(job));
+            pending_loads++;
+        }
+        job_available.notify_one();
+    }
+
+    void PyroTextureStreamer::io_worker() {
+        while (true) {
+            std::unique_lock lock(mutex);
+            job_available.wait(lock, [&] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            LoadJob job = jobs.top();
+            jobs.pop();
+            lock.unlock();
+
+            LoadResult result{job.handle, job.generation, job.level, std::nullopt, {}, {}, job.reserved, false};
+            if (job.level == NO_LEVEL) {
+                result.info = PyroTextureFile::read_info(job.path);
+                if (result.info.has_value()) {
+                    result.first_level = tail_level(*result.info);
+                    result.failed = !PyroTextureFile::read_levels(job.path, *result.info, result.first_level,
+                                                                  result.info->mip_count() - 1, result.data,
+                                                                  result.level_offsets);
+                } else {
+                    result.failed = true;
+                }
+            } else {
+                result.failed = !PyroTextureFile::read_levels(job.path, job.info, job.level, job.level, result.data,
+                                                              result.level_offsets);
+            }
+
+            lock.lock();
+            results.push_back(std::move(result));
+        }
+    }
+
+    void PyroTextureStreamer::record_uploads(const VkCommandBuffer command_buffer) {
+        for (const Demotion &demotion: pending_demotions) {
+            StreamedTexture &texture = textures[demotion.handle];
+            reserved_bytes -= demotion.reserved;
+            if (texture.generation == demotion.generation && texture.image) {
+                replace_image(command_buffer, texture, texture.resident_mip + 1, nullptr, 0);
+            }
+            texture.demoting = false;
+        }
+        pending_demotions.clear();
+
+        std::deque<LoadResult> ready;
+        {
+            std::lock_guard lock(mutex);
+            ready.swap(results);
+        }
+        const VkDeviceSize staging_start = frame_index * config.staging_bytes_per_frame;
+        const VkDeviceSize staging_end = staging_start + config.staging_bytes_per_frame;
+        std::deque<LoadResult> deferred;
+        uint32_t finished = 0;
+        for (LoadResult &result: ready) {
+            StreamedTexture &texture = textures[result.handle];
+            if (!texture.alive || texture.generation != result.generation) {
+                reserved_bytes -= result.reserved;
+                finished++;
+                continue;
+            }
+            if (result.info.has_value()) {
+                texture.info = *result.info;
+                texture.has_info = true;
+                texture.encode_bc1 = compressor && texture.info.format == VK_FORMAT_R8G8B8A8_UNORM;
+                if (PyroTextureFile::is_block_compressed(texture.info.format) &&
+                    !device->get_capabilities().texture_compression_bc) {
+                    LOG(LogLevel::ERROR, "{}: BC textures are not supported by this device", texture.path);
+                    result.failed = true;
+                }
+            }
+            if (!result.failed && result.data.size() > config.staging_bytes_per_frame) {
+                LOG(LogLevel::ERROR, "{}: mip tail exceeds the per-frame staging size", texture.path);
+                result.failed = true;
+            }
+            if (result.failed) {
+                LOG(LogLevel::ERROR, "Failed to stream texture {}", texture.path);
+                texture.failed = true;
+                texture.loading_mip = NO_LEVEL;
+                reserved_bytes -= result.reserved;
+                finished++;
+                continue;
+            }
+            // First-time tails were not reserved up front because their size was unknown until now.
+            const VkDeviceSize unreserved =
+                    result.reserved == 0 ? estimate_image_size(texture, result.first_level) : 0;
+            const VkDeviceSize offset = (staging_head + 15) / 16 * 16;
+            const bool over_budget =
+                    unreserved > 0 && resident_bytes + reserved_bytes + unreserved > config.budget_bytes;
+            if (over_budget) {
+                // As in schedule(): evicted memory only comes back once the frames using it retire, so wait for
+                // it rather than overshooting the budget now.
+                make_room(unreserved, result.handle);
+            }
+            if (offset + result.data.size() > staging_end || over_budget) {
+                deferred.push_back(std::move(result));
+                continue;
+            }
+            std::memcpy(static_cast<char *>(staging->get_mapped()) + offset, result.data.data(), result.data.size());
+            staging_head = offset + result.data.size();
+            replace_image(command_buffer, texture, result.first_level, &result, offset);
+            reserved_bytes -= result.reserved;
+            texture.loading_mip = NO_LEVEL;
+            uploads++;
+            finished++;
+        }
+        staging->flush(staging_start, staging_head - staging_start);
+
+        std::lock_guard lock(mutex);
+        pending_loads -= finished;
+        results.insert(results.begin(), std::make_move_iterator(deferred.begin()),
+                       std::make_move_iterator(deferred.end()));
+    }
+
+    void PyroTextureStreamer::replace_image(const VkCommandBuffer command_buffer, StreamedTexture &texture,
+                                            const uint32_t first_level, const LoadResult *upload,
+                                            const VkDeviceSize staging_offset) {
+        const TextureFileInfo &info = texture.info;
+        ImageDesc desc{};
+        desc.extent = {info.levels[first_level].width, info.levels[first_level].height};
+        desc.format = resident_format(texture);
+        desc.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        desc.mip_levels = info.mip_count() - first_level;
+        auto image = std::make_unique<VulkanImage>(device, desc);
+        resident_bytes += image->get_memory_size();
+
+        const uint32_t upload_first = upload ? upload->first_level : NO_LEVEL;
+        const uint32_t upload_count = upload ? static_cast<uint32_t>(upload->level_offsets.size()) : 0;
+        const auto uploaded_level = [&](const uint32_t level) {
+            return upload && level >= upload_first && level < upload_first + upload_count;
+        };
+        std::vector<VkImageCopy> copies;
+        if (texture.image) {
+            for (uint32_t level = std::max(first_level, texture.resident_mip); level < info.mip_count(); level++) {
+                if (uploaded_level(level)) {
+                    continue;
+                }
+                VkImageCopy copy{};
+                copy.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - texture.resident_mip, 0, 1};
+                copy.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - first_level, 0, 1};
+                copy.extent = {info.levels[level].width, info.levels[level].height, 1};
+                copies.push_back(copy);
+            }
+        }
+
+        VkImageMemoryBarrier barriers[2] = {};
+        barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barriers[0].srcAccessMask = 0;
+        barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[0].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[0].image = image->get_image();
+        barriers[0].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, desc.mip_levels, 0, 1};
+        uint32_t barrier_count = 1;
+        if (!copies.empty()) {
+            // Earlier frames may still be sampling the old image; order the copy after them.
+            barriers[1] = barriers[0];
+            barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barriers[1].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barriers[1].image = texture.image->get_image();
+            barriers[1].subresourceRange.levelCount = texture.image->get_desc().mip_levels;
+            barrier_count = 2;
+        }
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, barrier_count, barriers);
+
+        if (!copies.empty()) {
+            vkCmdCopyImage(command_buffer, texture.image->get_image(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           image->get_image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(copies.size()), copies.data());
+        }
+        if (upload) {
+            std::vector<VkBufferImageCopy> regions;
+            for (uint32_t i = 0; i < upload_count; i++) {
+                const TextureLevel &level = info.levels[upload_first + i];
+                VkBufferImageCopy region{};
+                region.bufferOffset = staging_offset + upload->level_offsets[i];
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, upload_first + i - first_level, 0, 1};
+                region.imageExtent = {level.width, level.height, 1};
+                regions.push_back(region);
+            }
+            if (texture.encode_bc1) {
+                compressor->upload_bc1(command_buffer, staging->get_buffer(), regions, *image,
+                                       upload_first - first_level);
+            } else {
+                vkCmdCopyBufferToImage(command_buffer, staging->get_buffer(), image->get_image(),
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()),
+                                       regions.data());
+            }
+        }
+
+        barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, barriers);
+
+        retire(texture);
+        texture.image = std::move(image);
+        texture.resident_mip = first_level;
+        if (bindless) {
+            texture.bindless_index =
+                    bindless->register_image(texture.image->get_view(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+    }
+
+    void PyroTextureStreamer::retire(StreamedTexture &texture) {
+        if (texture.image) {
+            retiring_bytes += texture.image->get_memory_size();
+            retired.push_back({std::move(texture.image), frame_number + MAX_FRAMES_IN_FLIGHT});
+        }
+        if (bindless && texture.bindless_index != PyroBindlessTable::INVALID_INDEX) {
+            bindless->release_image(texture.bindless_index);
+        }
+        texture.bindless_index = PyroBindlessTable::INVALID_INDEX;
+        texture.resident_mip = NO_LEVEL;
+    }
+
+    VkImageView PyroTextureStreamer::get_view(const TextureHandle handle) const {
+        const StreamedTexture &texture = textures[handle];
+        return texture.alive && texture.image ? texture.image->get_view() : VK_NULL_HANDLE;
+    }
+
+    uint32_t PyroTextureStreamer::get_bindless_index(const TextureHandle handle) const {
+        return textures[handle].bindless_index;
+    }
+
+    uint32_t PyroTextureStreamer::get_resident_mip(const TextureHandle handle) const {
+        return textures[handle].resident_mip;
+    }
+
+    VkDescriptorSet PyroTextureStreamer::get_feedback_set() const { return feedback_sets[frame_index]; }
+
+    TextureStreamingStats PyroTextureStreamer::get_stats() const {
+        std::lock_guard lock(mutex);
+        return {resident_bytes, config.budget_bytes, pending_loads, uploads, evictions};
+    }
+} // namespace pyro
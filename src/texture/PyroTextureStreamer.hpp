@@ -0,0 +1,202 @@
+//
+// Created by srijan on 2/19/25.
+//
+
+#ifndef PYROTEXTURESTREAMER_HPP
+#define PYROTEXTURESTREAMER_HPP
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "../compute/PyroBlockCompressor.hpp"
+#include "../core/VulkanBuffer.hpp"
+#include "../core/VulkanImage.hpp"
+#include "../descriptor/PyroDescriptors.hpp"
+#include "PyroTextureFile.hpp"
+
+namespace pyro {
+
+    using TextureHandle = uint32_t;
+    constexpr TextureHandle INVALID_TEXTURE = ~0u;
+
+    struct TextureStreamingConfig {
+        // Ceiling for all streamed image memory, including images waiting to be destroyed.
+        VkDeviceSize budget_bytes = 256ull * 1024 * 1024;
+        // Upload bandwidth per frame; levels larger than this are never made resident.
+        VkDeviceSize staging_bytes_per_frame = 16ull * 1024 * 1024;
+        // Levels no larger than this in either dimension form the mip tail, loaded in one go on first request.
+        uint32_t mip_tail_size = 128;
+        uint32_t max_textures = 4096;
+        uint32_t io_threads = 2;
+        uint32_t max_pending_loads = 16;
+        // Encode RGBA8_UNORM textures to BC1 on upload, for an eighth of their memory. Drops alpha; ignored
+        // without textureCompressionBC.
+        bool encode_rgba8 = false;
+    };
+
+    struct TextureStreamingStats {
+        VkDeviceSize resident_bytes;
+        VkDeviceSize budget_bytes;
+        uint32_t pending_loads;
+        uint32_t uploads;
+        uint32_t evictions;
+    };
+
+    // Streams pre-mipped KTX2/DDS textures against a fixed VRAM budget.
+    //
+    // request() returns immediately; background I/O threads read the header and the mip tail, which is
+    // uploaded before anything finer. After that a texture only gains one level at a time, and only when a
+    // finer level was asked for through request_mip() or the GPU feedback buffer (texture_feedback.glsl).
+    // Pending promotions are served coarsest-first across all textures. When a promotion does not fit the
+    // budget, the least recently requested textures are demoted one level, or dropped entirely if they have
+    // only their tail left.
+    //
+    // Each texture lives in one image holding exactly its resident levels. Changing residency builds a new
+    // image, copies the surviving levels across on the GPU and retires the old one after MAX_FRAMES_IN_FLIGHT
+    // frames, so the views and bindless indices returned here are only valid for the current frame.
+    //
+    // With TextureStreamingConfig::encode_rgba8, RGBA8 levels are encoded to BC1 by a compute pass inside
+    // record_uploads(), which therefore leaves a compute pipeline bound.
+    class PyroTextureStreamer {
+    public:
+        PyroTextureStreamer(VulkanDevice *device, PyroDescriptors *descriptors,
+                            const TextureStreamingConfig &config = {});
+        ~PyroTextureStreamer();
+        PyroTextureStreamer(const PyroTextureStreamer &) = delete;
+        PyroTextureStreamer &operator=(const PyroTextureStreamer &) = delete;
+
+        TextureHandle request(const std::string &path);
+        void release(TextureHandle handle);
+        // CPU-side feedback: `mip` is the finest level (0 = full resolution) needed this frame.
+        void request_mip(TextureHandle handle, uint32_t mip);
+
+        // Call after the frame's fence wait: consumes that frame's GPU feedback and schedules loads/evictions.
+        void begin_frame(uint32_t frame_index);
+        // Records this frame's uploads and residency changes. Must come before any draw using the textures.
+        void record_uploads(VkCommandBuffer command_buffer);
+
+        VkImageView get_view(TextureHandle handle) const;
+        uint32_t get_bindless_index(TextureHandle handle) const;
+        // Finest resident file level, or ~0u when nothing is resident yet.
+        uint32_t get_resident_mip(TextureHandle handle) const;
+        VkSampler get_sampler() const { return sampler; }
+        // Storage buffer set for texture_feedback.glsl, one uint per handle, for the current frame.
+        VkDescriptorSet get_feedback_set() const;
+        VkDescriptorSetLayout get_feedback_layout() const { return feedback_layout; }
+        TextureStreamingStats get_stats() const;
+
+    private:
+        static constexpr uint32_t NO_LEVEL = ~0u;
+
+        struct StreamedTexture {
+            std::string path;
+            TextureFileInfo info;
+            bool has_info = false;
+            // RGBA8 file encoded to a BC1 image by the compressor.
+            bool encode_bc1 = false;
+            bool failed = false;
+            bool alive = false;
+            uint32_t generation = 0;
+            std::unique_ptr<VulkanImage> image;
+            uint32_t bindless_index = ~0u;
+            // Image level 0 is file level resident_mip.
+            uint32_t resident_mip = NO_LEVEL;
+            uint32_t requested_mip = NO_LEVEL;
+            uint32_t loading_mip = NO_LEVEL;
+            bool demoting = false;
+            uint64_t last_requested_frame = 0;
+        };
+
+        struct LoadJob {
+            TextureHandle handle;
+            uint32_t generation;
+            // NO_LEVEL means "read the header and the mip tail".
+            uint32_t level;
+            uint64_t priority;
+            VkDeviceSize reserved;
+            std::string path;
+            TextureFileInfo info;
+            bool operator<(const LoadJob &other) const { return priority > other.priority; }
+        };
+
+        struct LoadResult {
+            TextureHandle handle;
+            uint32_t generation;
+            uint32_t first_level;
+            std::optional<TextureFileInfo> info;
+            std::vector<char> data;
+            std::vector<uint64_t> level_offsets;
+            VkDeviceSize reserved;
+            bool failed;
+        };
+
+        struct Demotion {
+            TextureHandle handle;
+            uint32_t generation;
+            VkDeviceSize reserved;
+        };
+
+        struct RetiredImage {
+            std::unique_ptr<VulkanImage> image;
+            uint64_t release_frame;
+        };
+
+        void io_worker();
+        void submit(LoadJob job);
+        void schedule();
+        bool make_room(VkDeviceSize needed, TextureHandle requester);
+        uint32_t tail_level(const TextureFileInfo &info) const;
+        static VkFormat resident_format(const StreamedTexture &texture);
+        VkDeviceSize estimate_image_size(const StreamedTexture &texture, uint32_t first_level) const;
+        void replace_image(VkCommandBuffer command_buffer, StreamedTexture &texture, uint32_t first_level,
+                           const LoadResult *upload, VkDeviceSize staging_offset);
+        void retire(StreamedTexture &texture);
+
+        VulkanDevice *device;
+        PyroDescriptors *descriptors;
+        PyroBindlessTable *bindless;
+        TextureStreamingConfig config;
+        std::vector<StreamedTexture> textures;
+        std::vector<TextureHandle> free_handles;
+        std::unordered_map<std::string, TextureHandle> handles_by_path;
+        std::vector<RetiredImage> retired;
+        std::vector<Demotion> pending_demotions;
+        VkSampler sampler{};
+
+        std::unique_ptr<PyroBlockCompressor> compressor;
+        std::unique_ptr<VulkanBuffer> staging;
+        VkDeviceSize staging_head = 0;
+        std::unique_ptr<VulkanBuffer> feedback;
+        VkDescriptorSetLayout feedback_layout{};
+        std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> feedback_sets{};
+
+        VkDeviceSize resident_bytes = 0;
+        VkDeviceSize reserved_bytes = 0;
+        // The part of resident_bytes held by retired images.
+        VkDeviceSize retiring_bytes = 0;
+        uint32_t frame_index = 0;
+        uint64_t frame_number = 0;
+        uint32_t uploads = 0;
+        uint32_t evictions = 0;
+
+        std::vector<std::thread> workers;
+        mutable std::mutex mutex;
+        std::condition_variable job_available;
+        std::priority_queue<LoadJob> jobs;
+        std::deque<LoadResult> results;
+        uint32_t pending_loads = 0;
+        bool stopping = false;
+    };
+
+} // namespace pyro
+
+#endif // PYROTEXTURESTREAMER_HPP
@@ -0,0 +1,20 @@
+//
+// Created by srijan on 2/16/25.
+//
+
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstddef>
+#include <functional>
+
+namespace pyro {
+
+    template<typename T>
+    void hash_combine(size_t &seed, const T &value) {
+        seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+} // namespace pyro
+
+#endif // HASH_HPP
@@ -0,0 +1,61 @@
+//
+// Created by srijan on 2/24/25.
+//
+
+#ifndef RADIXSORT_HPP
+#define RADIXSORT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pyro {
+
+    // Stable LSD radix sort of 64-bit items by their upper 32 bits, one byte per pass. The lower half rides along
+    // untouched (usually an index into the caller's data), so equal keys keep their insertion order. Histograms
+    // for every pass are built in a single read, and passes whose byte is identical across all items are skipped,
+    // so keys that only use their low bits cost one or two scatters. `scratch` is reused between calls.
+    inline void radix_sort_by_key(std::vector<uint64_t> &items, std::vector<uint64_t> &scratch) {
+        constexpr uint32_t PASSES = 4;
+        constexpr uint32_t RADIX = 256;
+        if (items.size() < 2) {
+            return;
+        }
+        scratch.resize(items.size());
+
+        std::array<std::array<uint32_t, RADIX>, PASSES> histograms{};
+        for (const uint64_t item : items) {
+            const auto key = static_cast<uint32_t>(item >> 32);
+            for (uint32_t pass = 0; pass < PASSES; pass++) {
+                histograms[pass][(key >> (pass * 8)) & 0xff]++;
+            }
+        }
+
+        uint64_t *source = items.data();
+        uint64_t *destination = scratch.data();
+        const auto first_key = static_cast<uint32_t>(items.front() >> 32);
+        for (uint32_t pass = 0; pass < PASSES; pass++) {
+            std::array<uint32_t, RADIX> &offsets = histograms[pass];
+            const uint32_t shift = pass * 8 + 32;
+            if (offsets[(first_key >> (pass * 8)) & 0xff] == items.size()) {
+                continue;
+            }
+            uint32_t sum = 0;
+            for (uint32_t &offset : offsets) {
+                sum += std::exchange(offset, sum);
+            }
+            for (size_t i = 0; i < items.size(); i++) {
+                destination[offsets[(source[i] >> shift) & 0xff]++] = source[i];
+            }
+            std::swap(source, destination);
+        }
+        if (source != items.data()) {
+            items.swap(scratch);
+        }
+    }
+
+} // namespace pyro
+
+#endif // RADIXSORT_HPP
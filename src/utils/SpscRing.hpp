@@ -0,0 +1,60 @@
+//
+// Created by srijan on 3/5/25.
+//
+
+#ifndef SPSCRING_HPP
+#define SPSCRING_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pyro {
+
+    // Fixed-capacity single-producer single-consumer queue. Each side owns one index and only reads the other's,
+    // with acquire/release ordering publishing the slot contents, so neither side ever blocks or locks. Capacity
+    // must be a power of two; push() fails instead of overwriting when the consumer falls behind.
+    template<typename T, size_t Capacity>
+    class SpscRing {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+    public:
+        // Producer side.
+        bool push(const T &value) {
+            const uint64_t tail = write_index.load(std::memory_order_relaxed);
+            if (tail - read_index.load(std::memory_order_acquire) == Capacity) {
+                return false;
+            }
+            slots[tail & (Capacity - 1)] = value;
+            write_index.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side.
+        bool pop(T &value) {
+            const uint64_t head = read_index.load(std::memory_order_relaxed);
+            if (head == write_index.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = slots[head & (Capacity - 1)];
+            read_index.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Exact from either side only while the other is idle.
+        size_t size() const {
+            return static_cast<size_t>(write_index.load(std::memory_order_acquire) -
+                                       read_index.load(std::memory_order_acquire));
+        }
+
+    private:
+        // Separate cache lines so the two sides don't false-share.
+        alignas(64) std::atomic<uint64_t> write_index{0};
+        alignas(64) std::atomic<uint64_t> read_index{0};
+        std::array<T, Capacity> slots{};
+    };
+
+} // namespace pyro
+
+#endif // SPSCRING_HPP
@@ -4,4 +4,105 @@
 
 #include "PyroEvents.hpp"
 
-namespace pyro {} // namespace pyro
+#include "../profiler/PyroTrace.hpp"
+
+namespace pyro {
+    void PyroEvents::pump() {
+        PYRO_ZONE("pump_events");
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            translate(event);
+        }
+    }
+
+    void PyroEvents::wait_and_pump(const int32_t timeout_ms) {
+        SDL_Event event;
+        if (SDL_WaitEventTimeout(&event, timeout_ms)) {
+            translate(event);
+            pump();
+        }
+    }
+
+    void PyroEvents::run_input_loop(const int32_t period_ms) {
+        PyroTrace::get_instance().set_thread_name("input");
+        while (!quit_requested()) {
+            wait_and_pump(period_ms);
+        }
+    }
+
+    bool PyroEvents::is_key_down(const KeyCode key) const {
+        const auto index = static_cast<size_t>(key);
+        if (index >= static_cast<size_t>(KeyCode::COUNT)) {
+            return false;
+        }
+        return (key_state[index / 64].load(std::memory_order_relaxed) >> (index % 64)) & 1;
+    }
+
+    void PyroEvents::publish(const InputEvent &event) {
+        if (!ring.push(event)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void PyroEvents::translate(const SDL_Event &event) {
+        InputEvent input{};
+        input.timestamp_ns = event.common.timestamp;
+        switch (event.type) {
+            case SDL_EVENT_QUIT:
+            case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
+                request_quit();
+                input.type = InputEventType::QUIT;
+                break;
+            case SDL_EVENT_KEY_DOWN:
+            case SDL_EVENT_KEY_UP: {
+                const bool down = event.type == SDL_EVENT_KEY_DOWN;
+                const auto index = static_cast<size_t>(event.key.scancode);
+                if (index < static_cast<size_t>(KeyCode::COUNT)) {
+                    const uint64_t bit = uint64_t{1} << (index % 64);
+                    if (down) {
+                        key_state[index / 64].fetch_or(bit, std::memory_order_relaxed);
+                    } else {
+                        key_state[index / 64].fetch_and(~bit, std::memory_order_relaxed);
+                    }
+                }
+                input.type = down ? InputEventType::KEY_DOWN : InputEventType::KEY_UP;
+                input.key = static_cast<KeyCode>(event.key.scancode);
+                input.modifiers = event.key.mod;
+                input.repeat = event.key.repeat;
+                break;
+            }
+            case SDL_EVENT_MOUSE_MOTION:
+                input.type = InputEventType::MOUSE_MOVE;
+                input.x = event.motion.x;
+                input.y = event.motion.y;
+                break;
+            case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            case SDL_EVENT_MOUSE_BUTTON_UP:
+                input.type = event.type == SDL_EVENT_MOUSE_BUTTON_DOWN ? InputEventType::MOUSE_BUTTON_DOWN
+                                                                       : InputEventType::MOUSE_BUTTON_UP;
+                input.button = event.button.button;
+                input.x = event.button.x;
+                input.y = event.button.y;
+                break;
+            case SDL_EVENT_MOUSE_WHEEL:
+                input.type = InputEventType::MOUSE_WHEEL;
+                input.x = event.wheel.x;
+                input.y = event.wheel.y;
+                break;
+            case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+                input.type = InputEventType::WINDOW_RESIZED;
+                input.x = static_cast<float>(event.window.data1);
+                input.y = static_cast<float>(event.window.data2);
+                break;
+            case SDL_EVENT_WINDOW_FOCUS_GAINED:
+                input.type = InputEventType::FOCUS_GAINED;
+                break;
+            case SDL_EVENT_WINDOW_FOCUS_LOST:
+                input.type = InputEventType::FOCUS_LOST;
+                break;
+            default:
+                return;
+        }
+        publish(input);
+    }
+} // namespace pyro
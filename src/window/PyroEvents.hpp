@@ -5,143 +5,216 @@
 #ifndef PYROEVENTS_HPP
 #define PYROEVENTS_HPP
 
-#define SDL2
+#include <SDL3/SDL.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "../utils/SpscRing.hpp"
+
 namespace pyro {
 
-    enum class KeyCode {
-#if GLFW
-        UNKNOWN = GLFW_KEY_UNKNOWN,
+    // Physical key positions (SDL scancodes), independent of the keyboard layout.
+    enum class KeyCode : uint16_t {
+        UNKNOWN = SDL_SCANCODE_UNKNOWN,
         // Printable Key
-        Space = GLFW_KEY_SPACE,
-        Apostrophe = GLFW_KEY_APOSTROPHE,
-        Comma = GLFW_KEY_COMMA,
-        Minus = GLFW_KEY_MINUS,
-        Period = GLFW_KEY_PERIOD,
-        Slash = GLFW_KEY_SLASH,
-        Num0 = GLFW_KEY_0,
-        Num1 = GLFW_KEY_1,
-        Num2 = GLFW_KEY_2,
-        Num3 = GLFW_KEY_3,
-        Num4 = GLFW_KEY_4,
-        Num5 = GLFW_KEY_5,
-        Num6 = GLFW_KEY_6,
-        Num7 = GLFW_KEY_7,
-        Num8 = GLFW_KEY_8,
-        Num9 = GLFW_KEY_9,
-        Semicolon = GLFW_KEY_SEMICOLON,
-        Equal = GLFW_KEY_EQUAL,
-        A = GLFW_KEY_A,
-        B = GLFW_KEY_B,
-        C = GLFW_KEY_C,
-        D = GLFW_KEY_D,
-        E = GLFW_KEY_E,
-        F = GLFW_KEY_F,
-        G = GLFW_KEY_G,
-        H = GLFW_KEY_H,
-        I = GLFW_KEY_I,
-        J = GLFW_KEY_J,
-        K = GLFW_KEY_K,
-        L = GLFW_KEY_L,
-        M = GLFW_KEY_M,
-        N = GLFW_KEY_N,
-        O = GLFW_KEY_O,
-        P = GLFW_KEY_P,
-        Q = GLFW_KEY_Q,
-        R = GLFW_KEY_R,
-        S = GLFW_KEY_S,
-        T = GLFW_KEY_T,
-        U = GLFW_KEY_U,
-        V = GLFW_KEY_V,
-        W = GLFW_KEY_W,
-        X = GLFW_KEY_X,
-        Y = GLFW_KEY_Y,
-        Z = GLFW_KEY_Z,
-        left_bracket = GLFW_KEY_LEFT_BRACKET,
-        backslash = GLFW_KEY_BACKSLASH,
-        right_bracket = GLFW_KEY_RIGHT_BRACKET,
-        grave_accent = GLFW_KEY_GRAVE_ACCENT,
-
-        Escape = GLFW_KEY_ESCAPE,
-        Enter = GLFW_KEY_ENTER,
-        Tab = GLFW_KEY_TAB,
-        Backspace = GLFW_KEY_BACKSPACE,
-        Insert = GLFW_KEY_INSERT,
-        Delete = GLFW_KEY_DELETE,
-
-        Up = GLFW_KEY_UP,
-        Down = GLFW_KEY_DOWN,
-        Left = GLFW_KEY_LEFT,
-        Right = GLFW_KEY_RIGHT,
-        PageUp = GLFW_KEY_PAGE_UP,
-        PageDown = GLFW_KEY_PAGE_DOWN,
-        Home = GLFW_KEY_HOME,
-        End = GLFW_KEY_END,
-
-        Caps_Lock = GLFW_KEY_CAPS_LOCK,
-        Scroll_Lock = GLFW_KEY_SCROLL_LOCK,
-        Numlock = GLFW_KEY_NUM_LOCK,
-
-        Print_screen = GLFW_KEY_PRINT_SCREEN,
-        Pause = GLFW_KEY_PAUSE,
-
-        F1 = GLFW_KEY_F1,
-        F2 = GLFW_KEY_F2,
-        F3 = GLFW_KEY_F3,
-        F4 = GLFW_KEY_F4,
-        F5 = GLFW_KEY_F5,
-        F6 = GLFW_KEY_F6,
-        F7 = GLFW_KEY_F7,
-        F8 = GLFW_KEY_F8,
-        F9 = GLFW_KEY_F9,
-        F10 = GLFW_KEY_F10,
-        F11 = GLFW_KEY_F11,
-        F12 = GLFW_KEY_F12,
-        F13 = GLFW_KEY_F13,
-        F14 = GLFW_KEY_F14,
-        F15 = GLFW_KEY_F15,
-        F16 = GLFW_KEY_F16,
-        F17 = GLFW_KEY_F17,
-        F18 = GLFW_KEY_F18,
-        F19 = GLFW_KEY_F19,
-        F20 = GLFW_KEY_F20,
-        F21 = GLFW_KEY_F21,
-        F22 = GLFW_KEY_F22,
-        F23 = GLFW_KEY_F23,
-        F24 = GLFW_KEY_F24,
-        F25 = GLFW_KEY_F25,
-
-        KeyPad_0 = GLFW_KEY_KP_0,
-        KeyPad_1 = GLFW_KEY_KP_1,
-        KeyPad_2 = GLFW_KEY_KP_2,
-        KeyPad_3 = GLFW_KEY_KP_3,
-        KeyPad_4 = GLFW_KEY_KP_4,
-        KeyPad_5 = GLFW_KEY_KP_5,
-        KeyPad_6 = GLFW_KEY_KP_6,
-        KeyPad_7 = GLFW_KEY_KP_7,
-        KeyPad_8 = GLFW_KEY_KP_8,
-        KeyPad_9 = GLFW_KEY_KP_9,
-        Keypad_decimal = GLFW_KEY_KP_DECIMAL,
-        Keypad_divide = GLFW_KEY_KP_DIVIDE,
-        Keypad_multiply = GLFW_KEY_KP_MULTIPLY,
-        Keypad_subtract = GLFW_KEY_KP_SUBTRACT,
-        Keypad_add = GLFW_KEY_KP_ADD,
-        KeyPad_enter = GLFW_KEY_KP_ENTER,
-        KeyPad_equal = GLFW_KEY_KP_EQUAL,
-
-        Left_Shift = GLFW_KEY_LEFT_SHIFT,
-        Left_Control = GLFW_KEY_LEFT_CONTROL,
-        Left_Alt = GLFW_KEY_LEFT_ALT,
-        Left_SUPER = GLFW_KEY_LEFT_SUPER,
-        Right_Shift = GLFW_KEY_RIGHT_SHIFT,
-        Right_Control = GLFW_KEY_RIGHT_CONTROL,
-        Right_Alt = GLFW_KEY_RIGHT_ALT,
-        Right_SUPER = GLFW_KEY_RIGHT_SUPER,
-        Menu = GLFW_KEY_MENU
-#endif
+        Space = SDL_SCANCODE_SPACE,
+        Apostrophe = SDL_SCANCODE_APOSTROPHE,
+        Comma = SDL_SCANCODE_COMMA,
+        Minus = SDL_SCANCODE_MINUS,
+        Period = SDL_SCANCODE_PERIOD,
+        Slash = SDL_SCANCODE_SLASH,
+        Num0 = SDL_SCANCODE_0,
+        Num1 = SDL_SCANCODE_1,
+        Num2 = SDL_SCANCODE_2,
+        Num3 = SDL_SCANCODE_3,
+        Num4 = SDL_SCANCODE_4,
+        Num5 = SDL_SCANCODE_5,
+        Num6 = SDL_SCANCODE_6,
+        Num7 = SDL_SCANCODE_7,
+        Num8 = SDL_SCANCODE_8,
+        Num9 = SDL_SCANCODE_9,
+        Semicolon = SDL_SCANCODE_SEMICOLON,
+        Equal = SDL_SCANCODE_EQUALS,
+        A = SDL_SCANCODE_A,
+        B = SDL_SCANCODE_B,
+        C = SDL_SCANCODE_C,
+        D = SDL_SCANCODE_D,
+        E = SDL_SCANCODE_E,
+        F = SDL_SCANCODE_F,
+        G = SDL_SCANCODE_G,
+        H = SDL_SCANCODE_H,
+        I = SDL_SCANCODE_I,
+        J = SDL_SCANCODE_J,
+        K = SDL_SCANCODE_K,
+        L = SDL_SCANCODE_L,
+        M = SDL_SCANCODE_M,
+        N = SDL_SCANCODE_N,
+        O = SDL_SCANCODE_O,
+        P = SDL_SCANCODE_P,
+        Q = SDL_SCANCODE_Q,
+        R = SDL_SCANCODE_R,
+        S = SDL_SCANCODE_S,
+        T = SDL_SCANCODE_T,
+        U = SDL_SCANCODE_U,
+        V = SDL_SCANCODE_V,
+        W = SDL_SCANCODE_W,
+        X = SDL_SCANCODE_X,
+        Y = SDL_SCANCODE_Y,
+        Z = SDL_SCANCODE_Z,
+        left_bracket = SDL_SCANCODE_LEFTBRACKET,
+        backslash = SDL_SCANCODE_BACKSLASH,
+        right_bracket = SDL_SCANCODE_RIGHTBRACKET,
+        grave_accent = SDL_SCANCODE_GRAVE,
+
+        Escape = SDL_SCANCODE_ESCAPE,
+        Enter = SDL_SCANCODE_RETURN,
+        Tab = SDL_SCANCODE_TAB,
+        Backspace = SDL_SCANCODE_BACKSPACE,
+        Insert = SDL_SCANCODE_INSERT,
+        Delete = SDL_SCANCODE_DELETE,
+
+        Up = SDL_SCANCODE_UP,
+        Down = SDL_SCANCODE_DOWN,
+        Left = SDL_SCANCODE_LEFT,
+        Right = SDL_SCANCODE_RIGHT,
+        PageUp = SDL_SCANCODE_PAGEUP,
+        PageDown = SDL_SCANCODE_PAGEDOWN,
+        Home = SDL_SCANCODE_HOME,
+        End = SDL_SCANCODE_END,
+
+        Caps_Lock = SDL_SCANCODE_CAPSLOCK,
+        Scroll_Lock = SDL_SCANCODE_SCROLLLOCK,
+        Numlock = SDL_SCANCODE_NUMLOCKCLEAR,
 
+        Print_screen = SDL_SCANCODE_PRINTSCREEN,
+        Pause = SDL_SCANCODE_PAUSE,
+
+        F1 = SDL_SCANCODE_F1,
+        F2 = SDL_SCANCODE_F2,
+        F3 = SDL_SCANCODE_F3,
+        F4 = SDL_SCANCODE_F4,
+        F5 = SDL_SCANCODE_F5,
+        F6 = SDL_SCANCODE_F6,
+        F7 = SDL_SCANCODE_F7,
+        F8 = SDL_SCANCODE_F8,
+        F9 = SDL_SCANCODE_F9,
+        F10 = SDL_SCANCODE_F10,
+        F11 = SDL_SCANCODE_F11,
+        F12 = SDL_SCANCODE_F12,
+        F13 = SDL_SCANCODE_F13,
+        F14 = SDL_SCANCODE_F14,
+        F15 = SDL_SCANCODE_F15,
+        F16 = SDL_SCANCODE_F16,
+        F17 = SDL_SCANCODE_F17,
+        F18 = SDL_SCANCODE_F18,
+        F19 = SDL_SCANCODE_F19,
+        F20 = SDL_SCANCODE_F20,
+        F21 = SDL_SCANCODE_F21,
+        F22 = SDL_SCANCODE_F22,
+        F23 = SDL_SCANCODE_F23,
+        F24 = SDL_SCANCODE_F24,
+
+        KeyPad_0 = SDL_SCANCODE_KP_0,
+        KeyPad_1 = SDL_SCANCODE_KP_1,
+        KeyPad_2 = SDL_SCANCODE_KP_2,
+        KeyPad_3 = SDL_SCANCODE_KP_3,
+        KeyPad_4 = SDL_SCANCODE_KP_4,
+        KeyPad_5 = SDL_SCANCODE_KP_5,
+        KeyPad_6 = SDL_SCANCODE_KP_6,
+        KeyPad_7 = SDL_SCANCODE_KP_7,
+        KeyPad_8 = SDL_SCANCODE_KP_8,
+        KeyPad_9 = SDL_SCANCODE_KP_9,
+        Keypad_decimal = SDL_SCANCODE_KP_PERIOD,
+        Keypad_divide = SDL_SCANCODE_KP_DIVIDE,
+        Keypad_multiply = SDL_SCANCODE_KP_MULTIPLY,
+        Keypad_subtract = SDL_SCANCODE_KP_MINUS,
+        Keypad_add = SDL_SCANCODE_KP_PLUS,
+        KeyPad_enter = SDL_SCANCODE_KP_ENTER,
+        KeyPad_equal = SDL_SCANCODE_KP_EQUALS,
+
+        Left_Shift = SDL_SCANCODE_LSHIFT,
+        Left_Control = SDL_SCANCODE_LCTRL,
+        Left_Alt = SDL_SCANCODE_LALT,
+        Left_SUPER = SDL_SCANCODE_LGUI,
+        Right_Shift = SDL_SCANCODE_RSHIFT,
+        Right_Control = SDL_SCANCODE_RCTRL,
+        Right_Alt = SDL_SCANCODE_RALT,
+        Right_SUPER = SDL_SCANCODE_RGUI,
+        Menu = SDL_SCANCODE_MENU,
+
+        COUNT = SDL_SCANCODE_COUNT
     };
 
-    class PyroEvents {};
+    enum class InputEventType : uint8_t {
+        QUIT,
+        KEY_DOWN,
+        KEY_UP,
+        MOUSE_MOVE,
+        MOUSE_BUTTON_DOWN,
+        MOUSE_BUTTON_UP,
+        MOUSE_WHEEL,
+        // x and y hold the new size in pixels.
+        WINDOW_RESIZED,
+        FOCUS_GAINED,
+        FOCUS_LOST,
+    };
+
+    // One translated SDL event, small enough to copy through the ring.
+    struct InputEvent {
+        // When SDL received the event, on the SDL_GetTicksNS() timeline.
+        uint64_t timestamp_ns = 0;
+        InputEventType type = InputEventType::QUIT;
+        // Mouse button for button events (1 left, 2 middle, 3 right).
+        uint8_t button = 0;
+        bool repeat = false;
+        KeyCode key = KeyCode::UNKNOWN;
+        // SDL_Keymod bits held during a key event.
+        uint16_t modifiers = 0;
+        // Cursor position for mouse move and button events, scroll amount for wheel events.
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+    static_assert(sizeof(InputEvent) <= 32);
+
+    // Drains every pending SDL event per pump() into a lock-free ring of InputEvents, so a burst of input is
+    // delivered in one tick instead of one event per frame, and tracks key state and quit requests on the side,
+    // which a full ring can't lose. One thread pumps (the producer) and one thread polls (the consumer); they may
+    // be the same thread.
+    //
+    // SDL only allows pumping on the thread that initialised video, so a dedicated input thread means that thread
+    // pumps with run_input_loop() while rendering moves to another one; see PyroRender::run().
+    class PyroEvents {
+    public:
+        static constexpr size_t CAPACITY = 1024;
+
+        // Producer side.
+        void pump();
+        // Sleeps in SDL until an event arrives or `timeout_ms` passes, then drains everything pending.
+        void wait_and_pump(int32_t timeout_ms);
+        // Pumps with wait_and_pump() until a quit is requested, sampling input every `period_ms` at worst.
+        void run_input_loop(int32_t period_ms = 1);
+
+        // Consumer side; returns false once the ring is empty.
+        bool poll(InputEvent &event) { return ring.pop(event); }
+
+        bool quit_requested() const { return quit.load(std::memory_order_acquire); }
+        void request_quit() { quit.store(true, std::memory_order_release); }
+        // Last known state, updated as events are pumped, so it can run ahead of what has been polled.
+        bool is_key_down(KeyCode key) const;
+        // Events lost because the consumer fell CAPACITY events behind.
+        uint64_t get_dropped_events() const { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        SpscRing<InputEvent, CAPACITY> ring;
+        std::atomic<bool> quit{false};
+        std::atomic<uint64_t> dropped{0};
+        // One bit per scancode.
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(KeyCode::COUNT) / 64> key_state{};
+
+        void translate(const SDL_Event &event);
+        void publish(const InputEvent &event);
+    };
 
 } // namespace pyro
 
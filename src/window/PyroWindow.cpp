@@ -9,11 +9,13 @@
 #include <string>
 #include <vulkan/vulkan_core.h>
 
+#include "../profiler/PyroStartup.hpp"
 #include "../utils/Logger.hpp"
 
 namespace pyro {
     PyroWindow::PyroWindow(int width, int height, const std::string &title, int options) :
         width(width), height(height) {
+        StartupScope scope("create_window");
         SDL_WindowFlags sdl_options = 0;
         SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS);
 
@@ -35,9 +37,9 @@ namespace pyro {
         LOG(LogLevel::INFO, "Window destroyed");
     }
 
-    bool PyroWindow::should_close() { return event.type == SDL_EVENT_QUIT; }
+    bool PyroWindow::should_close() { return events.quit_requested(); }
 
-    void PyroWindow::poll_events() { SDL_PollEvent(&event); }
+    void PyroWindow::poll_events() { events.pump(); }
     VkExtent2D PyroWindow::get_extent() {
         int width, height;
         SDL_GetWindowSizeInPixels(window, &width, &height);
@@ -48,10 +50,13 @@ namespace pyro {
         return extent;
     }
 
-    char const *const *PyroWindow::get_instance_extensions(uint32_t *ext_count) {
-        char const *const *extensions;
-        extensions = SDL_Vulkan_GetInstanceExtensions(ext_count);
-        return extensions;
+    std::vector<const char *> PyroWindow::get_instance_extensions() {
+        // Subsystems are reference counted, so the window's own SDL_Init later is unaffected.
+        ASSERT_EQUAL(SDL_InitSubSystem(SDL_INIT_VIDEO), true, "Failed to initialise SDL video")
+        ASSERT_EQUAL(SDL_Vulkan_LoadLibrary(nullptr), true, "Failed to load the Vulkan library")
+        uint32_t ext_count = 0;
+        char const *const *extensions = SDL_Vulkan_GetInstanceExtensions(&ext_count);
+        return {extensions, extensions + ext_count};
     }
     VkSurfaceKHR PyroWindow::create_surface(VkInstance *instance) {
         VkSurfaceKHR surface;
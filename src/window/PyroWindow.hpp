@@ -12,6 +12,8 @@
 #include <vector>
 #include <vulkan/vulkan_core.h>
 
+#include "PyroEvents.hpp"
+
 namespace pyro {
     enum WindowOptions {
         WINDOW_FULLSCREEN = 1 << 0,
@@ -31,17 +33,22 @@ namespace pyro {
 
         bool should_close();
 
+        // Drains every pending event into the input ring. Must run on the thread that created the window.
         void poll_events();
 
+        PyroEvents &get_events() { return events; }
+
         VkExtent2D get_extent();
 
 
-        char const *const *get_instance_extensions(uint32_t *ext_count);
+        // Instance extensions SDL needs for surfaces. Initialises SDL video itself, so it can run before any window
+        // exists; call it on the thread that will create windows.
+        static std::vector<const char *> get_instance_extensions();
         VkSurfaceKHR create_surface(VkInstance *instance);
 
     private:
         SDL_Window *window;
-        SDL_Event event;
+        PyroEvents events;
         uint32_t width;
         uint32_t height;
     };
@@ -0,0 +1,271 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#include "Json.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <format>
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t MAX_DEPTH = 256;
+
+        class JsonParser {
+        public:
+            explicit JsonParser(const std::string_view text) : text(text) {}
+
+            bool parse_document(JsonValue &out) {
+                skip_whitespace();
+                if (!parse_value(out, 0)) {
+                    return false;
+                }
+                skip_whitespace();
+                return position == text.size() || fail("trailing characters after document");
+            }
+
+            std::string error;
+
+        private:
+            std::string_view text;
+            size_t position = 0;
+
+            bool fail(const std::string_view reason) {
+                if (error.empty()) {
+                    error = std::format("offset {}: {}", position, reason);
+                }
+                return false;
+            }
+
+            void skip_whitespace() {
+                while (position < text.size() && (text[position] == ' ' || text[position] == '\t' ||
+                                                  text[position] == '\n' || text[position] == '\r')) {
+                    position++;
+                }
+            }
+
+            bool consume(const char c) {
+                skip_whitespace();
+                if (position < text.size() && text[position] == c) {
+                    position++;
+                    return true;
+                }
+                return false;
+            }
+
+            bool literal(const std::string_view word) {
+                if (text.substr(position, word.size()) != word) {
+                    return fail("invalid literal");
+                }
+                position += word.size();
+                return true;
+            }
+
+            bool parse_value(JsonValue &out, const uint32_t depth) {
+                if (depth > MAX_DEPTH) {
+                    return fail("nesting too deep");
+                }
+                skip_whitespace();
+                if (position >= text.size()) {
+                    return fail("unexpected end of input");
+                }
+                switch (text[position]) {
+                    case '{':
+                        return parse_object(out, depth);
+                    case '[':
+                        return parse_array(out, depth);
+                    case '"':
+                        out.type = JsonValue::Type::STRING;
+                        return parse_string(out.string);
+                    case 't':
+                        out.type = JsonValue::Type::BOOLEAN;
+                        out.boolean = true;
+                        return literal("true");
+                    case 'f':
+                        out.type = JsonValue::Type::BOOLEAN;
+                        return literal("false");
+                    case 'n':
+                        return literal("null");
+                    default:
+                        return parse_number(out);
+                }
+            }
+
+            bool parse_object(JsonValue &out, const uint32_t depth) {
+                out.type = JsonValue::Type::OBJECT;
+                position++;
+                if (consume('}')) {
+                    return true;
+                }
+                do {
+                    skip_whitespace();
+                    if (position >= text.size() || text[position] != '"') {
+                        return fail("expected member name");
+                    }
+                    if (!parse_string(out.keys.emplace_back())) {
+                        return false;
+                    }
+                    if (!consume(':')) {
+                        return fail("expected ':'");
+                    }
+                    if (!parse_value(out.items.emplace_back(), depth + 1)) {
+                        return false;
+                    }
+                } while (consume(','));
+                return consume('}') || fail("expected ',' or '}'");
+            }
+
+            bool parse_array(JsonValue &out, const uint32_t depth) {
+                out.type = JsonValue::Type::ARRAY;
+                position++;
+                if (consume(']')) {
+                    return true;
+                }
+                do {
+                    if (!parse_value(out.items.emplace_back(), depth + 1)) {
+                        return false;
+                    }
+                } while (consume(','));
+                return consume(']') || fail("expected ',' or ']'");
+            }
+
+            bool parse_number(JsonValue &out) {
+                out.type = JsonValue::Type::NUMBER;
+                const char *first = text.data() + position;
+                const auto [end, result] = std::from_chars(first, text.data() + text.size(), out.number);
+                if (result != std::errc{} || end == first) {
+                    return fail("invalid number");
+                }
+                position += end - first;
+                return true;
+            }
+
+            static void append_utf8(std::string &out, const uint32_t codepoint) {
+                if (codepoint < 0x80) {
+                    out += static_cast<char>(codepoint);
+                } else if (codepoint < 0x800) {
+                    out += static_cast<char>(0xc0 | codepoint >> 6);
+                    out += static_cast<char>(0x80 | (codepoint & 0x3f));
+                } else if (codepoint < 0x10000) {
+                    out += static_cast<char>(0xe0 | codepoint >> 12);
+                    out += static_cast<char>(0x80 | (codepoint >> 6 & 0x3f));
+                    out += static_cast<char>(0x80 | (codepoint & 0x3f));
+                } else {
+                    out += static_cast<char>(0xf0 | codepoint >> 18);
+                    out += static_cast<char>(0x80 | (codepoint >> 12 & 0x3f));
+                    out += static_cast<char>(0x80 | (codepoint >> 6 & 0x3f));
+                    out += static_cast<char>(0x80 | (codepoint & 0x3f));
+                }
+            }
+
+            bool parse_hex4(uint32_t &out) {
+                if (position + 4 > text.size()) {
+                    return fail("truncated \\u escape");
+                }
+                const char *first = text.data() + position;
+                const auto [end, result] = std::from_chars(first, first + 4, out, 16);
+                if (result != std::errc{} || end != first + 4) {
+                    return fail("invalid \\u escape");
+                }
+                position += 4;
+                return true;
+            }
+
+            // Copies unescaped spans in bulk; large embedded buffers are one long run without escapes.
+            bool parse_string(std::string &out) {
+                position++;
+                while (true) {
+                    const size_t stop = text.find_first_of("\"\\", position);
+                    if (stop == std::string_view::npos) {
+                        return fail("unterminated string");
+                    }
+                    out.append(text.data() + position, stop - position);
+                    position = stop + 1;
+                    if (text[stop] == '"') {
+                        return true;
+                    }
+                    if (position >= text.size()) {
+                        return fail("unterminated string");
+                    }
+                    const char escape = text[position++];
+                    switch (escape) {
+                        case '"':
+                        case '\\':
+                        case '/':
+                            out += escape;
+                            break;
+                        case 'b':
+                            out += '\b';
+                            break;
+                        case 'f':
+                            out += '\f';
+                            break;
+                        case 'n':
+                            out += '\n';
+                            break;
+                        case 'r':
+                            out += '\r';
+                            break;
+                        case 't':
+                            out += '\t';
+                            break;
+                        case 'u': {
+                            uint32_t codepoint = 0;
+                            if (!parse_hex4(codepoint)) {
+                                return false;
+                            }
+                            if (codepoint >= 0xd800 && codepoint < 0xdc00) {
+                                uint32_t low = 0;
+                                if (text.substr(position, 2) != "\\u") {
+                                    return fail("unpaired surrogate");
+                                }
+                                position += 2;
+                                if (!parse_hex4(low) || low < 0xdc00 || low >= 0xe000) {
+                                    return fail("unpaired surrogate");
+                                }
+                                codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                            }
+                            append_utf8(out, codepoint);
+                            break;
+                        }
+                        default:
+                            return fail("invalid escape");
+                    }
+                }
+            }
+        };
+    } // namespace
+
+    const JsonValue *JsonValue::find(const std::string_view key) const {
+        if (type != Type::OBJECT) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] == key) {
+                return &items[i];
+            }
+        }
+        return nullptr;
+    }
+
+    double JsonValue::number_or(const std::string_view key, const double fallback) const {
+        const JsonValue *value = find(key);
+        return value && value->is_number() ? value->number : fallback;
+    }
+
+    std::string JsonValue::string_or(const std::string_view key, const std::string_view fallback) const {
+        const JsonValue *value = find(key);
+        return std::string(value && value->is_string() ? std::string_view(value->string) : fallback);
+    }
+
+    std::optional<JsonValue> parse_json(const std::string_view text, std::string &error) {
+        JsonParser parser(text);
+        JsonValue root;
+        if (!parser.parse_document(root)) {
+            error = parser.error;
+            return std::nullopt;
+        }
+        return root;
+    }
+} // namespace pyro
@@ -0,0 +1,47 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#ifndef PYROJSON_HPP
+#define PYROJSON_HPP
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pyro {
+
+    // Just enough JSON for glTF: a DOM with numbers as doubles and objects as parallel key/value arrays in
+    // document order.
+    class JsonValue {
+    public:
+        enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+        Type type = Type::NUL;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        // Array elements, or object values matching `keys`.
+        std::vector<JsonValue> items;
+        std::vector<std::string> keys;
+
+        bool is_number() const { return type == Type::NUMBER; }
+        bool is_string() const { return type == Type::STRING; }
+        bool is_array() const { return type == Type::ARRAY; }
+        bool is_object() const { return type == Type::OBJECT; }
+
+        size_t size() const { return items.size(); }
+        const JsonValue &operator[](size_t index) const { return items[index]; }
+        // Null when this is not an object or has no such member.
+        const JsonValue *find(std::string_view key) const;
+        double number_or(std::string_view key, double fallback) const;
+        std::string string_or(std::string_view key, std::string_view fallback) const;
+    };
+
+    // Returns nothing and fills `error` with the byte offset and reason on malformed input.
+    std::optional<JsonValue> parse_json(std::string_view text, std::string &error);
+
+} // namespace pyro
+
+#endif // PYROJSON_HPP
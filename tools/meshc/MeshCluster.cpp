@@ -0,0 +1,205 @@
+//
+// Created by srijan on 3/1/25.
+//
+
+#include "MeshCluster.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <limits>
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t NOT_IN_MESHLET = std::numeric_limits<uint32_t>::max();
+        // How strongly a candidate's normal deviating from the meshlet's counts against it, in units of one
+        // extra vertex.
+        constexpr float CONE_WEIGHT = 0.5f;
+        // Below this spread the cone can never reject the meshlet, so it is disabled outright.
+        constexpr float MIN_CONE_DOT = 0.1f;
+
+        glm::vec3 position(const MeshVertex &vertex) { return glm::make_vec3(vertex.position); }
+
+        class MeshletBuilder {
+        public:
+            explicit MeshletBuilder(ImportedMesh &mesh) :
+                mesh(mesh), local_index(mesh.vertices.size(), NOT_IN_MESHLET) {}
+
+            void build() {
+                const size_t triangle_count = mesh.indices.size() / 3;
+                normals.resize(triangle_count);
+                emitted.assign(triangle_count, false);
+                // Triangles around each vertex, as offsets into a flat list.
+                adjacency_offsets.assign(mesh.vertices.size() + 1, 0);
+                for (const uint32_t index : mesh.indices) {
+                    adjacency_offsets[index + 1]++;
+                }
+                for (size_t v = 0; v < mesh.vertices.size(); v++) {
+                    adjacency_offsets[v + 1] += adjacency_offsets[v];
+                }
+                adjacency.resize(mesh.indices.size());
+                std::vector<uint32_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+                for (uint32_t t = 0; t < triangle_count; t++) {
+                    const glm::vec3 a = position(mesh.vertices[mesh.indices[t * 3]]);
+                    const glm::vec3 b = position(mesh.vertices[mesh.indices[t * 3 + 1]]);
+                    const glm::vec3 c = position(mesh.vertices[mesh.indices[t * 3 + 2]]);
+                    const glm::vec3 normal = glm::cross(b - a, c - a);
+                    const float length = glm::length(normal);
+                    normals[t] = length > 0.0f ? normal / length : glm::vec3(0.0f);
+                    for (uint32_t k = 0; k < 3; k++) {
+                        adjacency[fill[mesh.indices[t * 3 + k]]++] = t;
+                    }
+                }
+
+                // Seeds follow the (cache-optimised) triangle order, so meshlets start where the previous one
+                // left off.
+                size_t next_seed = 0;
+                while (true) {
+                    uint32_t triangle = pick_candidate();
+                    if (triangle == NOT_IN_MESHLET) {
+                        while (next_seed < triangle_count && emitted[next_seed]) {
+                            next_seed++;
+                        }
+                        if (next_seed == triangle_count) {
+                            break;
+                        }
+                        triangle = static_cast<uint32_t>(next_seed);
+                    }
+                    if (!fits(triangle)) {
+                        flush();
+                        continue;
+                    }
+                    add(triangle);
+                }
+                flush();
+            }
+
+        private:
+            ImportedMesh &mesh;
+            std::vector<glm::vec3> normals;
+            std::vector<bool> emitted;
+            std::vector<uint32_t> adjacency_offsets;
+            std::vector<uint32_t> adjacency;
+            std::vector<uint32_t> local_index;
+            // Current meshlet.
+            std::vector<uint32_t> vertices;
+            std::vector<uint32_t> triangles;
+            std::vector<uint32_t> meshlet_triangle_ids;
+            std::vector<uint32_t> candidates;
+            glm::vec3 normal_sum{0.0f};
+
+            uint32_t new_vertices(const uint32_t triangle) const {
+                uint32_t count = 0;
+                for (uint32_t k = 0; k < 3; k++) {
+                    count += local_index[mesh.indices[triangle * 3 + k]] == NOT_IN_MESHLET;
+                }
+                return count;
+            }
+
+            bool fits(const uint32_t triangle) const {
+                return triangles.size() < MESHLET_MAX_TRIANGLES &&
+                       vertices.size() + new_vertices(triangle) <= MESHLET_MAX_VERTICES;
+            }
+
+            // Best unemitted triangle sharing a vertex with the meshlet, or NOT_IN_MESHLET when there is none
+            // or the best one would overflow it.
+            uint32_t pick_candidate() {
+                std::erase_if(candidates, [this](const uint32_t t) { return emitted[t]; });
+                const float normal_length = glm::length(normal_sum);
+                const glm::vec3 axis = normal_length > 0.0f ? normal_sum / normal_length : glm::vec3(0.0f);
+                uint32_t best = NOT_IN_MESHLET;
+                float best_score = std::numeric_limits<float>::max();
+                for (const uint32_t t : candidates) {
+                    const float score = static_cast<float>(new_vertices(t)) +
+                                        CONE_WEIGHT * (1.0f - glm::dot(normals[t], axis));
+                    if (score < best_score) {
+                        best_score = score;
+                        best = t;
+                    }
+                }
+                return best != NOT_IN_MESHLET && fits(best) ? best : NOT_IN_MESHLET;
+            }
+
+            void add(const uint32_t triangle) {
+                uint32_t packed = 0;
+                for (uint32_t k = 0; k < 3; k++) {
+                    const uint32_t vertex = mesh.indices[triangle * 3 + k];
+                    if (local_index[vertex] == NOT_IN_MESHLET) {
+                        local_index[vertex] = static_cast<uint32_t>(vertices.size());
+                        vertices.push_back(vertex);
+                        for (uint32_t a = adjacency_offsets[vertex]; a < adjacency_offsets[vertex + 1]; a++) {
+                            if (!emitted[adjacency[a]]) {
+                                candidates.push_back(adjacency[a]);
+                            }
+                        }
+                    }
+                    packed |= local_index[vertex] << (k * 8);
+                }
+                triangles.push_back(packed);
+                emitted[triangle] = true;
+                normal_sum += normals[triangle];
+                meshlet_triangle_ids.push_back(triangle);
+            }
+
+            void flush() {
+                if (triangles.empty()) {
+                    return;
+                }
+                MeshletEntry meshlet{};
+                meshlet.vertex_offset = static_cast<uint32_t>(mesh.meshlet_vertices.size());
+                meshlet.triangle_offset = static_cast<uint32_t>(mesh.meshlet_triangles.size());
+                meshlet.vertex_count = static_cast<uint32_t>(vertices.size());
+                meshlet.triangle_count = static_cast<uint32_t>(triangles.size());
+
+                glm::vec3 low(std::numeric_limits<float>::max());
+                glm::vec3 high(std::numeric_limits<float>::lowest());
+                for (const uint32_t vertex : vertices) {
+                    low = glm::min(low, position(mesh.vertices[vertex]));
+                    high = glm::max(high, position(mesh.vertices[vertex]));
+                }
+                const glm::vec3 center = (low + high) * 0.5f;
+                float radius = 0.0f;
+                for (const uint32_t vertex : vertices) {
+                    radius = std::max(radius, glm::length(position(mesh.vertices[vertex]) - center));
+                }
+                std::copy_n(glm::value_ptr(center), 3, meshlet.center);
+                meshlet.radius = radius;
+
+                const float normal_length = glm::length(normal_sum);
+                float min_dot = -1.0f;
+                if (normal_length > 0.0f) {
+                    const glm::vec3 axis = normal_sum / normal_length;
+                    min_dot = 1.0f;
+                    for (const uint32_t t : meshlet_triangle_ids) {
+                        // Degenerate triangles are never rasterised and don't constrain the cone.
+                        if (normals[t] != glm::vec3(0.0f)) {
+                            min_dot = std::min(min_dot, glm::dot(normals[t], axis));
+                        }
+                    }
+                    std::copy_n(glm::value_ptr(axis), 3, meshlet.cone_axis);
+                }
+                meshlet.cone_cutoff = min_dot <= MIN_CONE_DOT ? 1.0f : std::sqrt(1.0f - min_dot * min_dot);
+
+                mesh.meshlets.push_back(meshlet);
+                mesh.meshlet_vertices.insert(mesh.meshlet_vertices.end(), vertices.begin(), vertices.end());
+                mesh.meshlet_triangles.insert(mesh.meshlet_triangles.end(), triangles.begin(), triangles.end());
+                for (const uint32_t vertex : vertices) {
+                    local_index[vertex] = NOT_IN_MESHLET;
+                }
+                vertices.clear();
+                triangles.clear();
+                candidates.clear();
+                meshlet_triangle_ids.clear();
+                normal_sum = glm::vec3(0.0f);
+            }
+        };
+    } // namespace
+
+    void build_meshlets(ImportedMesh &mesh) {
+        mesh.meshlets.clear();
+        mesh.meshlet_vertices.clear();
+        mesh.meshlet_triangles.clear();
+        MeshletBuilder(mesh).build();
+    }
+} // namespace pyro
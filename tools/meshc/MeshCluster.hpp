@@ -0,0 +1,22 @@
+//
+// Created by srijan on 3/1/25.
+//
+
+#ifndef PYROMESHCLUSTER_HPP
+#define PYROMESHCLUSTER_HPP
+
+#include "MeshImport.hpp"
+
+namespace pyro {
+
+    // Splits the full-detail triangles into meshlets of at most MESHLET_MAX_VERTICES vertices and
+    // MESHLET_MAX_TRIANGLES triangles and computes their bounding spheres and normal cones. Meshlets grow
+    // greedily through shared vertices, preferring triangles that add the fewest vertices and then those facing
+    // along the meshlet's average normal, which keeps the cones tight enough for backface culling; front faces are
+    // counter-clockwise, as in glTF and OBJ. Run after optimize_mesh(): the meshlets reference the final vertex
+    // order.
+    void build_meshlets(ImportedMesh &mesh);
+
+} // namespace pyro
+
+#endif // PYROMESHCLUSTER_HPP
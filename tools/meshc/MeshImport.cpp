@@ -0,0 +1,726 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#include "MeshImport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <unordered_map>
+
+#include "../../src/utils/Logger.hpp"
+#include "Json.hpp"
+
+namespace pyro {
+    namespace {
+        constexpr uint32_t GLB_MAGIC = 0x46546c67; // "glTF"
+        constexpr uint32_t GLB_CHUNK_JSON = 0x4e4f534a;
+        constexpr uint32_t GLB_CHUNK_BIN = 0x004e4942;
+        constexpr uint32_t GLTF_TRIANGLES = 4;
+
+        enum GltfComponentType : uint32_t {
+            BYTE = 5120,
+            UNSIGNED_BYTE = 5121,
+            SHORT = 5122,
+            UNSIGNED_SHORT = 5123,
+            UNSIGNED_INT = 5125,
+            FLOAT = 5126,
+        };
+
+        std::optional<std::vector<std::byte>> read_file(const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file) {
+                LOG(LogLevel::ERROR, "Failed to open {}", path.string());
+                return std::nullopt;
+            }
+            std::vector<std::byte> bytes(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if (!file.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+                LOG(LogLevel::ERROR, "Failed to read {}", path.string());
+                return std::nullopt;
+            }
+            return bytes;
+        }
+
+        // ---- OBJ ----
+
+        struct ObjCorner {
+            int32_t position;
+            int32_t uv;
+            int32_t normal;
+
+            bool operator==(const ObjCorner &) const = default;
+        };
+
+        struct ObjCornerHash {
+            size_t operator()(const ObjCorner &corner) const {
+                return (static_cast<size_t>(corner.position) * 73856093u) ^
+                       (static_cast<size_t>(corner.uv) * 19349663u) ^ (static_cast<size_t>(corner.normal) * 83492791u);
+            }
+        };
+
+        std::string_view next_token(std::string_view &line) {
+            const size_t start = line.find_first_not_of(" \t");
+            if (start == std::string_view::npos) {
+                line = {};
+                return {};
+            }
+            line.remove_prefix(start);
+            const size_t end = std::min(line.find_first_of(" \t"), line.size());
+            const std::string_view token = line.substr(0, end);
+            line.remove_prefix(end);
+            return token;
+        }
+
+        bool parse_floats(std::string_view line, float *out, const uint32_t count) {
+            for (uint32_t i = 0; i < count; i++) {
+                const std::string_view token = next_token(line);
+                const auto [end, result] = std::from_chars(token.data(), token.data() + token.size(), out[i]);
+                if (token.empty() || result != std::errc{}) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Resolves a 1-based or negative (relative to the end) OBJ reference to a 0-based index; -1 if absent.
+        bool parse_reference(const std::string_view text, const size_t count, int32_t &out) {
+            if (text.empty()) {
+                out = -1;
+                return true;
+            }
+            int64_t value = 0;
+            const auto [end, result] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (result != std::errc{} || end != text.data() + text.size() || value == 0) {
+                return false;
+            }
+            value = value > 0 ? value - 1 : static_cast<int64_t>(count) + value;
+            if (value < 0 || value >= static_cast<int64_t>(count)) {
+                return false;
+            }
+            out = static_cast<int32_t>(value);
+            return true;
+        }
+
+        // ---- glTF ----
+
+        struct GltfDocument {
+            JsonValue json;
+            std::vector<std::vector<std::byte>> buffers;
+        };
+
+        struct AccessorView {
+            const std::byte *data = nullptr;
+            size_t stride = 0;
+            size_t count = 0;
+            uint32_t component_type = 0;
+            uint32_t components = 0;
+            bool normalized = false;
+
+            float read_float(const size_t element, const uint32_t component) const {
+                const std::byte *source = data + element * stride;
+                switch (component_type) {
+                    case FLOAT: {
+                        float value;
+                        std::memcpy(&value, source + component * sizeof(float), sizeof(float));
+                        return value;
+                    }
+                    case UNSIGNED_BYTE: {
+                        const auto value = static_cast<float>(std::to_integer<uint8_t>(source[component]));
+                        return normalized ? value / 255.0f : value;
+                    }
+                    case BYTE: {
+                        const auto value = static_cast<float>(static_cast<int8_t>(source[component]));
+                        return normalized ? std::max(value / 127.0f, -1.0f) : value;
+                    }
+                    case UNSIGNED_SHORT: {
+                        uint16_t value;
+                        std::memcpy(&value, source + component * sizeof(value), sizeof(value));
+                        return normalized ? static_cast<float>(value) / 65535.0f : static_cast<float>(value);
+                    }
+                    case SHORT: {
+                        int16_t value;
+                        std::memcpy(&value, source + component * sizeof(value), sizeof(value));
+                        return normalized ? std::max(static_cast<float>(value) / 32767.0f, -1.0f)
+                                          : static_cast<float>(value);
+                    }
+                    default:
+                        return 0.0f;
+                }
+            }
+
+            uint32_t read_index(const size_t element) const {
+                const std::byte *source = data + element * stride;
+                switch (component_type) {
+                    case UNSIGNED_BYTE:
+                        return std::to_integer<uint32_t>(source[0]);
+                    case UNSIGNED_SHORT: {
+                        uint16_t value;
+                        std::memcpy(&value, source, sizeof(value));
+                        return value;
+                    }
+                    default: {
+                        uint32_t value;
+                        std::memcpy(&value, source, sizeof(value));
+                        return value;
+                    }
+                }
+            }
+        };
+
+        uint32_t component_size(const uint32_t component_type) {
+            switch (component_type) {
+                case BYTE:
+                case UNSIGNED_BYTE:
+                    return 1;
+                case SHORT:
+                case UNSIGNED_SHORT:
+                    return 2;
+                case UNSIGNED_INT:
+                case FLOAT:
+                    return 4;
+                default:
+                    return 0;
+            }
+        }
+
+        uint32_t component_count(const std::string_view type) {
+            if (type == "SCALAR") {
+                return 1;
+            }
+            if (type == "VEC2") {
+                return 2;
+            }
+            if (type == "VEC3") {
+                return 3;
+            }
+            if (type == "VEC4") {
+                return 4;
+            }
+            return 0;
+        }
+
+        const JsonValue *array_element(const JsonValue &root, const std::string_view array, const double index) {
+            const JsonValue *values = root.find(array);
+            if (!values || !values->is_array() || index < 0 || index >= static_cast<double>(values->size())) {
+                return nullptr;
+            }
+            return &(*values)[static_cast<size_t>(index)];
+        }
+
+        std::optional<AccessorView> accessor_view(const GltfDocument &document, const double index) {
+            const JsonValue *accessor = array_element(document.json, "accessors", index);
+            if (!accessor) {
+                LOG(LogLevel::ERROR, "glTF: accessor {} does not exist", index);
+                return std::nullopt;
+            }
+            if (accessor->find("sparse")) {
+                LOG(LogLevel::ERROR, "glTF: sparse accessors are not supported");
+                return std::nullopt;
+            }
+            const JsonValue *view = array_element(document.json, "bufferViews", accessor->number_or("bufferView", -1));
+            if (!view) {
+                LOG(LogLevel::ERROR, "glTF: accessor {} has no buffer view", index);
+                return std::nullopt;
+            }
+            const double buffer = view->number_or("buffer", -1);
+            if (buffer < 0 || buffer >= static_cast<double>(document.buffers.size())) {
+                LOG(LogLevel::ERROR, "glTF: buffer view references a missing buffer");
+                return std::nullopt;
+            }
+            const std::vector<std::byte> &bytes = document.buffers[static_cast<size_t>(buffer)];
+
+            AccessorView out{};
+            out.component_type = static_cast<uint32_t>(accessor->number_or("componentType", 0));
+            out.components = component_count(accessor->string_or("type", ""));
+            out.count = static_cast<size_t>(accessor->number_or("count", 0));
+            out.normalized = accessor->find("normalized") && accessor->find("normalized")->boolean;
+            const size_t element_size = static_cast<size_t>(component_size(out.component_type)) * out.components;
+            if (element_size == 0) {
+                LOG(LogLevel::ERROR, "glTF: accessor {} has an unsupported component type or shape", index);
+                return std::nullopt;
+            }
+            out.stride = static_cast<size_t>(view->number_or("byteStride", static_cast<double>(element_size)));
+            const auto view_offset = static_cast<size_t>(view->number_or("byteOffset", 0));
+            const auto view_length = static_cast<size_t>(view->number_or("byteLength", 0));
+            const auto accessor_offset = static_cast<size_t>(accessor->number_or("byteOffset", 0));
+            const size_t needed = out.count == 0 ? 0 : accessor_offset + out.stride * (out.count - 1) + element_size;
+            if (out.stride < element_size || view_offset + view_length > bytes.size() || needed > view_length) {
+                LOG(LogLevel::ERROR, "glTF: accessor {} reads outside its buffer", index);
+                return std::nullopt;
+            }
+            out.data = bytes.data() + view_offset + accessor_offset;
+            return out;
+        }
+
+        bool load_buffers(GltfDocument &document, const std::filesystem::path &directory,
+                          std::optional<std::vector<std::byte>> glb_binary) {
+            const JsonValue *buffers = document.json.find("buffers");
+            if (!buffers) {
+                return true;
+            }
+            for (size_t i = 0; i < buffers->size(); i++) {
+                const JsonValue &buffer = (*buffers)[i];
+                const std::string uri = buffer.string_or("uri", "");
+                std::optional<std::vector<std::byte>> bytes;
+                if (uri.empty()) {
+                    if (i != 0 || !glb_binary) {
+                        LOG(LogLevel::ERROR, "glTF: buffer {} has no uri and no GLB binary chunk", i);
+                        return false;
+                    }
+                    bytes = std::move(glb_binary);
+                } else if (uri.starts_with("data:")) {
+                    const size_t comma = uri.find(',');
+                    if (comma == std::string::npos || !std::string_view(uri).substr(0, comma).ends_with(";base64")) {
+                        LOG(LogLevel::ERROR, "glTF: buffer {} is a data URI without base64 payload", i);
+                        return false;
+                    }
+                    bytes = decode_base64(std::string_view(uri).substr(comma + 1));
+                    if (!bytes) {
+                        LOG(LogLevel::ERROR, "glTF: buffer {} has invalid base64 data", i);
+                        return false;
+                    }
+                } else {
+                    bytes = read_file(directory / uri);
+                    if (!bytes) {
+                        return false;
+                    }
+                }
+                if (static_cast<double>(bytes->size()) < buffer.number_or("byteLength", 0)) {
+                    LOG(LogLevel::ERROR, "glTF: buffer {} is shorter than its byteLength", i);
+                    return false;
+                }
+                document.buffers.push_back(std::move(*bytes));
+            }
+            return true;
+        }
+
+        std::optional<GltfDocument> load_gltf(const std::filesystem::path &path) {
+            auto file = read_file(path);
+            if (!file) {
+                return std::nullopt;
+            }
+            std::string_view json_text(reinterpret_cast<const char *>(file->data()), file->size());
+            std::optional<std::vector<std::byte>> glb_binary;
+
+            uint32_t magic = 0;
+            if (file->size() >= sizeof(magic)) {
+                std::memcpy(&magic, file->data(), sizeof(magic));
+            }
+            if (magic == GLB_MAGIC) {
+                // 12-byte header, then a JSON chunk and an optional BIN chunk, each with an 8-byte header.
+                const auto read_u32 = [&](const size_t offset) {
+                    uint32_t value = 0;
+                    if (offset + sizeof(value) <= file->size()) {
+                        std::memcpy(&value, file->data() + offset, sizeof(value));
+                    }
+                    return value;
+                };
+                json_text = {};
+                for (size_t offset = 12; offset + 8 <= file->size();) {
+                    const uint32_t length = read_u32(offset);
+                    const uint32_t type = read_u32(offset + 4);
+                    if (offset + 8 + length > file->size()) {
+                        LOG(LogLevel::ERROR, "{}: truncated GLB chunk", path.string());
+                        return std::nullopt;
+                    }
+                    const std::byte *chunk = file->data() + offset + 8;
+                    if (type == GLB_CHUNK_JSON && json_text.empty()) {
+                        json_text = {reinterpret_cast<const char *>(chunk), length};
+                    } else if (type == GLB_CHUNK_BIN && !glb_binary) {
+                        glb_binary.emplace(chunk, chunk + length);
+                    }
+                    offset += 8 + ((length + 3) & ~3u);
+                }
+            }
+
+            std::string error;
+            std::optional<JsonValue> json = parse_json(json_text, error);
+            if (!json || !json->is_object()) {
+                LOG(LogLevel::ERROR, "{}: invalid glTF JSON ({})", path.string(), error);
+                return std::nullopt;
+            }
+            GltfDocument document{std::move(*json), {}};
+            if (!load_buffers(document, path.parent_path(), std::move(glb_binary))) {
+                return std::nullopt;
+            }
+            return document;
+        }
+
+        bool import_primitive(const GltfDocument &document, const JsonValue &primitive, ImportedMesh &out) {
+            if (primitive.number_or("mode", GLTF_TRIANGLES) != GLTF_TRIANGLES) {
+                LOG(LogLevel::ERROR, "glTF: only triangle list primitives are supported");
+                return false;
+            }
+            const JsonValue *attributes = primitive.find("attributes");
+            const JsonValue *position_index = attributes ? attributes->find("POSITION") : nullptr;
+            if (!position_index || !position_index->is_number()) {
+                LOG(LogLevel::ERROR, "glTF: primitive has no POSITION attribute");
+                return false;
+            }
+            const auto positions = accessor_view(document, position_index->number);
+            if (!positions || positions->components != 3 || positions->component_type != FLOAT) {
+                LOG(LogLevel::ERROR, "glTF: POSITION must be a float VEC3 accessor");
+                return false;
+            }
+            std::optional<AccessorView> normals;
+            if (const JsonValue *index = attributes->find("NORMAL")) {
+                normals = accessor_view(document, index->number);
+                if (!normals || normals->components != 3 || normals->count != positions->count) {
+                    LOG(LogLevel::ERROR, "glTF: NORMAL must be a VEC3 accessor matching POSITION");
+                    return false;
+                }
+            }
+            std::optional<AccessorView> uvs;
+            if (const JsonValue *index = attributes->find("TEXCOORD_0")) {
+                uvs = accessor_view(document, index->number);
+                if (!uvs || uvs->components != 2 || uvs->count != positions->count) {
+                    LOG(LogLevel::ERROR, "glTF: TEXCOORD_0 must be a VEC2 accessor matching POSITION");
+                    return false;
+                }
+            }
+
+            out.vertices.resize(positions->count);
+            for (size_t i = 0; i < positions->count; i++) {
+                MeshVertex &vertex = out.vertices[i];
+                for (uint32_t c = 0; c < 3; c++) {
+                    vertex.position[c] = positions->read_float(i, c);
+                    vertex.normal[c] = normals ? normals->read_float(i, c) : 0.0f;
+                }
+                vertex.uv[0] = uvs ? uvs->read_float(i, 0) : 0.0f;
+                vertex.uv[1] = uvs ? uvs->read_float(i, 1) : 0.0f;
+            }
+
+            if (const JsonValue *index = primitive.find("indices")) {
+                const auto indices = accessor_view(document, index->number);
+                if (!indices || indices->components != 1 || indices->component_type == FLOAT ||
+                    indices->component_type == BYTE || indices->component_type == SHORT) {
+                    LOG(LogLevel::ERROR, "glTF: indices must be an unsigned integer SCALAR accessor");
+                    return false;
+                }
+                out.indices.resize(indices->count);
+                for (size_t i = 0; i < indices->count; i++) {
+                    out.indices[i] = indices->read_index(i);
+                    if (out.indices[i] >= positions->count) {
+                        LOG(LogLevel::ERROR, "glTF: index {} is out of range", out.indices[i]);
+                        return false;
+                    }
+                }
+            } else {
+                out.indices.resize(positions->count);
+                for (size_t i = 0; i < positions->count; i++) {
+                    out.indices[i] = static_cast<uint32_t>(i);
+                }
+            }
+            out.indices.resize(out.indices.size() / 3 * 3);
+            if (!normals) {
+                generate_normals(out);
+            }
+            return true;
+        }
+
+        glm::mat4 node_transform(const JsonValue &node) {
+            const auto numbers = [&](const std::string_view key, float *out, const uint32_t count) {
+                const JsonValue *values = node.find(key);
+                if (!values || values->size() != count) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < count; i++) {
+                    out[i] = static_cast<float>((*values)[i].number);
+                }
+                return true;
+            };
+            glm::mat4 matrix(1.0f);
+            if (numbers("matrix", glm::value_ptr(matrix), 16)) {
+                return matrix;
+            }
+            glm::vec3 translation(0.0f);
+            glm::vec4 rotation(0.0f, 0.0f, 0.0f, 1.0f);
+            glm::vec3 scale(1.0f);
+            numbers("translation", glm::value_ptr(translation), 3);
+            numbers("rotation", glm::value_ptr(rotation), 4);
+            numbers("scale", glm::value_ptr(scale), 3);
+            const glm::quat orientation(rotation.w, rotation.x, rotation.y, rotation.z);
+            return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(orientation) *
+                   glm::scale(glm::mat4(1.0f), scale);
+        }
+
+        void append_transformed(const ImportedMesh &source, const glm::mat4 &transform, ImportedMesh &out) {
+            const auto base = static_cast<uint32_t>(out.vertices.size());
+            const glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+            for (MeshVertex vertex : source.vertices) {
+                const glm::vec3 position(transform * glm::vec4(glm::make_vec3(vertex.position), 1.0f));
+                glm::vec3 normal = normal_matrix * glm::make_vec3(vertex.normal);
+                normal = glm::dot(normal, normal) > 0.0f ? glm::normalize(normal) : normal;
+                std::memcpy(vertex.position, glm::value_ptr(position), sizeof(vertex.position));
+                std::memcpy(vertex.normal, glm::value_ptr(normal), sizeof(vertex.normal));
+                out.vertices.push_back(vertex);
+            }
+            // A mirroring transform flips the winding.
+            const bool mirrored = glm::determinant(glm::mat3(transform)) < 0.0f;
+            for (size_t i = 0; i < source.indices.size(); i += 3) {
+                out.indices.push_back(base + source.indices[i]);
+                out.indices.push_back(base + source.indices[i + (mirrored ? 2 : 1)]);
+                out.indices.push_back(base + source.indices[i + (mirrored ? 1 : 2)]);
+            }
+        }
+
+        std::optional<ImportedMesh> import_gltf_mesh(const GltfDocument &document, const double index,
+                                                     const glm::mat4 &transform) {
+            const JsonValue *mesh = array_element(document.json, "meshes", index);
+            const JsonValue *primitives = mesh ? mesh->find("primitives") : nullptr;
+            if (!primitives) {
+                LOG(LogLevel::ERROR, "glTF: mesh {} does not exist or has no primitives", index);
+                return std::nullopt;
+            }
+            ImportedMesh out;
+            out.name = mesh->string_or("name", std::format("mesh{}", index));
+            for (size_t i = 0; i < primitives->size(); i++) {
+                ImportedMesh primitive;
+                if (!import_primitive(document, (*primitives)[i], primitive)) {
+                    return std::nullopt;
+                }
+                append_transformed(primitive, transform, out);
+            }
+            return out;
+        }
+    } // namespace
+
+    std::optional<std::vector<std::byte>> decode_base64(const std::string_view text) {
+        static constexpr std::array<int8_t, 256> TABLE = [] {
+            std::array<int8_t, 256> table{};
+            table.fill(-1);
+            constexpr std::string_view ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (size_t i = 0; i < ALPHABET.size(); i++) {
+                table[static_cast<uint8_t>(ALPHABET[i])] = static_cast<int8_t>(i);
+            }
+            return table;
+        }();
+
+        const std::string_view data = text.substr(0, text.find('='));
+        std::vector<std::byte> out(data.size() / 4 * 3 + 3);
+        size_t written = 0;
+        uint32_t accumulator = 0;
+        uint32_t bits = 0;
+        for (const char c : data) {
+            const int8_t value = TABLE[static_cast<uint8_t>(c)];
+            if (value < 0) {
+                return std::nullopt;
+            }
+            accumulator = accumulator << 6 | static_cast<uint32_t>(value);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                out[written++] = static_cast<std::byte>(accumulator >> bits);
+            }
+        }
+        out.resize(written);
+        return out;
+    }
+
+    void generate_normals(ImportedMesh &mesh) {
+        std::vector<glm::vec3> normals(mesh.vertices.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            const glm::vec3 a = glm::make_vec3(mesh.vertices[mesh.indices[i]].position);
+            const glm::vec3 b = glm::make_vec3(mesh.vertices[mesh.indices[i + 1]].position);
+            const glm::vec3 c = glm::make_vec3(mesh.vertices[mesh.indices[i + 2]].position);
+            // The unnormalised cross product weights each face by its area.
+            const glm::vec3 face = glm::cross(b - a, c - a);
+            for (size_t k = 0; k < 3; k++) {
+                normals[mesh.indices[i + k]] += face;
+            }
+        }
+        for (size_t i = 0; i < normals.size(); i++) {
+            const float length = glm::length(normals[i]);
+            const glm::vec3 normal = length > 0.0f ? normals[i] / length : glm::vec3(0.0f, 0.0f, 1.0f);
+            std::memcpy(mesh.vertices[i].normal, glm::value_ptr(normal), sizeof(mesh.vertices[i].normal));
+        }
+    }
+
+    std::optional<std::vector<ImportedMesh>> import_obj(const std::string &path) {
+        const auto file = read_file(path);
+        if (!file) {
+            return std::nullopt;
+        }
+        std::string_view text(reinterpret_cast<const char *>(file->data()), file->size());
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> uvs;
+        std::vector<ImportedMesh> meshes;
+        std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> corners;
+        std::vector<bool> needs_normals;
+        std::vector<uint32_t> polygon;
+        std::string pending_name = "default";
+
+        const auto current = [&]() -> ImportedMesh & {
+            if (meshes.empty() || !pending_name.empty()) {
+                if (meshes.empty() || !meshes.back().indices.empty()) {
+                    meshes.emplace_back();
+                    needs_normals.push_back(false);
+                }
+                meshes.back().name = pending_name;
+                pending_name.clear();
+                corners.clear();
+            }
+            return meshes.back();
+        };
+
+        for (size_t line_number = 1; !text.empty(); line_number++) {
+            const size_t end = std::min(text.find('\n'), text.size());
+            std::string_view line = text.substr(0, end);
+            text.remove_prefix(std::min(end + 1, text.size()));
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            const std::string_view keyword = next_token(line);
+            bool ok = true;
+            if (keyword == "v") {
+                ok = parse_floats(line, glm::value_ptr(positions.emplace_back()), 3);
+            } else if (keyword == "vn") {
+                ok = parse_floats(line, glm::value_ptr(normals.emplace_back()), 3);
+            } else if (keyword == "vt") {
+                ok = parse_floats(line, glm::value_ptr(uvs.emplace_back()), 2);
+            } else if (keyword == "o" || keyword == "g") {
+                const size_t start = line.find_first_not_of(" \t");
+                pending_name = start == std::string_view::npos ? std::string(keyword) : std::string(line.substr(start));
+            } else if (keyword == "f") {
+                ImportedMesh &mesh = current();
+                polygon.clear();
+                for (std::string_view token = next_token(line); ok && !token.empty(); token = next_token(line)) {
+                    // v, v/vt, v//vn or v/vt/vn.
+                    const size_t first_slash = token.find('/');
+                    const size_t second_slash =
+                            first_slash == std::string_view::npos ? first_slash : token.find('/', first_slash + 1);
+                    ObjCorner corner{};
+                    ok = parse_reference(token.substr(0, first_slash), positions.size(), corner.position) &&
+                         corner.position >= 0;
+                    if (ok && first_slash != std::string_view::npos) {
+                        const size_t uv_end = second_slash == std::string_view::npos ? token.size() : second_slash;
+                        ok = parse_reference(token.substr(first_slash + 1, uv_end - first_slash - 1), uvs.size(),
+                                             corner.uv);
+                    } else {
+                        corner.uv = -1;
+                    }
+                    if (ok && second_slash != std::string_view::npos) {
+                        ok = parse_reference(token.substr(second_slash + 1), normals.size(), corner.normal);
+                    } else {
+                        corner.normal = -1;
+                    }
+                    if (!ok) {
+                        break;
+                    }
+                    auto [entry, inserted] = corners.try_emplace(corner, static_cast<uint32_t>(mesh.vertices.size()));
+                    if (inserted) {
+                        MeshVertex vertex{};
+                        std::memcpy(vertex.position, &positions[corner.position], sizeof(vertex.position));
+                        if (corner.normal >= 0) {
+                            std::memcpy(vertex.normal, &normals[corner.normal], sizeof(vertex.normal));
+                        } else {
+                            needs_normals.back() = true;
+                        }
+                        if (corner.uv >= 0) {
+                            // OBJ puts the texture origin bottom-left; the engine and glTF use top-left.
+                            vertex.uv[0] = uvs[corner.uv].x;
+                            vertex.uv[1] = 1.0f - uvs[corner.uv].y;
+                        }
+                        mesh.vertices.push_back(vertex);
+                    }
+                    polygon.push_back(entry->second);
+                }
+                for (size_t i = 2; ok && i < polygon.size(); i++) {
+                    mesh.indices.insert(mesh.indices.end(), {polygon[0], polygon[i - 1], polygon[i]});
+                }
+            }
+            if (!ok) {
+                LOG(LogLevel::ERROR, "{}:{}: malformed '{}' statement", path, line_number, keyword);
+                return std::nullopt;
+            }
+        }
+
+        for (size_t i = 0; i < meshes.size(); i++) {
+            if (needs_normals[i]) {
+                generate_normals(meshes[i]);
+            }
+        }
+        std::erase_if(meshes, [](const ImportedMesh &mesh) { return mesh.indices.empty(); });
+        return meshes;
+    }
+
+    std::optional<std::vector<ImportedMesh>> import_gltf(const std::string &path) {
+        const std::optional<GltfDocument> document = load_gltf(path);
+        if (!document) {
+            return std::nullopt;
+        }
+        std::vector<ImportedMesh> meshes;
+        const JsonValue *scene = array_element(document->json, "scenes", document->json.number_or("scene", 0));
+        const JsonValue *roots = scene ? scene->find("nodes") : nullptr;
+        if (!roots) {
+            // No scene graph: every mesh once, untransformed.
+            const JsonValue *all = document->json.find("meshes");
+            for (size_t i = 0; all && i < all->size(); i++) {
+                auto mesh = import_gltf_mesh(*document, static_cast<double>(i), glm::mat4(1.0f));
+                if (!mesh) {
+                    return std::nullopt;
+                }
+                meshes.push_back(std::move(*mesh));
+            }
+            return meshes;
+        }
+
+        const JsonValue *nodes = document->json.find("nodes");
+        const size_t node_count = nodes ? nodes->size() : 0;
+        std::vector<bool> visited(node_count, false);
+        std::vector<std::pair<double, glm::mat4>> stack;
+        for (size_t i = roots->size(); i-- > 0;) {
+            stack.emplace_back((*roots)[i].number, glm::mat4(1.0f));
+        }
+        while (!stack.empty()) {
+            const auto [index, parent] = stack.back();
+            stack.pop_back();
+            const JsonValue *node = array_element(document->json, "nodes", index);
+            if (!node || visited[static_cast<size_t>(index)]) {
+                LOG(LogLevel::ERROR, "{}: node {} is missing or part of a cycle", path, index);
+                return std::nullopt;
+            }
+            visited[static_cast<size_t>(index)] = true;
+            const glm::mat4 world = parent * node_transform(*node);
+            if (const JsonValue *mesh_index = node->find("mesh")) {
+                auto mesh = import_gltf_mesh(*document, mesh_index->number, world);
+                if (!mesh) {
+                    return std::nullopt;
+                }
+                mesh->name = node->string_or("name", mesh->name);
+                meshes.push_back(std::move(*mesh));
+            }
+            if (const JsonValue *children = node->find("children")) {
+                for (size_t i = children->size(); i-- > 0;) {
+                    stack.emplace_back((*children)[i].number, world);
+                }
+            }
+        }
+        return meshes;
+    }
+
+    std::optional<std::vector<ImportedMesh>> import_mesh(const std::string &path) {
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::ranges::transform(extension, extension.begin(), [](const unsigned char c) { return std::tolower(c); });
+        if (extension == ".obj") {
+            return import_obj(path);
+        }
+        if (extension == ".gltf" || extension == ".glb") {
+            return import_gltf(path);
+        }
+        LOG(LogLevel::ERROR, "{}: unknown mesh format '{}'", path, extension);
+        return std::nullopt;
+    }
+} // namespace pyro
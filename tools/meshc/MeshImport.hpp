@@ -0,0 +1,54 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#ifndef PYROMESHIMPORT_HPP
+#define PYROMESHIMPORT_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../src/mesh/PyroMeshFormat.hpp"
+
+namespace pyro {
+
+    // A simplified level over the full-detail vertices.
+    struct ImportedLod {
+        std::vector<uint32_t> indices;
+        float error = 0.0f;
+    };
+
+    // One indexed triangle list; indices are relative to this mesh's vertices. `lods` holds the levels after the
+    // full-detail one, coarsest last. Meshlets cover the full-detail level, with offsets into this mesh's
+    // meshlet_vertices and meshlet_triangles.
+    struct ImportedMesh {
+        std::string name;
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<ImportedLod> lods;
+        std::vector<MeshletEntry> meshlets;
+        std::vector<uint32_t> meshlet_vertices;
+        std::vector<uint32_t> meshlet_triangles;
+    };
+
+    // Wavefront OBJ: every 'o' or 'g' starts a mesh, polygons are fanned into triangles and missing normals are
+    // generated by area-weighted averaging.
+    std::optional<std::vector<ImportedMesh>> import_obj(const std::string &path);
+    // glTF 2.0 as .gltf (external or base64 data: buffers) or .glb. Emits one mesh per node instance of the
+    // default scene with the node's world transform baked in; primitives of a mesh are merged. Only triangle
+    // lists with float attributes are accepted.
+    std::optional<std::vector<ImportedMesh>> import_gltf(const std::string &path);
+    // Picks the importer from the file extension.
+    std::optional<std::vector<ImportedMesh>> import_mesh(const std::string &path);
+
+    // Smooth normals for meshes whose source had none.
+    void generate_normals(ImportedMesh &mesh);
+    // Standard alphabet with optional padding; nothing on an invalid character.
+    std::optional<std::vector<std::byte>> decode_base64(std::string_view text);
+
+} // namespace pyro
+
+#endif // PYROMESHIMPORT_HPP
@@ -0,0 +1,342 @@
+//
+// Created by srijan on 2/27/25.
+//
+
+#include "MeshOptimize.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <limits>
+#include <numeric>
+
+namespace pyro {
+    namespace {
+        // Forsyth's published constants; the scoring cache is larger than the hardware one on purpose.
+        constexpr uint32_t SCORING_CACHE_SIZE = 32;
+        constexpr float CACHE_DECAY_POWER = 1.5f;
+        constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+        constexpr float VALENCE_BOOST_SCALE = 2.0f;
+        constexpr float VALENCE_BOOST_POWER = 0.5f;
+        // Cache size the overdraw pass measures clusters against.
+        constexpr uint32_t OVERDRAW_CACHE_SIZE = 16;
+
+        float vertex_score(const int32_t cache_position, const uint32_t remaining_triangles) {
+            if (remaining_triangles == 0) {
+                return -1.0f;
+            }
+            float score = 0.0f;
+            if (cache_position >= 0) {
+                // The vertices of the triangle just emitted score the same regardless of their order, so the
+                // next triangle is not biased towards one edge.
+                score = cache_position < 3 ? LAST_TRIANGLE_SCORE
+                                           : std::pow(1.0f - static_cast<float>(cache_position - 3) /
+                                                                     static_cast<float>(SCORING_CACHE_SIZE - 3),
+                                                      CACHE_DECAY_POWER);
+            }
+            // Vertices with few triangles left are boosted so they get finished off and leave the cache.
+            return score + VALENCE_BOOST_SCALE *
+                                   std::pow(static_cast<float>(remaining_triangles), -VALENCE_BOOST_POWER);
+        }
+
+        // FIFO cache by timestamps: a vertex is resident while fewer than `size` misses happened since its own.
+        class FifoCache {
+        public:
+            FifoCache(const size_t vertex_count, const uint32_t size) : stamps(vertex_count, 0), size(size) {
+                reset();
+            }
+
+            void reset() { time += size + 1; }
+
+            uint32_t access(const uint32_t vertex) {
+                if (time - stamps[vertex] < size) {
+                    return 0;
+                }
+                stamps[vertex] = time++;
+                return 1;
+            }
+
+            uint32_t access_triangle(const uint32_t *triangle) {
+                return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+            }
+
+        private:
+            std::vector<uint64_t> stamps;
+            uint64_t size;
+            uint64_t time = 0;
+        };
+    } // namespace
+
+    VertexCacheStats analyze_vertex_cache(const std::span<const uint32_t> indices, const size_t vertex_count,
+                                          const uint32_t cache_size) {
+        VertexCacheStats stats{};
+        if (indices.size() < 3) {
+            return stats;
+        }
+        FifoCache cache(vertex_count, cache_size);
+        std::vector<bool> referenced(vertex_count, false);
+        uint64_t misses = 0;
+        uint64_t unique = 0;
+        for (const uint32_t index : indices) {
+            misses += cache.access(index);
+            unique += !referenced[index];
+            referenced[index] = true;
+        }
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        stats.atvr = static_cast<float>(misses) / static_cast<float>(unique);
+        return stats;
+    }
+
+    void optimize_vertex_cache(const std::span<uint32_t> indices, const size_t vertex_count) {
+        const size_t triangle_count = indices.size() / 3;
+        if (triangle_count == 0) {
+            return;
+        }
+
+        // Per-vertex lists of triangles not yet emitted, packed back to back; each list shrinks from the end.
+        std::vector<uint32_t> remaining(vertex_count, 0);
+        for (size_t i = 0; i < triangle_count * 3; i++) {
+            remaining[indices[i]]++;
+        }
+        std::vector<uint32_t> first_adjacent(vertex_count + 1, 0);
+        std::partial_sum(remaining.begin(), remaining.end(), first_adjacent.begin() + 1);
+        std::vector<uint32_t> adjacency(triangle_count * 3);
+        {
+            std::vector<uint32_t> cursor(first_adjacent.begin(), first_adjacent.end() - 1);
+            for (size_t i = 0; i < triangle_count * 3; i++) {
+                adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<int32_t> cache_position(vertex_count, -1);
+        std::vector<float> score(vertex_count);
+        for (size_t v = 0; v < vertex_count; v++) {
+            score[v] = vertex_score(-1, remaining[v]);
+        }
+        std::vector<float> triangle_score(triangle_count);
+        std::vector<bool> emitted(triangle_count, false);
+        for (size_t t = 0; t < triangle_count; t++) {
+            triangle_score[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+        }
+
+        std::vector<uint32_t> output;
+        output.reserve(triangle_count * 3);
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> next_cache;
+        size_t best = std::max_element(triangle_score.begin(), triangle_score.end()) - triangle_score.begin();
+        size_t scan = 0;
+        while (output.size() < triangle_count * 3) {
+            if (best == std::numeric_limits<size_t>::max()) {
+                // Dead end: nothing adjacent to the cache is left, restart from the next triangle in input order.
+                while (emitted[scan]) {
+                    scan++;
+                }
+                best = scan;
+            }
+            const uint32_t *triangle = &indices[best * 3];
+            emitted[best] = true;
+            output.insert(output.end(), triangle, triangle + 3);
+            for (uint32_t k = 0; k < 3; k++) {
+                const uint32_t v = triangle[k];
+                uint32_t *list = &adjacency[first_adjacent[v]];
+                std::swap(*std::find(list, list + remaining[v], static_cast<uint32_t>(best)), list[remaining[v] - 1]);
+                remaining[v]--;
+            }
+
+            next_cache.assign(triangle, triangle + 3);
+            for (const uint32_t v : cache) {
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                    next_cache.push_back(v);
+                }
+            }
+            for (size_t i = 0; i < next_cache.size(); i++) {
+                const uint32_t v = next_cache[i];
+                cache_position[v] = i < SCORING_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+                score[v] = vertex_score(cache_position[v], remaining[v]);
+            }
+
+            // Rescore the triangles around every vertex whose score changed, including those just evicted, and
+            // continue with the best of them.
+            best = std::numeric_limits<size_t>::max();
+            float best_score = -std::numeric_limits<float>::max();
+            for (const uint32_t v : next_cache) {
+                for (uint32_t i = 0; i < remaining[v]; i++) {
+                    const uint32_t t = adjacency[first_adjacent[v] + i];
+                    triangle_score[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                    if (triangle_score[t] > best_score) {
+                        best_score = triangle_score[t];
+                        best = t;
+                    }
+                }
+            }
+            next_cache.resize(std::min<size_t>(next_cache.size(), SCORING_CACHE_SIZE));
+            cache.swap(next_cache);
+        }
+        std::ranges::copy(output, indices.begin());
+    }
+
+    void optimize_overdraw(const std::span<uint32_t> indices, const std::span<const MeshVertex> vertices,
+                           const float threshold) {
+        const size_t triangle_count = indices.size() / 3;
+        if (triangle_count < 2) {
+            return;
+        }
+
+        // Hard boundaries: triangles that miss on all three vertices start from a cold cache anyway.
+        FifoCache cache(vertices.size(), OVERDRAW_CACHE_SIZE);
+        std::vector<size_t> hard;
+        for (size_t t = 0; t < triangle_count; t++) {
+            if (cache.access_triangle(&indices[t * 3]) == 3 || t == 0) {
+                hard.push_back(t);
+            }
+        }
+        hard.push_back(triangle_count);
+
+        // Soft boundaries: inside each hard cluster, cut wherever the run since the last cut is already within
+        // `threshold` of the cluster's ACMR, so reordering the pieces costs little cache efficiency.
+        std::vector<size_t> clusters;
+        for (size_t c = 0; c + 1 < hard.size(); c++) {
+            const size_t start = hard[c];
+            const size_t end = hard[c + 1];
+            cache.reset();
+            uint64_t cluster_misses = 0;
+            for (size_t t = start; t < end; t++) {
+                cluster_misses += cache.access_triangle(&indices[t * 3]);
+            }
+            const float limit = threshold * static_cast<float>(cluster_misses) / static_cast<float>(end - start);
+
+            cache.reset();
+            clusters.push_back(start);
+            uint64_t run_misses = 0;
+            size_t run_start = start;
+            for (size_t t = start; t + 1 < end; t++) {
+                run_misses += cache.access_triangle(&indices[t * 3]);
+                if (static_cast<float>(run_misses) <= limit * static_cast<float>(t + 1 - run_start)) {
+                    clusters.push_back(t + 1);
+                    run_start = t + 1;
+                    run_misses = 0;
+                    cache.reset();
+                }
+            }
+        }
+        clusters.push_back(triangle_count);
+
+        glm::vec3 mesh_centroid(0.0f);
+        for (const MeshVertex &vertex : vertices) {
+            mesh_centroid += glm::make_vec3(vertex.position);
+        }
+        mesh_centroid /= static_cast<float>(std::max<size_t>(vertices.size(), 1));
+
+        // Clusters facing away from the centre are likely silhouettes seen from outside; drawing them first
+        // lets depth testing reject the inner and back-facing geometry behind them.
+        std::vector<float> sort_keys(clusters.size() - 1);
+        for (size_t c = 0; c + 1 < clusters.size(); c++) {
+            glm::vec3 centroid(0.0f);
+            glm::vec3 normal(0.0f);
+            float area = 0.0f;
+            for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+                const glm::vec3 a = glm::make_vec3(vertices[indices[t * 3]].position);
+                const glm::vec3 b = glm::make_vec3(vertices[indices[t * 3 + 1]].position);
+                const glm::vec3 d = glm::make_vec3(vertices[indices[t * 3 + 2]].position);
+                const glm::vec3 face = glm::cross(b - a, d - a);
+                const float face_area = glm::length(face);
+                centroid += (a + b + d) * (face_area / 3.0f);
+                normal += face;
+                area += face_area;
+            }
+            const float normal_length = glm::length(normal);
+            sort_keys[c] = area > 0.0f && normal_length > 0.0f
+                                   ? glm::dot(centroid / area - mesh_centroid, normal / normal_length)
+                                   : 0.0f;
+        }
+        std::vector<size_t> order(sort_keys.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::stable_sort(order, [&](const size_t a, const size_t b) { return sort_keys[a] > sort_keys[b]; });
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        for (const size_t c : order) {
+            output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+        }
+        std::ranges::copy(output, indices.begin());
+    }
+
+    void optimize_vertex_fetch(ImportedMesh &mesh) {
+        constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(mesh.vertices.size(), UNUSED);
+        std::vector<MeshVertex> vertices;
+        vertices.reserve(mesh.vertices.size());
+        const auto remap_indices = [&](std::vector<uint32_t> &indices) {
+            for (uint32_t &index : indices) {
+                if (remap[index] == UNUSED) {
+                    remap[index] = static_cast<uint32_t>(vertices.size());
+                    vertices.push_back(mesh.vertices[index]);
+                }
+                index = remap[index];
+            }
+        };
+        remap_indices(mesh.indices);
+        for (ImportedLod &lod : mesh.lods) {
+            remap_indices(lod.indices);
+        }
+        mesh.vertices = std::move(vertices);
+    }
+
+    void optimize_mesh(ImportedMesh &mesh) {
+        optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+        optimize_overdraw(mesh.indices, mesh.vertices);
+        // Coarse levels cover few pixels, so only their cache order is worth optimising.
+        for (ImportedLod &lod : mesh.lods) {
+            optimize_vertex_cache(lod.indices, mesh.vertices.size());
+        }
+        optimize_vertex_fetch(mesh);
+    }
+
+    uint16_t float_to_half(const float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const auto sign = static_cast<uint16_t>(bits >> 16 & 0x8000);
+        const uint32_t magnitude = bits & 0x7fffffff;
+        if (magnitude >= 0x7f800000) {
+            // Infinity stays infinity, NaN stays a quiet NaN.
+            return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0);
+        }
+        if (magnitude >= 0x477ff000) {
+            // Rounds past the largest half, 65504.
+            return sign | 0x7c00;
+        }
+        if (magnitude < 0x38800000) {
+            // Subnormal half: scale so the result's mantissa is the integer part, rounding to nearest even.
+            float absolute;
+            std::memcpy(&absolute, &magnitude, sizeof(absolute));
+            return sign | static_cast<uint16_t>(std::nearbyint(absolute * 16777216.0f));
+        }
+        // Rebias the exponent from 127 to 15 and round the mantissa to 10 bits, ties to even.
+        const uint32_t rounded = magnitude + 0xfff + (magnitude >> 13 & 1);
+        return sign | static_cast<uint16_t>((rounded - 0x38000000) >> 13);
+    }
+
+    QuantizedMeshVertex quantize_vertex(const MeshVertex &vertex) {
+        QuantizedMeshVertex out{};
+        for (uint32_t c = 0; c < 3; c++) {
+            out.position[c] = float_to_half(vertex.position[c]);
+        }
+        out.position[3] = float_to_half(1.0f);
+        out.uv[0] = float_to_half(vertex.uv[0]);
+        out.uv[1] = float_to_half(vertex.uv[1]);
+
+        // Octahedral mapping: project onto the L1 unit octahedron and fold the lower half over the upper.
+        const glm::vec3 normal = glm::make_vec3(vertex.normal);
+        const float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        glm::vec2 encoded = l1 > 0.0f ? glm::vec2(normal.x, normal.y) / l1 : glm::vec2(0.0f);
+        if (l1 > 0.0f && normal.z < 0.0f) {
+            encoded = glm::vec2((1.0f - std::abs(encoded.y)) * (encoded.x >= 0.0f ? 1.0f : -1.0f),
+                                (1.0f - std::abs(encoded.x)) * (encoded.y >= 0.0f ? 1.0f : -1.0f));
+        }
+        out.normal[0] = static_cast<int16_t>(std::lround(std::clamp(encoded.x, -1.0f, 1.0f) * 32767.0f));
+        out.normal[1] = static_cast<int16_t>(std::lround(std::clamp(encoded.y, -1.0f, 1.0f) * 32767.0f));
+        return out;
+    }
+} // namespace pyro
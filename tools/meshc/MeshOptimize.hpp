@@ -0,0 +1,45 @@
+//
+// Created by srijan on 2/27/25.
+//
+
+#ifndef PYROMESHOPTIMIZE_HPP
+#define PYROMESHOPTIMIZE_HPP
+
+#include <span>
+
+#include "MeshImport.hpp"
+
+namespace pyro {
+
+    struct VertexCacheStats {
+        // Average cache miss ratio: vertex shader invocations per triangle, 0.5 at best for large meshes, 3 at
+        // worst.
+        float acmr = 0.0f;
+        // Average transformed vertex ratio: invocations per unique vertex, 1 at best.
+        float atvr = 0.0f;
+    };
+
+    // Simulates a FIFO post-transform cache of `cache_size` entries over the triangle list.
+    VertexCacheStats analyze_vertex_cache(std::span<const uint32_t> indices, size_t vertex_count,
+                                          uint32_t cache_size = 16);
+
+    // Reorders triangles for post-transform cache hits with Forsyth's linear-speed greedy scoring, which is
+    // tuned for an LRU cache but performs well on the FIFO caches of real hardware.
+    void optimize_vertex_cache(std::span<uint32_t> indices, size_t vertex_count);
+    // Tipsify-style overdraw pass, run after optimize_vertex_cache(): splits the triangle order into clusters
+    // wherever the cache restarts or the running ACMR stays within `threshold` of the cluster's, then draws
+    // outward-facing clusters first so they occlude the rest from most viewpoints.
+    void optimize_overdraw(std::span<uint32_t> indices, std::span<const MeshVertex> vertices,
+                           float threshold = 1.05f);
+    // Renumbers vertices in first-use order so fetches walk the vertex buffer linearly, dropping unreferenced
+    // vertices. The full-detail indices come first, then each level's. Run last: it keeps the triangle order.
+    void optimize_vertex_fetch(ImportedMesh &mesh);
+    // All three passes in order; levels of detail get the vertex cache pass only.
+    void optimize_mesh(ImportedMesh &mesh);
+
+    uint16_t float_to_half(float value);
+    QuantizedMeshVertex quantize_vertex(const MeshVertex &vertex);
+
+} // namespace pyro
+
+#endif // PYROMESHOPTIMIZE_HPP
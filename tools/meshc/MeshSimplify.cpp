@@ -0,0 +1,247 @@
+//
+// Created by srijan on 2/28/25.
+//
+
+#include "MeshSimplify.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <unordered_map>
+
+namespace pyro {
+    namespace {
+        // Symmetric 4x4 matrix of summed plane equations, upper triangle row by row, plus the summed area that
+        // turns its value into a mean squared distance.
+        struct Quadric {
+            std::array<double, 10> m{};
+            double weight = 0.0;
+
+            void add_plane(const double a, const double b, const double c, const double d, const double w) {
+                const std::array plane{a, b, c, d};
+                for (size_t row = 0, k = 0; row < 4; row++) {
+                    for (size_t column = row; column < 4; column++) {
+                        m[k++] += w * plane[row] * plane[column];
+                    }
+                }
+                weight += w;
+            }
+
+            Quadric &operator+=(const Quadric &other) {
+                for (size_t i = 0; i < m.size(); i++) {
+                    m[i] += other.m[i];
+                }
+                weight += other.weight;
+                return *this;
+            }
+
+            // v^T Q v for v = (p, 1).
+            double evaluate(const float *p) const {
+                const double x = p[0], y = p[1], z = p[2];
+                return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x + m[4] * y * y +
+                       2.0 * m[5] * y * z + 2.0 * m[6] * y + m[7] * z * z + 2.0 * m[8] * z + m[9];
+            }
+        };
+
+        struct Collapse {
+            float cost;
+            uint32_t from;
+            uint32_t to;
+        };
+
+        std::array<double, 3> face_normal(const float *a, const float *b, const float *c) {
+            const double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const double e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            return {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+        }
+
+        double dot(const std::array<double, 3> &a, const std::array<double, 3> &b) {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+
+        uint64_t edge_key(const uint32_t a, const uint32_t b) {
+            return static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+        }
+    } // namespace
+
+    SimplifyResult simplify_mesh(const std::span<const MeshVertex> vertices, const std::span<const uint32_t> indices,
+                                 const size_t target_index_count, const float max_error) {
+        SimplifyResult result{{indices.begin(), indices.end()}, 0.0f};
+        result.indices.resize(result.indices.size() / 3 * 3);
+        const size_t vertex_count = vertices.size();
+
+        // Edges not shared by exactly two triangles lie on a border or a seam between split vertices.
+        std::unordered_map<uint64_t, uint32_t> edge_uses;
+        for (size_t i = 0; i < result.indices.size(); i += 3) {
+            for (uint32_t k = 0; k < 3; k++) {
+                edge_uses[edge_key(result.indices[i + k], result.indices[i + (k + 1) % 3])]++;
+            }
+        }
+        std::vector<bool> locked(vertex_count, false);
+        for (const auto &[key, uses] : edge_uses) {
+            if (uses != 2) {
+                locked[key >> 32] = true;
+                locked[key & 0xffffffff] = true;
+            }
+        }
+
+        std::vector<Quadric> quadrics(vertex_count);
+        for (size_t i = 0; i < result.indices.size(); i += 3) {
+            const float *p0 = vertices[result.indices[i]].position;
+            const std::array<double, 3> normal = face_normal(p0, vertices[result.indices[i + 1]].position,
+                                                             vertices[result.indices[i + 2]].position);
+            const double length = std::sqrt(dot(normal, normal));
+            if (length == 0.0) {
+                continue;
+            }
+            const double a = normal[0] / length, b = normal[1] / length, c = normal[2] / length;
+            const double d = -(a * p0[0] + b * p0[1] + c * p0[2]);
+            for (uint32_t k = 0; k < 3; k++) {
+                quadrics[result.indices[i + k]].add_plane(a, b, c, d, length * 0.5);
+            }
+        }
+
+        std::vector<uint32_t> remap(vertex_count);
+        std::vector<uint32_t> first_adjacent(vertex_count + 1);
+        std::vector<uint32_t> adjacency;
+        std::vector<bool> touched(vertex_count);
+        std::vector<Collapse> collapses;
+        while (result.indices.size() > target_index_count) {
+            // Vertex to triangle adjacency of the current level.
+            std::ranges::fill(first_adjacent, 0);
+            for (const uint32_t index : result.indices) {
+                first_adjacent[index + 1]++;
+            }
+            for (size_t v = 0; v < vertex_count; v++) {
+                first_adjacent[v + 1] += first_adjacent[v];
+            }
+            adjacency.resize(result.indices.size());
+            {
+                std::vector<uint32_t> cursor(first_adjacent.begin(), first_adjacent.end() - 1);
+                for (size_t i = 0; i < result.indices.size(); i++) {
+                    adjacency[cursor[result.indices[i]]++] = static_cast<uint32_t>(i / 3);
+                }
+            }
+
+            collapses.clear();
+            for (size_t i = 0; i < result.indices.size(); i += 3) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    const uint32_t a = result.indices[i + k];
+                    const uint32_t b = result.indices[i + (k + 1) % 3];
+                    for (const auto &[from, to] : {std::pair{a, b}, std::pair{b, a}}) {
+                        if (locked[from]) {
+                            continue;
+                        }
+                        Quadric merged = quadrics[from];
+                        merged += quadrics[to];
+                        const double squared = std::max(merged.evaluate(vertices[to].position), 0.0) /
+                                               std::max(merged.weight, 1e-30);
+                        collapses.push_back({static_cast<float>(std::sqrt(squared)), from, to});
+                    }
+                }
+            }
+            std::ranges::sort(collapses, {}, &Collapse::cost);
+
+            // Apply the cheapest collapses whose neighbourhoods do not overlap, so each flip test sees the
+            // final geometry around it.
+            touched.assign(vertex_count, false);
+            for (size_t v = 0; v < vertex_count; v++) {
+                remap[v] = static_cast<uint32_t>(v);
+            }
+            const size_t triangles_needed = (result.indices.size() - target_index_count + 2) / 3;
+            size_t triangles_removed = 0;
+            size_t applied = 0;
+            for (const Collapse &collapse : collapses) {
+                if (collapse.cost > max_error || triangles_removed >= triangles_needed) {
+                    break;
+                }
+                if (touched[collapse.from] || touched[collapse.to]) {
+                    continue;
+                }
+                bool flips = false;
+                size_t removes = 0;
+                for (uint32_t i = first_adjacent[collapse.from]; i < first_adjacent[collapse.from + 1]; i++) {
+                    const uint32_t *triangle = &result.indices[adjacency[i] * 3];
+                    if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                        removes++;
+                        continue;
+                    }
+                    std::array<const float *, 3> before{};
+                    std::array<const float *, 3> after{};
+                    for (uint32_t k = 0; k < 3; k++) {
+                        before[k] = vertices[triangle[k]].position;
+                        after[k] = triangle[k] == collapse.from ? vertices[collapse.to].position : before[k];
+                    }
+                    if (dot(face_normal(before[0], before[1], before[2]), face_normal(after[0], after[1], after[2])) <=
+                        0.0) {
+                        flips = true;
+                        break;
+                    }
+                }
+                if (flips) {
+                    continue;
+                }
+                remap[collapse.from] = collapse.to;
+                quadrics[collapse.to] += quadrics[collapse.from];
+                result.error = std::max(result.error, collapse.cost);
+                for (uint32_t i = first_adjacent[collapse.from]; i < first_adjacent[collapse.from + 1]; i++) {
+                    for (uint32_t k = 0; k < 3; k++) {
+                        touched[result.indices[adjacency[i] * 3 + k]] = true;
+                    }
+                }
+                triangles_removed += removes;
+                applied++;
+            }
+            if (applied == 0) {
+                break;
+            }
+
+            size_t write = 0;
+            for (size_t i = 0; i < result.indices.size(); i += 3) {
+                const uint32_t a = remap[result.indices[i]];
+                const uint32_t b = remap[result.indices[i + 1]];
+                const uint32_t c = remap[result.indices[i + 2]];
+                if (a != b && b != c && a != c) {
+                    result.indices[write++] = a;
+                    result.indices[write++] = b;
+                    result.indices[write++] = c;
+                }
+            }
+            result.indices.resize(write);
+        }
+        return result;
+    }
+
+    void generate_lods(ImportedMesh &mesh, const LodChainOptions &options) {
+        mesh.lods.clear();
+        if (mesh.vertices.empty()) {
+            return;
+        }
+        float low[3] = {mesh.vertices[0].position[0], mesh.vertices[0].position[1], mesh.vertices[0].position[2]};
+        float high[3] = {low[0], low[1], low[2]};
+        for (const MeshVertex &vertex : mesh.vertices) {
+            for (uint32_t c = 0; c < 3; c++) {
+                low[c] = std::min(low[c], vertex.position[c]);
+                high[c] = std::max(high[c], vertex.position[c]);
+            }
+        }
+        const float radius = 0.5f * std::sqrt((high[0] - low[0]) * (high[0] - low[0]) +
+                                              (high[1] - low[1]) * (high[1] - low[1]) +
+                                              (high[2] - low[2]) * (high[2] - low[2]));
+
+        // Every level is simplified from the full-detail mesh so its error is measured against the original.
+        size_t previous_count = mesh.indices.size();
+        float previous_error = 0.0f;
+        for (uint32_t level = 0; level < options.max_lods; level++) {
+            const size_t target = static_cast<size_t>(static_cast<float>(previous_count / 3) * options.reduction) * 3;
+            SimplifyResult simplified = simplify_mesh(mesh.vertices, mesh.indices, target, options.max_error * radius);
+            if (simplified.indices.empty() ||
+                static_cast<float>(simplified.indices.size()) > static_cast<float>(previous_count) * 0.9f) {
+                break;
+            }
+            previous_count = simplified.indices.size();
+            previous_error = std::max(previous_error, simplified.error);
+            mesh.lods.push_back({std::move(simplified.indices), previous_error});
+        }
+    }
+} // namespace pyro
@@ -0,0 +1,45 @@
+//
+// Created by srijan on 2/28/25.
+//
+
+#ifndef PYROMESHSIMPLIFY_HPP
+#define PYROMESHSIMPLIFY_HPP
+
+#include <span>
+#include <vector>
+
+#include "MeshImport.hpp"
+
+namespace pyro {
+
+    struct SimplifyResult {
+        // Triangle list over the input's vertex array; no vertex is moved or added.
+        std::vector<uint32_t> indices;
+        // Largest RMS distance to the original surface accepted by any collapse, in object units.
+        float error = 0.0f;
+    };
+
+    // Quadric error metric simplification by half-edge collapses onto existing vertices, so every level of a
+    // chain can share the full-detail vertex buffer. Collapses run in passes of independent edges, cheapest
+    // first, until the index count reaches `target_index_count` or the next collapse would exceed
+    // `max_error`; collapses that would flip a triangle are rejected. Vertices on open borders and attribute
+    // seams never move, so the result stays watertight and its UVs intact.
+    SimplifyResult simplify_mesh(std::span<const MeshVertex> vertices, std::span<const uint32_t> indices,
+                                 size_t target_index_count, float max_error);
+
+    struct LodChainOptions {
+        // Levels in addition to the full-detail mesh.
+        uint32_t max_lods = 4;
+        // Each level aims for this fraction of the previous level's triangles.
+        float reduction = 0.5f;
+        // Relative to the mesh's bounding sphere radius.
+        float max_error = 0.05f;
+    };
+
+    // Fills mesh.lods with successively coarser levels, stopping early when a level no longer removes at least
+    // a tenth of its predecessor's triangles.
+    void generate_lods(ImportedMesh &mesh, const LodChainOptions &options = {});
+
+} // namespace pyro
+
+#endif // PYROMESHSIMPLIFY_HPP
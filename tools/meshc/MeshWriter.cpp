@@ -0,0 +1,150 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#include "MeshWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+
+#include "../../src/utils/Logger.hpp"
+#include "MeshOptimize.hpp"
+
+namespace pyro {
+    bool write_mesh_file(const std::string &path, const std::span<const ImportedMesh> meshes,
+                         const MeshWriteOptions &options) {
+        const uint32_t vertex_stride = mesh_vertex_stride(options.vertex_format);
+        std::vector<MeshEntry> entries;
+        entries.reserve(meshes.size());
+        std::vector<MeshLod> lods;
+        std::vector<MeshletEntry> meshlets;
+        uint64_t meshlet_vertex_count = 0;
+        uint64_t meshlet_triangle_count = 0;
+        uint64_t vertex_count = 0;
+        uint64_t index_count = 0;
+        for (const ImportedMesh &mesh : meshes) {
+            MeshEntry entry{};
+            const size_t name_length = std::min(mesh.name.size(), sizeof(entry.name) - 1);
+            std::copy_n(mesh.name.data(), name_length, entry.name);
+            entry.first_vertex = static_cast<uint32_t>(vertex_count);
+            entry.vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+            entry.first_index = static_cast<uint32_t>(index_count);
+            entry.index_count = static_cast<uint32_t>(mesh.indices.size());
+            entry.first_lod = static_cast<uint32_t>(lods.size());
+            entry.lod_count = static_cast<uint32_t>(mesh.lods.size() + 1);
+            entry.first_meshlet = static_cast<uint32_t>(meshlets.size());
+            entry.meshlet_count = static_cast<uint32_t>(mesh.meshlets.size());
+            std::fill_n(entry.bounds_min, 3, mesh.vertices.empty() ? 0.0f : std::numeric_limits<float>::max());
+            std::fill_n(entry.bounds_max, 3, mesh.vertices.empty() ? 0.0f : std::numeric_limits<float>::lowest());
+            for (const MeshVertex &vertex : mesh.vertices) {
+                for (uint32_t c = 0; c < 3; c++) {
+                    entry.bounds_min[c] = std::min(entry.bounds_min[c], vertex.position[c]);
+                    entry.bounds_max[c] = std::max(entry.bounds_max[c], vertex.position[c]);
+                }
+            }
+            entries.push_back(entry);
+            vertex_count += mesh.vertices.size();
+            // Each mesh's levels follow its full-detail indices.
+            lods.push_back({entry.first_index, entry.index_count, 0.0f, 0});
+            index_count += mesh.indices.size();
+            for (const ImportedLod &lod : mesh.lods) {
+                lods.push_back({static_cast<uint32_t>(index_count), static_cast<uint32_t>(lod.indices.size()),
+                                lod.error, 0});
+                index_count += lod.indices.size();
+            }
+            // Meshlet offsets become offsets into the shared sections; their vertices stay mesh-relative.
+            for (MeshletEntry meshlet : mesh.meshlets) {
+                meshlet.vertex_offset += static_cast<uint32_t>(meshlet_vertex_count);
+                meshlet.triangle_offset += static_cast<uint32_t>(meshlet_triangle_count);
+                meshlets.push_back(meshlet);
+            }
+            meshlet_vertex_count += mesh.meshlet_vertices.size();
+            meshlet_triangle_count += mesh.meshlet_triangles.size();
+        }
+        constexpr uint64_t LIMIT = std::numeric_limits<uint32_t>::max();
+        if (vertex_count > LIMIT || index_count > LIMIT || meshlet_vertex_count > LIMIT ||
+            meshlet_triangle_count > LIMIT) {
+            LOG(LogLevel::ERROR, "{}: {} vertices / {} indices / {} meshlet triangles exceed the 32-bit ranges of "
+                "the mesh table", path, vertex_count, index_count, meshlet_triangle_count);
+            return false;
+        }
+
+        std::array<MeshSectionEntry, 7> sections{{
+                {MeshSectionType::MESHES, 0, 0, entries.size() * sizeof(MeshEntry)},
+                {MeshSectionType::LODS, 0, 0, lods.size() * sizeof(MeshLod)},
+                {MeshSectionType::MESHLETS, 0, 0, meshlets.size() * sizeof(MeshletEntry)},
+                {MeshSectionType::VERTICES, 0, 0, vertex_count * vertex_stride},
+                {MeshSectionType::INDICES, 0, 0, index_count * sizeof(uint32_t)},
+                {MeshSectionType::MESHLET_VERTICES, 0, 0, meshlet_vertex_count * sizeof(uint32_t)},
+                {MeshSectionType::MESHLET_TRIANGLES, 0, 0, meshlet_triangle_count * sizeof(uint32_t)},
+        }};
+        uint64_t offset = sizeof(MeshFileHeader) + sizeof(sections);
+        for (MeshSectionEntry &section : sections) {
+            section.offset = align_mesh_section(offset);
+            offset = section.offset + section.size;
+        }
+        MeshFileHeader header{};
+        header.magic = MESH_FILE_MAGIC;
+        header.version = MESH_FILE_VERSION;
+        header.section_count = static_cast<uint32_t>(sections.size());
+        header.vertex_stride = vertex_stride;
+        header.vertex_format = options.vertex_format;
+        header.file_size = offset;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            LOG(LogLevel::ERROR, "Failed to create {}", path);
+            return false;
+        }
+        uint64_t written = 0;
+        const auto write = [&](const void *data, const size_t size) {
+            file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+            written += size;
+        };
+        const auto pad_to = [&](const uint64_t target) {
+            static constexpr char ZEROS[MESH_SECTION_ALIGNMENT] = {};
+            write(ZEROS, target - written);
+        };
+        write(&header, sizeof(header));
+        write(sections.data(), sizeof(sections));
+        pad_to(sections[0].offset);
+        write(entries.data(), sections[0].size);
+        pad_to(sections[1].offset);
+        write(lods.data(), sections[1].size);
+        pad_to(sections[2].offset);
+        write(meshlets.data(), sections[2].size);
+        pad_to(sections[3].offset);
+        std::vector<QuantizedMeshVertex> quantized;
+        for (const ImportedMesh &mesh : meshes) {
+            if (options.vertex_format == MeshVertexFormat::QUANTIZED) {
+                quantized.resize(mesh.vertices.size());
+                std::ranges::transform(mesh.vertices, quantized.begin(), quantize_vertex);
+                write(quantized.data(), quantized.size() * sizeof(QuantizedMeshVertex));
+            } else {
+                write(mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshVertex));
+            }
+        }
+        pad_to(sections[4].offset);
+        for (const ImportedMesh &mesh : meshes) {
+            write(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+            for (const ImportedLod &lod : mesh.lods) {
+                write(lod.indices.data(), lod.indices.size() * sizeof(uint32_t));
+            }
+        }
+        pad_to(sections[5].offset);
+        for (const ImportedMesh &mesh : meshes) {
+            write(mesh.meshlet_vertices.data(), mesh.meshlet_vertices.size() * sizeof(uint32_t));
+        }
+        pad_to(sections[6].offset);
+        for (const ImportedMesh &mesh : meshes) {
+            write(mesh.meshlet_triangles.data(), mesh.meshlet_triangles.size() * sizeof(uint32_t));
+        }
+        if (!file.flush()) {
+            LOG(LogLevel::ERROR, "Failed to write {}", path);
+            return false;
+        }
+        return true;
+    }
+} // namespace pyro
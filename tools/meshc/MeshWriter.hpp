@@ -0,0 +1,27 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#ifndef PYROMESHWRITER_HPP
+#define PYROMESHWRITER_HPP
+
+#include <span>
+#include <string>
+
+#include "MeshImport.hpp"
+
+namespace pyro {
+
+    struct MeshWriteOptions {
+        MeshVertexFormat vertex_format = MeshVertexFormat::FLOAT32;
+    };
+
+    // Packs the meshes into one .pmesh file: the index, level and meshlet tables, then every mesh's vertices,
+    // indices (full detail, then each level) and meshlet data concatenated in order. Names longer than the
+    // table's field are truncated.
+    bool write_mesh_file(const std::string &path, std::span<const ImportedMesh> meshes,
+                         const MeshWriteOptions &options = {});
+
+} // namespace pyro
+
+#endif // PYROMESHWRITER_HPP
@@ -0,0 +1,107 @@
+//
+// Created by srijan on 2/26/25.
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <iostream>
+
+#include "MeshCluster.hpp"
+#include "MeshImport.hpp"
+#include "MeshOptimize.hpp"
+#include "MeshSimplify.hpp"
+#include "MeshWriter.hpp"
+
+namespace {
+    struct MeshTotals {
+        size_t vertices = 0;
+        size_t triangles = 0;
+        double misses = 0.0;
+        double unique_misses = 0.0;
+    };
+
+    MeshTotals measure(const std::vector<pyro::ImportedMesh> &meshes) {
+        MeshTotals totals{};
+        for (const pyro::ImportedMesh &mesh : meshes) {
+            const size_t triangles = mesh.indices.size() / 3;
+            const pyro::VertexCacheStats stats = pyro::analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+            totals.vertices += mesh.vertices.size();
+            totals.triangles += triangles;
+            totals.misses += stats.acmr * static_cast<double>(triangles);
+            totals.unique_misses += stats.atvr > 0.0f ? stats.acmr * static_cast<double>(triangles) / stats.atvr : 0.0;
+        }
+        return totals;
+    }
+
+    void print_totals(const char *label, const MeshTotals &totals, const size_t vertex_stride) {
+        const double acmr = totals.triangles ? totals.misses / static_cast<double>(totals.triangles) : 0.0;
+        const double atvr = totals.unique_misses > 0.0 ? totals.misses / totals.unique_misses : 0.0;
+        std::cout << std::format("{:<8} {:>10} vertices {:>10} triangles  ACMR {:.3f}  ATVR {:.3f}  {:.2f} MB\n",
+                                 label, totals.vertices, totals.triangles, acmr, atvr,
+                                 static_cast<double>(totals.vertices * vertex_stride + totals.triangles * 12) /
+                                         1048576.0);
+    }
+} // namespace
+
+// Offline converter from glTF/OBJ to the engine's .pmesh format. Every mesh gets a chain of up to --lods N
+// simplified levels (default 4, 0 disables) and is optimised for the post-transform cache, overdraw and vertex
+// fetch unless --no-optimize is given, then split into meshlets for cluster culling unless --no-meshlets is
+// given; --quantize stores QuantizedMeshVertex.
+int main(const int argc, char **argv) {
+    bool optimize = true;
+    bool meshlets = true;
+    pyro::LodChainOptions lod_options{};
+    pyro::MeshWriteOptions options{};
+    int first_path = 1;
+    for (; first_path < argc && std::strncmp(argv[first_path], "--", 2) == 0; first_path++) {
+        if (std::strcmp(argv[first_path], "--no-optimize") == 0) {
+            optimize = false;
+        } else if (std::strcmp(argv[first_path], "--no-meshlets") == 0) {
+            meshlets = false;
+        } else if (std::strcmp(argv[first_path], "--quantize") == 0) {
+            options.vertex_format = pyro::MeshVertexFormat::QUANTIZED;
+        } else if (std::strcmp(argv[first_path], "--lods") == 0 && first_path + 1 < argc) {
+            lod_options.max_lods = static_cast<uint32_t>(std::strtoul(argv[++first_path], nullptr, 10));
+        } else {
+            std::cerr << "unknown option " << argv[first_path] << "\n";
+            return 1;
+        }
+    }
+    if (argc - first_path != 2) {
+        std::cerr << "usage: pyro_meshc [--no-optimize] [--no-meshlets] [--quantize] [--lods N] "
+                     "<input.gltf|input.glb|input.obj> <output.pmesh>\n";
+        return 1;
+    }
+    auto meshes = pyro::import_mesh(argv[first_path]);
+    if (!meshes) {
+        return 1;
+    }
+    print_totals("input", measure(*meshes), sizeof(pyro::MeshVertex));
+    for (pyro::ImportedMesh &mesh : *meshes) {
+        pyro::generate_lods(mesh, lod_options);
+        std::cout << std::format("  {}: {} triangles", mesh.name, mesh.indices.size() / 3);
+        for (const pyro::ImportedLod &lod : mesh.lods) {
+            std::cout << std::format(" -> {} (error {:.4g})", lod.indices.size() / 3, lod.error);
+        }
+        std::cout << "\n";
+    }
+    if (optimize) {
+        for (pyro::ImportedMesh &mesh : *meshes) {
+            pyro::optimize_mesh(mesh);
+        }
+    }
+    if (meshlets) {
+        size_t meshlet_count = 0;
+        for (pyro::ImportedMesh &mesh : *meshes) {
+            pyro::build_meshlets(mesh);
+            meshlet_count += mesh.meshlets.size();
+        }
+        std::cout << std::format("{} meshlets\n", meshlet_count);
+    }
+    if (!pyro::write_mesh_file(argv[first_path + 1], *meshes, options)) {
+        return 1;
+    }
+    print_totals("output", measure(*meshes), pyro::mesh_vertex_stride(options.vertex_format));
+    return 0;
+}